@@ -0,0 +1,289 @@
+#include "gtest/gtest.h"
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <map>
+#include "random"
+#include "../../includes/sql/sql.h"
+using namespace std;
+
+//aggregates: grouped and ungrouped results, by index walk or by hashing, are what a count of
+//the rows in memory gives, ordered on a group key or an aggregate column and paged over groups
+
+const int AGG_ROWS = 600;
+const vectorstr AGG_FIELDS = {"region", "item", "qty", "price"};
+
+//the rows of a result table, in order
+vector<vectorstr> rows_of(Table& result)
+{
+  vector<vectorstr> rows;
+  fstream f;
+  result.open_records(f);
+  for (long r = 0; r < result.record_count(); r++)
+    rows.push_back(result.read_record(f, r));
+  f.close();
+  return rows;
+}
+
+vector<vectorstr> select_rows(SQL& sql, const string& command)
+{
+  Table result = sql.command(command);
+  if (sql.errorState())
+    return vector<vectorstr>(1, vectorstr(1, "error"));
+  return rows_of(result);
+}
+
+//columns over the rows keep picks, one row per distinct group_by value, groups in key order
+vector<vectorstr> reference(const vector<vectorstr>& rows, const vectorstr& columns, const vectorstr& group_by,
+                            function<bool(const vectorstr&)> keep)
+{
+  map<vectorstr, vector<int> > groups;
+  for (int r = 0; r < rows.size(); r++)
+  {
+    if (!keep(rows[r]))
+      continue;
+    vectorstr key;
+    for (int g = 0; g < group_by.size(); g++)
+      key.push_back(rows[r][find(AGG_FIELDS.begin(), AGG_FIELDS.end(), group_by[g]) - AGG_FIELDS.begin()]);
+    groups[key].push_back(r);
+  }
+  //without a group by there is one row, also over no records
+  if (group_by.empty() && groups.empty())
+    groups[vectorstr()];
+  vector<vectorstr> result;
+  for (map<vectorstr, vector<int> >::iterator it = groups.begin(); it != groups.end(); ++it)
+  {
+    vectorstr row;
+    for (int c = 0; c < columns.size(); c++)
+    {
+      AggregateColumn column(columns[c]);
+      int field = find(AGG_FIELDS.begin(), AGG_FIELDS.end(), column.field) - AGG_FIELDS.begin();
+      const vector<int>& members = it->second;
+      if (!column.is_aggregate())
+      {
+        row.push_back(rows[members[0]][field]);
+        continue;
+      }
+      Accumulator accumulator(column.func);
+      for (int m = 0; m < members.size(); m++)
+        accumulator.add(column.field == "*" ? "" : rows[members[m]][field]);
+      row.push_back(accumulator.result());
+    }
+    result.push_back(row);
+  }
+  return result;
+}
+
+vectorstr split_columns(const string& list)
+{
+  vectorstr columns;
+  istringstream in(list);
+  string column;
+  while (getline(in, column, ','))
+  {
+    column.erase(remove(column.begin(), column.end(), ' '), column.end());
+    columns.push_back(column);
+  }
+  return columns;
+}
+
+vector<vectorstr> sorted(vector<vectorstr> rows)
+{
+  sort(rows.begin(), rows.end());
+  return rows;
+}
+
+vector<vectorstr> make_sales(SQL& sql)
+{
+  mt19937 random(33);
+  const vectorstr regions = {"east", "west", "north", "south", "central"};
+  const vectorstr items = {"pen", "ink", "pad", "cap", "box", "tag"};
+  vector<vectorstr> rows(AGG_ROWS);
+  sql.command("drop table aggsales");
+  sql.command("make table aggsales fields region, item, qty, price");
+  for (int r = 0; r < AGG_ROWS; r++)
+  {
+    //a region or item is skewed toward the first few, so groups have different sizes
+    rows[r] = {regions[random() % (1 + random() % regions.size())], items[random() % items.size()],
+               to_string(1 + random() % 20), to_string(5 * (1 + random() % 40))};
+    sql.command("insert into aggsales values " + rows[r][0] + ", " + rows[r][1] + ", " + rows[r][2] + ", " + rows[r][3]);
+  }
+  return rows;
+}
+
+bool always(const vectorstr& row) {return true;}
+
+bool test_grouped_aggregates(bool debug = false)
+{
+  SQL sql;
+  vector<vectorstr> rows = make_sales(sql);
+  struct Grouped {string columns; string group_by;};
+  //one group field with aggregates of it walks its index, anything else hashes
+  const Grouped cases[] = {
+    {"region, count(*)", "region"},
+    {"region, count(*), min(region), max(region)", "region"},
+    {"region, count(*), sum(qty), avg(price), min(item), max(item)", "region"},
+    {"item, avg(qty), count(price)", "item"},
+    {"region, item, count(*), sum(qty)", "region, item"},
+    {"count(*), item", "item"}
+  };
+  for (int i = 0; i < sizeof(cases) / sizeof(cases[0]); i++)
+  {
+    string command = "select " + cases[i].columns + " from aggsales group by " + cases[i].group_by;
+    vector<vectorstr> want = reference(rows, split_columns(cases[i].columns), split_columns(cases[i].group_by), always);
+    vector<vectorstr> got = select_rows(sql, command);
+    if (debug)
+      cout << command << ": " << got.size() << " groups\n";
+    if (sorted(got) != sorted(want))
+      return false;
+  }
+  //and grouped under a where condition, a group with no rows left is not listed
+  vector<vectorstr> want = reference(rows, {"item", "count(*)", "sum(qty)"}, {"item"},
+                                     [](const vectorstr& row) {return row[0] == "east" && row[1] != "pen";});
+  if (sorted(select_rows(sql, "select item, count(*), sum(qty) from aggsales where region = east and not item = pen group by item")) != sorted(want))
+    return false;
+  sql.command("drop table aggsales");
+  return true;
+}
+
+bool test_ungrouped_aggregates(bool debug = false)
+{
+  SQL sql;
+  vector<vectorstr> rows = make_sales(sql);
+  const string columns = "count(*), min(qty), max(qty), sum(qty), avg(price), count(item), min(region)";
+  struct Where {string condition; function<bool(const vectorstr&)> keep;};
+  //the conditions compare as text, the way the indexes do
+  const Where cases[] = {
+    {"", always},
+    {" where region = east", [](const vectorstr& row) {return row[0] == "east";}},
+    {" where qty > 15 or item = ink", [](const vectorstr& row) {return strcmp(row[2].c_str(), "15") > 0 || row[1] == "ink";}},
+    {" where region != central and price < 50", [](const vectorstr& row) {return row[0] != "central" && strcmp(row[3].c_str(), "50") < 0;}},
+    {" where region = nowhere", [](const vectorstr& row) {return false;}}
+  };
+  for (int i = 0; i < sizeof(cases) / sizeof(cases[0]); i++)
+  {
+    string command = "select " + columns + " from aggsales" + cases[i].condition;
+    vector<vectorstr> want = reference(rows, split_columns(columns), vectorstr(), cases[i].keep);
+    vector<vectorstr> got = select_rows(sql, command);
+    if (debug && !got.empty())
+      cout << command << ": " << got[0][0] << " rows, sum " << got[0][3] << ", avg " << got[0][4] << "\n";
+    if (got != want)
+      return false;
+  }
+  sql.command("drop table aggsales");
+  return true;
+}
+
+bool test_ordered_groups(bool debug = false)
+{
+  SQL sql;
+  vector<vectorstr> rows = make_sales(sql);
+  const vectorstr columns = {"item", "count(*)", "sum(qty)", "max(region)"};
+  vector<vectorstr> groups = reference(rows, columns, {"item"}, always);
+  struct Order {string clause; int column; bool numeric; bool descending;};
+  const Order orders[] = {
+    {" order by item", 0, false, false},
+    {" order by item desc", 0, false, true},
+    {" order by count(*)", 1, true, false},
+    {" order by count(*) desc", 1, true, true},
+    {" order by sum(qty) desc", 2, true, true},
+    {" order by max(region) asc", 3, false, false}
+  };
+  const long pages[][2] = {{-1, 0}, {2, 0}, {3, 2}, {10, 4}, {-1, 5}, {0, 0}};
+  for (int o = 0; o < sizeof(orders) / sizeof(orders[0]); o++)
+  {
+    //groups in item order, then stably by the column, counts and sums as numbers
+    vector<vectorstr> ordered = groups;
+    const Order& order = orders[o];
+    stable_sort(ordered.begin(), ordered.end(), [&order](const vectorstr& lhs, const vectorstr& rhs) {
+      const string& l = lhs[order.column];
+      const string& r = rhs[order.column];
+      if (order.numeric)
+        return order.descending ? atof(r.c_str()) < atof(l.c_str()) : atof(l.c_str()) < atof(r.c_str());
+      return order.descending ? r < l : l < r;
+    });
+    for (int p = 0; p < sizeof(pages) / sizeof(pages[0]); p++)
+    {
+      long limit = pages[p][0];
+      long offset = pages[p][1];
+      string command = "select item, count(*), sum(qty), max(region) from aggsales group by item" + order.clause;
+      if (limit >= 0)
+        command += " limit " + to_string(limit);
+      if (offset)
+        command += " offset " + to_string(offset);
+      vector<vectorstr> want(ordered.begin() + min<long>(offset, ordered.size()), ordered.end());
+      if (limit >= 0 && want.size() > limit)
+        want.resize(limit);
+      vector<vectorstr> got = select_rows(sql, command);
+      if (got != want)
+      {
+        if (debug)
+          cout << command << ": " << got.size() << " rows, wanted " << want.size() << "\n";
+        return false;
+      }
+    }
+  }
+  //an order on a column the result does not have is an error
+  ostringstream silenced;
+  streambuf* cout_buffer = cout.rdbuf(silenced.rdbuf());
+  sql.command("select item, count(*) from aggsales group by item order by sum(qty)");
+  bool missing_failed = sql.errorState();
+  cout.rdbuf(cout_buffer);
+  sql.command("drop table aggsales");
+  return missing_failed;
+}
+
+bool test_group_values(bool debug = false)
+{
+  //group is stored as a value, and a quoted "group" in a condition is that value, not the clause
+  SQL sql;
+  sql.command("drop table aggwords");
+  sql.command("make table aggwords fields word, qty");
+  sql.command("insert into aggwords values group, 1");
+  sql.command("insert into aggwords values sum, 2");
+  sql.command("insert into aggwords values \"group\", 3");
+  if (sql.errorState())
+    return false;
+  vector<vectorstr> grouped = select_rows(sql, "select word, qty from aggwords where word = \"group\"");
+  vector<vectorstr> summed = select_rows(sql, "select word, sum(qty) from aggwords where word = 'group' or word = sum group by word");
+  if (debug)
+    cout << grouped.size() << " rows, " << summed.size() << " groups\n";
+  sql.command("drop table aggwords");
+  return grouped == vector<vectorstr>({{"group", "1"}, {"group", "3"}})
+      && summed == vector<vectorstr>({{"group", "4"}, {"sum", "2"}});
+}
+
+// ==============================
+// global BAD!
+bool debug = false;
+// ==============================
+
+TEST(AGGREGATE, GroupedAggregates) {
+  EXPECT_EQ(test_grouped_aggregates(debug), true);
+}
+
+TEST(AGGREGATE, UngroupedAggregates) {
+  EXPECT_EQ(test_ungrouped_aggregates(debug), true);
+}
+
+TEST(AGGREGATE, OrderedGroups) {
+  EXPECT_EQ(test_ordered_groups(debug), true);
+}
+
+TEST(AGGREGATE, GroupValues) {
+  EXPECT_EQ(test_group_values(debug), true);
+}
+
+int main(int argc, char **argv) {
+  if (argc > 1)
+  {
+    debug = !strcmp(argv[1], "debug");
+  }
+
+  ::testing::InitGoogleTest(&argc, argv);
+  std::cout<<"\n\n----------running aggregate_test.cpp---------\n\n"<<std::endl;
+  return RUN_ALL_TESTS();
+}
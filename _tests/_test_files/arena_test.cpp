@@ -0,0 +1,165 @@
+#include "gtest/gtest.h"
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include "../../includes/Arena/arena.h"
+#include "../../includes/sql/sql.h"
+using namespace std;
+
+//the arena and the leak check: the sample query set runs over and over, and after its first
+//round (which fills the tables' and the parser's one time state) the heap must not grow
+
+const int LEAK_ROUNDS = 50;
+
+const char* SETUP_COMMANDS[] = {
+  "make table leakemployee fields last, first, dep, salary, year",
+  "insert into leakemployee values Blow, Joe, CS, 100000, 2018",
+  "insert into leakemployee values Blow, JoAnn, Physics, 200000, 2016",
+  "insert into leakemployee values Johnson, Jack, HR, 150000, 2014",
+  "insert into leakemployee values Johnson, \"Jimmy\", Chemistry, 140000, 2018",
+  "make table leakstudent fields fname, lname, major, age, company",
+  "insert into leakstudent values Flo, Yao, CS, 20, Google",
+  "insert into leakstudent values Bo, Yang, CS, 28, Microsoft",
+  "insert into leakstudent values \"Sammuel L.\", Jackson, CS, 40, Uber",
+  "insert into leakstudent values \"Flo\", \"Jackson\", Math, 21, Google",
+  "insert into leakstudent values \"Greg\", \"Pearson\", Physics, 20, Amazon"
+};
+const int SETUP_COMMAND_COUNT = sizeof(SETUP_COMMANDS) / sizeof(SETUP_COMMANDS[0]);
+
+//the sample queries, the ones with errors throw out of the middle of compiling their condition
+const char* QUERY_COMMANDS[] = {
+  "select lname, fname, major from leakstudent where ((lname=Yang or major=CS) and age<23 )or lname=Jackson",
+  "select lname, fname, major from leakstudent where ((lname=Yang or major=CS and age<23 )or lname=Jackson",
+  "select lname, fname, major from leakstudent where (lname=Yang or major=CS) and age<23 )or lname=Jackson",
+  "select lname, fname, major from leakstudent where ((lname= or major=CS) and age<23 )or lname=Jackson",
+  "select lname, fname, major from leakstudent where ((lname=Yang  major=CS) and age<23 )or lname=Jackson",
+  "select lname, fname, major from leakstudent where ((lname=Yang or ) and age<23 )or lname=Jackson",
+  "select lname, fname, major from leakstudent where ((lname=Yang or major=>CS) and age<23 )or lname=Jackson",
+  "select * from leakstudent where lname = Nobody or age < 21",
+  "select * from leakstudent where not (major = CS) and age != 20",
+  "select * from leakemployee where salary >= 150000 and year = 2018 order by last",
+  "select dep, count(*) from leakemployee where year > 2014 group by dep",
+  "select * from leakemployee where bogus = 3",
+  "select * from leakemployee where last = Blow and salary"
+};
+const int QUERY_COMMAND_COUNT = sizeof(QUERY_COMMANDS) / sizeof(QUERY_COMMANDS[0]);
+
+//heap blocks not yet freed, counted from the start of the program
+atomic<long> live_allocations(0);
+
+void* operator new(size_t size)
+{
+  live_allocations++;
+  void* p = malloc(size ? size : 1);
+  if (!p)
+    throw bad_alloc();
+  return p;
+}
+
+void operator delete(void* p) noexcept
+{
+  if (p)
+    live_allocations--;
+  free(p);
+}
+
+//counts how many of it are alive
+struct Tracked
+{
+  static int alive;
+  string text;
+  Tracked(const string& t): text(t) {alive++;}
+  ~Tracked() {alive--;}
+};
+int Tracked::alive = 0;
+
+bool test_arena(bool debug = false)
+{
+  Arena arena;
+  //the inline bytes first, then heap blocks, with every object aligned for its type
+  for (int round = 0; round < 3; round++)
+  {
+    for (int i = 0; i < 1000; i++)
+    {
+      Tracked* t = arena.make<Tracked>("a string that is too long for the small string buffer");
+      double* d = arena.make<double>(i);
+      char* c = arena.make<char>('c');
+      if ((size_t)t % alignof(Tracked) || (size_t)d % alignof(double) || *d != i || *c != 'c')
+        return false;
+    }
+    if (Tracked::alive != 1000 || arena.heap_blocks() == 0)
+      return false;
+    if (debug)
+      cout << arena.bytes_used() << " bytes in " << arena.heap_blocks() << " heap blocks\n";
+    arena.reset();
+    if (Tracked::alive != 0 || arena.bytes_used() != 0 || arena.heap_blocks() != 0)
+      return false;
+  }
+  //a few tokens fit in the arena's own bytes, and one bigger than a block gets a block of its own
+  long before = live_allocations;
+  {
+    Arena tokens;
+    for (int i = 0; i < 20; i++)
+      tokens.make<TokenStr>("lname");
+    if (tokens.heap_blocks() != 0)
+      return false;
+    char* big = static_cast<char*>(tokens.allocate(3 * ARENA_BLOCK_BYTES, 64));
+    big[3 * ARENA_BLOCK_BYTES - 1] = 'x';
+    if ((size_t)big % 64 || tokens.heap_blocks() != 1)
+      return false;
+  }
+  return live_allocations == before;
+}
+
+void run_commands(SQL& sql, const char* commands[], int count)
+{
+  //errors are printed by the commands, they are expected here
+  stringstream quiet;
+  streambuf* out = cout.rdbuf(quiet.rdbuf());
+  for (int i = 0; i < count; i++)
+    sql.command(commands[i]);
+  cout.rdbuf(out);
+}
+
+bool test_query_leaks(bool debug = false)
+{
+  SQL sql;
+  //every query runs, none is answered from the cache
+  sql.enableQueryCache(0, false);
+  run_commands(sql, SETUP_COMMANDS, SETUP_COMMAND_COUNT);
+  run_commands(sql, QUERY_COMMANDS, QUERY_COMMAND_COUNT);
+  long after_first_round = live_allocations;
+  for (int round = 0; round < LEAK_ROUNDS; round++)
+    run_commands(sql, QUERY_COMMANDS, QUERY_COMMAND_COUNT);
+  long grown = live_allocations - after_first_round;
+  if (debug || grown != 0)
+    cout << grown << " heap blocks still alive after " << LEAK_ROUNDS << " rounds of " << QUERY_COMMAND_COUNT << " queries\n";
+  return grown == 0;
+}
+
+// ==============================
+// global BAD!
+bool debug = false;
+// ==============================
+
+TEST(ARENA, Arena) {
+  EXPECT_EQ(test_arena(debug), true);
+}
+
+TEST(ARENA, QueryLeaks) {
+  EXPECT_EQ(test_query_leaks(debug), true);
+}
+
+int main(int argc, char **argv) {
+  if (argc > 1)
+  {
+    debug = !strcmp(argv[1], "debug");
+  }
+
+  ::testing::InitGoogleTest(&argc, argv);
+  std::cout<<"\n\n----------running arena_test.cpp---------\n\n"<<std::endl;
+  return RUN_ALL_TESTS();
+}
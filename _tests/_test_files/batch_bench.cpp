@@ -0,0 +1,197 @@
+#include "gtest/gtest.h"
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <chrono>
+#include <algorithm>
+#include "../../includes/sql/sql.h"
+using namespace std;
+
+//batch transaction: a script that commits leaves the same tables a plain batch leaves, one that
+//fails leaves them as they were, and the timings print statements per second of both batches
+
+const int BENCH_INSERTS = 1000;
+
+double elapsed_ms(chrono::steady_clock::time_point start)
+{
+  return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+}
+
+void write_script(const vectorstr& statements)
+{
+  ofstream script("batch.txt", ios::trunc);
+  for (int i = 0; i < statements.size(); i++)
+    script << statements[i] << ";\n";
+}
+
+//what a select selects, by record number in order, {-1} if it failed
+vectorlong selected(SQL& sql, const string& command)
+{
+  sql.command(command);
+  if (sql.errorState())
+    return vectorlong(1, -1);
+  vectorlong recnos = sql.selectRecordNos();
+  sort(recnos.begin(), recnos.end());
+  return recnos;
+}
+
+//runs the script with cout silenced, returns its milliseconds
+double run_batch(SQL& sql, bool transaction, string* output = NULL)
+{
+  ostringstream silenced;
+  streambuf* cout_buffer = cout.rdbuf(silenced.rdbuf());
+  chrono::steady_clock::time_point start = chrono::steady_clock::now();
+  sql.batch(transaction);
+  double ms = elapsed_ms(start);
+  cout.rdbuf(cout_buffer);
+  if (output)
+    *output = silenced.str();
+  return ms;
+}
+
+bool test_batch_commit(bool debug = false)
+{
+  SQL sql;
+  sql.command("drop table batchcommit");
+  write_script({
+    "make table batchcommit fields name, age",
+    "insert into batchcommit values Ann, 30",
+    "insert into batchcommit values Bob, 25",
+    "select * from batchcommit where age > 20",
+    "insert into batchcommit values (Cid, 41), (Dee, 19)",
+    "insert into batchcommit values Eve, 30"
+  });
+  string output;
+  run_batch(sql, true, &output);
+  if (debug)
+    cout << output;
+  //only the select prints its rows, then the summary
+  if (output.find("4: select") == string::npos || output.find("batch transaction committed: 6 statements") == string::npos
+      || output.find("2: insert") != string::npos)
+    return false;
+  //the index keys collected while the inserts were deferred went in with their recnos in order
+  if (selected(sql, "select * from batchcommit where age = 30") != vectorlong({0, 4}))
+    return false;
+  if (selected(sql, "select * from batchcommit where age < 26") != vectorlong({1, 3}))
+    return false;
+  //inserts after the batch go straight to the index again
+  sql.command("insert into batchcommit values Fay, 30");
+  return selected(sql, "select * from batchcommit where age = 30") == vectorlong({0, 4, 5});
+}
+
+bool test_batch_rollback(bool debug = false)
+{
+  SQL sql;
+  sql.command("drop table batchkept");
+  sql.command("drop table batchmade");
+  sql.command("make table batchkept fields name, age");
+  sql.command("insert into batchkept values Ann, 30");
+  write_script({
+    "insert into batchkept values Bob, 30",
+    "select * from batchkept where age = 30",
+    "make table batchmade fields name",
+    "insert into batchmade values Cid",
+    "insert into batchkept values Dee, 30",
+    "insert into nosuchtable values Eve",
+    "insert into batchkept values Fay, 30"
+  });
+  string output;
+  run_batch(sql, true, &output);
+  if (debug)
+    cout << output;
+  if (output.find("rolled back, statement 6 failed") == string::npos)
+    return false;
+  //the select inside the batch saw Bob, after the rollback only Ann is left
+  if (output.find("records: 2") == string::npos)
+    return false;
+  if (selected(sql, "select * from batchkept where age = 30") != vectorlong({0}))
+    return false;
+  //the table the batch made is gone, selecting from it fails
+  if (selected(sql, "select * from batchmade") != vectorlong(1, -1))
+    return false;
+  //drop cannot be rolled back, so a batch transaction refuses it
+  write_script({"insert into batchkept values Gus, 30", "drop table batchkept"});
+  run_batch(sql, true, &output);
+  if (output.find("cannot run inside a batch transaction") == string::npos)
+    return false;
+  return selected(sql, "select * from batchkept") == vectorlong({0});
+}
+
+bool test_transaction_value(bool debug = false)
+{
+  //transaction is a keyword only after batch, as a value it is inserted and selected like any word
+  SQL sql;
+  sql.command("drop table batchword");
+  sql.command("drop table batchother");
+  sql.command("make table batchword fields a, b");
+  sql.command("insert into batchword values transaction, x");
+  sql.command("insert into batchword values (y, transaction), (transaction, transaction)");
+  bool ok = !sql.errorState();
+  ok = ok && selected(sql, "select * from batchword where a = transaction") == vectorlong({0, 2});
+  ok = ok && selected(sql, "select * from batchword where b = transaction and not a = transaction") == vectorlong({1});
+  //and in a join condition
+  sql.command("make table batchother fields c");
+  sql.command("insert into batchother values transaction");
+  Table joined = sql.command("select a, c from batchword join batchother on a = c and c = transaction");
+  ok = ok && !sql.errorState() && joined.record_count() == 2;
+  sql.command("drop table batchword");
+  sql.command("drop table batchother");
+  return ok;
+}
+
+bool bench_batch(bool debug = false)
+{
+  vectorstr script;
+  script.push_back("make table batchbench fields name, dept, salary");
+  for (int i = 0; i < BENCH_INSERTS; i++)
+    script.push_back("insert into batchbench values " + to_string(i) + ", " + string(1, 'a' + i % 10) + ", " + to_string(i * 7 % 1000));
+  script.push_back("select name from batchbench where dept = d and salary < 500");
+  write_script(script);
+  vectorlong want;
+  for (int transaction = 0; transaction < 2; transaction++)
+  {
+    SQL sql;
+    sql.command("drop table batchbench");
+    double ms = run_batch(sql, transaction);
+    vectorlong got = selected(sql, "select name from batchbench where dept = d and salary < 500");
+    cout << (transaction ? "batch transaction: " : "batch:             ") << script.size() << " statements in "
+         << fixed << setprecision(1) << ms << " ms, " << setprecision(0) << script.size() * 1000 / ms << " statements/s\n";
+    if (got.empty() || got[0] == -1 || (transaction && got != want))
+      return false;
+    want = got;
+  }
+  return true;
+}
+
+// ==============================
+// global BAD!
+bool debug = false;
+// ==============================
+
+TEST(BATCH, Commit) {
+  EXPECT_EQ(test_batch_commit(debug), true);
+}
+
+TEST(BATCH, Rollback) {
+  EXPECT_EQ(test_batch_rollback(debug), true);
+}
+
+TEST(BATCH, TransactionValue) {
+  EXPECT_EQ(test_transaction_value(debug), true);
+}
+
+TEST(BATCH, BenchBatch) {
+  EXPECT_EQ(bench_batch(debug), true);
+}
+
+int main(int argc, char **argv) {
+  if (argc > 1)
+  {
+    debug = !strcmp(argv[1], "debug");
+  }
+
+  ::testing::InitGoogleTest(&argc, argv);
+  std::cout<<"\n\n----------running batch_bench.cpp---------\n\n"<<std::endl;
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,268 @@
+#include "gtest/gtest.h"
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include "random"
+#include "../../includes/sql/sql.h"
+using namespace std;
+
+//insert_many: rows inserted a batch at a time, with their keys added to each index in one sorted
+//pass, make the table insert_into makes row by row: the same records, valid indexes holding the
+//same keys and recnos, and the same selects, reopened from its file too; so does load_file,
+//parsing a csv's chunks side by side and adding their keys a run at a time
+
+const vectorstr BULK_FIELDS = {"name", "bucket", "code"};
+//batch sizes taken in turn, one row to a few leaves' worth
+const int BULK_BATCHES[] = {1, 3, 64, 250, 17, 400};
+
+void remove_table(const string& name)
+{
+  remove((name + "_fields.txt").c_str());
+  remove((name + "_fields.bin").c_str());
+}
+
+//letters only, in the order of n
+string letters(int n, int width)
+{
+  string text(width, 'a');
+  for (int i = width - 1; i >= 0; i--, n /= 26)
+    text[i] += n % 26;
+  return text;
+}
+
+//a few names repeated many times, within a batch and across batches, then runs of names new
+//to the index that sort next to each other, between, below and above the names already there,
+//so a run fills and splits the same leaves
+vector<vectorstr> make_rows()
+{
+  mt19937 random(43);
+  vector<vectorstr> rows;
+  for (int r = 0; r < 600; r++)
+    rows.push_back({"m" + letters(random() % 6, 1), to_string(random() % 30), r % 7 ? letters(random() % 500, 2) : "same"});
+  const string prefixes[] = {"mc", "a", "z", "mc"};
+  for (int run = 0; run < 4; run++)
+  {
+    //the last run goes in descending, between the keys of the first
+    for (int i = 0; i < 700; i++)
+    {
+      int n = run == 3 ? 2 * (700 - i) - 1 : 2 * i;
+      rows.push_back({prefixes[run] + letters(n, 3), to_string(i % 30), letters(i, 2)});
+    }
+  }
+  return rows;
+}
+
+vector<vectorstr> records(Table& table)
+{
+  vector<vectorstr> rows;
+  fstream f;
+  table.open_records(f);
+  for (long r = 0; r < table.record_count(); r++)
+    rows.push_back(table.read_record(f, r));
+  f.close();
+  return rows;
+}
+
+//every index valid and holding the keys and recnos, in order, of the same index of expected
+bool same_indexes(Table& table, Table& expected, bool debug)
+{
+  for (int field = 0; field < BULK_FIELDS.size(); field++)
+  {
+    mmap_sl& index = table.field_index(field);
+    mmap_sl& want = expected.field_index(field);
+    if (!index.is_valid() || !want.is_valid())
+    {
+      if (debug)
+        cout << BULK_FIELDS[field] << " index is not valid\n";
+      return false;
+    }
+    mmap_sl::Iterator it = index.begin();
+    mmap_sl::Iterator want_it = want.begin();
+    for (; it != index.end() && want_it != want.end(); ++it, ++want_it)
+      if (it->key != want_it->key || it->value_list != want_it->value_list)
+      {
+        if (debug)
+          cout << BULK_FIELDS[field] << " index differs at " << it->key << "\n";
+        return false;
+      }
+    if (it != index.end() || want_it != want.end())
+      return false;
+  }
+  return true;
+}
+
+bool same_selects(Table& table, Table& expected)
+{
+  const vectorstr conditions[] = {
+    {"name", "=", "ma"},
+    {"name", ">=", "mc"},
+    {"name", "<", "b"},
+    {"name", ">", "mcaaz", "and", "name", "<", "mcabz"},
+    {"bucket", "=", "7", "or", "code", "=", "same"},
+    {"not", "name", "=", "mb", "and", "bucket", "<", "3"},
+    {"code", "!=", "same", "and", "name", ">", "z"}
+  };
+  for (int i = 0; i < sizeof(conditions) / sizeof(conditions[0]); i++)
+  {
+    vectorlong got = table.where_recnos(conditions[i]);
+    vectorlong want = expected.where_recnos(conditions[i]);
+    sort(got.begin(), got.end());
+    sort(want.begin(), want.end());
+    if (got != want || want.empty())
+      return false;
+  }
+  return true;
+}
+
+bool test_insert_many_matches_insert_into(bool debug = false)
+{
+  vector<vectorstr> rows = make_rows();
+  remove_table("bulkone");
+  remove_table("bulkmany");
+  Table one("bulkone", BULK_FIELDS);
+  Table many("bulkmany", BULK_FIELDS);
+  for (int r = 0; r < rows.size(); r++)
+    one.insert_into(rows[r]);
+  for (int first = 0, b = 0; first < rows.size(); b++)
+  {
+    int size = BULK_BATCHES[b % (sizeof(BULK_BATCHES) / sizeof(BULK_BATCHES[0]))];
+    int last = min<int>(first + size, rows.size());
+    many.insert_many(vector<vectorstr>(rows.begin() + first, rows.begin() + last));
+    first = last;
+  }
+  if (debug)
+    cout << rows.size() << " rows, " << many.field_index(0).size() << " name index keys\n";
+  if (many.record_count() != rows.size() || records(many) != rows || records(one) != rows)
+    return false;
+  if (!same_indexes(many, one, debug) || !same_selects(many, one))
+    return false;
+  //the file insert_many wrote reads back into the same table
+  Table reopened("bulkmany");
+  bool ok = records(reopened) == rows && same_indexes(reopened, one, debug) && same_selects(reopened, one);
+  remove_table("bulkone");
+  remove_table("bulkmany");
+  return ok;
+}
+
+bool test_deferred_insert_many(bool debug = false)
+{
+  //a batch transaction defers the indexes, inserts of both kinds collect their keys and ending
+  //the deferral adds them all in one flush
+  vector<vectorstr> rows = make_rows();
+  remove_table("bulkone");
+  remove_table("bulkdeferred");
+  Table one("bulkone", BULK_FIELDS);
+  Table deferred("bulkdeferred", BULK_FIELDS);
+  for (int r = 0; r < rows.size(); r++)
+    one.insert_into(rows[r]);
+  //half the rows go in before the indexes are deferred, the rest one at a time and in batches
+  int half = rows.size() / 2;
+  deferred.insert_many(vector<vectorstr>(rows.begin(), rows.begin() + half));
+  deferred.defer_index(true);
+  for (int r = half; r < rows.size(); )
+  {
+    if (r % 3)
+      deferred.insert_into(rows[r++]);
+    else
+    {
+      int last = min<int>(r + 90, rows.size());
+      deferred.insert_many(vector<vectorstr>(rows.begin() + r, rows.begin() + last));
+      r = last;
+    }
+  }
+  deferred.defer_index(false);
+  bool ok = records(deferred) == rows && same_indexes(deferred, one, debug) && same_selects(deferred, one);
+  remove_table("bulkone");
+  remove_table("bulkdeferred");
+  return ok;
+}
+
+//the rows as a csv under a header, quoting some values, one with the delimiter and one with a
+//doubled quote inside, and with blank lines and windows line ends here and there
+void write_csv(const string& path, vector<vectorstr>& rows)
+{
+  ofstream f(path.c_str(), ios::binary);
+  f << "name,bucket,code\n";
+  for (int r = 0; r < rows.size(); r++)
+  {
+    if (r % 1000 == 999)
+      rows[r][2] = "a, \"b\"";
+    for (int field = 0; field < rows[r].size(); field++)
+    {
+      string value = rows[r][field];
+      if (field == 2 && r % 1000 == 999)
+        value = "\"a, \"\"b\"\"\"";
+      else if (r % 5 == field)
+        value = "\"" + value + "\"";
+      f << (field ? "," : "") << value;
+    }
+    f << (r % 7 ? "\n" : "\r\n");
+    if (r % 4001 == 0)
+      f << "\n";
+  }
+}
+
+bool test_load_file_matches_insert_into(bool debug = false)
+{
+  //rows enough for a few dozen chunks and for their keys to go to the indexes more than once
+  vector<vectorstr> some = make_rows();
+  vector<vectorstr> rows;
+  while (rows.size() < 2 * LOAD_INDEX_ROWS)
+    rows.insert(rows.end(), some.begin(), some.end());
+  write_csv("bulkload.csv", rows);
+  //a row inserted before the load, the loaded rows come after it
+  remove_table("bulkone");
+  remove_table("bulkloaded");
+  Table one("bulkone", BULK_FIELDS);
+  one.insert_into(rows[0]);
+  for (int r = 0; r < rows.size(); r++)
+    one.insert_into(rows[r]);
+  Table loaded("bulkloaded", BULK_FIELDS);
+  loaded.insert_into(rows[0]);
+  int threads = Table::load_threads;
+  Table::load_threads = 3;
+  long count = loaded.load_file("bulkload.csv");
+  Table::load_threads = threads;
+  if (debug)
+    cout << count << " rows loaded, " << loaded.field_index(0).size() << " name index keys\n";
+  bool ok = count == rows.size() && records(loaded) == records(one);
+  ok = ok && same_indexes(loaded, one, debug) && same_selects(loaded, one);
+  //the file load_file wrote reads back into the same table
+  Table reopened("bulkloaded");
+  ok = ok && records(reopened) == records(one) && same_indexes(reopened, one, debug) && same_selects(reopened, one);
+  remove("bulkload.csv");
+  remove_table("bulkone");
+  remove_table("bulkloaded");
+  return ok;
+}
+
+// ==============================
+// global BAD!
+bool debug = false;
+// ==============================
+
+TEST(BULK_INSERT, InsertManyMatchesInsertInto) {
+  EXPECT_EQ(test_insert_many_matches_insert_into(debug), true);
+}
+
+TEST(BULK_INSERT, DeferredInsertMany) {
+  EXPECT_EQ(test_deferred_insert_many(debug), true);
+}
+
+TEST(BULK_INSERT, LoadFileMatchesInsertInto) {
+  EXPECT_EQ(test_load_file_matches_insert_into(debug), true);
+}
+
+int main(int argc, char **argv) {
+  if (argc > 1)
+  {
+    debug = !strcmp(argv[1], "debug");
+  }
+
+  ::testing::InitGoogleTest(&argc, argv);
+  std::cout<<"\n\n----------running bulk_insert_test.cpp---------\n\n"<<std::endl;
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,206 @@
+#include "gtest/gtest.h"
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <algorithm>
+#include <cstring>
+#include "../../includes/sql/sql.h"
+using namespace std;
+
+//explain: a plain explain plans a select without running any of it, a join included, and
+//explain analyze runs the select once, through the same steps, giving the rows the select gives
+
+//the lines of an explain's plan, without the padding that lines them up
+vectorstr plan_lines(Table& plan)
+{
+  vectorstr lines;
+  fstream f;
+  plan.open_records(f);
+  for (long r = 0; r < plan.record_count(); r++)
+  {
+    string line = plan.read_record(f, r)[0];
+    line.erase(line.find_last_not_of(' ') + 1);
+    lines.push_back(line);
+  }
+  f.close();
+  return lines;
+}
+
+bool has_line(const vectorstr& lines, const string& line)
+{
+  return find(lines.begin(), lines.end(), line) != lines.end();
+}
+
+void make_tables(SQL& sql)
+{
+  sql.command("drop table explainemp");
+  sql.command("drop table explaindept");
+  sql.command("make table explainemp fields name, dept, salary, year");
+  sql.command("insert into explainemp values (Ann, eng, 150000, 2018), (Bob, ops, 90000, 2018), (Cat, eng, 160000, 2019),"
+              " (Dan, hr, 70000, 2017), (Eve, eng, 155000, 2018), (Fay, ops, 95000, 2019)", false);
+  sql.command("make table explaindept fields dname, floor");
+  sql.command("insert into explaindept values (eng, 3), (ops, 1), (hr, 2)", false);
+}
+
+//the condition on the employees is estimated as if its comparisons were independent, which
+//they are not, so an estimate is told apart from a count
+const string EMP_CONDITION = "salary >= 150000 and year = 2018";
+
+bool test_plain_explain_runs_nothing(bool debug = false)
+{
+  SQL sql;
+  make_tables(sql);
+  Table emp("explainemp");
+  PredicatePlan plan = emp.compile_condition({"salary", ">=", "150000", "and", "year", "=", "2018"});
+  string estimate = ExplainOutput::rows_text(emp.estimate_where_rows(plan).back());
+  string count = to_string(emp.where_recnos(plan).size());
+  if (estimate == count)
+    return false;
+
+  const string join = "select name, floor from explainemp join explaindept on dept = dname where " + EMP_CONDITION;
+  //a plain explain makes the plan's table and no other, and shows estimates only
+  int serial = Table::serial;
+  Table planned = sql.command("explain " + join);
+  vectorstr lines = plan_lines(planned);
+  if (debug)
+    for (int i = 0; i < lines.size(); i++)
+      cout << lines[i] << "\n";
+  if (sql.errorState() || Table::serial != serial + 1)
+    return false;
+  for (int i = 0; i < lines.size(); i++)
+    if (lines[i].find("actual:") != string::npos)
+      return false;
+  if (!has_line(lines, "    outer explainemp: est " + estimate + " of 6 records pass its own conditions"))
+    return false;
+  //explain analyze selects the records the plain explain only estimated
+  Table analyzed = sql.command("explain analyze " + join);
+  if (!has_line(plan_lines(analyzed), "    outer explainemp: " + count + " of 6 records pass its own conditions"))
+    return false;
+
+  //a planned join cursor picks its method on the estimates and gives no rows
+  Table dept("explaindept");
+  vectorstr condition = {"explainemp.dept", "=", "explaindept.dname", "and", "salary", ">=", "150000", "and", "year", "=", "2018"};
+  JoinCursor cursor(emp, "explainemp", dept, "explaindept", condition, {"name", "floor"}, true);
+  vectorstr row;
+  if (cursor.next(row) || ExplainOutput::rows_text(cursor.side_rows(0)) != estimate || cursor.side_rows(1) != 3)
+    return false;
+  JoinCursor selected(emp, "explainemp", dept, "explaindept", condition, {"name", "floor"});
+  if (to_string((long)selected.side_rows(0)) != count || !selected.next(row))
+    return false;
+
+  //and the one table pipeline plans each step without running it
+  serial = Table::serial;
+  Table one = sql.command("explain select name from explainemp where " + EMP_CONDITION + " order by name limit 1");
+  lines = plan_lines(one);
+  if (debug)
+    for (int i = 0; i < lines.size(); i++)
+      cout << lines[i] << "\n";
+  bool ok = !sql.errorState() && Table::serial == serial + 1 && has_line(lines, "  page: limit 1, est 1 rows");
+  for (int i = 0; i < lines.size(); i++)
+    ok = ok && lines[i].find("actual:") == string::npos;
+  return ok;
+}
+
+bool test_analyze_runs_the_select(bool debug = false)
+{
+  SQL sql;
+  make_tables(sql);
+  const string selects[] = {
+    "select * from explainemp",
+    "select name from explainemp where " + EMP_CONDITION,
+    "select name, salary from explainemp where not dept = hr or year = 2018 order by salary desc limit 2",
+    "select * from explainemp limit 2 offset 1",
+    "select dept, count(*) from explainemp group by dept order by dept desc limit 2",
+    "select count(*), max(salary) from explainemp where year = 2018",
+    "select name, floor from explainemp join explaindept on dept = dname where salary > 100000",
+    "select name, floor from explainemp, explaindept where dept = dname order by name desc limit 2 offset 1"
+  };
+  for (int i = 0; i < sizeof(selects) / sizeof(selects[0]); i++)
+  {
+    Table result = sql.command(selects[i]);
+    //the select's result and the plan's table, the select ran once
+    int serial = Table::serial;
+    Table analyzed = sql.command("explain analyze " + selects[i]);
+    vectorstr lines = plan_lines(analyzed);
+    string actual = "  actual: " + to_string(result.record_count()) + " rows, ";
+    if (debug)
+      cout << selects[i] << ": " << lines[1] << "\n";
+    if (sql.errorState() || Table::serial != serial + 2 || lines.size() < 2 || lines[1].compare(0, actual.size(), actual))
+      return false;
+    //and every step of the plain explain is a step explain analyze ran
+    Table planned = sql.command("explain " + selects[i]);
+    vectorstr steps = plan_lines(planned);
+    for (int s = 0; s < steps.size(); s++)
+    {
+      //a step is named before its first colon or comma, the figures after it may differ
+      string step = steps[s].substr(0, steps[s].find_first_of(":,"));
+      bool found = false;
+      for (int l = 0; l < lines.size() && !found; l++)
+        found = lines[l].compare(0, step.size(), step) == 0;
+      if (!found)
+      {
+        if (debug)
+          cout << "not run: " << steps[s] << "\n";
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+bool test_explain_errors(bool debug = false)
+{
+  //a plain explain reports what the select would
+  SQL sql;
+  make_tables(sql);
+  const string bad[] = {
+    "explain select * from explainemp where bogus = 1",
+    "explain select * from explainemp order by bogus",
+    "explain select bogus from explainemp",
+    "explain select name from explainemp, explaindept where dept = dname order by bogus",
+    "explain select bogus from explainemp, explaindept where dept = dname",
+    "explain select * from explainnone"
+  };
+  ostringstream silenced;
+  streambuf* cout_buffer = cout.rdbuf(silenced.rdbuf());
+  bool ok = true;
+  for (int i = 0; i < sizeof(bad) / sizeof(bad[0]); i++)
+  {
+    sql.command(bad[i]);
+    ok = ok && sql.errorState();
+  }
+  cout.rdbuf(cout_buffer);
+  if (debug)
+    cout << silenced.str();
+  sql.command("drop table explainemp");
+  sql.command("drop table explaindept");
+  return ok;
+}
+
+// ==============================
+// global BAD!
+bool debug = false;
+// ==============================
+
+TEST(EXPLAIN, PlainExplainRunsNothing) {
+  EXPECT_EQ(test_plain_explain_runs_nothing(debug), true);
+}
+
+TEST(EXPLAIN, AnalyzeRunsTheSelect) {
+  EXPECT_EQ(test_analyze_runs_the_select(debug), true);
+}
+
+TEST(EXPLAIN, ExplainErrors) {
+  EXPECT_EQ(test_explain_errors(debug), true);
+}
+
+int main(int argc, char **argv) {
+  if (argc > 1)
+  {
+    debug = !strcmp(argv[1], "debug");
+  }
+
+  ::testing::InitGoogleTest(&argc, argv);
+  std::cout<<"\n\n----------running explain_test.cpp---------\n\n"<<std::endl;
+  return RUN_ALL_TESTS();
+}
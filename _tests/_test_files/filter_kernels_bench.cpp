@@ -0,0 +1,183 @@
+#include "gtest/gtest.h"
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include "random"
+#include "../../includes/FilterKernels/filter_kernels.h"
+#include "../../includes/BatchFilter/batch_filter.h"
+#include "../../includes/sql/sql.h"
+using namespace std;
+
+//microbenchmarks of the batch filter kernels: every simd level has to give the scalar kernel's
+//masks, and the timings print how much faster it gives them
+
+const int BENCH_ROWS = SCAN_MORSEL_RECORDS;
+const int BENCH_REPEATS = 2000;
+
+double elapsed_ns(chrono::steady_clock::time_point start)
+{
+  return chrono::duration<double, nano>(chrono::steady_clock::now() - start).count();
+}
+
+vector<uint64_t> random_keys(int count, mt19937_64& random)
+{
+  //a few distinct high bytes so every comparison selects a fair share of the rows
+  vector<uint64_t> keys(count);
+  for (int i = 0; i < count; i++)
+    keys[i] = (random() % 16) << 56 | random() % 1000;
+  return keys;
+}
+
+bool test_kernels_agree(bool debug = false)
+{
+  mt19937_64 random(37);
+  for (int count = 0; count < 300; count += 7)
+  {
+    vector<uint64_t> keys = random_keys(count + 1, random);
+    for (int op = PLAN_EQ; op <= PLAN_NE; op++)
+    {
+      vector<mask_word> want(mask_words(count) + 1, 0);
+      compare_keys(op, &keys[0], count, keys[count], &want[0], SIMD_SCALAR);
+      for (int level = SIMD_SSE4; level <= simd_level(); level++)
+      {
+        vector<mask_word> got(mask_words(count) + 1, 0);
+        compare_keys(op, &keys[0], count, keys[count], &got[0], level);
+        if (got != want)
+        {
+          cout << simd_level_name(level) << " disagrees on op " << op << " over " << count << " rows\n";
+          return false;
+        }
+      }
+    }
+  }
+  if (debug)
+    cout << "kernels agree up to " << simd_level_name(simd_level()) << "\n";
+  return true;
+}
+
+bool bench_compare_keys(bool debug = false)
+{
+  mt19937_64 random(37);
+  vector<uint64_t> keys = random_keys(BENCH_ROWS, random);
+  vector<mask_word> want(mask_words(BENCH_ROWS));
+  compare_keys(PLAN_GE, &keys[0], BENCH_ROWS, uint64_t(8) << 56, &want[0], SIMD_SCALAR);
+  for (int level = SIMD_SCALAR; level <= simd_level(); level++)
+  {
+    vector<mask_word> mask(mask_words(BENCH_ROWS));
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    for (int i = 0; i < BENCH_REPEATS; i++)
+      compare_keys(PLAN_GE, &keys[0], BENCH_ROWS, uint64_t(8) << 56, &mask[0], level);
+    double per_row = elapsed_ns(start) / BENCH_REPEATS / BENCH_ROWS;
+    cout << "compare_keys " << setw(6) << simd_level_name(level) << ": " << fixed << setprecision(3) << per_row << " ns/row\n";
+    if (mask != want)
+      return false;
+  }
+  return true;
+}
+
+bool bench_mask_and(bool debug = false)
+{
+  mt19937_64 random(37);
+  vector<mask_word> lhs(mask_words(BENCH_ROWS));
+  vector<mask_word> rhs(mask_words(BENCH_ROWS));
+  for (int i = 0; i < lhs.size(); i++)
+  {
+    lhs[i] = random();
+    rhs[i] = random();
+  }
+  for (int level = SIMD_SCALAR; level <= simd_level(); level++)
+  {
+    vector<mask_word> mask = lhs;
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    for (int i = 0; i < BENCH_REPEATS; i++)
+      mask_and(&mask[0], &rhs[0], mask.size(), level);
+    double per_row = elapsed_ns(start) / BENCH_REPEATS / BENCH_ROWS;
+    cout << "mask_and     " << setw(6) << simd_level_name(level) << ": " << fixed << setprecision(3) << per_row << " ns/row\n";
+    for (int i = 0; i < mask.size(); i++)
+    {
+      if (mask[i] != (lhs[i] & rhs[i]))
+        return false;
+    }
+  }
+  return true;
+}
+
+bool bench_batch_filter(bool debug = false)
+{
+  //salary >= 150000 and year = 2018 over one morsel, a record at a time and as a batch
+  mt19937_64 random(37);
+  Table employees("bench_filter_kernels", {"salary", "year"});
+  for (int i = 0; i < BENCH_ROWS; i++)
+    employees.insert_into({to_string(100000 + random() % 100000), to_string(2010 + random() % 10)});
+  vectorstr condition = {"salary", ">=", "150000", "and", "year", "=", "2018"};
+  PredicatePlan plan = employees.compile_condition(condition);
+  fstream f;
+  open_fileRW(f, "bench_filter_kernels_fields.bin");
+  const int repeats = 20;
+
+  vectorlong want;
+  FileRecord r;
+  chrono::steady_clock::time_point start = chrono::steady_clock::now();
+  for (int i = 0; i < repeats; i++)
+  {
+    want.clear();
+    for (long recno = 0; recno < BENCH_ROWS; recno++)
+    {
+      r.read(f, recno);
+      if (plan.matches(r._record))
+        want.push_back(recno);
+    }
+  }
+  cout << "row at a time       : " << fixed << setprecision(3) << elapsed_ns(start) / repeats / BENCH_ROWS << " ns/row\n";
+
+  for (int level = SIMD_SCALAR; level <= simd_level(); level++)
+  {
+    BatchFilter batch_filter(plan, level);
+    ColumnBatch batch(batch_filter.fields());
+    vectorlong got;
+    start = chrono::steady_clock::now();
+    for (int i = 0; i < repeats; i++)
+    {
+      got.clear();
+      batch.load(f, 0, BENCH_ROWS);
+      append_selected(batch_filter.filter(batch), batch.rows(), 0, got);
+    }
+    cout << "batch " << setw(6) << simd_level_name(level) << "       : " << fixed << setprecision(3) << elapsed_ns(start) / repeats / BENCH_ROWS << " ns/row\n";
+    if (got != want)
+      return false;
+  }
+  f.close();
+  return true;
+}
+
+// ==============================
+// global BAD!
+bool debug = false;
+// ==============================
+
+TEST(FILTER_KERNELS, KernelsAgree) {
+  EXPECT_EQ(test_kernels_agree(debug), true);
+}
+
+TEST(FILTER_KERNELS, BenchCompareKeys) {
+  EXPECT_EQ(bench_compare_keys(debug), true);
+}
+
+TEST(FILTER_KERNELS, BenchMaskAnd) {
+  EXPECT_EQ(bench_mask_and(debug), true);
+}
+
+TEST(FILTER_KERNELS, BenchBatchFilter) {
+  EXPECT_EQ(bench_batch_filter(debug), true);
+}
+
+int main(int argc, char **argv) {
+  if (argc > 1)
+  {
+    debug = !strcmp(argv[1], "debug");
+  }
+
+  ::testing::InitGoogleTest(&argc, argv);
+  std::cout<<"\n\n----------running filter_kernels_bench.cpp---------\n\n"<<std::endl;
+  return RUN_ALL_TESTS();
+}
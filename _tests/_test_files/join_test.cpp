@@ -0,0 +1,295 @@
+#include "gtest/gtest.h"
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include "random"
+#include "../../includes/sql/sql.h"
+using namespace std;
+
+//joins: the index nested-loop join and the hash join give the rows a nested loop over both
+//tables in memory gives, in the same order, with fields named plainly or as table.field
+
+const int JOIN_ORDERS = 2000;
+const int JOIN_CUSTOMERS = 300;
+
+vector<vectorstr> rows_of(Table& result)
+{
+  vector<vectorstr> rows;
+  fstream f;
+  result.open_records(f);
+  for (long r = 0; r < result.record_count(); r++)
+    rows.push_back(result.read_record(f, r));
+  f.close();
+  return rows;
+}
+
+//orders: customer, item, qty    customers: cname, city, tier
+//every customer name is unique, an order's customer may have no customer row
+struct JoinData
+{
+  vector<vectorstr> orders;
+  vector<vectorstr> customers;
+};
+
+//customer names are letters only, a value like c12 would be read as two values
+string customer_name(int customer)
+{
+  string name = "c";
+  for (; customer; customer /= 26)
+    name += char('a' + customer % 26);
+  return name;
+}
+
+JoinData make_tables(SQL& sql)
+{
+  mt19937 random(34);
+  JoinData data;
+  const vectorstr cities = {"Austin", "Boston", "Chicago", "Denver"};
+  const vectorstr tiers = {"gold", "silver", "bronze"};
+  const vectorstr items = {"pen", "ink", "pad", "cap"};
+  sql.command("drop table joinorders");
+  sql.command("drop table joincust");
+  sql.command("make table joinorders fields customer, item, qty");
+  sql.command("make table joincust fields cname, city, tier");
+  for (int c = 0; c < JOIN_CUSTOMERS; c++)
+    data.customers.push_back({customer_name(c), cities[random() % cities.size()], tiers[random() % tiers.size()]});
+  //a third of the orders go to a few busy customers, some to customers who do not exist
+  for (int o = 0; o < JOIN_ORDERS; o++)
+  {
+    int customer = o % 3 ? random() % (JOIN_CUSTOMERS + 20) : random() % 4;
+    data.orders.push_back({customer_name(customer), items[random() % items.size()], to_string(1 + random() % 9)});
+  }
+  //a hundred rows to an insert
+  const vector<vectorstr>* tables[2] = {&data.orders, &data.customers};
+  const string names[2] = {"joinorders", "joincust"};
+  for (int t = 0; t < 2; t++)
+  {
+    const vector<vectorstr>& rows = *tables[t];
+    for (int first = 0; first < rows.size(); first += 100)
+    {
+      string insert = "insert into " + names[t] + " values ";
+      for (int r = first; r < rows.size() && r < first + 100; r++)
+        insert += string(r > first ? ", " : "") + "(" + rows[r][0] + ", " + rows[r][1] + ", " + rows[r][2] + ")";
+      sql.command(insert, false);
+    }
+  }
+  return data;
+}
+
+//what a nested loop over both tables selects, left rows in order and right rows in order for each
+vector<vectorstr> nested_loop(const JoinData& data, function<bool(const vectorstr&, const vectorstr&)> keep,
+                              function<vectorstr(const vectorstr&, const vectorstr&)> project)
+{
+  vector<vectorstr> rows;
+  for (int o = 0; o < data.orders.size(); o++)
+    for (int c = 0; c < data.customers.size(); c++)
+      if (keep(data.orders[o], data.customers[c]))
+        rows.push_back(project(data.orders[o], data.customers[c]));
+  return rows;
+}
+
+int join_method(const string& condition, const vectorstr& columns)
+{
+  Table orders("joinorders");
+  Table customers("joincust");
+  istringstream in(condition);
+  vectorstr tokens;
+  string token;
+  while (in >> token)
+    tokens.push_back(token);
+  JoinCursor cursor(orders, "joinorders", customers, "joincust", tokens, columns);
+  return cursor.method();
+}
+
+vectorstr item_city(const vectorstr& order, const vectorstr& customer)
+{
+  return {order[1], customer[1]};
+}
+
+bool test_join_methods(bool debug = false)
+{
+  SQL sql;
+  JoinData data = make_tables(sql);
+  struct JoinCase
+  {
+    string condition;
+    int method;
+    function<bool(const vectorstr&, const vectorstr&)> keep;
+  };
+  const JoinCase cases[] = {
+    //a few orders probe the customers' index, each key holds one customer
+    {"joinorders.customer = joincust.cname and joinorders.qty = 7 and joinorders.item = pen", INDEX_NESTED_LOOP_JOIN,
+     [](const vectorstr& o, const vectorstr& c) {return o[0] == c[0] && o[2] == "7" && o[1] == "pen";}},
+    //every order against a few customers is cheaper with those customers in a hash table
+    {"joinorders.customer = joincust.cname and joincust.tier = gold and joincust.city = Boston", HASH_JOIN,
+     [](const vectorstr& o, const vectorstr& c) {return o[0] == c[0] && c[2] == "gold" && c[1] == "Boston";}},
+    //the key written the other way round, an or within one side
+    {"joincust.cname = joinorders.customer and ( joinorders.item = ink or joinorders.qty = 3 )", -1,
+     [](const vectorstr& o, const vectorstr& c) {return o[0] == c[0] && (o[1] == "ink" || o[2] == "3");}},
+    {"joinorders.customer = joincust.cname and not joincust.tier = bronze and joinorders.qty > 5", -1,
+     [](const vectorstr& o, const vectorstr& c) {return o[0] == c[0] && c[2] != "bronze" && strcmp(o[2].c_str(), "5") > 0;}}
+  };
+  set<int> methods;
+  for (int i = 0; i < sizeof(cases) / sizeof(cases[0]); i++)
+  {
+    int method = join_method(cases[i].condition, {"item", "city"});
+    methods.insert(method);
+    if (cases[i].method >= 0 && method != cases[i].method)
+      return false;
+    vector<vectorstr> want = nested_loop(data, cases[i].keep, item_city);
+    Table result = sql.command("select item, city from joinorders, joincust where " + cases[i].condition, false);
+    vector<vectorstr> got = rows_of(result);
+    if (debug)
+      cout << JoinCursor::method_name(method) << ": " << got.size() << " rows, wanted " << want.size() << "\n";
+    if (sql.errorState() || got != want)
+      return false;
+    //the same condition split into on and where
+    size_t split = cases[i].condition.find(" and ");
+    Table on_result = sql.command("select item, city from joinorders join joincust on " + cases[i].condition.substr(0, split)
+                                  + " where " + cases[i].condition.substr(split + 5), false);
+    if (sql.errorState() || rows_of(on_result) != want)
+      return false;
+  }
+  return methods.count(INDEX_NESTED_LOOP_JOIN) && methods.count(HASH_JOIN);
+}
+
+bool test_join_pages(bool debug = false)
+{
+  SQL sql;
+  JoinData data = make_tables(sql);
+  auto keep = [](const vectorstr& o, const vectorstr& c) {return o[0] == c[0] && c[1] != "Austin";};
+  auto project = [](const vectorstr& o, const vectorstr& c) {return vectorstr({o[0], o[2], c[2]});};
+  vector<vectorstr> joined = nested_loop(data, keep, project);
+  const string select = "select customer, qty, tier from joinorders join joincust on customer = cname where city != Austin";
+  //more rows than one result batch, unordered and ordered, paged
+  const long pages[][2] = {{-1, 0}, {10, 0}, {25, 1300}, {5000, 3}, {0, 0}};
+  //unordered, then on a selected column and on one that is not
+  const string orders[] = {"", " order by tier desc", " order by city"};
+  for (int o = 0; o < 3; o++)
+  {
+    //each row carries its city at the end while it is ordered
+    vector<vectorstr> ordered;
+    for (int l = 0; l < data.orders.size(); l++)
+      for (int r = 0; r < data.customers.size(); r++)
+        if (keep(data.orders[l], data.customers[r]))
+        {
+          ordered.push_back(project(data.orders[l], data.customers[r]));
+          ordered.back().push_back(data.customers[r][1]);
+        }
+    if (o == 1)
+      stable_sort(ordered.begin(), ordered.end(), [](const vectorstr& lhs, const vectorstr& rhs) {return rhs[2] < lhs[2];});
+    if (o == 2)
+      stable_sort(ordered.begin(), ordered.end(), [](const vectorstr& lhs, const vectorstr& rhs) {return lhs[3] < rhs[3];});
+    for (int i = 0; i < ordered.size(); i++)
+      ordered[i].pop_back();
+    const string& order = orders[o];
+    for (int p = 0; p < sizeof(pages) / sizeof(pages[0]); p++)
+    {
+      long limit = pages[p][0];
+      long offset = pages[p][1];
+      string command = select + order + (limit >= 0 ? " limit " + to_string(limit) : "") + (offset ? " offset " + to_string(offset) : "");
+      vector<vectorstr> want(ordered.begin() + min<long>(offset, ordered.size()), ordered.end());
+      if (limit >= 0 && want.size() > limit)
+        want.resize(limit);
+      Table result = sql.command(command, false);
+      vector<vectorstr> got = rows_of(result);
+      if (debug)
+        cout << command << ": " << got.size() << " rows\n";
+      if (sql.errorState() || got != want)
+        return false;
+    }
+  }
+  return joined.size() > JOIN_RESULT_BATCH;
+}
+
+bool test_qualified_fields(bool debug = false)
+{
+  SQL sql;
+  JoinData data = make_tables(sql);
+  sql.command("drop table joinother");
+  sql.command("make table joinother fields cname, item");
+  sql.command("insert into joinother values " + data.customers[1][0] + ", pen");
+  sql.command("insert into joinother values " + data.customers[2][0] + ", cap");
+  //qualified and plain names for the same fields select the same rows
+  auto keep = [](const vectorstr& o, const vectorstr& c) {return o[0] == c[0] && c[2] == "gold" && o[1] == "pad";};
+  vector<vectorstr> want = nested_loop(data, keep, [](const vectorstr& o, const vectorstr& c) {return vectorstr({o[0], c[1], o[2]});});
+  const string selects[] = {
+    "select joinorders.customer, joincust.city, joinorders.qty from joinorders, joincust where joinorders.customer = joincust.cname and joincust.tier = gold and joinorders.item = pad",
+    "select customer, city, qty from joinorders, joincust where customer = cname and tier = gold and item = pad",
+    "select customer, joincust.city, qty from joinorders join joincust on joincust.cname = customer where joinorders.item = pad and tier = gold"
+  };
+  for (int i = 0; i < 3; i++)
+  {
+    Table result = sql.command(selects[i], false);
+    if (sql.errorState() || rows_of(result) != want)
+    {
+      if (debug)
+        cout << selects[i] << "\n";
+      return false;
+    }
+  }
+  //select * names every field after its table
+  Table both = sql.command("select * from joinother, joincust where joinother.cname = joincust.cname", false);
+  if (debug)
+    cout << both.get_field_names() << "\n";
+  vectorstr fields = both.get_field_names();
+  if (sql.errorState() || both.record_count() != 2 || fields.size() != 5
+      || find(fields.begin(), fields.end(), "joinother.item") == fields.end())
+    return false;
+  //a field both tables have has to be qualified, and a qualifier has to name one of the tables
+  ostringstream silenced;
+  streambuf* cout_buffer = cout.rdbuf(silenced.rdbuf());
+  const string bad[] = {
+    "select cname from joinother, joincust where joinother.cname = joincust.cname",
+    "select item from joinother, joincust where joinother.cname = joincust.cname and cname = cb",
+    "select joinnope.item from joinother, joincust where joinother.cname = joincust.cname",
+    "select joincust.item from joinother, joincust where joinother.cname = joincust.cname"
+  };
+  bool ok = true;
+  for (int i = 0; i < 4; i++)
+  {
+    sql.command(bad[i]);
+    ok = ok && sql.errorState();
+  }
+  cout.rdbuf(cout_buffer);
+  if (debug)
+    cout << silenced.str();
+  Table one = sql.command("select joinother.item, city from joinother, joincust where joinother.cname = joincust.cname and joinother.cname = " + data.customers[2][0], false);
+  vector<vectorstr> one_rows = rows_of(one);
+  ok = ok && one_rows.size() == 1 && one_rows[0][0] == "cap" && one_rows[0][1] == data.customers[2][1];
+  sql.command("drop table joinother");
+  sql.command("drop table joinorders");
+  sql.command("drop table joincust");
+  return ok;
+}
+
+// ==============================
+// global BAD!
+bool debug = false;
+// ==============================
+
+TEST(JOIN, JoinMethods) {
+  EXPECT_EQ(test_join_methods(debug), true);
+}
+
+TEST(JOIN, JoinPages) {
+  EXPECT_EQ(test_join_pages(debug), true);
+}
+
+TEST(JOIN, QualifiedFields) {
+  EXPECT_EQ(test_qualified_fields(debug), true);
+}
+
+int main(int argc, char **argv) {
+  if (argc > 1)
+  {
+    debug = !strcmp(argv[1], "debug");
+  }
+
+  ::testing::InitGoogleTest(&argc, argv);
+  std::cout<<"\n\n----------running join_test.cpp---------\n\n"<<std::endl;
+  return RUN_ALL_TESTS();
+}
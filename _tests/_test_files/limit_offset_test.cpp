@@ -0,0 +1,211 @@
+#include "gtest/gtest.h"
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <algorithm>
+#include "random"
+#include "../../includes/sql/sql.h"
+using namespace std;
+
+//limit and offset: a page of a select is the same page of the select without them, whether
+//the selection stops early, the index walk stops early or a top-k heap keeps only the page
+
+const int LIMIT_ROWS = 1500;
+
+vector<vectorstr> make_rows(SQL& sql, const string& table)
+{
+  mt19937 random(32);
+  vector<vectorstr> rows(LIMIT_ROWS);
+  sql.command("drop table " + table);
+  sql.command("make table " + table + " fields name, bucket");
+  for (int r = 0; r < LIMIT_ROWS; r++)
+  {
+    string name(2, 'a');
+    name[0] += random() % 5;
+    name[1] += random() % 5;
+    rows[r] = {name, to_string(random() % 40)};
+    sql.command("insert into " + table + " values " + name + ", " + rows[r][1]);
+  }
+  return rows;
+}
+
+vectorlong page(vectorlong recnos, long limit, long offset)
+{
+  recnos.erase(recnos.begin(), recnos.begin() + min<long>(offset, recnos.size()));
+  if (recnos.size() > limit)
+    recnos.resize(limit);
+  return recnos;
+}
+
+vectorlong select_recnos(SQL& sql, const string& command)
+{
+  sql.command(command, false);
+  if (sql.errorState())
+    return vectorlong(1, -1);
+  return sql.selectRecordNos();
+}
+
+string page_clause(long limit, long offset)
+{
+  return " limit " + to_string(limit) + (offset ? " offset " + to_string(offset) : "");
+}
+
+bool test_limit_offset(bool debug = false)
+{
+  SQL sql;
+  vector<vectorstr> rows = make_rows(sql, "limitpage");
+  const long pages[][2] = {{0, 0}, {1, 0}, {10, 0}, {10, 5}, {7, 1493}, {5, 1500}, {3, 4000}, {2000, 0}, {100, 37}};
+  const string conditions[] = {"", " where bucket = 7", " where name >= cc", " where bucket < 2 or name = aa",
+                               " where not bucket = 3"};
+  for (int c = 0; c < 5; c++)
+  {
+    const string select = "select * from limitpage" + conditions[c];
+    vectorlong all = select_recnos(sql, select);
+    vectorlong sorted_all = all;
+    sort(sorted_all.begin(), sorted_all.end());
+    for (int p = 0; p < sizeof(pages) / sizeof(pages[0]); p++)
+    {
+      vectorlong paged = select_recnos(sql, select + page_clause(pages[p][0], pages[p][1]));
+      bool ok = paged.size() == page(all, pages[p][0], pages[p][1]).size();
+      //without an order the rows are those the selection finds first, a single comparison finds
+      //them in index order, and a selection without a condition in record order
+      if (c < 3)
+        ok = ok && paged == page(all, pages[p][0], pages[p][1]);
+      for (int i = 0; i < paged.size() && ok; i++)
+        ok = binary_search(sorted_all.begin(), sorted_all.end(), paged[i])
+             && count(paged.begin(), paged.end(), paged[i]) == 1;
+      if (!ok)
+      {
+        if (debug)
+          cout << select << page_clause(pages[p][0], pages[p][1]) << ": " << paged.size() << " rows\n";
+        return false;
+      }
+    }
+  }
+  sql.command("drop table limitpage");
+  return true;
+}
+
+bool test_ordered_pages(bool debug = false)
+{
+  //a page of an ordered select, by top-k heap for a small selection and by an index walk
+  //that stops at the page's end for a large one
+  SQL sql;
+  vector<vectorstr> rows = make_rows(sql, "limittopk");
+  Table table("limittopk");
+  const long pages[][2] = {{1, 0}, {5, 0}, {5, 5}, {20, 3}, {30, 200}, {0, 0}};
+  const string conditions[] = {" where bucket = 3 or bucket = 9", ""};
+  set<int> methods;
+  for (int c = 0; c < 2; c++)
+  {
+    for (int descending = 0; descending < 2; descending++)
+    {
+      const string select = "select * from limittopk" + conditions[c] + " order by name" + (descending ? " desc" : "");
+      vectorlong ordered = select_recnos(sql, select);
+      for (int p = 0; p < sizeof(pages) / sizeof(pages[0]); p++)
+      {
+        long limit = pages[p][0];
+        long offset = pages[p][1];
+        if (limit)
+          methods.insert(table.order_method(c ? LIMIT_ROWS : ordered.size(), descending, limit + offset));
+        vectorlong paged = select_recnos(sql, select + page_clause(limit, offset));
+        if (paged != page(ordered, limit, offset))
+        {
+          if (debug)
+            cout << select << page_clause(limit, offset) << ": " << paged.size() << " rows\n";
+          return false;
+        }
+      }
+    }
+  }
+  if (debug)
+    cout << methods.size() << " order methods\n";
+  sql.command("drop table limittopk");
+  return methods.count(ORDER_TOP_K) && methods.count(ORDER_INDEX_WALK);
+}
+
+bool test_limit_errors(bool debug = false)
+{
+  SQL sql;
+  sql.command("drop table limitbad");
+  sql.command("make table limitbad fields name");
+  sql.command("insert into limitbad values Ann");
+  const string bad[] = {"select * from limitbad limit", "select * from limitbad limit -1",
+                        "select * from limitbad limit abc", "select * from limitbad limit 1 offset",
+                        "select * from limitbad limit 9999999999", "select * from limitbad limit 2.5"};
+  ostringstream silenced;
+  streambuf* cout_buffer = cout.rdbuf(silenced.rdbuf());
+  bool ok = true;
+  for (int i = 0; i < sizeof(bad) / sizeof(bad[0]); i++)
+  {
+    sql.command(bad[i]);
+    ok = ok && sql.errorState();
+  }
+  cout.rdbuf(cout_buffer);
+  if (debug)
+    cout << silenced.str();
+  //offset alone skips rows without a limit
+  ok = ok && select_recnos(sql, "select * from limitbad offset 1") == vectorlong();
+  ok = ok && select_recnos(sql, "select * from limitbad offset 0") == vectorlong({0});
+  //and a prepared select pages its rows the same way
+  sql.command("insert into limitbad values Bob");
+  sql.command("insert into limitbad values Cid");
+  PreparedStatement select = sql.prepare("select * from limitbad where name > ? order by name desc limit 1 offset 1");
+  select.bind(1, "A");
+  sql.execute(select);
+  ok = ok && !sql.errorState() && sql.selectRecordNos() == vectorlong({1});
+  sql.command("drop table limitbad");
+  return ok;
+}
+
+bool test_limit_values(bool debug = false)
+{
+  //limit and offset are stored as values, and quoted in a condition they are those values,
+  //while the unquoted words after it still page the rows
+  SQL sql;
+  sql.command("drop table limitwords");
+  sql.command("make table limitwords fields word");
+  const string words[] = {"limit", "offset", "\"limit\"", "page", "'offset'"};
+  for (int i = 0; i < sizeof(words) / sizeof(words[0]); i++)
+    sql.command("insert into limitwords values " + words[i]);
+  if (sql.errorState())
+    return false;
+  vectorlong limits = select_recnos(sql, "select * from limitwords where word = \"limit\"");
+  vectorlong offsets = select_recnos(sql, "select * from limitwords where word = 'offset' or word = \"limit\" limit 2 offset 1");
+  if (debug)
+    cout << limits.size() << " limit rows, " << offsets.size() << " paged rows\n";
+  sql.command("drop table limitwords");
+  return limits == vectorlong({0, 2}) && offsets == vectorlong({1, 2});
+}
+
+// ==============================
+// global BAD!
+bool debug = false;
+// ==============================
+
+TEST(LIMIT_OFFSET, LimitOffset) {
+  EXPECT_EQ(test_limit_offset(debug), true);
+}
+
+TEST(LIMIT_OFFSET, OrderedPages) {
+  EXPECT_EQ(test_ordered_pages(debug), true);
+}
+
+TEST(LIMIT_OFFSET, LimitErrors) {
+  EXPECT_EQ(test_limit_errors(debug), true);
+}
+
+TEST(LIMIT_OFFSET, LimitValues) {
+  EXPECT_EQ(test_limit_values(debug), true);
+}
+
+int main(int argc, char **argv) {
+  if (argc > 1)
+  {
+    debug = !strcmp(argv[1], "debug");
+  }
+
+  ::testing::InitGoogleTest(&argc, argv);
+  std::cout<<"\n\n----------running limit_offset_test.cpp---------\n\n"<<std::endl;
+  return RUN_ALL_TESTS();
+}
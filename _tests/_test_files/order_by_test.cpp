@@ -0,0 +1,229 @@
+#include "gtest/gtest.h"
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include "random"
+#include "../../includes/sql/sql.h"
+#include "../../includes/SortingAlgorithms/ExternalSort.h"
+#ifndef _WIN32
+#include <dirent.h>
+#endif
+using namespace std;
+
+//order by: the index walk and the external sort, spilling or not, list the same records, ties in
+//record order both ways, and an external sort leaves no run files behind, under names no other
+//sort shares
+
+const int ORDER_ROWS = 2000;
+
+//files in the current directory whose names contain part
+int files_containing(const string& part)
+{
+  int count = 0;
+#ifndef _WIN32
+  DIR* dir = opendir(".");
+  if (!dir)
+    return -1;
+  for (dirent* entry = readdir(dir); entry; entry = readdir(dir))
+    count += string(entry->d_name).find(part) != string::npos;
+  closedir(dir);
+#endif
+  return count;
+}
+
+//recnos ordered on key, ties in record order for both directions
+vectorlong reference_order(const vector<vectorstr>& rows, const vectorlong& recnos, int field, bool descending)
+{
+  vectorlong ordered = recnos;
+  sort(ordered.begin(), ordered.end());
+  stable_sort(ordered.begin(), ordered.end(), [&rows, field, descending](long lhs, long rhs) {
+    return descending ? rows[rhs][field] < rows[lhs][field] : rows[lhs][field] < rows[rhs][field];
+  });
+  return ordered;
+}
+
+vector<vectorstr> make_rows(SQL& sql, const string& table)
+{
+  mt19937 random(31);
+  vector<vectorstr> rows(ORDER_ROWS);
+  sql.command("drop table " + table);
+  sql.command("make table " + table + " fields name, bucket");
+  for (int r = 0; r < ORDER_ROWS; r++)
+  {
+    //names of one to three letters repeat, and compare as text
+    string name(1 + random() % 3, 'a');
+    for (int i = 0; i < name.size(); i++)
+      name[i] = 'a' + random() % 4;
+    rows[r] = {name, to_string(random() % 50)};
+    sql.command("insert into " + table + " values " + name + ", " + rows[r][1]);
+  }
+  return rows;
+}
+
+bool test_index_walk_order(bool debug = false)
+{
+  SQL sql;
+  vector<vectorstr> rows = make_rows(sql, "orderwalk");
+  Table table("orderwalk");
+  //every record selected, walking the index is cheaper than reading them all to sort
+  if (table.order_method(ORDER_ROWS, false, -1) != ORDER_INDEX_WALK || table.order_method(ORDER_ROWS, true, -1) != ORDER_INDEX_WALK)
+    return false;
+  vectorlong all;
+  for (long r = 0; r < ORDER_ROWS; r++)
+    all.push_back(r);
+  for (int descending = 0; descending < 2; descending++)
+  {
+    sql.command(string("select * from orderwalk order by name") + (descending ? " desc" : ""), false);
+    if (sql.errorState() || sql.selectRecordNos() != reference_order(rows, all, 0, descending))
+      return false;
+    //a condition that keeps most of the records still walks the index
+    vectorlong most;
+    for (long r = 0; r < ORDER_ROWS; r++)
+      if (rows[r][1] != "7")
+        most.push_back(r);
+    if (table.order_method(most.size(), descending, -1) != ORDER_INDEX_WALK)
+      return false;
+    sql.command(string("select * from orderwalk where bucket != 7 order by name") + (descending ? " desc" : ""), false);
+    if (debug)
+      cout << (descending ? "desc: " : "asc: ") << sql.selectRecordNos().size() << " records\n";
+    if (sql.errorState() || sql.selectRecordNos() != reference_order(rows, most, 0, descending))
+      return false;
+  }
+  sql.command("drop table orderwalk");
+  return true;
+}
+
+bool test_external_sort_order(bool debug = false)
+{
+  SQL sql;
+  vector<vectorstr> rows = make_rows(sql, "ordersort");
+  Table table("ordersort");
+  long saved_budget = Table::sort_memory_budget;
+  bool ok = true;
+  //a budget of a few entries spills many runs, the default sorts in memory
+  const long budgets[] = {saved_budget, 512, 64};
+  for (int b = 0; b < 3 && ok; b++)
+  {
+    Table::sort_memory_budget = budgets[b];
+    for (int descending = 0; descending < 2 && ok; descending++)
+    {
+      //a few buckets out of fifty are a small selection, sorting it beats walking every key
+      vectorlong few;
+      for (long r = 0; r < ORDER_ROWS; r++)
+        if (rows[r][1] == "3" || rows[r][1] == "4" || rows[r][1] == "40")
+          few.push_back(r);
+      ok = table.order_method(few.size(), descending, -1) == ORDER_EXTERNAL_SORT;
+      sql.command(string("select * from ordersort where bucket = 3 or bucket = 4 or bucket = 40 order by name")
+                  + (descending ? " desc" : ""), false);
+      ok = ok && !sql.errorState() && sql.selectRecordNos() == reference_order(rows, few, 0, descending);
+      if (debug)
+        cout << "budget " << budgets[b] << (descending ? " desc: " : " asc: ") << few.size() << " records\n";
+    }
+  }
+  Table::sort_memory_budget = saved_budget;
+  ok = ok && files_containing("_run_") == 0;
+  sql.command("drop table ordersort");
+  return ok;
+}
+
+bool test_sort_run_files(bool debug = false)
+{
+  //two sorts at once never write to the same run file
+  ExternalSort first(64, "orderruns");
+  ExternalSort second(64, "orderruns");
+  for (long i = 0; i < 100; i++)
+  {
+    first.add(to_string(i % 7), i);
+    second.add(to_string(i % 5), i);
+  }
+  if (first.run_count() < 2 || second.run_count() < 2)
+    return false;
+  vector<string> first_runs = first.run_files();
+  for (int i = 0; i < first_runs.size(); i++)
+    if (find(second.run_files().begin(), second.run_files().end(), first_runs[i]) != second.run_files().end())
+      return false;
+  if (files_containing("orderruns") != first.run_count() + second.run_count())
+    return false;
+  //finishing removes the sorter's own runs
+  vectorlong recnos;
+  first.finish(recnos, true);
+  if (recnos.size() != 100 || files_containing("orderruns") != second.run_count())
+    return false;
+  if (debug)
+    cout << first_runs.size() << " and " << second.run_count() << " runs\n";
+  //and a sort that never finishes, left by an exception, removes them as it goes
+  {
+    ExternalSort abandoned(64, "orderruns");
+    for (long i = 0; i < 100; i++)
+      abandoned.add("x", i);
+  }
+  return files_containing("orderruns") == second.run_count();
+}
+
+//sorted recnos the select lists, {-1} when it fails
+vectorlong selected(SQL& sql, const string& command)
+{
+  sql.command(command);
+  if (sql.errorState())
+    return vectorlong(1, -1);
+  vectorlong recnos = sql.selectRecordNos();
+  sort(recnos.begin(), recnos.end());
+  return recnos;
+}
+
+bool test_direction_values(bool debug = false)
+{
+  //asc, desc and by are stored as values, and a condition finds them, quoted or not
+  SQL sql;
+  sql.command("drop table orderwords");
+  sql.command("make table orderwords fields word, kind");
+  sql.command("insert into orderwords values asc, by");
+  sql.command("insert into orderwords values desc, by");
+  sql.command("insert into orderwords values \"desc\", order");
+  if (sql.errorState())
+    return false;
+  bool ok = selected(sql, "select * from orderwords where word = desc") == vectorlong({1, 2})
+         && selected(sql, "select * from orderwords where word = asc") == vectorlong({0})
+         && selected(sql, "select * from orderwords where kind = by") == vectorlong({0, 1})
+         && selected(sql, "select * from orderwords where word = \"desc\" and kind = \"order\"") == vectorlong({2})
+         && selected(sql, "select * from orderwords where kind = 'by' order by word desc") == vectorlong({0, 1});
+  if (debug)
+    cout << "values " << (ok ? "found" : "missed") << "\n";
+  //a quoted word that fails is reported as a value, not a keyword
+  sql.command("select word \"desc\" from orderwords");
+  ok = ok && sql.errorState() && sql.errorMessage().find("Extra Keywords") == string::npos;
+  sql.command("drop table orderwords");
+  return ok;
+}
+
+// ==============================
+// global BAD!
+bool debug = false;
+// ==============================
+
+TEST(ORDER_BY, IndexWalk) {
+  EXPECT_EQ(test_index_walk_order(debug), true);
+}
+
+TEST(ORDER_BY, ExternalSort) {
+  EXPECT_EQ(test_external_sort_order(debug), true);
+}
+
+TEST(ORDER_BY, SortRunFiles) {
+  EXPECT_EQ(test_sort_run_files(debug), true);
+}
+
+TEST(ORDER_BY, DirectionValues) {
+  EXPECT_EQ(test_direction_values(debug), true);
+}
+
+int main(int argc, char **argv) {
+  if (argc > 1)
+  {
+    debug = !strcmp(argv[1], "debug");
+  }
+
+  ::testing::InitGoogleTest(&argc, argv);
+  std::cout<<"\n\n----------running order_by_test.cpp---------\n\n"<<std::endl;
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,317 @@
+#include "gtest/gtest.h"
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include "random"
+#include <cstdlib>
+#include <new>
+#include <fstream>
+#include "../../includes/PerfectHash/perfect_hash.h"
+#include "../../includes/Parser/parser.h"
+#include "../../includes/Tokenizer/stokenize.h"
+using namespace std;
+
+//parse throughput: a parser and a tokenizer are made for every command, so their setup is part
+//of every command's cost, and keyword lookups happen once per token
+
+const int BENCH_REPEATS = 20000;
+
+const char* BENCH_COMMANDS[] = {
+  "select * from employee",
+  "select lname, fname, salary from employee where dep = CS and salary >= 100000 order by lname limit 10",
+  "insert into employee values Blow, Joe, CS, 100000, 2018",
+  "make table employee fields last, first, dep, salary, year",
+  "select dep, count(*), avg(salary) from employee group by dep order by dep desc",
+  "select lname, room from employee join dept on dep = dname where year > 2015"
+};
+const int BENCH_COMMAND_COUNT = sizeof(BENCH_COMMANDS) / sizeof(BENCH_COMMANDS[0]);
+
+//heap allocations made while counting_allocations is set
+long allocations = 0;
+bool counting_allocations = false;
+
+void* operator new(size_t size)
+{
+  if (counting_allocations)
+    allocations++;
+  void* p = malloc(size ? size : 1);
+  if (!p)
+    throw bad_alloc();
+  return p;
+}
+
+void operator delete(void* p) noexcept
+{
+  free(p);
+}
+
+double elapsed_ns(chrono::steady_clock::time_point start)
+{
+  return chrono::duration<double, nano>(chrono::steady_clock::now() - start).count();
+}
+
+string random_word(mt19937& random)
+{
+  string word;
+  int length = 1 + random() % 8;
+  for (int i = 0; i < length; i++)
+    word += 'a' + random() % 26;
+  return word;
+}
+
+bool test_perfect_hash(bool debug = false)
+{
+  mt19937 random(39);
+  for (int count = 1; count < 300; count += 13)
+  {
+    set<string> unique;
+    while (unique.size() < count)
+      unique.insert(random_word(random));
+    vectorstr words(unique.begin(), unique.end());
+    vector<long> values;
+    for (int i = 0; i < words.size(); i++)
+      values.push_back(i);
+    PerfectHash hash;
+    hash.build(words, values);
+    for (int i = 0; i < words.size(); i++)
+    {
+      if (hash.find(words[i]) != i)
+        return false;
+    }
+    for (int i = 0; i < 1000; i++)
+    {
+      string word = random_word(random) + "_";
+      if (hash.contains(word))
+        return false;
+    }
+    if (debug)
+      cout << count << " words in " << hash.slots() << " slots\n";
+  }
+  PerfectHash empty;
+  return !empty.contains("select");
+}
+
+bool test_parse_statements(bool debug = false)
+{
+  //keywords still go to their states through the hash
+  const char* command = "explain select dep, count(*) from employee where year > 2015 group by dep order by dep desc limit 2";
+  Parser parser(command);
+  Statement statement;
+  parser.parse_statement(statement);
+  if (debug)
+    cout << statement << "\n";
+  if (!(statement.command == COMMAND_SELECT && statement.explain && !statement.analyze && statement.fields.size() == 2
+      && statement.fields[1] == "count(*)" && statement.aggregate && statement.table_names.size() == 1
+      && statement.table_names[0] == "employee" && statement.where && statement.condition.size() == 3
+      && statement.group && statement.group_by.size() == 1 && statement.group_by[0] == "dep"
+      && statement.order_by == "dep" && statement.direction == "desc" && statement.limit && statement.limit_count == "2"
+      && !statement.offset))
+    return false;
+  //a statement is cleared before the next command fills it
+  Parser join("select lname, room from employee join dept on dep = dname");
+  join.parse_statement(statement);
+  if (debug)
+    cout << statement << "\n";
+  if (!(statement.command == COMMAND_SELECT && !statement.explain && !statement.where && statement.condition.empty()
+      && statement.join && statement.join_condition.size() == 3 && statement.table_names.size() == 2
+      && statement.table_names[1] == "dept" && !statement.group && !statement.limit && statement.order_by.empty()))
+    return false;
+  //rows of an insert go into values one after another, with where each one ends
+  Parser insert("insert into employee values (Jo, \"Lee Ann\", 2019), (Al, Yi, 2020), (Bo, Ng, 2021)");
+  insert.parse_statement(statement);
+  if (debug)
+    cout << statement << "\n";
+  int row_ends[] = {3, 6, 9};
+  return statement.command == COMMAND_INSERT && statement.values.size() == 9 && statement.values[1] == "Lee Ann"
+      && statement.values[8] == "2021" && statement.row_ends == vector<int>(row_ends, row_ends + 3);
+}
+
+bool test_parse_allocations(bool debug = false)
+{
+  //tokenizing and walking the state table allocate nothing, and a statement that has held
+  //a command before has room for its parts again
+  Statement statement;
+  for (int i = 0; i < BENCH_COMMAND_COUNT; i++)
+  {
+    allocations = 0;
+    counting_allocations = true;
+    {
+      Parser parser(BENCH_COMMANDS[i]);
+      parser.parse();
+    }
+    counting_allocations = false;
+    long parse_allocations = allocations;
+    long first_allocations = 0;
+    for (int pass = 0; pass < 2; pass++)
+    {
+      allocations = 0;
+      counting_allocations = true;
+      {
+        Parser parser(BENCH_COMMANDS[i]);
+        parser.parse_statement(statement);
+      }
+      counting_allocations = false;
+      if (pass == 0)
+        first_allocations = allocations;
+    }
+    if (debug)
+      cout << parse_allocations << " allocations to parse, " << first_allocations << " into a new statement, "
+           << allocations << " into a used one: " << BENCH_COMMANDS[i] << "\n";
+    if (parse_allocations || allocations)
+      return false;
+  }
+  return true;
+}
+
+bool test_long_command(bool debug = false)
+{
+  //commands are not cut to a buffer size, and quoted values are the text between their quotes
+  string command = "select name from employee where year = 2000";
+  for (int i = 1; i < 500; i++)
+    command += " or year = " + to_string(2000 + i);
+  Parser select(command);
+  Statement statement;
+  select.parse_statement(statement);
+  if (debug)
+    cout << command.size() << " chars, " << statement.condition.size() << " condition tokens\n";
+  if (statement.condition.size() != 500 * 4 - 1 || statement.condition.back() != "2499")
+    return false;
+  string insert = "insert into employee values \"Smith, Jo\u00e9\", \"a@b\",\"\",\"x\" 2018";
+  Parser values(insert);
+  values.parse_statement(statement);
+  if (statement.values.size() != 5 || statement.values[0] != "Smith, Jo\u00e9" || statement.values[1] != "a@b"
+      || statement.values[2] != "" || statement.values[3] != "x" || statement.values[4] != "2018")
+    return false;
+  //an empty quoted value is a value, in a condition too
+  Parser empty("select name from employee where name = \"\" or name = ''");
+  empty.parse_statement(statement);
+  return statement.condition == vectorstr({"name", "=", "", "or", "name", "=", ""});
+}
+
+bool bench_keyword_lookup(bool debug = false)
+{
+  const char* keywords[] = {"select", "from", "where", "insert", "into", "values", "order", "by", "limit", "count"};
+  const int keyword_count = sizeof(keywords) / sizeof(keywords[0]);
+  vectorstr words;
+  vector<long> values;
+  map_sl tree;
+  for (int i = 0; i < keyword_count; i++)
+  {
+    words.push_back(keywords[i]);
+    values.push_back(i);
+    tree[keywords[i]] = i;
+  }
+  PerfectHash hash;
+  hash.build(words, values);
+  //half of the tokens of a command are not keywords
+  vectorstr tokens = words;
+  mt19937 random(39);
+  for (int i = 0; i < keyword_count; i++)
+    tokens.push_back(random_word(random));
+
+  long found = 0;
+  chrono::steady_clock::time_point start = chrono::steady_clock::now();
+  for (int r = 0; r < BENCH_REPEATS; r++)
+  {
+    for (int i = 0; i < tokens.size(); i++)
+    {
+      if (tree.contains(tokens[i]))
+        found += tree[tokens[i]];
+    }
+  }
+  double tree_ns = elapsed_ns(start) / BENCH_REPEATS / tokens.size();
+  long hashed = 0;
+  start = chrono::steady_clock::now();
+  for (int r = 0; r < BENCH_REPEATS; r++)
+  {
+    for (int i = 0; i < tokens.size(); i++)
+    {
+      long value = hash.find(tokens[i]);
+      if (value != -1)
+        hashed += value;
+    }
+  }
+  double hash_ns = elapsed_ns(start) / BENCH_REPEATS / tokens.size();
+  cout << "keyword lookup  map : " << fixed << setprecision(3) << tree_ns << " ns/token\n";
+  cout << "keyword lookup  hash: " << fixed << setprecision(3) << hash_ns << " ns/token\n";
+  return found == hashed;
+}
+
+bool bench_tokenize(bool debug = false)
+{
+  long tokens = 0;
+  chrono::steady_clock::time_point start = chrono::steady_clock::now();
+  for (int r = 0; r < BENCH_REPEATS; r++)
+  {
+    STokenizer stk(BENCH_COMMANDS[r % BENCH_COMMAND_COUNT]);
+    SToken t;
+    stk >> t;
+    while (stk.more())
+    {
+      tokens++;
+      t = SToken();
+      stk >> t;
+    }
+  }
+  cout << "tokenize        : " << fixed << setprecision(3) << elapsed_ns(start) / BENCH_REPEATS / 1000 << " us/command\n";
+  return tokens > 0;
+}
+
+bool bench_parse(bool debug = false)
+{
+  long fields = 0;
+  Statement statement;
+  chrono::steady_clock::time_point start = chrono::steady_clock::now();
+  for (int r = 0; r < BENCH_REPEATS; r++)
+  {
+    Parser parser(BENCH_COMMANDS[r % BENCH_COMMAND_COUNT]);
+    parser.parse_statement(statement);
+    fields += statement.fields.size();
+  }
+  cout << "parser + parse  : " << fixed << setprecision(3) << elapsed_ns(start) / BENCH_REPEATS / 1000 << " us/command\n";
+  return fields > 0;
+}
+
+// ==============================
+// global BAD!
+bool debug = false;
+// ==============================
+
+TEST(PARSER_BENCH, PerfectHash) {
+  EXPECT_EQ(test_perfect_hash(debug), true);
+}
+
+TEST(PARSER_BENCH, ParseStatements) {
+  EXPECT_EQ(test_parse_statements(debug), true);
+}
+
+TEST(PARSER_BENCH, ParseAllocations) {
+  EXPECT_EQ(test_parse_allocations(debug), true);
+}
+
+TEST(PARSER_BENCH, LongCommand) {
+  EXPECT_EQ(test_long_command(debug), true);
+}
+
+TEST(PARSER_BENCH, BenchKeywordLookup) {
+  EXPECT_EQ(bench_keyword_lookup(debug), true);
+}
+
+TEST(PARSER_BENCH, BenchTokenize) {
+  EXPECT_EQ(bench_tokenize(debug), true);
+}
+
+TEST(PARSER_BENCH, BenchParse) {
+  EXPECT_EQ(bench_parse(debug), true);
+}
+
+int main(int argc, char **argv) {
+  if (argc > 1)
+  {
+    debug = !strcmp(argv[1], "debug");
+  }
+
+  ::testing::InitGoogleTest(&argc, argv);
+  std::cout<<"\n\n----------running parser_bench.cpp---------\n\n"<<std::endl;
+  return RUN_ALL_TESTS();
+}
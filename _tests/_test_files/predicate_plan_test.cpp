@@ -0,0 +1,274 @@
+#include "gtest/gtest.h"
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include <cstring>
+#include "random"
+#include "../../includes/Table/table.h"
+#include "../../includes/PredicatePlan/predicate_plan.h"
+#include "../../includes/ParallelScan/parallel_scan.h"
+#include "../../includes/Files/FileRecord.h"
+using namespace std;
+
+//where clause evaluators: random and/or/not conditions over a generated table, with leaves shared
+//between branches, come back the same from the serial index probes, the parallel dag, the morsel
+//scan on one and on several threads, a record by record match and Table::where_recnos, and the
+//same as a comparison of every row in memory
+
+const int PLAN_ROWS = 3000;         //a few scan morsels
+const int PLAN_CONDITIONS = 300;
+
+//a condition as tokens and as a function of a row, built side by side
+struct Condition
+{
+  vectorstr tokens;
+  vector<int> op;                   //postfix: leaf index >= 0, -1 and, -2 or, -3 not
+};
+
+struct Leaf
+{
+  int field;
+  string relational;
+  string literal;
+};
+
+bool compare(const string& relational, const string& value, const string& literal)
+{
+  int cmp = strcmp(value.c_str(), literal.c_str());
+  if (relational == "=")
+    return cmp == 0;
+  if (relational == "<")
+    return cmp < 0;
+  if (relational == ">")
+    return cmp > 0;
+  if (relational == "<=")
+    return cmp <= 0;
+  if (relational == ">=")
+    return cmp >= 0;
+  return cmp != 0;
+}
+
+bool row_matches(const Condition& condition, const vector<Leaf>& leaves, const vectorstr& row)
+{
+  vector<bool> stack;
+  for (int i = 0; i < condition.op.size(); i++)
+  {
+    int op = condition.op[i];
+    if (op >= 0)
+      stack.push_back(compare(leaves[op].relational, row[leaves[op].field], leaves[op].literal));
+    else if (op == -3)
+      stack.back() = !stack.back();
+    else
+    {
+      bool rhs = stack.back();
+      stack.pop_back();
+      stack.back() = op == -1 ? stack.back() && rhs : stack.back() || rhs;
+    }
+  }
+  return stack.back();
+}
+
+//a random expression of depth at most depth over the leaves
+void build(mt19937& random, const vector<Leaf>& leaves, const vectorstr& fields, int depth, Condition& out)
+{
+  int pick = random() % 8;
+  if (depth == 0 || pick < 3)
+  {
+    int leaf = random() % leaves.size();
+    out.tokens.push_back(fields[leaves[leaf].field]);
+    out.tokens.push_back(leaves[leaf].relational);
+    out.tokens.push_back(leaves[leaf].literal);
+    out.op.push_back(leaf);
+    return;
+  }
+  if (pick == 3)
+  {
+    out.tokens.push_back("not");
+    out.tokens.push_back("(");
+    build(random, leaves, fields, depth - 1, out);
+    out.tokens.push_back(")");
+    out.op.push_back(-3);
+    return;
+  }
+  out.tokens.push_back("(");
+  build(random, leaves, fields, depth - 1, out);
+  out.tokens.push_back(pick % 2 ? "and" : "or");
+  build(random, leaves, fields, depth - 1, out);
+  out.tokens.push_back(")");
+  out.op.push_back(pick % 2 ? -1 : -2);
+}
+
+vectorlong sorted(vectorlong recnos)
+{
+  sort(recnos.begin(), recnos.end());
+  return recnos;
+}
+
+bool test_evaluators_agree(bool debug = false)
+{
+  mt19937 random(27);
+  const vectorstr fields = {"a", "b", "c"};
+  //single digits, letters and two digit numbers, so every field has repeats and ranges
+  vector<vectorstr> rows(PLAN_ROWS);
+  for (int r = 0; r < PLAN_ROWS; r++)
+  {
+    char two[3] = {char('0' + random() % 10), char('0' + random() % 10), 0};
+    rows[r] = {to_string(random() % 10), string(1, 'a' + random() % 6), two};
+  }
+  Table table("planequivalence", fields);
+  table.insert_many(rows);
+  //the test's own indexes, built a row at a time
+  vector<mmap_sl> indices(fields.size());
+  for (int r = 0; r < PLAN_ROWS; r++)
+    for (int f = 0; f < fields.size(); f++)
+      indices[f][rows[r][f]] += (long)r;
+
+  const vectorstr relationals = {"=", "<", ">", "<=", ">=", "!=", "<>"};
+  int empty_results = 0;
+  int full_results = 0;
+  for (int round = 0; round < PLAN_CONDITIONS; round++)
+  {
+    //a handful of leaves, so branches keep sharing the same comparison
+    //literals just outside every field's values make leaves that select nothing or everything
+    vector<Leaf> leaves(1 + random() % 5);
+    for (int i = 0; i < leaves.size(); i++)
+    {
+      leaves[i].field = random() % fields.size();
+      leaves[i].relational = relationals[random() % relationals.size()];
+      int edge = random() % 6;
+      if (edge == 0)
+        leaves[i].literal = "!";
+      else if (edge == 1)
+        leaves[i].literal = "~";
+      else
+        leaves[i].literal = rows[random() % PLAN_ROWS][leaves[i].field];
+    }
+    Condition condition;
+    build(random, leaves, fields, 1 + round % 4, condition);
+    vectorlong want;
+    for (int r = 0; r < PLAN_ROWS; r++)
+      if (row_matches(condition, leaves, rows[r]))
+        want.push_back(r);
+    empty_results += want.empty();
+    full_results += want.size() == PLAN_ROWS;
+
+    PredicatePlan plan = table.compile_condition(condition.tokens);
+    vectorlong serial = sorted(plan.evaluate(indices, PLAN_ROWS, -1, 1));
+    vectorlong parallel = sorted(plan.evaluate(indices, PLAN_ROWS, -1, 4));
+    ParallelScan one_thread("planequivalence_fields.bin", 1);
+    ParallelScan threads("planequivalence_fields.bin", 4);
+    vectorlong scanned = one_thread.filter(plan, PLAN_ROWS);
+    vectorlong scanned_parallel = threads.filter(plan, PLAN_ROWS);
+    vectorlong matched;
+    fstream f;
+    table.open_records(f);
+    FileRecord record;
+    for (int r = 0; r < PLAN_ROWS; r++)
+    {
+      record.read(f, r);
+      if (plan.matches(record._record))
+        matched.push_back(r);
+    }
+    f.close();
+    vectorlong table_path = sorted(table.where_recnos(condition.tokens));
+    //a limit keeps a part of what the plan selects
+    long limit = random() % 20;
+    vectorlong limited = plan.evaluate(indices, PLAN_ROWS, limit, 1 + random() % 4);
+    bool limited_ok = limited.size() == min<long>(limit, want.size());
+    for (int i = 0; i < limited.size() && limited_ok; i++)
+      limited_ok = binary_search(want.begin(), want.end(), limited[i]);
+
+    if (serial != want || parallel != want || scanned != want || scanned_parallel != want || matched != want
+        || table_path != want || !limited_ok)
+    {
+      if (debug)
+      {
+        for (int i = 0; i < condition.tokens.size(); i++)
+          cout << condition.tokens[i] << " ";
+        cout << "\nwant " << want.size() << " serial " << serial.size() << " parallel " << parallel.size()
+             << " scan " << scanned.size() << " parallel scan " << scanned_parallel.size() << " matched " << matched.size()
+             << " table " << table_path.size() << " limited " << limited_ok << "\n";
+      }
+      return false;
+    }
+  }
+  if (debug)
+    cout << empty_results << " empty and " << full_results << " full results out of " << PLAN_CONDITIONS << "\n";
+  //the edge literals have to have produced both
+  return empty_results > 0 && full_results > 0;
+}
+
+bool test_table_methods(bool debug = false)
+{
+  //where_recnos picks probes, parallel probes or a parallel scan by cost, all three give the same rows
+  mt19937 random(35);
+  const int rows_count = 4 * SCAN_MORSEL_RECORDS;
+  vector<vectorstr> rows(rows_count);
+  for (int r = 0; r < rows_count; r++)
+    rows[r] = {to_string(random() % 100), to_string(random() % 3)};
+  Table table("planmethods", {"x", "y"});
+  table.insert_many(rows);
+  const vector<vectorstr> conditions = {
+    {"x", "<", "5", "and", "y", "=", "1"},
+    {"x", ">=", "1", "or", "y", "!=", "2"},
+    {"not", "(", "x", "<", "9", "or", "y", "=", "0", ")", "and", "x", ">", "2"},
+    {"(", "x", "=", "42", "or", "x", "=", "7", ")", "and", "(", "x", "=", "42", "or", "y", "=", "2", ")"}
+  };
+  int saved_scan = Table::scan_threads;
+  int saved_probe = Table::probe_threads;
+  for (int c = 0; c < conditions.size(); c++)
+  {
+    vectorlong want;
+    PredicatePlan plan = table.compile_condition(conditions[c]);
+    for (int r = 0; r < rows_count; r++)
+    {
+      char record[2][FIELD_MAX_LEN];
+      strcpy(record[0], rows[r][0].c_str());
+      strcpy(record[1], rows[r][1].c_str());
+      if (plan.matches(record))
+        want.push_back(r);
+    }
+    set<int> methods;
+    for (int threads = 1; threads <= 64; threads *= 4)
+    {
+      Table::scan_threads = threads;
+      Table::probe_threads = threads;
+      methods.insert(table.where_method(plan));
+      if (sorted(table.where_recnos(conditions[c])) != want)
+      {
+        Table::scan_threads = saved_scan;
+        Table::probe_threads = saved_probe;
+        return false;
+      }
+    }
+    if (debug)
+      cout << "condition " << c << ": " << want.size() << " rows, " << methods.size() << " methods\n";
+  }
+  Table::scan_threads = saved_scan;
+  Table::probe_threads = saved_probe;
+  return true;
+}
+
+// ==============================
+// global BAD!
+bool debug = false;
+// ==============================
+
+TEST(PREDICATE_PLAN, EvaluatorsAgree) {
+  EXPECT_EQ(test_evaluators_agree(debug), true);
+}
+
+TEST(PREDICATE_PLAN, TableMethods) {
+  EXPECT_EQ(test_table_methods(debug), true);
+}
+
+int main(int argc, char **argv) {
+  if (argc > 1)
+  {
+    debug = !strcmp(argv[1], "debug");
+  }
+
+  ::testing::InitGoogleTest(&argc, argv);
+  std::cout<<"\n\n----------running predicate_plan_test.cpp---------\n\n"<<std::endl;
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,197 @@
+#include "gtest/gtest.h"
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <algorithm>
+#include "../../includes/sql/sql.h"
+using namespace std;
+
+//prepared statements: "?" is a parameter only outside quotes and only where a value goes, bind
+//refuses a parameter the statement does not have, and a statement run again sees what changed
+//in its table since it last ran
+
+//what a select selects, by record number in order, {-1} if it failed
+vectorlong sorted_recnos(SQL& sql)
+{
+  if (sql.errorState())
+    return vectorlong(1, -1);
+  vectorlong recnos = sql.selectRecordNos();
+  sort(recnos.begin(), recnos.end());
+  return recnos;
+}
+
+vectorlong executed(SQL& sql, PreparedStatement& statement)
+{
+  sql.execute(statement);
+  return sorted_recnos(sql);
+}
+
+vectorlong commanded(SQL& sql, const string& command)
+{
+  sql.command(command);
+  return sorted_recnos(sql);
+}
+
+bool test_prepare_bind_execute(bool debug = false)
+{
+  SQL sql;
+  sql.command("drop table prepared");
+  sql.command("make table prepared fields name, age");
+  PreparedStatement insert = sql.prepare("insert into prepared values ?, ?");
+  if (sql.errorState() || insert.param_count() != 2)
+    return false;
+  const vector<vectorstr> people = {{"Ann", "30"}, {"Bob", "25"}, {"Cid", "30"}, {"Dee", "41"}};
+  for (int i = 0; i < people.size(); i++)
+  {
+    if (!insert.bind(people[i]))
+      return false;
+    sql.execute(insert);
+    if (sql.errorState())
+      return false;
+  }
+  //a parameter next to fixed comparisons, under a not, is the value of its own comparison
+  PreparedStatement select = sql.prepare("select name from prepared where age > ? and not (name = Bob or name = ?)");
+  if (sql.errorState() || select.param_count() != 2)
+    return false;
+  const vector<vectorstr> bindings = {{"20", "Ann"}, {"29", "Cid"}, {"40", "Nobody"}, {"99", "Ann"}};
+  for (int i = 0; i < bindings.size(); i++)
+  {
+    select.bind(1, bindings[i][0]);
+    select.bind(2, bindings[i][1]);
+    vectorlong want = commanded(sql, "select name from prepared where age > " + bindings[i][0]
+                                     + " and not (name = Bob or name = " + bindings[i][1] + ")");
+    if (debug)
+      cout << select;
+    if (executed(sql, select) != want || want == vectorlong(1, -1))
+      return false;
+  }
+
+  //run again after an insert, the new row is there
+  select.bind(1, "20");
+  select.bind(2, "Ann");
+  if (executed(sql, select) != vectorlong({2, 3}))
+    return false;
+  insert.bind(1, "Eve");
+  insert.bind(2, "50");
+  sql.execute(insert);
+  if (executed(sql, select) != vectorlong({2, 3, 4}))
+    return false;
+
+  //and after the table is made again with its fields in another order
+  sql.command("drop table prepared");
+  sql.command("make table prepared fields age, name");
+  sql.command("insert into prepared values 60, Fay");
+  if (executed(sql, select) != vectorlong({0}))
+    return false;
+  sql.command("drop table prepared");
+  return true;
+}
+
+bool test_bind_errors(bool debug = false)
+{
+  SQL sql;
+  sql.command("drop table preparedbind");
+  sql.command("make table preparedbind fields name, age");
+  PreparedStatement insert = sql.prepare("insert into preparedbind values ?, ?");
+  //no parameter 0 or 3, and a list of values has to have one for each parameter
+  if (insert.bind(0, "x") || insert.bind(3, "x") || insert.bind(-1, "x"))
+    return false;
+  if (insert.bind(vectorstr({"only one"})) || insert.bind(vectorstr({"a", "b", "c"})))
+    return false;
+  if (insert.bound(1) || insert.bound(0) || insert.bound(3))
+    return false;
+  //running it with a parameter still unbound fails and inserts nothing
+  if (!insert.bind(1, "Ann") || !insert.bound(1))
+    return false;
+  ostringstream silenced;
+  streambuf* cout_buffer = cout.rdbuf(silenced.rdbuf());
+  sql.execute(insert);
+  bool unbound_failed = sql.errorState();
+  cout.rdbuf(cout_buffer);
+  if (debug)
+    cout << silenced.str();
+  if (!unbound_failed || sql.errorMessage().find("?2") == string::npos)
+    return false;
+  insert.clear_bindings();
+  if (insert.bound(1))
+    return false;
+  insert.bind(vectorstr({"Ann", "30"}));
+  sql.execute(insert);
+  bool ok = !sql.errorState() && commanded(sql, "select * from preparedbind") == vectorlong({0});
+  sql.command("drop table preparedbind");
+  return ok;
+}
+
+bool test_parameter_placement(bool debug = false)
+{
+  SQL sql;
+  sql.command("drop table preparedplace");
+  sql.command("make table preparedplace fields name, note");
+  ostringstream silenced;
+  streambuf* cout_buffer = cout.rdbuf(silenced.rdbuf());
+  //a quoted "?" is text, in either quote
+  PreparedStatement insert = sql.prepare("insert into preparedplace values ?, \"?\"");
+  bool ok = !sql.errorState() && insert.param_count() == 1;
+  PreparedStatement quoted = sql.prepare("insert into preparedplace values 'why?', ?");
+  ok = ok && !sql.errorState() && quoted.param_count() == 1;
+  //a "?" where no value goes does not prepare
+  sql.prepare("select ? from preparedplace");
+  ok = ok && sql.errorState();
+  sql.prepare("select * from preparedplace where ? = Ann");
+  ok = ok && sql.errorState();
+  sql.prepare("drop table ?");
+  ok = ok && sql.errorState();
+  //and outside a prepared statement a "?" is refused rather than dropped
+  sql.command("insert into preparedplace values ?, x");
+  ok = ok && sql.errorState();
+  sql.command("select * from preparedplace where name = ?");
+  ok = ok && sql.errorState();
+  cout.rdbuf(cout_buffer);
+  if (debug)
+    cout << silenced.str();
+  if (!ok)
+    return false;
+
+  insert.bind(1, "Ann");
+  sql.execute(insert);
+  quoted.bind(1, "Bob");
+  sql.execute(quoted);
+  PreparedStatement select = sql.prepare("select name from preparedplace where note = ?");
+  select.bind(1, "?");
+  if (executed(sql, select) != vectorlong({0}))
+    return false;
+  select.bind(1, "Bob");
+  if (executed(sql, select) != vectorlong({1}))
+    return false;
+  ok = commanded(sql, "select * from preparedplace where name = \"?\"") == vectorlong();
+  sql.command("drop table preparedplace");
+  return ok;
+}
+
+// ==============================
+// global BAD!
+bool debug = false;
+// ==============================
+
+TEST(PREPARED_STATEMENT, PrepareBindExecute) {
+  EXPECT_EQ(test_prepare_bind_execute(debug), true);
+}
+
+TEST(PREPARED_STATEMENT, BindErrors) {
+  EXPECT_EQ(test_bind_errors(debug), true);
+}
+
+TEST(PREPARED_STATEMENT, ParameterPlacement) {
+  EXPECT_EQ(test_parameter_placement(debug), true);
+}
+
+int main(int argc, char **argv) {
+  if (argc > 1)
+  {
+    debug = !strcmp(argv[1], "debug");
+  }
+
+  ::testing::InitGoogleTest(&argc, argv);
+  std::cout<<"\n\n----------running prepared_statement_test.cpp---------\n\n"<<std::endl;
+  return RUN_ALL_TESTS();
+}
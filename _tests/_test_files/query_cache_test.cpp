@@ -0,0 +1,167 @@
+#include "gtest/gtest.h"
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include "../../includes/sql/sql.h"
+using namespace std;
+
+//select result cache: a repeated select is a hit, a full cache drops its least recently used
+//entry, and every way of changing a table (insert, prepared insert, load, rolled back batch
+//transaction, drop) leaves the next select reading fresh rows
+
+//what a select selects, by record number in order, {-1} if it failed
+vectorlong selected(SQL& sql, const string& command)
+{
+  sql.command(command);
+  if (sql.errorState())
+    return vectorlong(1, -1);
+  vectorlong recnos = sql.selectRecordNos();
+  sort(recnos.begin(), recnos.end());
+  return recnos;
+}
+
+void make_people(SQL& sql, const string& table)
+{
+  sql.command("drop table " + table);
+  sql.command("make table " + table + " fields name, age");
+  sql.command("insert into " + table + " values Ann, 30");
+  sql.command("insert into " + table + " values Bob, 25");
+  sql.command("insert into " + table + " values Cid, 30");
+}
+
+bool test_cache_hits(bool debug = false)
+{
+  SQL sql;
+  make_people(sql, "cachehits");
+  sql.enableQueryCache(8);
+  if (selected(sql, "select * from cachehits where age = 30") != vectorlong({0, 2}))
+    return false;
+  //the same select with other spacing shares the entry
+  if (selected(sql, "select  *   from cachehits where age=30") != vectorlong({0, 2}))
+    return false;
+  if (selected(sql, "select * from cachehits where age = 25") != vectorlong({1}))
+    return false;
+  if (debug)
+    cout << sql.queryCache();
+  if (sql.queryCache().hits() != 1 || sql.queryCache().misses() != 2 || sql.queryCache().size() != 2)
+    return false;
+  //without rows cached the hit is rebuilt from its record numbers
+  sql.enableQueryCache(8, false);
+  selected(sql, "select name from cachehits where age = 30");
+  Table hit = sql.command("select name from cachehits where age = 30");
+  return sql.queryCache().hits() == 2 && hit.record_count() == 2 && hit.get_field_names() == vectorstr({"name"});
+}
+
+bool test_cache_eviction(bool debug = false)
+{
+  SQL sql;
+  make_people(sql, "cacheevict");
+  sql.enableQueryCache(2);
+  selected(sql, "select * from cacheevict where age = 30");
+  selected(sql, "select * from cacheevict where age = 25");
+  //a hit makes age = 30 the most recently used, so age > 20 pushes out age = 25
+  selected(sql, "select * from cacheevict where age = 30");
+  selected(sql, "select * from cacheevict where age > 20");
+  if (sql.queryCache().size() != 2 || sql.queryCache().evictions() != 1)
+    return false;
+  long misses = sql.queryCache().misses();
+  selected(sql, "select * from cacheevict where age = 30");
+  if (sql.queryCache().misses() != misses)
+    return false;
+  if (selected(sql, "select * from cacheevict where age = 25") != vectorlong({1}))
+    return false;
+  if (debug)
+    cout << sql.queryCache();
+  return sql.queryCache().misses() == misses + 1 && sql.queryCache().size() == 2;
+}
+
+bool test_cache_invalidation(bool debug = false)
+{
+  SQL sql;
+  make_people(sql, "cachefresh");
+  sql.enableQueryCache(8);
+  const string select = "select * from cachefresh where age = 30";
+  if (selected(sql, select) != vectorlong({0, 2}))
+    return false;
+
+  //insert
+  sql.command("insert into cachefresh values Dee, 30");
+  if (selected(sql, select) != vectorlong({0, 2, 3}))
+    return false;
+
+  //prepared insert
+  PreparedStatement insert = sql.prepare("insert into cachefresh values ?, ?");
+  insert.bind(1, "Eve");
+  insert.bind(2, "30");
+  sql.execute(insert);
+  if (selected(sql, select) != vectorlong({0, 2, 3, 4}))
+    return false;
+
+  //load
+  {
+    ofstream csv("cachefresh.csv", ios::trunc);
+    csv << "name,age\nFay,30\nGus,19\n";
+  }
+  sql.command("load data from \"cachefresh.csv\" into cachefresh");
+  if (selected(sql, select) != vectorlong({0, 2, 3, 4, 5}))
+    return false;
+
+  //a batch transaction whose select cached its own rows, then rolled back
+  {
+    ofstream script("batch.txt", ios::trunc);
+    script << "insert into cachefresh values Hal, 30;\n" << select << ";\ninsert into nosuchtable values Ivy;\n";
+  }
+  ostringstream silenced;
+  streambuf* cout_buffer = cout.rdbuf(silenced.rdbuf());
+  sql.batch(true);
+  cout.rdbuf(cout_buffer);
+  if (debug)
+    cout << silenced.str();
+  if (silenced.str().find("rolled back") == string::npos || silenced.str().find("records: 6") == string::npos)
+    return false;
+  if (selected(sql, select) != vectorlong({0, 2, 3, 4, 5}))
+    return false;
+
+  //drop, and a new table under the same name
+  sql.command("drop table cachefresh");
+  if (selected(sql, select) != vectorlong(1, -1))
+    return false;
+  sql.command("make table cachefresh fields name, age");
+  sql.command("insert into cachefresh values Jo, 30");
+  if (selected(sql, select) != vectorlong({0}))
+    return false;
+  if (debug)
+    cout << sql.queryCache();
+  sql.command("drop table cachefresh");
+  return sql.queryCache().invalidations() > 0;
+}
+
+// ==============================
+// global BAD!
+bool debug = false;
+// ==============================
+
+TEST(QUERY_CACHE, Hits) {
+  EXPECT_EQ(test_cache_hits(debug), true);
+}
+
+TEST(QUERY_CACHE, Eviction) {
+  EXPECT_EQ(test_cache_eviction(debug), true);
+}
+
+TEST(QUERY_CACHE, Invalidation) {
+  EXPECT_EQ(test_cache_invalidation(debug), true);
+}
+
+int main(int argc, char **argv) {
+  if (argc > 1)
+  {
+    debug = !strcmp(argv[1], "debug");
+  }
+
+  ::testing::InitGoogleTest(&argc, argv);
+  std::cout<<"\n\n----------running query_cache_test.cpp---------\n\n"<<std::endl;
+  return RUN_ALL_TESTS();
+}
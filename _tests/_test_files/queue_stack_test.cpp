@@ -0,0 +1,328 @@
+#include "gtest/gtest.h"
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include "../../includes/Table/table.h"
+#include "../../includes/Queue/Queue.h"
+#include "../../includes/Stack/Stack.h"
+#include "../../includes/ShuntingYardAlgorithm/ShuntingYardAlgo.h"
+#include "../../includes/DoublyLinkedList/DoublyLinkedList.h"
+using namespace std;
+
+//queue and stack: the queue's ring keeps its items in order as its head wraps around the array
+//and the array grows, the stack stays in its inline array until it outgrows it, and both keep
+//their items through copies and moves
+
+const int BENCH_REPEATS = 20000;
+
+//heap allocations made while counting_allocations is set
+long allocations = 0;
+bool counting_allocations = false;
+
+void* operator new(size_t size)
+{
+  if (counting_allocations)
+    allocations++;
+  void* p = malloc(size ? size : 1);
+  if (!p)
+    throw bad_alloc();
+  return p;
+}
+
+void operator delete(void* p) noexcept
+{
+  free(p);
+}
+
+double elapsed_ns(chrono::steady_clock::time_point start)
+{
+  return chrono::duration<double, nano>(chrono::steady_clock::now() - start).count();
+}
+
+vectorstr items(const Queue<string>& q)
+{
+  vectorstr walked;
+  for (Queue<string>::Iterator it = q.begin(); it != q.end(); ++it)
+    walked.push_back(*it);
+  return walked;
+}
+
+//a full ring of capacity slots holding the numbers from first on, its head at slot head: the
+//slots fill and the head moves to head with placeholders, then each placeholder popped makes
+//room for a number
+Queue<string> wrapped(int capacity, int head, int first = 0)
+{
+  Queue<string> q;
+  for (int i = 0; i < capacity; i++)
+    q.push("");
+  for (int i = 0; i < head; i++)
+  {
+    q.pop();
+    q.push("");
+  }
+  for (int i = 0; i < capacity; i++)
+  {
+    q.pop();
+    q.push(to_string(first + i));
+  }
+  return q;
+}
+
+vectorstr numbers(int size, int first = 0)
+{
+  vectorstr want;
+  for (int i = 0; i < size; i++)
+    want.push_back(to_string(first + i));
+  return want;
+}
+
+bool test_queue_order(bool debug = false)
+{
+  //pushes and pops interleaved, the ring wraps around and grows while full
+  Queue<string> q;
+  vectorstr want;
+  for (int i = 0; i < 1000; i++)
+  {
+    q.push(to_string(i));
+    want.push_back(to_string(i));
+    if (i % 3 == 0)
+    {
+      if (q.pop() != want.front())
+        return false;
+      want.erase(want.begin());
+    }
+  }
+  if (items(q) != want || q.size() != want.size() || q.front() != want.front() || q.back() != want.back())
+    return false;
+  q.clear();
+  q.push(q.empty() ? "again" : "");
+  return q.size() == 1 && q.front() == "again";
+}
+
+bool test_queue_wraparound(bool debug = false)
+{
+  //a full ring whose head is at every slot grows by one push, the items unwrapped in order
+  for (int capacity = 8; capacity <= 32; capacity *= 2)
+  {
+    for (int head = 0; head < capacity; head++)
+    {
+      Queue<string> q = wrapped(capacity, head);
+      if (debug && head == capacity - 1)
+        q.print_pointers();
+      if (q.capacity() != capacity || items(q) != numbers(capacity))
+        return false;
+      //the item pushed is the queue's own front, in the array being replaced
+      q.push(*q.begin());
+      vectorstr want = numbers(capacity);
+      want.push_back("0");
+      if (q.capacity() != 2 * capacity || items(q) != want || q.back() != "0")
+        return false;
+      for (int i = 0; i < want.size(); i++)
+        if (q.pop() != want[i])
+          return false;
+      if (!q.empty())
+        return false;
+    }
+  }
+  return true;
+}
+
+bool test_queue_copy_move(bool debug = false)
+{
+  //copies and moves of a wrapped ring, into empty queues and over ones holding items
+  Queue<string> q = wrapped(8, 5, 100);
+  vectorstr want = numbers(8, 100);
+  Queue<string> copy(q);
+  Queue<string> moved(std::move(copy));
+  if (items(copy) != vectorstr() || items(moved) != want || items(q) != want)
+    return false;
+  //a moved from queue takes items again
+  copy.push("x");
+  if (copy.size() != 1 || copy.front() != "x")
+    return false;
+
+  //assigned over a smaller and a bigger array, and onto itself
+  Queue<string> small = wrapped(8, 3);
+  Queue<string> big = wrapped(32, 20);
+  small = q;
+  big = q;
+  Queue<string>& same = big;
+  big = same;
+  if (items(small) != want || items(big) != want || big.capacity() != 32)
+    return false;
+  big.push("more");
+  want.push_back("more");
+  if (items(big) != want)
+    return false;
+  Queue<string> taken = wrapped(8, 1);
+  taken = std::move(big);
+  big = std::move(big);
+  if (items(taken) != want || !big.empty() || taken.back() != "more")
+    return false;
+
+  //the shunting yard takes its infix queue by move, a wrapped one converts as a copy of it does
+  TokenStr a("a");
+  TokenStr b("b");
+  Relational equals("=");
+  Queue<Token*> infix;
+  for (int i = 0; i < 6; i++)
+  {
+    infix.push(&a);
+    infix.pop();
+  }
+  infix.push(&a);
+  infix.push(&equals);
+  infix.push(&b);
+  ShuntingYard copied_yard(infix);
+  ShuntingYard moved_yard(std::move(infix));
+  Queue<Token*> copied_postfix = copied_yard.postfix();
+  Queue<Token*> moved_postfix = moved_yard.postfix();
+  if (!infix.empty() || moved_postfix.size() != 3 || copied_postfix.size() != 3)
+    return false;
+  for (Queue<Token*>::Iterator c = copied_postfix.begin(), m = moved_postfix.begin(); c != copied_postfix.end(); ++c, ++m)
+    if (*c != *m)
+      return false;
+  return moved_postfix.back() == &equals;
+}
+
+bool test_stack(bool debug = false)
+{
+  //the stack walks from its top, and stays in its own array until it outgrows it
+  Stack<string> st;
+  for (int i = 0; i < 100; i++)
+  {
+    st.push(to_string(i));
+    if (st.is_inline() != (i < STACK_INLINE))
+      return false;
+  }
+  Stack<string> st_copy(st);
+  Stack<string> st_moved(std::move(st_copy));
+  int expect = 99;
+  for (Stack<string>::Iterator it = st_moved.begin(); it != st_moved.end(); ++it, expect--)
+  {
+    if (*it != to_string(expect))
+      return false;
+  }
+  while (!st.empty())
+  {
+    string top = st.pop();
+    if (top != to_string(st.size()))
+      return false;
+  }
+  Stack<string> small;
+  small.push("a");
+  small.push("b");
+  Stack<string> small_moved(std::move(small));
+  if (expect != -1 || !st_copy.empty() || !small.empty() || small_moved.top() != "b" || small_moved.size() != 2)
+    return false;
+
+  //a where clause's operator stack allocates nothing
+  Stack<Token*> operators;
+  allocations = 0;
+  counting_allocations = true;
+  for (int i = 0; i < STACK_INLINE; i++)
+    operators.push(NULL);
+  while (!operators.empty())
+    operators.pop();
+  counting_allocations = false;
+  return allocations == 0;
+}
+
+bool bench_queue_stack(bool debug = false)
+{
+  //the queue and stack traffic of converting one 15 token where clause, on linked nodes and on arrays
+  const int tokens = 15;
+  const int repeats = BENCH_REPEATS * 10;
+  Token token;
+  long checksum = 0;
+  chrono::steady_clock::time_point start = chrono::steady_clock::now();
+  for (int r = 0; r < repeats; r++)
+  {
+    node<Token*>* front = nullptr;
+    node<Token*>* rear = nullptr;
+    node<Token*>* top = nullptr;
+    for (int i = 0; i < tokens; i++)
+    {
+      rear = front ? _insert_after(front, rear, &token) : _insert_head(front, &token);
+      if (i % 2)
+        _insert_head(top, &token);
+    }
+    node<Token*>* copy = nullptr;
+    _copy_list(copy, front);
+    while (top)
+      checksum += _remove_head(top) == &token;
+    while (front)
+      checksum += _remove_head(front) == &token;
+    _clear_list(copy);
+  }
+  double list_ns = elapsed_ns(start) / repeats;
+  start = chrono::steady_clock::now();
+  for (int r = 0; r < repeats; r++)
+  {
+    Queue<Token*> infix;
+    Stack<Token*> operators;
+    for (int i = 0; i < tokens; i++)
+    {
+      infix.push(&token);
+      if (i % 2)
+        operators.push(&token);
+    }
+    Queue<Token*> moved(std::move(infix));
+    while (!operators.empty())
+      checksum -= operators.pop() == &token;
+    while (!moved.empty())
+      checksum -= moved.pop() == &token;
+  }
+  double array_ns = elapsed_ns(start) / repeats;
+  cout << "queue + stack   nodes: " << fixed << setprecision(3) << list_ns << " ns/condition\n";
+  cout << "queue + stack  arrays: " << fixed << setprecision(3) << array_ns << " ns/condition\n";
+
+  //and the whole conversion into a plan, tokens from an arena
+  Table employees("parser_bench_employee", {"last", "dep", "salary", "year"});
+  vectorstr condition = {"(", "dep", "=", "CS", "or", "dep", "=", "HR", ")", "and", "salary", ">=", "100000", "and", "not",
+                         "year", "<", "2015"};
+  start = chrono::steady_clock::now();
+  for (int r = 0; r < BENCH_REPEATS; r++)
+    checksum += employees.compile_condition(condition).size() - 8;
+  cout << "compile condition    : " << fixed << setprecision(3) << elapsed_ns(start) / BENCH_REPEATS / 1000 << " us/condition\n";
+  return checksum == 0;
+}
+
+// ==============================
+// global BAD!
+bool debug = false;
+// ==============================
+
+TEST(QUEUE_STACK, QueueOrder) {
+  EXPECT_EQ(test_queue_order(debug), true);
+}
+
+TEST(QUEUE_STACK, QueueWraparound) {
+  EXPECT_EQ(test_queue_wraparound(debug), true);
+}
+
+TEST(QUEUE_STACK, QueueCopyMove) {
+  EXPECT_EQ(test_queue_copy_move(debug), true);
+}
+
+TEST(QUEUE_STACK, Stack) {
+  EXPECT_EQ(test_stack(debug), true);
+}
+
+TEST(QUEUE_STACK, BenchQueueStack) {
+  EXPECT_EQ(bench_queue_stack(debug), true);
+}
+
+int main(int argc, char **argv) {
+  if (argc > 1)
+  {
+    debug = !strcmp(argv[1], "debug");
+  }
+
+  ::testing::InitGoogleTest(&argc, argv);
+  std::cout<<"\n\n----------running queue_stack_test.cpp---------\n\n"<<std::endl;
+  return RUN_ALL_TESTS();
+}
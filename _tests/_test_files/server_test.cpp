@@ -0,0 +1,257 @@
+#include "gtest/gtest.h"
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <thread>
+#include <algorithm>
+#include <chrono>
+#include <sys/stat.h>
+#include "../../includes/sql/sql.h"
+#include "../../includes/Server/server.h"
+#include "../../includes/Server/client.h"
+using namespace std;
+
+//stealthd: frames survive being cut anywhere, clients talking to one server at once all get
+//their own answers back, a result's files go once it is sent and a client that hangs up still
+//has what it sent run
+
+const char* TEST_SOCKET = "server_test.sock";
+const int TEST_CLIENTS = 8;
+const int TEST_ROWS = 50;
+#ifdef __linux__
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#endif
+
+bool test_wire_frames(bool debug = false)
+{
+  string bytes;
+  wire_put_text(bytes, WIRE_QUERY, "select * from t");
+  wire_put_strings(bytes, WIRE_FIELDS, {"name", "age"});
+  wire_put_strings(bytes, WIRE_ROW, {string(300, 'x'), ""});
+  wire_put_done(bytes, 1);
+  //fed a byte at a time the reader hands back the same frames as fed all at once
+  WireReader reader;
+  vector<WireMessage> messages;
+  WireMessage message;
+  for (int i = 0; i < bytes.size(); i++)
+  {
+    reader.append(&bytes[i], 1);
+    while (reader.next(message))
+      messages.push_back(message);
+  }
+  if (messages.size() != 4 || reader.pending() != 0 || reader.failed())
+    return false;
+  vectorstr values;
+  const string& row = messages[2].body;
+  if (messages[0].type != WIRE_QUERY || messages[0].body != "select * from t" || messages[2].type != WIRE_ROW
+      || !wire_get_strings(row.data(), row.data() + row.size(), values) || values != vectorstr({string(300, 'x'), ""}))
+    return false;
+  //a row cut short is refused
+  if (wire_get_strings(row.data(), row.data() + row.size() - 1, values))
+    return false;
+  //a frame longer than the limit breaks the reader
+  string huge;
+  wire_put_varint(huge, WIRE_MAX_FRAME + 1);
+  reader.append(huge.data(), huge.size());
+  return !reader.next(message) && reader.failed();
+}
+
+bool test_server_clients(bool debug = false)
+{
+  SQL sql;
+  StealthServer server(sql, 3);
+  if (!server.listen_unix(TEST_SOCKET))
+  {
+    cout << server.error() << "\n";
+    return false;
+  }
+  //the server's SQL prints like the REPL does
+  ostringstream silenced;
+  streambuf* cout_buffer = cout.rdbuf(silenced.rdbuf());
+  thread serving(&StealthServer::run, &server);
+
+  StealthClient setup;
+  ClientResult result;
+  bool ok = setup.connect_unix(TEST_SOCKET);
+  ok = ok && setup.query("drop table servertest", result);
+  ok = ok && setup.query("make table servertest fields client, n", result) && !result.failed;
+  //every client inserts its rows and reads back only its own, all at once
+  vector<int> passed(TEST_CLIENTS, 0);
+  vector<thread> clients;
+  for (int c = 0; c < TEST_CLIENTS && ok; c++)
+    clients.push_back(thread([c, &passed]() {
+      StealthClient client;
+      ClientResult result;
+      if (!client.connect_unix(TEST_SOCKET))
+        return;
+      for (int i = 0; i < TEST_ROWS; i++)
+        if (!client.query("insert into servertest values " + to_string(c) + ", " + to_string(i), result) || result.failed)
+          return;
+      long streamed = 0;
+      if (!client.query("select n from servertest where client = " + to_string(c), result,
+                        [&streamed](const vectorstr& row) {streamed++;}))
+        return;
+      if (result.fields != vectorstr({"n"}) || result.row_count != TEST_ROWS || streamed != TEST_ROWS)
+        return;
+      passed[c] = 1;
+    }));
+  for (int c = 0; c < clients.size(); c++)
+    clients[c].join();
+  for (int c = 0; c < TEST_CLIENTS; c++)
+    ok = ok && passed[c];
+  //everything every client inserted is there
+  ok = ok && setup.query("select * from servertest", result) && result.row_count == TEST_CLIENTS * TEST_ROWS;
+  if (ok)
+  {
+    vectorstr row = result.rows[0];
+    ok = result.fields == vectorstr({"client", "n"}) && row.size() == 2;
+  }
+  //a bad command is answered with its error and the connection stays usable
+  ok = ok && setup.query("select * from nosuchtable", result) && result.failed && result.error.find('\033') == string::npos;
+  ok = ok && setup.query("select n from servertest where client = 3 and n = 7", result) && !result.failed && result.rows == vector<vectorstr>({{"7"}});
+  setup.query("drop table servertest", result);
+  setup.disconnect();
+
+  server.stop();
+  serving.join();
+  cout.rdbuf(cout_buffer);
+  if (debug)
+    cout << "commands: " << server.commands() << "\n";
+  return ok && server.commands() == 2 + TEST_CLIENTS * (TEST_ROWS + 1) + 4;
+}
+
+bool file_exists(const string& name)
+{
+  struct stat info;
+  return stat(name.c_str(), &info) == 0;
+}
+
+bool result_files_exist(int serial)
+{
+  string name = "serverresult_" + to_string(serial);
+  return file_exists(name + "_fields.txt") || file_exists(name + "_fields.bin");
+}
+
+#ifdef __linux__
+//sends the commands on a socket of its own and hangs up without waiting for a reply
+bool send_and_hang_up(const vectorstr& commands)
+{
+  sockaddr_un address;
+  memset(&address, 0, sizeof(address));
+  address.sun_family = AF_UNIX;
+  strcpy(address.sun_path, TEST_SOCKET);
+  int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+  if (fd < 0 || connect(fd, (sockaddr*)&address, sizeof(address)) != 0)
+    return false;
+  string frames;
+  for (int i = 0; i < commands.size(); i++)
+    wire_put_text(frames, WIRE_QUERY, commands[i]);
+  bool sent = write(fd, frames.data(), frames.size()) == frames.size();
+  close(fd);
+  return sent;
+}
+#endif
+
+bool test_server_results(bool debug = false)
+{
+  SQL sql;
+  StealthServer server(sql, 2);
+  if (!server.listen_unix(TEST_SOCKET))
+  {
+    cout << server.error() << "\n";
+    return false;
+  }
+  ostringstream silenced;
+  streambuf* cout_buffer = cout.rdbuf(silenced.rdbuf());
+  thread serving(&StealthServer::run, &server);
+
+  StealthClient client;
+  ClientResult result;
+  bool ok = client.connect_unix(TEST_SOCKET);
+  ok = ok && client.query("drop table serverresult", result);
+  ok = ok && client.query("make table serverresult fields name, n", result) && !result.failed;
+  //a table made is the table itself, it is kept
+  ok = ok && file_exists("serverresult_fields.bin");
+  string values;
+  for (int i = 0; i < 3000; i++)
+    values += string(i ? ", " : "") + "(row, " + to_string(i) + ")";
+  ok = ok && client.query("insert into serverresult values " + values, result) && !result.failed;
+  //a result bigger than a reply chunk comes in frames, and its files are gone once it is sent
+  long streamed = 0;
+  ok = ok && client.query("select * from serverresult where n >= 1000", result, [&streamed](const vectorstr& row) {streamed++;});
+  ok = ok && !result.failed && result.row_count == streamed && streamed > 0 && !result_files_exist(Table::serial);
+  //an explain's plan is a result too
+  ok = ok && client.query("explain select * from serverresult", result) && !result.failed && !result_files_exist(Table::serial);
+  //a select the cache answers from keeps its result's files, a hit reads them again; the server
+  //is between commands, its SQL can be set up from here
+  sql.enableQueryCache(4);
+  ok = ok && client.query("select name from serverresult where n = 7", result) && result.rows == vector<vectorstr>({{"row"}});
+  int cached = Table::serial;
+  ok = ok && result_files_exist(cached);
+  ok = ok && client.query("select name from serverresult where n = 7", result) && result.rows == vector<vectorstr>({{"row"}});
+  ok = ok && Table::serial == cached && result_files_exist(cached);
+  //and once the cache lets go of it, by a write to its table or by evicting it, its files go too
+  ok = ok && client.query("insert into serverresult values kept, 7", result) && !result.failed && !result_files_exist(cached);
+  sql.enableQueryCache(1);
+  ok = ok && client.query("select name from serverresult where n = 7", result) && result.rows.size() == 2;
+  int evicted = Table::serial;
+  ok = ok && client.query("select name from serverresult where n = 8", result) && !result_files_exist(evicted);
+  ok = ok && result_files_exist(Table::serial);
+
+#ifdef __linux__
+  //commands sent right before hanging up are read and run
+  vectorstr inserts;
+  for (int i = 0; i < 20; i++)
+    inserts.push_back("insert into serverresult values gone, " + to_string(i));
+  ok = ok && send_and_hang_up(inserts);
+  long gone = 0;
+  for (int tries = 0; ok && tries < 500 && gone != 20; tries++)
+  {
+    ok = client.query("select n from serverresult where name = gone", result) && !result.failed;
+    gone = result.row_count;
+    if (gone != 20)
+      this_thread::sleep_for(chrono::milliseconds(10));
+  }
+  if (debug)
+    cout << gone << " rows inserted by a client that hung up\n";
+  ok = ok && gone == 20;
+#endif
+  client.query("drop table serverresult", result);
+  client.disconnect();
+  server.stop();
+  serving.join();
+  cout.rdbuf(cout_buffer);
+  return ok;
+}
+
+// ==============================
+// global BAD!
+bool debug = false;
+// ==============================
+
+TEST(SERVER, WireFrames) {
+  EXPECT_EQ(test_wire_frames(debug), true);
+}
+
+#ifdef __linux__
+TEST(SERVER, ServerClients) {
+  EXPECT_EQ(test_server_clients(debug), true);
+}
+
+TEST(SERVER, ServerResults) {
+  EXPECT_EQ(test_server_results(debug), true);
+}
+#endif
+
+int main(int argc, char **argv) {
+  if (argc > 1)
+  {
+    debug = !strcmp(argv[1], "debug");
+  }
+
+  ::testing::InitGoogleTest(&argc, argv);
+  std::cout<<"\n\n----------running server_test.cpp---------\n\n"<<std::endl;
+  return RUN_ALL_TESTS();
+}
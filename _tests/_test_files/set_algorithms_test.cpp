@@ -0,0 +1,198 @@
+#include "gtest/gtest.h"
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+#include "random"
+#include "../../includes/SortingAlgorithms/SetAlgorithms.h"
+using namespace std;
+
+//sorted list operations: the galloping intersection and difference give what the std algorithms
+//give, on both sides of GALLOP_RATIO and at the ends of the lists where a gallop runs off
+
+//count distinct values below range, ascending
+vector<long> random_sorted(mt19937& random, int count, long range)
+{
+  set<long> values;
+  while (values.size() < count && values.size() < range)
+    values.insert(random() % range);
+  return vector<long>(values.begin(), values.end());
+}
+
+bool test_gallop_lower_bound(bool debug = false)
+{
+  const vector<long> a = {2, 4, 6, 8, 10, 12, 14, 16, 18, 20};
+  const unsigned int size = a.size();
+  //every key from below the first value to past the last, from every start
+  for (unsigned int lo = 0; lo <= size; lo++)
+  {
+    for (long key = 0; key <= 22; key++)
+    {
+      unsigned int want = lower_bound(a.begin() + lo, a.end(), key) - a.begin();
+      if (gallop_lower_bound(&a[0], lo, size, key) != want)
+      {
+        if (debug)
+          cout << "lo " << lo << " key " << key << "\n";
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+bool test_intersection_edges(bool debug = false)
+{
+  vector<long> result;
+  vector<long> large;
+  for (long i = 0; i < 1000; i++)
+    large.push_back(i * 2);
+  //small sides that gallop off the end, sit before the start, match at both ends or not at all
+  vector<vector<long> > smalls = {{}, {-1}, {5000}, {0}, {1998}, {0, 1998}, {1, 3, 1997}, {-5, 0, 999, 1000, 1998, 2000}};
+  for (int i = 0; i < smalls.size(); i++)
+  {
+    vector<long> want;
+    set_intersection(smalls[i].begin(), smalls[i].end(), large.begin(), large.end(), back_inserter(want));
+    sorted_intersection(smalls[i], large, result);
+    if (result != want)
+      return false;
+    //either argument order
+    sorted_intersection(large, smalls[i], result);
+    if (result != want)
+      return false;
+  }
+  sorted_intersection(large, large, result);
+  return result == large;
+}
+
+bool test_difference_edges(bool debug = false)
+{
+  vector<long> result;
+  vector<long> large;
+  for (long i = 0; i < 1000; i++)
+    large.push_back(i * 2);
+  vector<vector<long> > smalls = {{}, {-1}, {5000}, {0}, {1998}, {1, 3, 1997}, {-5, 0, 999, 1000, 1998, 2000}};
+  for (int i = 0; i < smalls.size(); i++)
+  {
+    //a much smaller than b gallops, b much smaller than a walks
+    vector<long> want;
+    set_difference(smalls[i].begin(), smalls[i].end(), large.begin(), large.end(), back_inserter(want));
+    sorted_difference(smalls[i], large, result);
+    if (result != want)
+      return false;
+    want.clear();
+    set_difference(large.begin(), large.end(), smalls[i].begin(), smalls[i].end(), back_inserter(want));
+    sorted_difference(large, smalls[i], result);
+    if (result != want)
+      return false;
+  }
+  sorted_difference(large, large, result);
+  return result.empty();
+}
+
+bool test_random_sets(bool debug = false)
+{
+  mt19937 random(29);
+  vector<long> result;
+  vector<long> want;
+  //size ratios from even to far past GALLOP_RATIO, dense and sparse
+  for (int round = 0; round < 500; round++)
+  {
+    int a_size = random() % 40;
+    int b_size = random() % (round % 2 ? 40 : 2000);
+    long range = round % 3 ? 4000 : 100;
+    vector<long> a = random_sorted(random, a_size, range);
+    vector<long> b = random_sorted(random, b_size, range);
+    want.clear();
+    set_intersection(a.begin(), a.end(), b.begin(), b.end(), back_inserter(want));
+    sorted_intersection(a, b, result);
+    if (result != want)
+      return false;
+    want.clear();
+    set_difference(a.begin(), a.end(), b.begin(), b.end(), back_inserter(want));
+    sorted_difference(a, b, result);
+    if (result != want)
+      return false;
+    want.clear();
+    set_union(a.begin(), a.end(), b.begin(), b.end(), back_inserter(want));
+    sorted_union(a, b, result);
+    if (result != want)
+      return false;
+  }
+  return true;
+}
+
+bool test_complement_and_k_way(bool debug = false)
+{
+  vector<long> result;
+  sorted_complement(vector<long>({1, 2, 5}), 7L, result);
+  if (result != vector<long>({0, 3, 4, 6}))
+    return false;
+  //limit, an empty list, a list covering everything and values past the universe
+  sorted_complement(vector<long>({1, 2, 5}), 7L, result, 2);
+  if (result != vector<long>({0, 3}))
+    return false;
+  sorted_complement(vector<long>(), 3L, result);
+  if (result != vector<long>({0, 1, 2}))
+    return false;
+  sorted_complement(vector<long>({0, 1, 2}), 3L, result);
+  if (!result.empty())
+    return false;
+  sorted_complement(vector<long>({1, 8, 9}), 4L, result);
+  if (result != vector<long>({0, 2, 3}))
+    return false;
+
+  mt19937 random(7);
+  for (int round = 0; round < 100; round++)
+  {
+    //empty runs, one run, two runs and many overlapping runs
+    int count = round % 7;
+    vector<vector<long> > runs(count);
+    vector<const vector<long>*> pointers;
+    set<long> want;
+    for (int i = 0; i < count; i++)
+    {
+      runs[i] = random_sorted(random, random() % 30, 60);
+      want.insert(runs[i].begin(), runs[i].end());
+      pointers.push_back(&runs[i]);
+    }
+    k_way_union(pointers, result);
+    if (result != vector<long>(want.begin(), want.end()))
+      return false;
+  }
+  return true;
+}
+
+// ==============================
+// global BAD!
+bool debug = false;
+// ==============================
+
+TEST(SET_ALGORITHMS, GallopLowerBound) {
+  EXPECT_EQ(test_gallop_lower_bound(debug), true);
+}
+
+TEST(SET_ALGORITHMS, IntersectionEdges) {
+  EXPECT_EQ(test_intersection_edges(debug), true);
+}
+
+TEST(SET_ALGORITHMS, DifferenceEdges) {
+  EXPECT_EQ(test_difference_edges(debug), true);
+}
+
+TEST(SET_ALGORITHMS, RandomSets) {
+  EXPECT_EQ(test_random_sets(debug), true);
+}
+
+TEST(SET_ALGORITHMS, ComplementAndKWay) {
+  EXPECT_EQ(test_complement_and_k_way(debug), true);
+}
+
+int main(int argc, char **argv) {
+  if (argc > 1)
+  {
+    debug = !strcmp(argv[1], "debug");
+  }
+
+  ::testing::InitGoogleTest(&argc, argv);
+  std::cout<<"\n\n----------running set_algorithms_test.cpp---------\n\n"<<std::endl;
+  return RUN_ALL_TESTS();
+}
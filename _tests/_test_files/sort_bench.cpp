@@ -0,0 +1,204 @@
+#include "gtest/gtest.h"
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <algorithm>
+#include "random"
+#include "../../includes/SortingAlgorithms/SortAlgorithms.h"
+#include "../../includes/SortingAlgorithms/RecnoSort.h"
+using namespace std;
+
+//the recno sorts have to agree with std::sort on every shape of input, and the timings print
+//what each of them costs per recno at the sizes a where clause hands them
+
+double elapsed_ns(chrono::steady_clock::time_point start)
+{
+  return chrono::duration<double, nano>(chrono::steady_clock::now() - start).count();
+}
+
+enum recno_shapes {SHAPE_RANDOM, SHAPE_SORTED, SHAPE_REVERSED, SHAPE_RUNS, SHAPE_DUPLICATES, SHAPE_COUNT};
+const char* shape_name(int shape)
+{
+  const char* names[] = {"random", "sorted", "reversed", "8 runs", "duplicates"};
+  return names[shape];
+}
+
+//recnos 0 .. size - 1 in the given shape, runs are what an index probe of 8 keys gives
+vector<long> make_recnos(int shape, int size, mt19937_64& random)
+{
+  vector<long> recnos(size);
+  for (int i = 0; i < size; i++)
+    recnos[i] = i;
+  if (shape == SHAPE_REVERSED)
+    reverse(recnos.begin(), recnos.end());
+  else if (shape == SHAPE_RANDOM || shape == SHAPE_RUNS)
+  {
+    shuffle(recnos.begin(), recnos.end(), random);
+    if (shape == SHAPE_RUNS)
+      for (int r = 0; r < 8; r++)
+        sort(recnos.begin() + (long)size * r / 8, recnos.begin() + (long)size * (r + 1) / 8);
+  }
+  else if (shape == SHAPE_DUPLICATES)
+    for (int i = 0; i < size; i++)
+      recnos[i] = random() % 10;
+  return recnos;
+}
+
+bool test_radix_sort(bool debug = false)
+{
+  mt19937_64 random(41);
+  for (int size = 0; size < 600; size += 13)
+  {
+    //small values, values past 32 bits and values that only differ in their top byte
+    long masks[] = {0xff, 0xffffffffffL, 0x7f00000000000000L};
+    for (int m = 0; m < 3; m++)
+    {
+      vector<long> values(size);
+      for (int i = 0; i < size; i++)
+        values[i] = random() & masks[m];
+      vector<long> want = values;
+      sort(want.begin(), want.end());
+      radix_sort(values.empty() ? NULL : &values[0], size);
+      if (values != want)
+      {
+        cout << "radix_sort wrong for " << size << " values under mask " << hex << masks[m] << dec << "\n";
+        return false;
+      }
+    }
+  }
+  //a negative value leaves it to std::sort
+  long negatives[] = {5, -3, 0, -9, 7};
+  radix_sort(negatives, 5);
+  if (!is_sorted(negatives, negatives + 5))
+    return false;
+  if (debug)
+    cout << "radix_sort agrees with std::sort\n";
+  return true;
+}
+
+bool test_sort_recnos(bool debug = false)
+{
+  mt19937_64 random(41);
+  int sizes[] = {0, 1, 2, 5, 63, 64, 65, 500, 4000, int(PARALLEL_SORT_MIN) + 17};
+  for (int s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++)
+    for (int shape = 0; shape < SHAPE_COUNT; shape++)
+      for (int threads = 1; threads <= 4; threads += 3)
+      {
+        vector<long> recnos = make_recnos(shape, sizes[s], random);
+        vector<long> want = recnos;
+        sort(want.begin(), want.end());
+        sort_recnos(recnos, threads);
+        if (recnos != want)
+        {
+          cout << "sort_recnos wrong for " << sizes[s] << " " << shape_name(shape) << " recnos on " << threads << " threads\n";
+          return false;
+        }
+      }
+  if (debug)
+    cout << "sort_recnos agrees with std::sort\n";
+  return true;
+}
+
+//sorted by key alone, so equal keys show whether a sort kept their order
+struct KeyedRow
+{
+  int key;
+  int row;
+  bool operator <(const KeyedRow& other) const { return key < other.key; }
+};
+
+bool test_parallel_merge_sort(bool debug = false)
+{
+  mt19937_64 random(41);
+  int sizes[] = {0, 1, 1000, int(PARALLEL_SORT_MIN) * 2 + 3};
+  for (int s = 0; s < 4; s++)
+    for (int threads = 1; threads <= 5; threads += 2)
+    {
+      vector<KeyedRow> rows(sizes[s]);
+      for (int i = 0; i < sizes[s]; i++)
+      {
+        rows[i].key = random() % 100;
+        rows[i].row = i;
+      }
+      parallel_merge_sort(rows.empty() ? NULL : &rows[0], rows.size(), threads);
+      for (int i = 1; i < rows.size(); i++)
+        if (rows[i].key < rows[i - 1].key || (rows[i].key == rows[i - 1].key && rows[i].row < rows[i - 1].row))
+        {
+          cout << "parallel_merge_sort out of order at " << i << " of " << sizes[s] << " on " << threads << " threads\n";
+          return false;
+        }
+    }
+  if (debug)
+    cout << "parallel_merge_sort is stable\n";
+  return true;
+}
+
+void std_sort(long a[], unsigned int size) { sort(a, a + size); }
+void recno_sort(long a[], unsigned int size) { sort_recnos(a, size); }
+
+bool bench_sort_recnos(bool debug = false)
+{
+  const char* names[] = {"std::sort", "merge_sort", "radix_sort", "sort_recnos"};
+  void (*sorts[])(long[], unsigned int) = {std_sort, merge_sort<long>, radix_sort, recno_sort};
+  mt19937_64 random(41);
+  int sizes[] = {1000, 100000, 1000000};
+  for (int s = 0; s < 3; s++)
+    for (int shape = 0; shape < SHAPE_COUNT; shape++)
+    {
+      vector<long> input = make_recnos(shape, sizes[s], random);
+      vector<long> want = input;
+      sort(want.begin(), want.end());
+      //about 2 million recnos sorted per timing
+      int repeats = 2000000 / sizes[s];
+      cout << setw(8) << sizes[s] << " " << setw(10) << shape_name(shape) << ":";
+      for (int f = 0; f < 4; f++)
+      {
+        vector<long> recnos;
+        double ns = 0;
+        for (int r = 0; r < repeats; r++)
+        {
+          recnos = input;
+          chrono::steady_clock::time_point start = chrono::steady_clock::now();
+          sorts[f](&recnos[0], recnos.size());
+          ns += elapsed_ns(start);
+        }
+        cout << "  " << names[f] << " " << fixed << setprecision(2) << ns / repeats / sizes[s] << " ns";
+        if (recnos != want)
+          return false;
+      }
+      cout << "\n";
+    }
+  return true;
+}
+
+// ==============================
+// global BAD!
+bool debug = false;
+// ==============================
+
+TEST(SORT, RadixSort) {
+  EXPECT_EQ(test_radix_sort(debug), true);
+}
+
+TEST(SORT, SortRecnos) {
+  EXPECT_EQ(test_sort_recnos(debug), true);
+}
+
+TEST(SORT, ParallelMergeSort) {
+  EXPECT_EQ(test_parallel_merge_sort(debug), true);
+}
+
+TEST(SORT, BenchSortRecnos) {
+  EXPECT_EQ(bench_sort_recnos(debug), true);
+}
+
+int main(int argc, char **argv) {
+  if (argc > 1)
+  {
+    debug = !strcmp(argv[1], "debug");
+  }
+
+  ::testing::InitGoogleTest(&argc, argv);
+  std::cout<<"\n\n----------running sort_bench.cpp---------\n\n"<<std::endl;
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,163 @@
+#include "gtest/gtest.h"
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <fstream>
+#include <cstring>
+#include "../../includes/Tokenizer/statement_splitter.h"
+#include "../../includes/Parser/typedefs.h"
+using namespace std;
+
+//statement splitter: a script streams through an FTokenizer a block at a time and comes out as
+//the same statements whatever the block size, ended by ; or, in a script without them, by lines
+
+const char* SPLIT_COMMANDS[] = {
+  "select * from employee",
+  "select lname, fname, salary from employee where dep = CS and salary >= 100000 order by lname limit 10",
+  "insert into employee values Blow, Joe, CS, 100000, 2018",
+  "make table employee fields last, first, dep, salary, year"
+};
+const int SPLIT_COMMAND_COUNT = sizeof(SPLIT_COMMANDS) / sizeof(SPLIT_COMMANDS[0]);
+
+void write_script(const string& file_name, const string& text)
+{
+  ofstream script(file_name.c_str(), ios::binary);
+  script << text;
+}
+
+vectorstr split_script(const string& file_name, int block_size)
+{
+  FTokenizer ftk(file_name, block_size);
+  StatementSplitter splitter(ftk);
+  vectorstr statements;
+  string statement;
+  while (splitter.next(statement))
+    statements.push_back(statement);
+  return statements;
+}
+
+bool test_script_splitter(bool debug = false)
+{
+  //statements span lines and blocks, a ; in quotes is a value and a script without ; goes by lines
+  string script = "make table t fields a,\n  b;\r\ninsert into t values \"x; y\", 'it''s';;\n"
+                  "select * from t_1\n  where a = \"x; y\" ;\n\nselect a from t";
+  vectorstr want = {"make table t fields a,\n  b", "insert into t values \"x; y\", 'it''s'",
+                    "select * from t_1\n  where a = \"x; y\"", "select a from t"};
+  string lines = "make table t fields a, b\r\n\ninsert into t values \"x; y\", \u00e9\nselect * from t";
+  vectorstr want_lines = {"make table t fields a, b", "insert into t values \"x; y\", \u00e9", "select * from t"};
+  write_script("splitter_script.sql", script);
+  write_script("splitter_lines.sql", lines);
+  for (int block_size = 1; block_size <= 64; block_size++)
+  {
+    //the tokens of every block size add up to the whole file
+    FTokenizer ftk("splitter_script.sql", block_size);
+    string text;
+    SToken t;
+    ftk >> t;
+    while (ftk.more())
+    {
+      if (ftk.pos() != text.size())
+        return false;
+      text.append(t.view().data(), t.view().size());
+      ftk >> t;
+    }
+    if (text != script || split_script("splitter_script.sql", block_size) != want
+        || split_script("splitter_lines.sql", block_size) != want_lines)
+    {
+      cout << "script split differently with " << block_size << " byte blocks\n";
+      return false;
+    }
+  }
+  FTokenizer missing("splitter_no_such_script.sql");
+  return !missing.is_open() && !missing.more() && split_script("splitter_no_such_script.sql", 16).empty();
+}
+
+bool bench_script(bool debug = false)
+{
+  //a script streams through a block at a time, however long it is
+  const int statements = 200000;
+  string script;
+  for (int i = 0; i < statements; i++)
+    script += string(SPLIT_COMMANDS[i % SPLIT_COMMAND_COUNT]) + ";\n";
+  write_script("splitter_big.sql", script);
+  chrono::steady_clock::time_point start = chrono::steady_clock::now();
+  vectorstr split = split_script("splitter_big.sql", FTokenizer::MAX_BLOCK);
+  double split_ns = chrono::duration<double, nano>(chrono::steady_clock::now() - start).count();
+  cout << "split script    : " << fixed << setprecision(3) << split_ns / statements / 1000 << " us/statement, "
+       << split_ns / script.size() << " ns/byte\n";
+  return split.size() == statements && split.back() == SPLIT_COMMANDS[(statements - 1) % SPLIT_COMMAND_COUNT];
+}
+
+bool test_line_fallback(bool debug = false)
+{
+  //a select may go on to its where and ; on the next lines, two whole commands in a row make a
+  //script of lines, where a line that does not parse is still a statement and a ; also ends one
+  const string scripts[] = {
+    "select * from t\n  where a = 1;\nselect b from t\n",
+    "bogus line\nselect a from t\n\nselect b from t\nselect c from t;\nwhere",
+    "drop table t\r\nmake table t fields a, b\ninsert into t values \"x; y\", 'z'"
+  };
+  const vectorstr want[] = {
+    {"select * from t\n  where a = 1", "select b from t"},
+    {"bogus line", "select a from t", "select b from t", "select c from t", "where"},
+    {"drop table t", "make table t fields a, b", "insert into t values \"x; y\", 'z'"}
+  };
+  for (int i = 0; i < sizeof(scripts) / sizeof(scripts[0]); i++)
+  {
+    write_script("splitter_fallback.sql", scripts[i]);
+    for (int block_size = 1; block_size <= 16; block_size++)
+      if (split_script("splitter_fallback.sql", block_size) != want[i])
+      {
+        if (debug)
+          cout << "script " << i << " split differently with " << block_size << " byte blocks\n";
+        return false;
+      }
+  }
+  //a script of lines hands out its first statement with the script read no further than its
+  //second line, however long it is
+  string lines;
+  for (int i = 0; i < 20000; i++)
+    lines += string(SPLIT_COMMANDS[i % SPLIT_COMMAND_COUNT]) + "\n";
+  write_script("splitter_fallback.sql", lines);
+  FTokenizer ftk("splitter_fallback.sql", 64);
+  StatementSplitter splitter(ftk);
+  string first;
+  bool ok = splitter.next(first) && first == SPLIT_COMMANDS[0];
+  long read = ftk.pos();
+  if (debug)
+    cout << read << " of " << lines.size() << " bytes read for the first statement\n";
+  ok = ok && read < strlen(SPLIT_COMMANDS[0]) + strlen(SPLIT_COMMANDS[1]) + 2 + 64;
+  long count = 1;
+  string statement;
+  while (ok && splitter.next(statement))
+    ok = statement == SPLIT_COMMANDS[count++ % SPLIT_COMMAND_COUNT];
+  return ok && count == 20000;
+}
+
+// ==============================
+// global BAD!
+bool debug = false;
+// ==============================
+
+TEST(STATEMENT_SPLITTER, ScriptSplitter) {
+  EXPECT_EQ(test_script_splitter(debug), true);
+}
+
+TEST(STATEMENT_SPLITTER, LineFallback) {
+  EXPECT_EQ(test_line_fallback(debug), true);
+}
+
+TEST(STATEMENT_SPLITTER, BenchScript) {
+  EXPECT_EQ(bench_script(debug), true);
+}
+
+int main(int argc, char **argv) {
+  if (argc > 1)
+  {
+    debug = !strcmp(argv[1], "debug");
+  }
+
+  ::testing::InitGoogleTest(&argc, argv);
+  std::cout<<"\n\n----------running statement_splitter_test.cpp---------\n\n"<<std::endl;
+  return RUN_ALL_TESTS();
+}
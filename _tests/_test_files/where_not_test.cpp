@@ -0,0 +1,128 @@
+#include "gtest/gtest.h"
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <algorithm>
+#include <functional>
+#include "../../includes/sql/sql.h"
+#include "../../includes/ParallelScan/parallel_scan.h"
+using namespace std;
+
+//not, != and <>: every condition selects, through the index probes that merge complements by
+//De Morgan and through a full scan of the records, the rows its truth table says it does
+
+//a and b are 0, 1 or 2 and c is x or y, every combination twice so keys repeat
+const char* TRUTH_TABLE = "truthtable";
+
+struct TruthCase
+{
+  string condition;
+  function<bool(int a, int b, char c)> truth;
+};
+
+vectorstr split_words(const string& text)
+{
+  vectorstr words;
+  istringstream in(text);
+  string word;
+  while (in >> word)
+    words.push_back(word);
+  return words;
+}
+
+bool test_not_truth_table(bool debug = false)
+{
+  SQL sql;
+  sql.command("drop table truthtable");
+  sql.command("make table truthtable fields a, b, c");
+  vector<vector<int> > rows;
+  for (int copy = 0; copy < 2; copy++)
+    for (int a = 0; a < 3; a++)
+      for (int b = 0; b < 3; b++)
+        for (int c = 0; c < 2; c++)
+        {
+          sql.command("insert into truthtable values " + to_string(a) + ", " + to_string(b) + ", " + (c ? "y" : "x"));
+          rows.push_back({a, b, c ? 'y' : 'x'});
+        }
+
+  const vector<TruthCase> cases = {
+    //!= and <> are the same comparison
+    {"a != 1", [](int a, int b, char c) {return a != 1;}},
+    {"a <> 1", [](int a, int b, char c) {return a != 1;}},
+    {"c <> x", [](int a, int b, char c) {return c != 'x';}},
+    {"a != 1 and b <> 1 and c != y", [](int a, int b, char c) {return a != 1 && b != 1 && c != 'y';}},
+    {"a != 0 or b <> 0", [](int a, int b, char c) {return a != 0 || b != 0;}},
+    //not binds tighter than and/or and looser than the comparison it negates
+    {"not a = 1", [](int a, int b, char c) {return a != 1;}},
+    {"not a = 1 and b = 2", [](int a, int b, char c) {return a != 1 && b == 2;}},
+    {"not a = 1 or b = 2", [](int a, int b, char c) {return a != 1 || b == 2;}},
+    {"b = 2 and not a = 1", [](int a, int b, char c) {return b == 2 && a != 1;}},
+    {"a = 1 or not b = 2 and c = x", [](int a, int b, char c) {return a == 1 || (b != 2 && c == 'x');}},
+    {"not ( a = 1 or b = 2 )", [](int a, int b, char c) {return !(a == 1 || b == 2);}},
+    {"not ( a = 1 and b = 2 )", [](int a, int b, char c) {return !(a == 1 && b == 2);}},
+    {"not not a = 2", [](int a, int b, char c) {return a == 2;}},
+    {"not a != 1", [](int a, int b, char c) {return a == 1;}},
+    {"not ( a <> 0 or b != 0 )", [](int a, int b, char c) {return a == 0 && b == 0;}},
+    {"not a < 1 and not b > 1", [](int a, int b, char c) {return a >= 1 && b <= 1;}},
+    //complements merged with complements and with plain results, by De Morgan
+    {"not a = 0 and not b = 0", [](int a, int b, char c) {return a != 0 && b != 0;}},
+    {"not a = 0 or not b = 0", [](int a, int b, char c) {return a != 0 || b != 0;}},
+    {"a = 1 and not b = 0", [](int a, int b, char c) {return a == 1 && b != 0;}},
+    {"a = 1 or not b = 0", [](int a, int b, char c) {return a == 1 || b != 0;}},
+    {"not b = 0 and a = 1", [](int a, int b, char c) {return b != 0 && a == 1;}},
+    {"not ( a = 1 or b = 2 ) and not c = x", [](int a, int b, char c) {return !(a == 1 || b == 2) && c != 'x';}},
+    {"not ( a = 1 or b = 2 ) or not ( a = 2 and c = y )", [](int a, int b, char c) {return !(a == 1 || b == 2) || !(a == 2 && c == 'y');}},
+    {"a != 1 and not ( b != 2 )", [](int a, int b, char c) {return a != 1 && b == 2;}},
+    //nothing and everything
+    {"not a >= 0", [](int a, int b, char c) {return false;}},
+    {"not ( a = 1 and a != 1 )", [](int a, int b, char c) {return true;}},
+    {"a != 9", [](int a, int b, char c) {return true;}},
+    {"not a != 9", [](int a, int b, char c) {return false;}}
+  };
+
+  Table table(TRUTH_TABLE);
+  ParallelScan scan(string(TRUTH_TABLE) + "_fields.bin", 1);
+  bool ok = true;
+  for (int i = 0; i < cases.size(); i++)
+  {
+    vectorlong want;
+    for (int r = 0; r < rows.size(); r++)
+      if (cases[i].truth(rows[r][0], rows[r][1], char(rows[r][2])))
+        want.push_back(r);
+
+    sql.command("select * from truthtable where " + cases[i].condition, false);
+    vectorlong probed = sql.selectRecordNos();
+    sort(probed.begin(), probed.end());
+    PredicatePlan plan = table.compile_condition(split_words(cases[i].condition));
+    vectorlong scanned = scan.filter(plan, rows.size());
+    if (sql.errorState() || probed != want || scanned != want)
+    {
+      if (debug)
+        cout << cases[i].condition << ": want " << want.size() << ", probed " << probed.size()
+             << ", scanned " << scanned.size() << "\n" << plan << "\n";
+      ok = false;
+    }
+  }
+  sql.command("drop table truthtable");
+  return ok;
+}
+
+// ==============================
+// global BAD!
+bool debug = false;
+// ==============================
+
+TEST(WHERE_NOT, NotTruthTable) {
+  EXPECT_EQ(test_not_truth_table(debug), true);
+}
+
+int main(int argc, char **argv) {
+  if (argc > 1)
+  {
+    debug = !strcmp(argv[1], "debug");
+  }
+
+  ::testing::InitGoogleTest(&argc, argv);
+  std::cout<<"\n\n----------running where_not_test.cpp---------\n\n"<<std::endl;
+  return RUN_ALL_TESTS();
+}
@@ -15,16 +15,37 @@ echo Compiling with g++...
 g++ -I./includes ^
     main.cpp ^
     includes/SQL/sql.cpp ^
+    includes/SQL/select_clauses.cpp ^
+    includes/SQL/batch_pipeline.cpp ^
     includes/Table/table.cpp ^
     includes/Files/FileRecord.cpp ^
     includes/Files/Utilities.cpp ^
     includes/Parser/parser.cpp ^
     includes/Parser/sql_parser_functions.cpp ^
     includes/Parser/parser_state_machine_functions.cpp ^
+    includes/Parser/token_array.cpp ^
+    includes/Parser/statement.cpp ^
     includes/SortingAlgorithms/SortAlgorithms.cpp ^
+    includes/SortingAlgorithms/ExternalSort.cpp ^
+    includes/SortingAlgorithms/RecnoSort.cpp ^
     includes/Stub/stub.cpp ^
+    includes/QueryCache/query_cache.cpp ^
+    includes/PredicatePlan/predicate_plan.cpp ^
+    includes/PreparedStatement/prepared_statement.cpp ^
+    includes/Aggregate/aggregate.cpp ^
+    includes/Join/join.cpp ^
+    includes/ThreadPool/thread_pool.cpp ^
+    includes/ParallelScan/parallel_scan.cpp ^
+    includes/FilterKernels/filter_kernels.cpp ^
+    includes/BatchFilter/batch_filter.cpp ^
+    includes/Explain/explain.cpp ^
+    includes/PerfectHash/perfect_hash.cpp ^
+    includes/StrView/str_view.cpp ^
+    includes/BulkLoad/bulk_load.cpp ^
+    includes/Arena/arena.cpp ^
     includes/Token/*.cpp ^
     includes/Tokenizer/*.cpp ^
+    -pthread ^
     -o stealth_dbms.exe
 
 if %ERRORLEVEL% EQU 0 (
@@ -0,0 +1,105 @@
+#ifndef AGGREGATE_CPP
+#define AGGREGATE_CPP
+
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <set>
+#include <vector>
+#include <string>
+#include <cassert>
+#include <cstdlib>
+#include <sstream>
+#include "aggregate.h"
+
+using namespace std;
+
+AggregateColumn::AggregateColumn(const string& column)
+{
+    func = AGG_NONE;
+    field = column;
+    label = column;
+    //the parser only builds name(arg) for the aggregate keywords
+    size_t open = column.find('(');
+    if(open == string::npos || column[column.size() - 1] != ')')
+        return;
+    string name = column.substr(0, open);
+    if(name == "count")
+        func = AGG_COUNT;
+    else if(name == "min")
+        func = AGG_MIN;
+    else if(name == "max")
+        func = AGG_MAX;
+    else if(name == "sum")
+        func = AGG_SUM;
+    else if(name == "avg")
+        func = AGG_AVG;
+    else
+        return;
+    field = column.substr(open + 1, column.size() - open - 2);
+}
+
+Accumulator::Accumulator(int func)
+{
+    _func = func;
+    _count = 0;
+    _sum = 0;
+}
+void Accumulator::add(const string& value, long times) throw(Error_Code)
+{
+    if(times <= 0)
+        return;
+    if(_func == AGG_SUM || _func == AGG_AVG)
+    {
+        char* end;
+        double number = strtod(value.c_str(), &end);
+        if(value.empty() || *end != '\0')
+        {
+            Error_Code error_code;
+            error_code._code = NON_NUMERIC_AGGREGATE;
+            error_code._error_token = value;
+            throw error_code;
+        }
+        _sum += number * times;
+    }
+    else if(_func == AGG_MIN)
+    {
+        if(!_count || value < _min)
+            _min = value;
+    }
+    else if(_func == AGG_MAX)
+    {
+        if(!_count || _max < value)
+            _max = value;
+    }
+    _count += times;
+}
+string Accumulator::result() const
+{
+    switch(_func)
+    {
+    case AGG_COUNT:
+        return to_string(_count);
+    case AGG_MIN:
+        return _min;
+    case AGG_MAX:
+        return _max;
+    case AGG_SUM:
+        return _count ? format_number(_sum) : "";
+    case AGG_AVG:
+        return _count ? format_number(_sum / _count) : "";
+    default:
+        assert(false && "result() of a plain field");
+    }
+    return "";
+}
+string Accumulator::format_number(double value)
+{
+    if(value == floor(value) && fabs(value) < 1e15)
+        return to_string(static_cast<long long>(value));
+    ostringstream outs;
+    outs << setprecision(15) << value;
+    return outs.str();
+}
+
+#endif //AGGREGATE_CPP
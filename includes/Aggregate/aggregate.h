@@ -0,0 +1,61 @@
+#ifndef AGGREGATE_H
+#define AGGREGATE_H
+
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <set>
+#include <vector>
+#include <string>
+#include <cassert>
+#include "../Error_code/error_code.h"
+
+using namespace std;
+
+//aggregate functions a select field can apply
+enum aggregate_funcs
+{
+    AGG_NONE,       //plain field, has to be one of the group by fields
+    AGG_COUNT,
+    AGG_MIN,
+    AGG_MAX,
+    AGG_SUM,
+    AGG_AVG
+};
+
+//one field of an aggregate select, parsed from the text the parser kept for it: "major", "count(*)", "avg(age)"
+struct AggregateColumn
+{
+    int func;               //aggregate_funcs
+    string field;           //field the function reads, "*" for count(*)
+    string label;           //column name in the result, the field as written
+
+    AggregateColumn(const string& column = "");
+    bool is_aggregate() const {return func != AGG_NONE;}
+};
+
+//running value of one aggregate over one group
+//a value is added with the number of records holding it, so a whole index key counts at once
+//min and max compare values as strings, the same order the field indexes and where conditions use
+class Accumulator
+{
+public:
+    Accumulator(int func = AGG_COUNT);
+    void add(const string& value, long times = 1) throw(Error_Code);
+    void add_count(long times) {_count += times;}
+    long count() const {return _count;}
+    //the aggregate as result table text, empty for min/max/sum/avg of no records
+    string result() const;
+
+    //whole numbers print without a decimal point
+    static string format_number(double value);
+
+private:
+    int _func;
+    long _count;
+    double _sum;
+    string _min;
+    string _max;
+};
+
+#endif //AGGREGATE_H
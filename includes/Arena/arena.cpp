@@ -0,0 +1,63 @@
+#ifndef ARENA_CPP
+#define ARENA_CPP
+
+#include <cstdlib>
+#include "arena.h"
+
+using namespace std;
+
+Arena::Arena()
+{
+    _next = _inline;
+    _end = _inline + ARENA_INLINE_BYTES;
+    _blocks = NULL;
+    _destructors = NULL;
+    _used = 0;
+    _heap_blocks = 0;
+}
+Arena::~Arena()
+{
+    reset();
+}
+void* Arena::allocate(size_t bytes, size_t align)
+{
+    assert(align && !(align & (align - 1)) && "Alignment has to be a power of two");
+    size_t padding = (align - (size_t)_next % align) % align;
+    if(padding + bytes > size_t(_end - _next))
+    {
+        //a block of its own for anything bigger than a block
+        size_t header = (sizeof(Block) + alignof(max_align_t) - 1) / alignof(max_align_t) * alignof(max_align_t);
+        size_t size = header + (bytes + align > ARENA_BLOCK_BYTES ? bytes + align : ARENA_BLOCK_BYTES);
+        Block* block = static_cast<Block*>(malloc(size));
+        if(!block)
+            throw bad_alloc();
+        block->next = _blocks;
+        _blocks = block;
+        _heap_blocks++;
+        _next = reinterpret_cast<char*>(block) + header;
+        _end = reinterpret_cast<char*>(block) + size;
+        padding = (align - (size_t)_next % align) % align;
+    }
+    void* p = _next + padding;
+    _next += padding + bytes;
+    _used += bytes;
+    return p;
+}
+void Arena::reset()
+{
+    for(Destructor* d = _destructors; d; d = d->next)
+        d->destroy(d->object);
+    _destructors = NULL;
+    while(_blocks)
+    {
+        Block* next = _blocks->next;
+        free(_blocks);
+        _blocks = next;
+    }
+    _next = _inline;
+    _end = _inline + ARENA_INLINE_BYTES;
+    _used = 0;
+    _heap_blocks = 0;
+}
+
+#endif //ARENA_CPP
@@ -0,0 +1,84 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <set>
+#include <vector>
+#include <string>
+#include <cassert>
+#include <cstddef>
+#include <new>
+#include <utility>
+#include <type_traits>
+
+using namespace std;
+
+//bytes an arena holds in itself, enough for the tokens of a long where clause
+const int ARENA_INLINE_BYTES = 4096;
+//bytes of each block an arena takes from the heap once its own bytes are used up
+const int ARENA_BLOCK_BYTES = 16 * 1024;
+
+//owns everything made in it for as long as one query runs: objects are bump allocated,
+//first from the arena's own bytes and then from heap blocks, and all of them go at once
+//when the arena is reset or goes away. objects are never freed one at a time
+class Arena
+{
+public:
+    Arena();
+    ~Arena();
+    //a T made in the arena, reset() destroys it as a T, so it needs no virtual destructor
+    template <typename T, typename... Args>
+    T* make(Args&&... args)
+    {
+        T* object = new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+        if(!is_trivially_destructible<T>::value)
+        {
+            Destructor* d = new (allocate(sizeof(Destructor), alignof(Destructor))) Destructor;
+            d->destroy = &destroy<T>;
+            d->object = object;
+            d->next = _destructors;
+            _destructors = d;
+        }
+        return object;
+    }
+    //bytes aligned to align, which has to be a power of two
+    void* allocate(size_t bytes, size_t align = alignof(max_align_t));
+    //destroys what was made, newest first, and gives back the heap blocks
+    void reset();
+    //bytes handed out since the last reset
+    size_t bytes_used() const {return _used;}
+    //heap blocks taken since the last reset
+    int heap_blocks() const {return _heap_blocks;}
+
+private:
+    struct Destructor
+    {
+        void (*destroy)(void*);
+        void* object;
+        Destructor* next;
+    };
+    struct Block
+    {
+        Block* next;
+    };
+
+    alignas(max_align_t) char _inline[ARENA_INLINE_BYTES];
+    char* _next;                //next free byte of the current block
+    char* _end;                 //end of the current block
+    Block* _blocks;             //heap blocks, newest first
+    Destructor* _destructors;   //newest first
+    size_t _used;
+    int _heap_blocks;
+
+    template <typename T>
+    static void destroy(void* object)
+    {
+        static_cast<T*>(object)->~T();
+    }
+    Arena(const Arena&);
+    Arena& operator =(const Arena&);
+};
+
+#endif //ARENA_H
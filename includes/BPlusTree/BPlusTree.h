@@ -29,6 +29,11 @@ public:
             return it->data[key_ptr];
         }
 
+        //accessing members of current data element without copying it
+        T* operator ->() {
+            return &it->data[key_ptr];
+        }
+
         //moving iterator to next position (postfix ++)
         Iterator operator++(int un_used) {
             int prev_key_ptr = key_ptr;
@@ -145,7 +150,9 @@ public:
     //copying another tree's structure into this tree
     void copy_tree(const BPlusTree<T>& other) {
         //initializing last leaf for maintaining linked list structure
-        BPlusTree<T>* last_leaf= new BPlusTree<T>;
+        //the head before the first leaf only lives while copying
+        BPlusTree<T> head;
+        BPlusTree<T>* last_leaf = &head;
         copy_tree(other, last_leaf);
         last_leaf->next = nullptr;
     }
@@ -177,6 +184,16 @@ public:
         grow_tree();
     }
 
+    //inserting entries sorted by key, consecutive entries going into the same subtree share one descent
+    void insert_sorted(const T* entries, int count) {
+        int i = 0;
+        while(i < count)
+        {
+            i = loose_insert_run(entries, i, count, nullptr, duplicates_ok);
+            grow_tree();
+        }
+    }
+
     //removing entry from the tree while maintaining B+ tree properties
     void remove(const T& entry){
         if(data_count > 0) {
@@ -215,7 +232,6 @@ public:
             shrink_ptr->data_count = 0;
             shrink_ptr->child_count = 0;
             delete shrink_ptr;
-            delete shrink_ptr;
         }
     }
 
@@ -505,12 +521,21 @@ public:
     //validating tree structure and relationships
     bool is_valid()
     {
-        //should check that every data[i] < data[i+1]
-        //data[data_count-1] must be less than equal to every subset[child_count-1]->data[]
-        //every data[i] is greater than every subset[i]->data[]
-        //B+Tree: Every data[i] is equal to subset[i+1]->smallest
-        //Recursively validate every subset[i]
-        return true;
+        int leaf_depth = -1;
+        int leaf_keys = 0;
+        if(!is_valid(true, 0, leaf_depth, leaf_keys))
+            return false;
+        //the leaves, linked from the smallest on, hold every key in order and end at the biggest
+        BPlusTree<T>* last = nullptr;
+        for(BPlusTree<T>* walker = get_smallest_node(); walker; walker = walker->next)
+        {
+            if(last && last->data_count && walker->data_count
+               && !(last->data[last->data_count - 1] < walker->data[0]))
+                return false;
+            leaf_keys -= walker->data_count;
+            last = walker;
+        }
+        return leaf_keys == 0 && last == get_biggest_node();
     }
 
     //creating in-order string representation of tree
@@ -551,6 +576,15 @@ public:
         return Iterator();
     }
 
+    //getting iterator to the last (biggest) element, end() if the tree is empty
+    Iterator last()
+    {
+        if(data_count == 0)
+            return end();
+        BPlusTree<T>* node = get_biggest_node();
+        return Iterator(node, node->data_count - 1);
+    }
+
     //printing keys between two iterators
     ostream& list_keys(Iterator from = NULL, Iterator to = NULL)
     {
@@ -635,6 +669,35 @@ private:
             }
         }
     }                                     //   the root
+    //inserts entries from i on while they sort below upper (all of them without an upper)
+    //and this Node is not over MAXIMUM, returns the first entry it did not insert
+    //duplicates is the root's duplicates_ok, the Nodes below it are made without one
+    int loose_insert_run(const T* entries, int i, int count, const T* upper, bool duplicates)
+    {
+        while(i < count && data_count <= MAXIMUM && (!upper || entries[i] < *upper))
+        {
+            int ge_i = first_ge(data, data_count, entries[i]);
+            bool found = ge_i < data_count && data[ge_i] == entries[i];
+            if(is_leaf())
+            {
+                if(found)
+                    data[ge_i] = duplicates ? data[ge_i] + entries[i] : entries[i];
+                else if(ge_i < data_count)
+                    insert_item(data, ge_i, data_count, entries[i]);
+                else
+                    attach_item(data, data_count, entries[i]);
+                i++;
+            }
+            else
+            {
+                //same child loose_insert would pick, whose keys sort below data[child]
+                int child = found ? ge_i + 1 : ge_i;
+                i = subset[child]->loose_insert_run(entries, i, count, child < data_count ? &data[child] : upper, duplicates);
+                fix_excess(child);
+            }
+        }
+        return i;
+    }
     void fix_excess(int i)              //fix excess in child i
     {
         if(subset[i]->data_count > MAXIMUM)
@@ -816,6 +879,45 @@ private:
         else
             return nullptr;
     }
+    //validating this Node and every Node under it, only the root may have fewer than MINIMUM keys
+    //every leaf has to be at leaf_depth, the depth of the first leaf found, leaf_keys counts their keys
+    bool is_valid(bool root, int depth, int& leaf_depth, int& leaf_keys)
+    {
+        if(data_count > MAXIMUM || (!root && data_count < MINIMUM))
+            return false;
+        //every data[i] < data[i+1]
+        for(int i = 0; i + 1 < data_count; i++)
+        {
+            if(!(data[i] < data[i + 1]))
+                return false;
+        }
+        if(is_leaf())
+        {
+            if(leaf_depth == -1)
+                leaf_depth = depth;
+            leaf_keys += data_count;
+            return depth == leaf_depth;
+        }
+        if(child_count != data_count + 1)
+            return false;
+        //recursively validate every subset[i], so none of them is empty below
+        for(int i = 0; i < child_count; i++)
+        {
+            if(!subset[i]->is_valid(false, depth + 1, leaf_depth, leaf_keys))
+                return false;
+        }
+        for(int i = 0; i < data_count; i++)
+        {
+            //every data[i] is greater than every subset[i]->data[]
+            const BPlusTree<T>* biggest = subset[i]->get_biggest_node();
+            if(!(biggest->data[biggest->data_count - 1] < data[i]))
+                return false;
+            //B+Tree: every data[i] is equal to subset[i+1]->smallest
+            if(!(subset[i + 1]->get_smallest_node()->data[0] == data[i]))
+                return false;
+        }
+        return true;
+    }
     // and return the smallest key in this subtree
     BPlusTree<T>* get_smallest_node()
     {
@@ -824,6 +926,13 @@ private:
         else
             return subset[0]->get_smallest_node();
     }
+    BPlusTree<T>* get_biggest_node()
+    {
+        if(is_leaf())
+            return this;
+        else
+            return subset[child_count - 1]->get_biggest_node();
+    }
     void get_smallest(T& entry)      //entry := leftmost leaf //use to replace data[i] after searching for where data[i] is
     {
         if(is_leaf())
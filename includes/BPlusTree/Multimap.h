@@ -49,6 +49,11 @@ public:
             return *_it;
         }
 
+        //accessing key and value_list of current MPair without copying them
+        const MPair<K, V>* operator ->() {
+            return _it.operator->();
+        }
+
         //comparing iterators for equality
         friend bool operator ==(const Iterator& lhs, const Iterator& rhs) {
             return lhs._it == rhs._it;
@@ -76,6 +81,11 @@ public:
         return Iterator(mmap.end());
     }
 
+    //getting iterator to the element with the biggest key
+    Iterator last() {
+        return Iterator(mmap.last());
+    }
+
     //checking if multimap is empty
     int size() const {
         return mmap.elements_count();
@@ -102,6 +112,12 @@ public:
         mmap.insert(p);
     }
 
+    //inserting pairs sorted by key with no key twice, their values go after the key's values already there
+    void insert_sorted(const vector<MPair<K, V> >& pairs) {
+        if(!pairs.empty())
+            mmap.insert_sorted(&pairs[0], pairs.size());
+    }
+
     //removing all elements with given key
     void erase(const K& key) {
         mmap.remove();
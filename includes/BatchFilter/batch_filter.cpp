@@ -0,0 +1,162 @@
+#ifndef BATCH_FILTER_CPP
+#define BATCH_FILTER_CPP
+
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <set>
+#include <vector>
+#include <string>
+#include <cstring>
+#include <cassert>
+#include "batch_filter.h"
+
+using namespace std;
+
+ColumnBatch::ColumnBatch(const vector<int>& fields)
+{
+    _fields = fields;
+    _column.assign(FileRecord::ROW, -1);
+    for(int i = 0; i < _fields.size(); i++)
+        _column[_fields[i]] = i;
+    _keys.resize(_fields.size());
+    _longer.resize(_fields.size());
+    _any_longer.assign(_fields.size(), false);
+    _rows = 0;
+}
+int ColumnBatch::load(fstream& records, long begin, long end)
+{
+    _records.resize((end - begin) * RECORD_BYTES);
+    records.clear();
+    records.seekg(begin * RECORD_BYTES, ios_base::beg);
+    records.read(&_records[0], _records.size());
+    _rows = records.gcount() / RECORD_BYTES;
+    for(int c = 0; c < _fields.size(); c++)
+    {
+        _keys[c].resize(_rows);
+        _longer[c].assign(mask_words(_rows), 0);
+        _any_longer[c] = false;
+        for(int row = 0; row < _rows; row++)
+        {
+            bool longer;
+            _keys[c][row] = value_key(value(row, _fields[c]), FIELD_MAX_LEN, longer);
+            if(longer)
+            {
+                _longer[c][row / MASK_WORD_BITS] |= mask_word(1) << row % MASK_WORD_BITS;
+                _any_longer[c] = true;
+            }
+        }
+    }
+    return _rows;
+}
+
+BatchFilter::BatchFilter(const PredicatePlan& plan, int level)
+{
+    assert(!plan.empty() && "Cannot filter with an empty plan");
+    _ops = plan.ops();
+    _level = level;
+    _leaves.resize(_ops.size());
+    set<int> fields;
+    int depth = 0;
+    int max_depth = 0;
+    for(int i = 0; i < _ops.size(); i++)
+    {
+        if(_ops[i].is_leaf())
+        {
+            _leaves[i].key = value_key(_ops[i].literal.c_str(), _ops[i].literal.size(), _leaves[i].longer);
+            fields.insert(_ops[i].field);
+            depth++;
+        }
+        else if(_ops[i].op != PLAN_NOT)
+            depth--;
+        if(depth > max_depth)
+            max_depth = depth;
+    }
+    _fields.assign(fields.begin(), fields.end());
+    _stack.resize(max_depth);
+}
+const mask_word* BatchFilter::filter(const ColumnBatch& batch)
+{
+    int rows = batch.rows();
+    int words = mask_words(rows);
+    int top = 0;
+    for(int i = 0; i < _ops.size(); i++)
+    {
+        const PlanOp& op = _ops[i];
+        if(op.is_leaf())
+        {
+            _stack[top].resize(words);
+            compare(i, batch, &_stack[top][0]);
+            top++;
+        }
+        else if(op.op == PLAN_NOT)
+            mask_not(&_stack[top - 1][0], rows);
+        else
+        {
+            if(op.op == PLAN_AND)
+                mask_and(&_stack[top - 2][0], &_stack[top - 1][0], words, _level);
+            else
+                mask_or(&_stack[top - 2][0], &_stack[top - 1][0], words, _level);
+            top--;
+        }
+    }
+    assert(top == 1 && "Plan must leave exactly one mask");
+    return &_stack[0][0];
+}
+
+//private
+void BatchFilter::compare(int i, const ColumnBatch& batch, mask_word* mask)
+{
+    const PlanOp& op = _ops[i];
+    const Leaf& leaf = _leaves[i];
+    int rows = batch.rows();
+    int words = mask_words(rows);
+    compare_keys(op.op, batch.keys(op.field), rows, leaf.key, mask, _level);
+    //rows whose key equals the literal's are only really equal when neither value goes past its key
+    if(!leaf.longer && !batch.any_longer(op.field))
+        return;
+    _ties.resize(words);
+    compare_keys(PLAN_EQ, batch.keys(op.field), rows, leaf.key, &_ties[0], _level);
+    if(!leaf.longer)
+        mask_and(&_ties[0], batch.longer(op.field), words, _level);
+    if(mask_empty(&_ties[0], words))
+        return;
+    vectorlong tied;
+    append_selected(&_ties[0], rows, 0, tied);
+    for(int t = 0; t < tied.size(); t++)
+    {
+        int row = tied[t];
+        const char* value = batch.value(row, op.field);
+        int cmp = string(value, strnlen(value, FIELD_MAX_LEN)).compare(op.literal);
+        int below = cmp < 0;
+        int above = cmp > 0;
+        bool passes;
+        switch(op.op)
+        {
+        case PLAN_EQ:
+            passes = !below && !above;
+            break;
+        case PLAN_LT:
+            passes = below;
+            break;
+        case PLAN_GT:
+            passes = above;
+            break;
+        case PLAN_LE:
+            passes = !above;
+            break;
+        case PLAN_GE:
+            passes = !below;
+            break;
+        default:
+            passes = below || above;
+        }
+        mask_word bit = mask_word(1) << row % MASK_WORD_BITS;
+        if(passes)
+            mask[row / MASK_WORD_BITS] |= bit;
+        else
+            mask[row / MASK_WORD_BITS] &= ~bit;
+    }
+}
+
+#endif //BATCH_FILTER_CPP
@@ -0,0 +1,79 @@
+#ifndef BATCH_FILTER_H
+#define BATCH_FILTER_H
+
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <set>
+#include <vector>
+#include <string>
+#include <cassert>
+#include <fstream>
+#include "../Table/typedefs.h"
+#include "../Table/table_constants.h"
+#include "../Files/FileRecord.h"
+#include "../PredicatePlan/predicate_plan.h"
+#include "../FilterKernels/filter_kernels.h"
+
+using namespace std;
+
+//a run of consecutive records read with one read() and the fields a filter looks at
+//decoded once into column arrays of filter keys
+class ColumnBatch
+{
+public:
+    //fields are the positions decoded into columns
+    explicit ColumnBatch(const vector<int>& fields);
+    //reads records [begin, end) of the open bin file, returns the rows read
+    int load(fstream& records, long begin, long end);
+    int rows() const {return _rows;}
+    //column of field, which has to be one of the decoded fields
+    const uint64_t* keys(int field) const {return &_keys[_column[field]][0];}
+    //rows of field whose value is longer than its key
+    const mask_word* longer(int field) const {return &_longer[_column[field]][0];}
+    bool any_longer(int field) const {return _any_longer[_column[field]];}
+    //value of field in row, as it is on disk
+    const char* value(int row, int field) const {return &_records[row * RECORD_BYTES + field * FIELD_MAX_LEN];}
+
+    static const int RECORD_BYTES = FileRecord::ROW * (FileRecord::MAX + 1);
+
+private:
+    vector<int> _fields;
+    vector<int> _column;                    //field position to its column, -1 if not decoded
+    vector<char> _records;                  //the raw records
+    vector<vector<uint64_t> > _keys;
+    vector<vector<mask_word> > _longer;
+    vector<bool> _any_longer;
+    int _rows;
+};
+
+//evaluates a predicate plan over a ColumnBatch with one kernel call per comparison and per and/or,
+//giving the same rows PredicatePlan::matches() gives one record at a time
+//keeps its own mask stack, so every thread needs its own
+class BatchFilter
+{
+public:
+    explicit BatchFilter(const PredicatePlan& plan, int level = -1);
+    //fields the plan reads, the ones a ColumnBatch for it has to decode
+    const vector<int>& fields() const {return _fields;}
+    //mask of the batch rows that satisfy the plan, valid until the next call
+    const mask_word* filter(const ColumnBatch& batch);
+
+private:
+    struct Leaf
+    {
+        uint64_t key;           //key of the literal
+        bool longer;            //literal is longer than its key
+    };
+    vector<PlanOp> _ops;
+    vector<Leaf> _leaves;       //by op, unused for logical ops
+    vector<int> _fields;
+    vector<vector<mask_word> > _stack;
+    vector<mask_word> _ties;
+    int _level;
+
+    //mask of the rows satisfying leaf _ops[i]
+    void compare(int i, const ColumnBatch& batch, mask_word* mask);
+};
+
+#endif //BATCH_FILTER_H
@@ -0,0 +1,216 @@
+#ifndef BULK_LOAD_CPP
+#define BULK_LOAD_CPP
+
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <set>
+#include <vector>
+#include <string>
+#include <cstring>
+#include <cassert>
+#include <fstream>
+#include <sstream>
+#include "bulk_load.h"
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+MappedFile::MappedFile()
+{
+    _data = NULL;
+    _size = 0;
+    _mapped = false;
+}
+MappedFile::~MappedFile()
+{
+    close();
+}
+bool MappedFile::open(const string& path)
+{
+    close();
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if(file == INVALID_HANDLE_VALUE)
+        return false;
+    LARGE_INTEGER size;
+    if(GetFileSizeEx(file, &size) && size.QuadPart > 0)
+    {
+        //the view keeps the mapping alive after both handles are closed
+        HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+        if(mapping)
+        {
+            _data = (const char*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+            CloseHandle(mapping);
+        }
+        _size = size.QuadPart;
+        _mapped = _data != NULL;
+    }
+    CloseHandle(file);
+#else
+    int file = ::open(path.c_str(), O_RDONLY);
+    if(file < 0)
+        return false;
+    struct stat status;
+    if(fstat(file, &status) == 0 && status.st_size > 0)
+    {
+        void* view = mmap(NULL, status.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+        if(view != MAP_FAILED)
+        {
+            //read front to back
+            madvise(view, status.st_size, MADV_SEQUENTIAL);
+            _data = (const char*)view;
+            _mapped = true;
+        }
+        _size = status.st_size;
+    }
+    ::close(file);
+#endif
+    if(!_mapped && _size > 0)
+    {
+        ifstream in(path.c_str(), ios::binary);
+        ostringstream whole;
+        whole << in.rdbuf();
+        _copy = whole.str();
+        _data = _copy.data();
+        _size = _copy.size();
+    }
+    return true;
+}
+void MappedFile::close()
+{
+    if(_mapped)
+    {
+#ifdef _WIN32
+        UnmapViewOfFile(_data);
+#else
+        munmap((void*)_data, _size);
+#endif
+    }
+    _data = NULL;
+    _size = 0;
+    _mapped = false;
+    _copy.clear();
+}
+
+char load_delimiter(const string& path, const char* data, long size)
+{
+    if(path.size() >= 4 && path.compare(path.size() - 4, 4, ".tsv") == 0)
+        return '\t';
+    bool tabs = false;
+    for(long i = 0; i < size && data[i] != '\n'; i++)
+    {
+        if(data[i] == ',')
+            return ',';
+        if(data[i] == '\t')
+            tabs = true;
+    }
+    return tabs ? '\t' : ',';
+}
+const char* parse_load_line(const char* p, const char* end, char delimiter, vectorstr& values)
+{
+    values.clear();
+    //one record per line, a quote left open ends with its line
+    while(true)
+    {
+        while(p < end && *p == ' ')
+            p++;
+        values.push_back(string());
+        string& value = values.back();
+        if(p < end && *p == '\"')
+        {
+            for(p++; p < end && *p != '\n'; p++)
+            {
+                if(*p == '\"')
+                {
+                    if(p + 1 < end && p[1] == '\"')
+                        p++;
+                    else
+                    {
+                        p++;
+                        break;
+                    }
+                }
+                value += *p;
+            }
+            //anything between the closing quote and the delimiter is dropped
+            while(p < end && *p != delimiter && *p != '\n')
+                p++;
+        }
+        else
+        {
+            const char* begin = p;
+            while(p < end && *p != delimiter && *p != '\n')
+                p++;
+            const char* last = p;
+            while(last > begin && (last[-1] == ' ' || last[-1] == '\r'))
+                last--;
+            value.assign(begin, last - begin);
+        }
+        if(p >= end || *p == '\n')
+            break;
+        p++;
+    }
+    return p < end ? p + 1 : end;
+}
+vector<LoadChunk> split_load_chunks(const char* begin, const char* end, long chunk_bytes)
+{
+    vector<LoadChunk> chunks;
+    const char* p = begin;
+    while(p < end)
+    {
+        const char* stop = end - p > chunk_bytes ? p + chunk_bytes : end;
+        while(stop < end && stop[-1] != '\n')
+            stop++;
+        chunks.push_back(LoadChunk(p, stop));
+        p = stop;
+    }
+    return chunks;
+}
+void parse_load_chunk(LoadChunk& chunk, char delimiter, int fields)
+{
+    const int record_bytes = FileRecord::ROW * (FileRecord::MAX + 1);
+    //every line but the file's last ends with a newline, so this is the most rows the chunk can have
+    long most_rows = 1;
+    for(const char* p = chunk.begin; p < chunk.end; p++)
+        most_rows += *p == '\n';
+    chunk.records.assign(most_rows * record_bytes, '\0');
+    chunk.keys.assign(fields, vectorstr());
+    for(int f = 0; f < fields; f++)
+        chunk.keys[f].reserve(most_rows);
+    chunk.rows = 0;
+    vectorstr values;
+    const char* p = chunk.begin;
+    while(p < chunk.end)
+    {
+        p = parse_load_line(p, chunk.end, delimiter, values);
+        if(values.size() == 1 && values[0].empty())
+            continue;
+        char* record = &chunk.records[chunk.rows * record_bytes];
+        for(int f = 0; f < fields; f++)
+        {
+            if(f < values.size())
+            {
+                //stored cut to MAX characters like FileRecord stores it, the index gets the whole value
+                memcpy(record + f * (FileRecord::MAX + 1), values[f].data(),
+                       values[f].size() < FileRecord::MAX ? values[f].size() : FileRecord::MAX);
+                chunk.keys[f].push_back(values[f]);
+            }
+            else
+                chunk.keys[f].push_back(string());
+        }
+        chunk.rows++;
+    }
+    chunk.records.resize(chunk.rows * record_bytes);
+}
+
+#endif //BULK_LOAD_CPP
@@ -0,0 +1,67 @@
+#ifndef BULK_LOAD_H
+#define BULK_LOAD_H
+
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <set>
+#include <vector>
+#include <string>
+#include <cassert>
+#include <utility>
+#include "../Table/typedefs.h"
+#include "../Files/FileRecord.h"
+
+using namespace std;
+
+//bytes of a load file one task parses, the records of a chunk of 40 byte lines take 25 times that
+const long LOAD_CHUNK_BYTES = 64 * 1024;
+//rows whose index keys a load collects before adding them to the indexes in one sorted pass
+const long LOAD_INDEX_ROWS = 64 * 1024;
+
+//a file mapped into memory for reading, or read whole when it cannot be mapped
+class MappedFile
+{
+public:
+    MappedFile();
+    ~MappedFile();
+    //false if the file cannot be opened
+    bool open(const string& path);
+    void close();
+    const char* data() const {return _data;}
+    long size() const {return _size;}
+
+private:
+    const char* _data;
+    long _size;
+    bool _mapped;               //_data is a mapping to unmap, otherwise it points into _copy
+    string _copy;
+
+    MappedFile(const MappedFile&);
+    MappedFile& operator =(const MappedFile&);
+};
+
+//lines [begin, end) of a load file and what parsing them gave: the records the way
+//FileRecord::write() lays them out in a bin file, and every field's values for its index
+struct LoadChunk
+{
+    const char* begin;
+    const char* end;
+    long rows;
+    vector<char> records;
+    vector<vectorstr> keys;     //by field, a value per row
+
+    LoadChunk(const char* b = NULL, const char* e = NULL): begin(b), end(e), rows(0) {}
+};
+
+//tab for a .tsv file or a first line with tabs and no commas, comma otherwise
+char load_delimiter(const string& path, const char* data, long size);
+//values of the line starting at p, returns where the next line starts
+//a value may be in double quotes, with "" for a quote inside it, unquoted values lose their outer spaces
+const char* parse_load_line(const char* p, const char* end, char delimiter, vectorstr& values);
+//[begin, end) cut into chunks of about chunk_bytes that each end after a newline
+vector<LoadChunk> split_load_chunks(const char* begin, const char* end, long chunk_bytes = LOAD_CHUNK_BYTES);
+//parses the chunk's lines into records of the first fields values, skipping empty lines
+void parse_load_chunk(LoadChunk& chunk, char delimiter, int fields);
+
+#endif //BULK_LOAD_H
@@ -34,7 +34,22 @@ enum sql_errors
     INVALID_USAGE_OF_OP,
     EXPECT_LOGICAL,
     EXPECT_A_RELATIONAL,
-    UNKNOWN_COLUMN
+    UNKNOWN_COLUMN,
+    STATEMENT_NOT_PREPARED,
+    PARAMETER_NOT_BOUND,
+    INVALID_PARAMETER,
+    PARAMETER_NOT_PREPARED,
+    EXPECT_ORDER_FIELD,
+    INVALID_LIMIT,
+    EXPECT_GROUP_FIELD,
+    FIELD_NOT_GROUPED,
+    NON_NUMERIC_AGGREGATE,
+    AMBIGUOUS_COLUMN,
+    UNSUPPORTED_JOIN_CONDITION,
+    UNSUPPORTED_JOIN,
+    LOAD_FILE_NOT_FOUND,
+    NOT_IN_TRANSACTION,
+    SORT_RUN_FAILED
 };
 
 struct Error_Code
@@ -151,6 +166,61 @@ public:
         case EXPECT_A_RELATIONAL:
             error_string = "\033[31mERROR: Expected a relational operator between a column name and a value\033[0m";
             break;
+        case STATEMENT_NOT_PREPARED:
+            error_string = "\033[31mERROR: Cannot execute a statement that failed to prepare\033[0m";
+            break;
+        case PARAMETER_NOT_BOUND:
+            error_string = "\033[31mERROR: No value bound to parameter \033[34m" + _error_token + "\033[0m";
+            break;
+        case INVALID_PARAMETER:
+            error_string = "\033[31mERROR: Parameters (\"?\") can only stand for insert values or values in a where condition\033[0m";
+            break;
+        case PARAMETER_NOT_PREPARED:
+            error_string = "\033[31mERROR: A \"?\" parameter needs prepare() and execute(), quote it to mean the text ?\033[0m";
+            break;
+        case EXPECT_ORDER_FIELD:
+            error_string = "\033[31mERROR: Expected a field name after \"order by\"\033[0m";
+            break;
+        case INVALID_LIMIT:
+            error_string = "\033[31mERROR: \"limit\" and \"offset\" expect a whole number of rows\033[0m";
+            if(!_error_token.empty())
+                error_string += "\033[31m, not \033[34m" + _error_token + "\033[0m";
+            break;
+        case EXPECT_GROUP_FIELD:
+            error_string = "\033[31mERROR: Expected a field name after \"group by\"\033[0m";
+            break;
+        case FIELD_NOT_GROUPED:
+            error_string = "\033[31mERROR: column \033[34m\"" + _error_token + "\"\033[31m must appear in the group by or be used in an aggregate function\033[0m";
+            break;
+        case NON_NUMERIC_AGGREGATE:
+            error_string = "\033[31mERROR: sum and avg need numbers, found \033[34m\"" + _error_token + "\"\033[0m";
+            break;
+        case AMBIGUOUS_COLUMN:
+            error_string = "\033[31mERROR: column reference \033[34m\"" + _error_token + "\"\033[31m is ambiguous \033[0m\n";
+            error_string += "\033[31m" + _error_input + "\033[0m\n";
+            for(int i = 0; i < _character_count; i++)
+            {
+                error_string += " ";
+            }
+            error_string += "\033[31m^\033[0m";
+            break;
+        case UNSUPPORTED_JOIN_CONDITION:
+            error_string = "\033[31mERROR: Conditions between the two tables of a join can only be table.field = table.field\033[0m";
+            break;
+        case UNSUPPORTED_JOIN:
+            error_string = "\033[31mERROR: Joins take two different tables and no group by, aggregates or parameters\033[0m";
+            break;
+        case LOAD_FILE_NOT_FOUND:
+            error_string = "\033[31mERROR: could not open file \033[34m\"" + _error_token + "\"\033[31m for reading\033[0m";
+            break;
+        case NOT_IN_TRANSACTION:
+            error_string = "\033[31mERROR: \033[34m" + _error_token + "\033[31m cannot run inside a batch transaction\033[0m";
+            break;
+        case SORT_RUN_FAILED:
+            error_string = "\033[31mERROR: order by could not write or read back its sorted runs\033[0m";
+            if(!_error_token.empty())
+                error_string += "\033[31m, check the space left for \033[34m" + _error_token + "\033[0m";
+            break;
         default:
             error_string = "Wrong Error Code";
             break;
@@ -0,0 +1,133 @@
+#ifndef EXPLAIN_CPP
+#define EXPLAIN_CPP
+
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <set>
+#include <vector>
+#include <string>
+#include <cassert>
+#include <sstream>
+#include "explain.h"
+
+using namespace std;
+
+ExplainOutput::ExplainOutput(bool analyze)
+{
+    _analyze = analyze;
+    _expected = 0;
+}
+int ExplainOutput::step(int depth, const string& text)
+{
+    Line line;
+    line.depth = depth;
+    line.text = text;
+    _lines.push_back(line);
+    return _lines.size() - 1;
+}
+void ExplainOutput::actual(int step, const string& text)
+{
+    _lines[step].actual = text;
+}
+void ExplainOutput::where_tree(const PredicatePlan& plan, const vector<double>& estimates, bool probed, int depth)
+{
+    //inputs of every op, found the way the postfix order is evaluated
+    const vector<PlanOp>& ops = plan.ops();
+    vector<int> lhs(ops.size(), -1);
+    vector<int> rhs(ops.size(), -1);
+    vector<int> stack;
+    for(int i = 0; i < ops.size(); i++)
+    {
+        if(!ops[i].is_leaf())
+        {
+            if(ops[i].op != PLAN_NOT)
+            {
+                rhs[i] = stack.back();
+                stack.pop_back();
+            }
+            lhs[i] = stack.back();
+            stack.pop_back();
+        }
+        stack.push_back(i);
+    }
+    where_node(plan, estimates, lhs, rhs, ops.size() - 1, probed, depth);
+}
+vector<vectorstr> ExplainOutput::rows() const
+{
+    vector<vectorstr> rows;
+    int width = 0;
+    for(int i = 0; i < _lines.size(); i++)
+    {
+        string indent(2 * _lines[i].depth, ' ');
+        rows.push_back(vectorstr(1, indent + _lines[i].text));
+        if(_analyze && !_lines[i].actual.empty())
+            rows.push_back(vectorstr(1, indent + "  actual: " + _lines[i].actual));
+    }
+    //tables print their fields right aligned, lines of one width keep the indentation lined up
+    for(int i = 0; i < rows.size(); i++)
+        width = rows[i][0].size() > width ? rows[i][0].size() : width;
+    if(width > FileRecord::MAX)
+        width = FileRecord::MAX;
+    for(int i = 0; i < rows.size(); i++)
+    {
+        if(rows[i][0].size() < width)
+            rows[i][0].append(width - rows[i][0].size(), ' ');
+    }
+    return rows;
+}
+string ExplainOutput::rows_text(double rows)
+{
+    return to_string((long)(rows + 0.5));
+}
+string ExplainOutput::ms_text(double ms)
+{
+    ostringstream text;
+    text << fixed << setprecision(3) << ms << " ms";
+    return text.str();
+}
+
+//private
+void ExplainOutput::where_node(const PredicatePlan& plan, const vector<double>& estimates, const vector<int>& lhs,
+                               const vector<int>& rhs, int op, bool probed, int depth)
+{
+    //a scanned plan is checked against every record, so its ops are not looked up in any index
+    const PlanOp& plan_op = plan.ops()[op];
+    string text;
+    if(plan_op.is_leaf())
+    {
+        text = plan_op.field_name + " " + PredicatePlan::op_string(plan_op.op) + " " + plan_op.literal + ": ";
+        if(!probed)
+            text += "checked per record";
+        else if(plan_op.op == PLAN_EQ)
+            text += "lookup in " + plan_op.field_name + " index";
+        else if(plan_op.op == PLAN_NE)
+            text += "walk of " + plan_op.field_name + " index around the value";
+        else
+            text += "range walk of " + plan_op.field_name + " index";
+    }
+    else if(plan_op.op == PLAN_NOT)
+        text = string("not: ") + (probed ? "complement" : "negate");
+    else
+        text = (plan_op.op == PLAN_AND ? string("and: ") : string("or: ")) + (probed ? "merge of sorted recnos" : "mask combine");
+    int line = step(depth, text + ", est " + rows_text(estimates[op]) + " rows");
+    const vector<PlanOpStats>& stats = plan.op_stats();
+    if(!stats.empty())
+    {
+        const PlanOpStats& s = stats[op];
+        string figures = to_string(s.rows) + " rows";
+        if(s.shared_with != -1)
+            figures += ", probe shared with the same comparison";
+        else if(plan_op.is_leaf())
+            figures += ", " + to_string(s.keys_visited) + " index keys, " + to_string(s.entries_visited) + " entries";
+        if(s.shared_with == -1)
+            figures += ", " + ms_text(s.ms);
+        actual(line, figures);
+    }
+    if(lhs[op] != -1)
+        where_node(plan, estimates, lhs, rhs, lhs[op], probed, depth + 1);
+    if(rhs[op] != -1)
+        where_node(plan, estimates, lhs, rhs, rhs[op], probed, depth + 1);
+}
+
+#endif //EXPLAIN_CPP
@@ -0,0 +1,68 @@
+#ifndef EXPLAIN_H
+#define EXPLAIN_H
+
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <set>
+#include <vector>
+#include <string>
+#include <cassert>
+#include <chrono>
+#include "../Table/typedefs.h"
+#include "../PredicatePlan/predicate_plan.h"
+#include "../Files/FileRecord.h"
+
+using namespace std;
+
+//wall time since it was made or last restarted
+class ExplainTimer
+{
+public:
+    ExplainTimer() {restart();}
+    void restart() {_start = chrono::steady_clock::now();}
+    double ms() const {return chrono::duration<double, milli>(chrono::steady_clock::now() - _start).count();}
+
+private:
+    chrono::steady_clock::time_point _start;
+};
+
+//the text of an explain: one line per step of a select, indented under the step it belongs to,
+//and under explain analyze an "actual" line below each step that ran
+class ExplainOutput
+{
+public:
+    explicit ExplainOutput(bool analyze);
+    bool analyze() const {return _analyze;}
+    //adds a step, returns it for actual()
+    int step(int depth, const string& text);
+    //what step actually did, only shown by explain analyze
+    void actual(int step, const string& text);
+    //the where plan as a tree under depth, root first, with each op's estimated rows and,
+    //if the plan was profiled while it ran, what every op did
+    void where_tree(const PredicatePlan& plan, const vector<double>& estimates, bool probed, int depth);
+    //rows of the one column result table
+    vector<vectorstr> rows() const;
+    //rows the steps added so far are expected to give, each step narrows it
+    double expected() const {return _expected;}
+    void expect(double rows) {_expected = rows;}
+
+    static string rows_text(double rows);
+    static string ms_text(double ms);
+
+private:
+    struct Line
+    {
+        int depth;
+        string text;
+        string actual;
+    };
+    bool _analyze;
+    vector<Line> _lines;
+    double _expected;
+
+    void where_node(const PredicatePlan& plan, const vector<double>& estimates, const vector<int>& lhs,
+                    const vector<int>& rhs, int op, bool probed, int depth);
+};
+
+#endif //EXPLAIN_H
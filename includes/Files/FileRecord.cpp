@@ -28,7 +28,7 @@ FileRecord::FileRecord(vector<string> strings) {
     }
 
     //copying strings from vector to record fields
-    for(int i = 0; i < strings.size(); i++) {
+    for(int i = 0; i < strings.size() && i < ROW; i++) {
         strncpy(_record[i], strings[i].c_str(), MAX);
     }
 }
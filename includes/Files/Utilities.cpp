@@ -9,6 +9,12 @@
 #include <string>
 #include <cassert>
 #include "utilities.h"
+#ifdef _WIN32
+#include <io.h>
+#include <fcntl.h>
+#else
+#include <unistd.h>
+#endif
 using namespace std;
 
 //checking if file exists by attempting to open it in binary read mode
@@ -141,4 +147,18 @@ void write_to_file_txt_app(const string& _filename, const vector<string>& data_a
     fout.close();
 }
 
+//cutting the file off after its first bytes bytes
+void truncate_file(const string& _filename, long bytes) {
+#ifdef _WIN32
+    int file = _open(_filename.c_str(), _O_RDWR | _O_BINARY);
+    if(file < 0 || _chsize_s(file, bytes) != 0)
+        cout <<"Could not truncate "<<_filename<<"\n";
+    if(file >= 0)
+        _close(file);
+#else
+    if(truncate(_filename.c_str(), bytes) != 0)
+        cout <<"Could not truncate "<<_filename<<"\n";
+#endif
+}
+
 #endif //UTILITIES_CPP
\ No newline at end of file
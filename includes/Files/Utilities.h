@@ -21,6 +21,7 @@ vectorstr read_from_file_txt(const string& _filename);              //reading da
 void write_to_file_bin(const string& _filename, const vector<string>& data_arr);        //appending data to binary file
 void write_to_file_txt(const string& _filename, const vector<string>& data_arr);        //writing data to text file (overwriting)
 void write_to_file_txt_app(const string& _filename, const vector<string>& data_arr);    //appending data to text file
+void truncate_file(const string& _filename, long bytes);                                //cutting file off after its first bytes bytes
 
 
 #endif // ZAC_UTILITIES_
\ No newline at end of file
@@ -0,0 +1,244 @@
+#ifndef FILTER_KERNELS_CPP
+#define FILTER_KERNELS_CPP
+
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <set>
+#include <vector>
+#include <string>
+#include <cassert>
+#include "filter_kernels.h"
+#include "../PredicatePlan/predicate_plan.h"
+
+//sse and avx2 kernels are compiled with per function target attributes and picked at run time,
+//so the rest of the program keeps building for a baseline cpu
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define FILTER_KERNELS_X86
+#include <immintrin.h>
+#endif
+
+using namespace std;
+
+namespace
+{
+    const uint64_t SIGN_BIT = 0x8000000000000000ULL;
+
+    //a comparison only needs which rows are below and which are above the literal
+    mask_word select_rows(int op, mask_word below, mask_word above)
+    {
+        switch(op)
+        {
+        case PLAN_EQ:
+            return ~(below | above);
+        case PLAN_LT:
+            return below;
+        case PLAN_GT:
+            return above;
+        case PLAN_LE:
+            return ~above;
+        case PLAN_GE:
+            return ~below;
+        case PLAN_NE:
+            return below | above;
+        default:
+            assert(false && "compare_keys() called with a logical op");
+            return 0;
+        }
+    }
+    mask_word valid_rows(int count)
+    {
+        return count >= MASK_WORD_BITS ? ~mask_word(0) : (mask_word(1) << count) - 1;
+    }
+    void compare_scalar(int op, const uint64_t* keys, int count, uint64_t literal, mask_word* mask)
+    {
+        for(int first = 0; first < count; first += MASK_WORD_BITS)
+        {
+            int rows = count - first < MASK_WORD_BITS ? count - first : MASK_WORD_BITS;
+            mask_word below = 0;
+            mask_word above = 0;
+            for(int i = 0; i < rows; i++)
+            {
+                below |= mask_word(keys[first + i] < literal) << i;
+                above |= mask_word(keys[first + i] > literal) << i;
+            }
+            mask[first / MASK_WORD_BITS] = select_rows(op, below, above) & valid_rows(rows);
+        }
+    }
+
+#ifdef FILTER_KERNELS_X86
+    //there are no unsigned 64 bit compares, flipping the sign bit of both sides makes the signed ones order the same
+    __attribute__((target("sse4.2")))
+    void compare_sse4(int op, const uint64_t* keys, int count, uint64_t literal, mask_word* mask)
+    {
+        const __m128i lit = _mm_set1_epi64x(literal ^ SIGN_BIT);
+        const __m128i bias = _mm_set1_epi64x(SIGN_BIT);
+        int full = count - count % MASK_WORD_BITS;
+        for(int first = 0; first < full; first += MASK_WORD_BITS)
+        {
+            mask_word below = 0;
+            mask_word above = 0;
+            for(int i = 0; i < MASK_WORD_BITS; i += 2)
+            {
+                __m128i v = _mm_xor_si128(_mm_loadu_si128((const __m128i*)(keys + first + i)), bias);
+                below |= mask_word(_mm_movemask_pd(_mm_castsi128_pd(_mm_cmpgt_epi64(lit, v)))) << i;
+                above |= mask_word(_mm_movemask_pd(_mm_castsi128_pd(_mm_cmpgt_epi64(v, lit)))) << i;
+            }
+            mask[first / MASK_WORD_BITS] = select_rows(op, below, above);
+        }
+        if(full < count)
+            compare_scalar(op, keys + full, count - full, literal, mask + full / MASK_WORD_BITS);
+    }
+    __attribute__((target("avx2")))
+    void compare_avx2(int op, const uint64_t* keys, int count, uint64_t literal, mask_word* mask)
+    {
+        const __m256i lit = _mm256_set1_epi64x(literal ^ SIGN_BIT);
+        const __m256i bias = _mm256_set1_epi64x(SIGN_BIT);
+        int full = count - count % MASK_WORD_BITS;
+        for(int first = 0; first < full; first += MASK_WORD_BITS)
+        {
+            mask_word below = 0;
+            mask_word above = 0;
+            for(int i = 0; i < MASK_WORD_BITS; i += 4)
+            {
+                __m256i v = _mm256_xor_si256(_mm256_loadu_si256((const __m256i*)(keys + first + i)), bias);
+                below |= mask_word(_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(lit, v)))) << i;
+                above |= mask_word(_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(v, lit)))) << i;
+            }
+            mask[first / MASK_WORD_BITS] = select_rows(op, below, above);
+        }
+        if(full < count)
+            compare_scalar(op, keys + full, count - full, literal, mask + full / MASK_WORD_BITS);
+    }
+    __attribute__((target("avx2")))
+    void combine_avx2(bool is_and, mask_word* lhs, const mask_word* rhs, int words)
+    {
+        int i = 0;
+        for(; i + 4 <= words; i += 4)
+        {
+            __m256i l = _mm256_loadu_si256((const __m256i*)(lhs + i));
+            __m256i r = _mm256_loadu_si256((const __m256i*)(rhs + i));
+            _mm256_storeu_si256((__m256i*)(lhs + i), is_and ? _mm256_and_si256(l, r) : _mm256_or_si256(l, r));
+        }
+        for(; i < words; i++)
+            lhs[i] = is_and ? lhs[i] & rhs[i] : lhs[i] | rhs[i];
+    }
+#endif
+
+    int usable_level(int level)
+    {
+        int best = simd_level();
+        return level < 0 || level > best ? best : level;
+    }
+    int detect_level()
+    {
+#ifdef FILTER_KERNELS_X86
+        __builtin_cpu_init();
+        if(__builtin_cpu_supports("avx2"))
+            return SIMD_AVX2;
+        if(__builtin_cpu_supports("sse4.2"))
+            return SIMD_SSE4;
+#endif
+        return SIMD_SCALAR;
+    }
+}
+
+int simd_level()
+{
+    static const int level = detect_level();
+    return level;
+}
+string simd_level_name(int level)
+{
+    switch(level)
+    {
+    case SIMD_AVX2:
+        return "avx2";
+    case SIMD_SSE4:
+        return "sse4";
+    default:
+        return "scalar";
+    }
+}
+uint64_t value_key(const char* value, int max_len, bool& longer)
+{
+    uint64_t key = 0;
+    int i = 0;
+    for(; i < 8 && i < max_len && value[i] != '\0'; i++)
+        key |= uint64_t((unsigned char)value[i]) << (8 * (7 - i));
+    longer = i == 8 && i < max_len && value[i] != '\0';
+    return key;
+}
+void compare_keys(int op, const uint64_t* keys, int count, uint64_t literal, mask_word* mask, int level)
+{
+    switch(usable_level(level))
+    {
+#ifdef FILTER_KERNELS_X86
+    case SIMD_AVX2:
+        compare_avx2(op, keys, count, literal, mask);
+        return;
+    case SIMD_SSE4:
+        compare_sse4(op, keys, count, literal, mask);
+        return;
+#endif
+    default:
+        compare_scalar(op, keys, count, literal, mask);
+    }
+}
+void mask_and(mask_word* lhs, const mask_word* rhs, int words, int level)
+{
+#ifdef FILTER_KERNELS_X86
+    if(usable_level(level) == SIMD_AVX2)
+    {
+        combine_avx2(true, lhs, rhs, words);
+        return;
+    }
+#endif
+    for(int i = 0; i < words; i++)
+        lhs[i] &= rhs[i];
+}
+void mask_or(mask_word* lhs, const mask_word* rhs, int words, int level)
+{
+#ifdef FILTER_KERNELS_X86
+    if(usable_level(level) == SIMD_AVX2)
+    {
+        combine_avx2(false, lhs, rhs, words);
+        return;
+    }
+#endif
+    for(int i = 0; i < words; i++)
+        lhs[i] |= rhs[i];
+}
+void mask_not(mask_word* mask, int count)
+{
+    for(int first = 0; first < count; first += MASK_WORD_BITS)
+        mask[first / MASK_WORD_BITS] = ~mask[first / MASK_WORD_BITS] & valid_rows(count - first);
+}
+bool mask_empty(const mask_word* mask, int words)
+{
+    for(int i = 0; i < words; i++)
+    {
+        if(mask[i])
+            return false;
+    }
+    return true;
+}
+void append_selected(const mask_word* mask, int count, long base, vectorlong& rows)
+{
+    for(int w = 0; w < mask_words(count); w++)
+    {
+        for(mask_word bits = mask[w]; bits; bits &= bits - 1)
+        {
+#if defined(__GNUC__) || defined(__clang__)
+            int bit = __builtin_ctzll(bits);
+#else
+            int bit = 0;
+            while(!(bits >> bit & 1))
+                bit++;
+#endif
+            rows.push_back(base + w * MASK_WORD_BITS + bit);
+        }
+    }
+}
+
+#endif //FILTER_KERNELS_CPP
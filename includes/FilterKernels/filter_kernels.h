@@ -0,0 +1,53 @@
+#ifndef FILTER_KERNELS_H
+#define FILTER_KERNELS_H
+
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <set>
+#include <vector>
+#include <string>
+#include <cassert>
+#include <cstdint>
+#include "../Table/typedefs.h"
+
+using namespace std;
+
+//kernels a batch filter runs over a column of up to a few thousand rows at a time
+//
+//a column is an array of 64 bit keys, each the first 8 bytes of a field value read big endian
+//and zero padded, so comparing two keys as unsigned numbers orders them the way strcmp orders
+//the values, exactly so when neither value is longer than 8 bytes
+//a comparison leaves a selection bitmask: bit i % 64 of word i / 64 is set if row i passed
+
+typedef uint64_t mask_word;
+
+const int MASK_WORD_BITS = 64;
+
+enum simd_levels {SIMD_SCALAR, SIMD_SSE4, SIMD_AVX2};
+
+//words a mask of rows rows takes
+inline int mask_words(int rows) {return (rows + MASK_WORD_BITS - 1) / MASK_WORD_BITS;}
+
+//best level this cpu runs, detected once, SIMD_SCALAR off x86 or without gcc/clang builtins
+int simd_level();
+string simd_level_name(int level);
+
+//key of value, reading at most max_len bytes, longer is set if it has more than the 8 bytes the key holds
+uint64_t value_key(const char* value, int max_len, bool& longer);
+
+//mask of the rows whose key compares to literal as op (a PLAN_EQ .. PLAN_NE leaf op) does
+//bits past count are left clear, level above simd_level() runs at simd_level()
+void compare_keys(int op, const uint64_t* keys, int count, uint64_t literal, mask_word* mask, int level = -1);
+
+//lhs = lhs and rhs, lhs = lhs or rhs, over words words
+void mask_and(mask_word* lhs, const mask_word* rhs, int words, int level = -1);
+void mask_or(mask_word* lhs, const mask_word* rhs, int words, int level = -1);
+//flips the first count bits of mask, leaving the rest clear
+void mask_not(mask_word* mask, int count);
+//true if no bit of the first words words is set
+bool mask_empty(const mask_word* mask, int words);
+//appends base + i for every set bit i of the first count bits, ascending
+void append_selected(const mask_word* mask, int count, long base, vectorlong& rows);
+
+#endif //FILTER_KERNELS_H
@@ -0,0 +1,417 @@
+#ifndef JOIN_CPP
+#define JOIN_CPP
+
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <set>
+#include <vector>
+#include <string>
+#include <cassert>
+#include <algorithm>
+#include "join.h"
+#include "../SortingAlgorithms/RecnoSort.h"
+
+using namespace std;
+
+namespace
+{
+    bool is_relational(const string& token)
+    {
+        return PredicatePlan::relational_op(token) != -1;
+    }
+    //splits tokens wherever word appears outside parentheses
+    vector<vectorstr> split_top_level(const vectorstr& tokens, const string& word)
+    {
+        vector<vectorstr> parts(1);
+        int depth = 0;
+        for(int i = 0; i < tokens.size(); i++)
+        {
+            if(tokens[i] == "(")
+                depth++;
+            else if(tokens[i] == ")")
+                depth--;
+            if(depth == 0 && tokens[i] == word)
+                parts.push_back(vectorstr());
+            else
+                parts.back().push_back(tokens[i]);
+        }
+        return parts;
+    }
+    //true if the first "(" is closed by the last token
+    bool wrapped(const vectorstr& tokens)
+    {
+        if(tokens.size() < 2 || tokens.front() != "(" || tokens.back() != ")")
+            return false;
+        int depth = 0;
+        for(int i = 0; i < tokens.size() - 1; i++)
+        {
+            if(tokens[i] == "(")
+                depth++;
+            else if(tokens[i] == ")")
+                depth--;
+            if(depth == 0)
+                return false;
+        }
+        return true;
+    }
+    //a and (b and c) gives a, b and c, anything with an or outside parentheses stays whole
+    void conjuncts(const vectorstr& tokens, vector<vectorstr>& parts)
+    {
+        if(wrapped(tokens))
+        {
+            conjuncts(vectorstr(tokens.begin() + 1, tokens.end() - 1), parts);
+            return;
+        }
+        vector<vectorstr> ands = split_top_level(tokens, "and");
+        if(ands.size() == 1 || split_top_level(tokens, "or").size() > 1)
+        {
+            parts.push_back(tokens);
+            return;
+        }
+        for(int i = 0; i < ands.size(); i++)
+            conjuncts(ands[i], parts);
+    }
+}
+
+JoinCursor::JoinCursor(Table& left, const string& left_name, Table& right, const string& right_name,
+                       const vectorstr& condition, const vectorstr& columns, bool plan_only) throw(Error_Code)
+{
+    Error_Code error_code;
+    if(left_name == right_name)
+    {
+        error_code._code = UNSUPPORTED_JOIN;
+        throw error_code;
+    }
+    _sides[0].table = &left;
+    _sides[0].name = left_name;
+    _sides[1].table = &right;
+    _sides[1].name = right_name;
+    _key_fields[0] = _key_fields[1] = -1;
+    _outer_next = 0;
+    _match_next = 0;
+    _current = nullptr;
+    _built = false;
+    _plan_only = plan_only;
+
+    vectorstr pushed[2];
+    split_condition(condition, pushed);
+    for(int i = 0; i < 2; i++)
+        select_side(i, pushed[i]);
+
+    vectorstr names = columns;
+    if(names.empty())
+    {
+        for(int i = 0; i < 2; i++)
+        {
+            vectorstr fields = _sides[i].table->get_field_names();
+            for(int j = 0; j < fields.size(); j++)
+                names.push_back(_sides[i].name + "." + fields[j]);
+        }
+    }
+    for(int i = 0; i < names.size(); i++)
+    {
+        int side, field;
+        resolve(names[i], side, field);
+        _column_names.push_back(names[i]);
+        _column_sides.push_back(side);
+        _column_fields.push_back(field);
+    }
+    choose_method();
+}
+int JoinCursor::add_column(const string& column) throw(Error_Code)
+{
+    int side, field;
+    resolve(column, side, field);
+    for(int i = 0; i < _column_names.size(); i++)
+    {
+        if(_column_sides[i] == side && _column_fields[i] == field)
+            return i;
+    }
+    _column_names.push_back(column);
+    _column_sides.push_back(side);
+    _column_fields.push_back(field);
+    return _column_names.size() - 1;
+}
+string JoinCursor::method_name(int method)
+{
+    switch(method)
+    {
+    case INDEX_NESTED_LOOP_JOIN:
+        return "index nested loop join";
+    case HASH_JOIN:
+        return "hash join";
+    default:
+        return "cross join";
+    }
+}
+string JoinCursor::join_key() const
+{
+    if(_key_fields[0] == -1)
+        return "";
+    string key;
+    for(int i = 0; i < 2; i++)
+    {
+        if(i)
+            key += " = ";
+        key += _sides[i].name + "." + _sides[i].table->get_field_names()[_key_fields[i]];
+    }
+    return key;
+}
+double JoinCursor::estimate_rows()
+{
+    //every left row meets the right rows sharing its key, as if the keys were spread evenly
+    double rows = _sides[0].rows * _sides[1].rows;
+    if(_key_fields[0] == -1)
+        return rows;
+    long keys = _sides[1].table->field_index(_key_fields[1]).size();
+    return keys > 0 ? rows / keys : 0;
+}
+bool JoinCursor::next(vectorstr& row)
+{
+    if(_plan_only)
+        return false;
+    if(!_built)
+        build();
+    JoinSide& outer = _sides[0];
+    JoinSide& inner = _sides[1];
+    while(true)
+    {
+        while(!_current || _match_next >= _current->size())
+        {
+            if(_outer_next >= outer.recnos.size())
+                return false;
+            _outer_row = outer.table->read_record(outer.records, outer.recnos[_outer_next++]);
+            find_matches();
+        }
+        long match = (*_current)[_match_next++];
+        vectorstr read_row;
+        if(_method == INDEX_NESTED_LOOP_JOIN)
+            read_row = inner.table->read_record(inner.records, match);
+        const vectorstr& inner_row = _method == INDEX_NESTED_LOOP_JOIN ? read_row : _inner_rows[match];
+        bool equal = true;
+        for(int i = 0; i < _also_equal.size() && equal; i++)
+            equal = _outer_row[_also_equal[i].first] == inner_row[_also_equal[i].second];
+        if(!equal)
+            continue;
+        row.clear();
+        for(int i = 0; i < _column_names.size(); i++)
+            row.push_back(_column_sides[i] == 0 ? _outer_row[_column_fields[i]] : inner_row[_column_fields[i]]);
+        return true;
+    }
+}
+
+//private
+void JoinCursor::resolve(const string& column, int& side, int& field) throw(Error_Code)
+{
+    Error_Code error_code;
+    error_code._error_token = column;
+    error_code._code = UNKNOWN_COLUMN;
+    error_code._modify_to_postgre = true;
+    string::size_type dot = column.find('.');
+    if(dot != string::npos)
+    {
+        string qualifier = column.substr(0, dot);
+        string name = column.substr(dot + 1);
+        for(int i = 0; i < 2; i++)
+        {
+            if(_sides[i].name == qualifier && _sides[i].table->has_field(name))
+            {
+                side = i;
+                field = _sides[i].table->field_position(name);
+                return;
+            }
+        }
+        throw error_code;
+    }
+    side = -1;
+    for(int i = 0; i < 2; i++)
+    {
+        if(!_sides[i].table->has_field(column))
+            continue;
+        if(side != -1)
+        {
+            error_code._code = AMBIGUOUS_COLUMN;
+            throw error_code;
+        }
+        side = i;
+        field = _sides[i].table->field_position(column);
+    }
+    if(side == -1)
+        throw error_code;
+}
+bool JoinCursor::names_column(const string& token, int lhs_side) const
+{
+    string::size_type dot = token.find('.');
+    if(dot == string::npos)
+        return _sides[1 - lhs_side].table->has_field(token) && !_sides[lhs_side].table->has_field(token);
+    for(int i = 0; i < 2; i++)
+    {
+        if(_sides[i].name == token.substr(0, dot) && _sides[i].table->has_field(token.substr(dot + 1)))
+            return true;
+    }
+    return false;
+}
+void JoinCursor::split_condition(const vectorstr& condition, vectorstr pushed[2]) throw(Error_Code)
+{
+    const bool debug = false;
+    Error_Code error_code;
+    vector<vectorstr> parts;
+    if(!condition.empty())
+        conjuncts(condition, parts);
+    for(int i = 0; i < parts.size(); i++)
+    {
+        const vectorstr& part = parts[i];
+        //a.x = b.y
+        int sides[2], fields[2];
+        if(part.size() == 3 && part[1] == "=")
+            resolve(part[0], sides[0], fields[0]);
+        if(part.size() == 3 && part[1] == "=" && names_column(part[2], sides[0]))
+        {
+            resolve(part[2], sides[1], fields[1]);
+            if(sides[0] != sides[1])
+            {
+                if(sides[0] == 1)
+                    Swap(fields[0], fields[1]);
+                if(_key_fields[0] == -1)
+                {
+                    _key_fields[0] = fields[0];
+                    _key_fields[1] = fields[1];
+                }
+                else
+                    _also_equal.push_back(make_pair(fields[0], fields[1]));
+                continue;
+            }
+        }
+        //everything else has to be about one table, its field names lose the table name
+        int side = -1;
+        int lhs_side = -1;
+        vectorstr local = part;
+        for(int j = 0; j < part.size(); j++)
+        {
+            error_code._code = UNSUPPORTED_JOIN_CONDITION;
+            if(j + 1 < part.size() && is_relational(part[j + 1]))
+            {
+                int field;
+                resolve(part[j], lhs_side, field);
+                if(side != -1 && side != lhs_side)
+                    throw error_code;
+                side = lhs_side;
+                local[j] = _sides[side].table->get_field_names()[field];
+            }
+            else if(j > 0 && is_relational(part[j - 1]) && lhs_side != -1 && names_column(part[j], lhs_side))
+                throw error_code;
+        }
+        if(side == -1)
+            side = 0;
+        if(!pushed[side].empty())
+            pushed[side].push_back("and");
+        pushed[side].push_back("(");
+        pushed[side].insert(pushed[side].end(), local.begin(), local.end());
+        pushed[side].push_back(")");
+    }
+    if(debug)
+        cout<<"left: "<<pushed[0]<<"\nright: "<<pushed[1]<<"\n";
+}
+void JoinCursor::select_side(int side, const vectorstr& condition) throw(Error_Code)
+{
+    JoinSide& s = _sides[side];
+    if(condition.empty())
+    {
+        if(!_plan_only)
+            s.recnos = s.table->all_recnos();
+        s.rows = s.table->record_count();
+        return;
+    }
+    PredicatePlan plan = s.table->compile_condition(condition);
+    if(_plan_only)
+    {
+        s.rows = s.table->estimate_where_rows(plan).back();
+        return;
+    }
+    //single comparisons come back in index key order, the join walks recno order
+    s.recnos = s.table->where_recnos(plan);
+    s.rows = s.recnos.size();
+    sort_recnos(s.recnos);
+    s.is_selected.assign(s.table->record_count(), false);
+    for(int i = 0; i < s.recnos.size(); i++)
+        s.is_selected[s.recnos[i]] = true;
+}
+void JoinCursor::choose_method()
+{
+    const bool debug = false;
+    if(_key_fields[0] == -1)
+    {
+        _method = CROSS_JOIN;
+        return;
+    }
+    //both read every left record, they differ in how the right rows for each are found
+    //the index walks each left key's value list, skipping right records the right side's
+    //own conditions dropped, and reads every match from disk again
+    //the hash join reads the selected right records once and keeps them in memory
+    double outer = _sides[0].rows;
+    double inner = _sides[1].rows;
+    double records = _sides[1].table->record_count();
+    long keys = _sides[1].table->field_index(_key_fields[1]).size();
+    if(records == 0 || keys == 0)
+    {
+        _method = INDEX_NESTED_LOOP_JOIN;
+        return;
+    }
+    double per_key = records / keys;
+    double selected = inner / records;
+    double index_cost = outer * (1 + per_key * (1 - selected) + per_key * selected * RECORD_READ_COST);
+    double hash_cost = inner * RECORD_READ_COST + outer;
+    _method = hash_cost < index_cost ? HASH_JOIN : INDEX_NESTED_LOOP_JOIN;
+    if(debug)
+        cout<<"index cost: "<<index_cost<<", hash cost: "<<hash_cost<<", "<<method_name(_method)<<"\n";
+}
+void JoinCursor::build()
+{
+    _built = true;
+    for(int i = 0; i < 2; i++)
+        _sides[i].table->open_records(_sides[i].records);
+    if(_method == INDEX_NESTED_LOOP_JOIN)
+        return;
+    //build side of a hash join, or the rows a cross join pairs with every left row
+    JoinSide& inner = _sides[1];
+    _inner_rows.reserve(inner.recnos.size());
+    for(int i = 0; i < inner.recnos.size(); i++)
+    {
+        _inner_rows.push_back(inner.table->read_record(inner.records, inner.recnos[i]));
+        if(_method == HASH_JOIN)
+            _hash[_inner_rows.back()[_key_fields[1]]].push_back(i);
+        else
+            _all_rows.push_back(i);
+    }
+}
+void JoinCursor::find_matches()
+{
+    _match_next = 0;
+    if(_method == CROSS_JOIN)
+    {
+        _current = &_all_rows;
+        return;
+    }
+    const string& key = _outer_row[_key_fields[0]];
+    if(_method == HASH_JOIN)
+    {
+        unordered_map<string, vectorlong>::const_iterator bucket = _hash.find(key);
+        _current = bucket == _hash.end() ? nullptr : &bucket->second;
+        return;
+    }
+    _matches.clear();
+    _current = &_matches;
+    JoinSide& inner = _sides[1];
+    mmap_sl& index = inner.table->field_index(_key_fields[1]);
+    if(!index.contains(key))
+        return;
+    const vectorlong& recnos = index.get(key);
+    for(int i = 0; i < recnos.size(); i++)
+    {
+        if(inner.is_selected.empty() || inner.is_selected[recnos[i]])
+            _matches.push_back(recnos[i]);
+    }
+}
+
+#endif //JOIN_CPP
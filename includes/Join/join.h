@@ -0,0 +1,91 @@
+#ifndef JOIN_H
+#define JOIN_H
+
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <set>
+#include <vector>
+#include <string>
+#include <cassert>
+#include <fstream>
+#include <unordered_map>
+#include "../Table/table.h"
+#include "../error_code/error_code.h"
+
+using namespace std;
+
+enum join_methods {CROSS_JOIN, INDEX_NESTED_LOOP_JOIN, HASH_JOIN};
+
+//one table of a join, the records its own conditions select and the name the query calls it by
+struct JoinSide
+{
+    Table* table;
+    string name;
+    vectorlong recnos;          //ascending
+    double rows;                //records its own conditions select, estimated when only planned
+    vector<bool> is_selected;   //by recno, empty when every record is selected
+    fstream records;
+    JoinSide(): table(nullptr), rows(0) {}
+};
+
+//streams the rows of an inner join of two tables, one row per next() call
+//left is the outer side and rows come in its recno order, right is the inner side
+//the condition (on and where together) is split into:
+//  conditions on one table, pushed down to that table's indexes before joining
+//  left.x = right.y equalities, the first one is the join key and the rest are checked per row
+class JoinCursor
+{
+public:
+    //columns are "table.field" or a field only one of the two tables has, empty for every field of both
+    //plan_only, for an explain, picks the method from each side's estimated rows and selects no
+    //records, next() then gives no rows
+    JoinCursor(Table& left, const string& left_name, Table& right, const string& right_name,
+               const vectorstr& condition, const vectorstr& columns, bool plan_only = false) throw(Error_Code);
+    //appends a column the rows carry without it being selected, for an order by, returns its position
+    int add_column(const string& column) throw(Error_Code);
+    vectorstr column_names() const {return _column_names;}
+    int method() const {return _method;}
+    static string method_name(int method);
+    //for an explain: records each side's own conditions select (estimated if plan_only), the
+    //join key as "left.x = right.y" (empty for a cross join) and the rows the join is expected to give
+    double side_rows(int side) const {return _sides[side].rows;}
+    string join_key() const;
+    double estimate_rows();
+    //fills row with the next joined row, false once the join is done
+    bool next(vectorstr& row);
+
+private:
+    JoinSide _sides[2];
+    vectorstr _column_names;
+    vector<int> _column_sides;
+    vector<int> _column_fields;
+    int _method;
+    bool _plan_only;
+    int _key_fields[2];                 //join key field position on each side, -1 for a cross join
+    vector<pair<int, int> > _also_equal;    //left and right field positions of the other equalities
+
+    long _outer_next;                   //position in the left recnos
+    vectorstr _outer_row;
+    vectorlong _matches;                //right recnos the index gives for the current left row
+    const vectorlong* _current;         //_matches, a hash bucket or every right row position for a cross join
+    long _match_next;
+    bool _built;
+    vector<vectorstr> _inner_rows;      //right rows held in memory by hash and cross joins
+    vectorlong _all_rows;               //0.._inner_rows.size()-1, for a cross join
+    unordered_map<string, vectorlong> _hash;    //join key to positions in _inner_rows
+
+    //side and field position of a column, qualified or not
+    void resolve(const string& column, int& side, int& field) throw(Error_Code);
+    //true if the right side of a comparison is a column rather than a value: "table.field"
+    //for a field of either table, or a field only the other table than the left side's has
+    bool names_column(const string& token, int lhs_side) const;
+    void split_condition(const vectorstr& condition, vectorstr pushed[2]) throw(Error_Code);
+    //selects the side's records, or only estimates how many there are when planning
+    void select_side(int side, const vectorstr& condition) throw(Error_Code);
+    void choose_method();
+    void build();
+    void find_matches();
+};
+
+#endif //JOIN_H
@@ -0,0 +1,85 @@
+#ifndef PARALLEL_SCAN_CPP
+#define PARALLEL_SCAN_CPP
+
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <set>
+#include <vector>
+#include <string>
+#include <cassert>
+#include "parallel_scan.h"
+
+using namespace std;
+
+ParallelScan::ParallelScan(const string& bin_filename, int threads)
+{
+    _bin_filename = bin_filename;
+    _threads = threads > 0 ? threads : 1;
+    _records_read = 0;
+}
+vectorlong ParallelScan::filter(const PredicatePlan& plan, long record_count, long keep)
+{
+    vectorlong recnos;
+    long morsels = (record_count + SCAN_MORSEL_RECORDS - 1) / SCAN_MORSEL_RECORDS;
+    //without a limit every morsel goes in one wave, with one a wave is a morsel per thread
+    long wave = keep < 0 ? morsels : _threads;
+    for(long first = 0; first < morsels && (keep < 0 || recnos.size() < keep); first += wave)
+    {
+        long count = first + wave < morsels ? wave : morsels - first;
+        vector<vectorlong> found(count);
+        ThreadPool::shared().parallel_for(count, [&](int m)
+        {
+            long begin = (first + m) * SCAN_MORSEL_RECORDS;
+            long end = begin + SCAN_MORSEL_RECORDS < record_count ? begin + SCAN_MORSEL_RECORDS : record_count;
+            //the morsel is one batch: read in one go, decoded into columns and filtered a kernel at a time
+            fstream f;
+            BatchFilter batch_filter(plan);
+            ColumnBatch batch(batch_filter.fields());
+            open_fileRW(f, _bin_filename.c_str());
+            if(batch.load(f, begin, end) > 0)
+                append_selected(batch_filter.filter(batch), batch.rows(), begin, found[m]);
+            f.close();
+        }, _threads);
+        for(int m = 0; m < count; m++)
+            recnos.insert(recnos.end(), found[m].begin(), found[m].end());
+        _records_read += (first + count) * SCAN_MORSEL_RECORDS < record_count ? count * SCAN_MORSEL_RECORDS : record_count - first * SCAN_MORSEL_RECORDS;
+    }
+    if(keep >= 0 && recnos.size() > keep)
+        recnos.resize(keep);
+    return recnos;
+}
+void ParallelScan::for_each_row(const vectorlong& recnos, const vector<int>& fields, const function<void(const vectorstr&)>& visit)
+{
+    long morsels = (recnos.size() + SCAN_MORSEL_RECORDS - 1) / SCAN_MORSEL_RECORDS;
+    vector<vectorstr> rows;
+    for(long first = 0; first < morsels; first += _threads)
+    {
+        long count = first + _threads < morsels ? _threads : morsels - first;
+        long wave_begin = first * SCAN_MORSEL_RECORDS;
+        long wave_end = wave_begin + count * SCAN_MORSEL_RECORDS < recnos.size() ? wave_begin + count * SCAN_MORSEL_RECORDS : recnos.size();
+        rows.assign(wave_end - wave_begin, vectorstr());
+        ThreadPool::shared().parallel_for(count, [&](int m)
+        {
+            long begin = wave_begin + m * SCAN_MORSEL_RECORDS;
+            long end = begin + SCAN_MORSEL_RECORDS < wave_end ? begin + SCAN_MORSEL_RECORDS : wave_end;
+            fstream f;
+            FileRecord r;
+            open_fileRW(f, _bin_filename.c_str());
+            for(long i = begin; i < end; i++)
+            {
+                r.read(f, recnos[i]);
+                vectorstr& row = rows[i - wave_begin];
+                row.reserve(fields.size());
+                for(int j = 0; j < fields.size(); j++)
+                    row.push_back(r._record[fields[j]]);
+            }
+            f.close();
+        }, _threads);
+        _records_read += rows.size();
+        for(int i = 0; i < rows.size(); i++)
+            visit(rows[i]);
+    }
+}
+
+#endif //PARALLEL_SCAN_CPP
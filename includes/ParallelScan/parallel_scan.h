@@ -0,0 +1,46 @@
+#ifndef PARALLEL_SCAN_H
+#define PARALLEL_SCAN_H
+
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <set>
+#include <vector>
+#include <string>
+#include <cassert>
+#include <functional>
+#include "../Table/typedefs.h"
+#include "../Table/table_constants.h"
+#include "../Files/FileRecord.h"
+#include "../Files/utilities.h"
+#include "../PredicatePlan/predicate_plan.h"
+#include "../ThreadPool/thread_pool.h"
+#include "../BatchFilter/batch_filter.h"
+
+using namespace std;
+
+//reads a table's records on the shared thread pool in morsels of SCAN_MORSEL_RECORDS records,
+//every worker reading, filtering and projecting its morsels with its own file stream
+//filter() reads a morsel as one ColumnBatch and runs its plan over it with the BatchFilter kernels
+//results are put back together in recno order
+class ParallelScan
+{
+public:
+    //threads is the degree of parallelism, the calling thread included
+    ParallelScan(const string& bin_filename, int threads);
+    //recnos below record_count whose record satisfies plan, ascending
+    //keep > -1 stops reading once the first keep of them are found
+    vectorlong filter(const PredicatePlan& plan, long record_count, long keep = -1);
+    //hands visit the fields (positions) of each record in recnos, one row at a time in recnos order,
+    //reading a wave of morsels in parallel while only that wave is held in memory
+    void for_each_row(const vectorlong& recnos, const vector<int>& fields, const function<void(const vectorstr&)>& visit);
+    //records filter() and for_each_row() have read so far
+    long records_read() const {return _records_read;}
+
+private:
+    string _bin_filename;
+    int _threads;
+    long _records_read;
+};
+
+#endif //PARALLEL_SCAN_H
@@ -19,110 +19,40 @@ Parser::Parser()
     //should not be using defualt CTOR
     cout<<"Should not be using default CTOR\n";
 }
-Parser::Parser(char cmd_str[300])
+Parser::Parser(StrView cmd_str)
 {
-    init_table(_table);
-    make_table();
-    build_keyword_map();
+    static const bool tables_built = build_tables();
+    assert(tables_built);
     set_string(cmd_str);
-    //build
 }
-//To Update Parser Commands must make changes to this function v 
-mmap_ss Parser::parse_tree() throw(Error_Code)
+void Parser::parse() throw(Error_Code)
 {
     const bool debug = false;
     Error_Code error_code;
-    STokenizer stk(_input_buffer);
-    SToken t;
-    Queue<string> input_q;
-    string quotation_str = "";
-    int quotation_count = 0;
-    bool waiting_for_alpha = false;
-    stk>>t;
-    while(stk.more())
-    {
-        //process token here...
-        bool punc_tok_contains_quotation = false;
-        if(t.type_string() == "PUNC")
-        {
-            //v if double quote in one punc token, this wont be true
-            if(t.token_str() == "\"")
-                quotation_count++;
-            else if(t.token_str() == ",")
-               input_q.push(t.token_str());
-            else
-            {
-                for(int i = 0; i < t.token_str().size(); i++)
-                {
-                    if(t.token_str()[i] == '\"')
-                    {
-                        quotation_count++;
-                        punc_tok_contains_quotation = true;
-                    }
-                }
-            }
-            
-        }
-        else if((t.type_string() == "ALPHA" || t.type_string() == "NUMBER" 
-        || t.type_string() == "OPERATOR" || t.type_string() == "PAREN" || t.token_str() == ",") && quotation_count == 0)
-        {
-        //   cout<<setw(10)<<t.type_string()<<setw(10)<<t<<endl;
-          input_q.push(t.token_str());
-        }
-
-        if(quotation_count == 1 && t.token_str() != "\"" && !punc_tok_contains_quotation)
-            quotation_str += t.token_str();
-        if(quotation_count == 2)
-        {
-            quotation_count = 0;
-            if(punc_tok_contains_quotation)
-            {
-                int i = 0;
-                while(t.token_str()[i] != '\"')
-                {
-                    quotation_str += t.token_str()[i];
-                    i++;
-                }
-            }
-            if(!quotation_str.empty())
-                input_q.push(quotation_str);
-            quotation_str.clear();
-        }
-        t = SToken();
-        stk>>t;
-    }
+    tokenize();
     if(debug)
     {
-        cout<<"------Strings in input q------------\n";
-        for(Queue<string>::Iterator it = input_q.begin(); it != input_q.end(); it++)
-        {
-          cout<<*it<<"\n";
-        }
+        cout<<"------Tokens of the command------------\n";
+        for(int i = 0; i < _tokens.size(); i++)
+          cout<<_tokens[i].text<<"\n";
     }
-    //^ get the input token queues
-    if(input_q.empty())
+    if(_tokens.empty())
     {
       error_code._code = EMPTY_COMMAND;
       throw error_code;
     }
-    string cause_of_failure = "";
     int current_state =0;
     long new_state= 0;
     fail = false;
     int last_state_before_fail = 0;
-    // int select_field_name_count = 0;
-    // int select_comma_count = 0;
-    Queue<string>::Iterator it;
-    for(it = input_q.begin(); it != input_q.end() && current_state != -1; it++)
+    int i;
+    for(i = 0; i < _tokens.size() && current_state != -1; i++)
     {
         if(debug)
           cout<<"current state: "<<current_state<<"\n";
-        if(_keywords_map.contains(*it))
-        {
-          new_state = _keywords_map[*it];
-          current_state = _table[current_state][new_state];
-        }
-        else
+        //a quoted word is a value, "desc" or "limit" included
+        new_state = _tokens[i].quoted ? -1 : _keywords.find(_tokens[i].text.data(), _tokens[i].text.size());
+        if(new_state == -1)
         {
           if(!current_state)
           {
@@ -130,74 +60,20 @@ mmap_ss Parser::parse_tree() throw(Error_Code)
             throw error_code;
           }
           new_state = SYM;
-          current_state = _table[current_state][new_state];
         }
-        switch (current_state)
-        {
-        case SELECT:
-          _ptree["command"] += *it;
-          break;
-        case STAR:
-          _ptree["fields"] += *it;
-          break;
-        case TABLENAME:
-          _ptree["table_name"] += *it;
-          break;
-        case MAKE_OR_CREATE:
-          _ptree["command"] += *it;
-          break;
-        case NEWTABLENAME:
-          _ptree["table_name"] += *it;
-          break;
-        case FIELDNAME:
-          _ptree["col"] += *it;
-          break;
-        case INTO:
-          _ptree["command"] += string("insert");
-          break;
-        case OPENTABLENAME:
-          _ptree["table_name"] += *it;
-          break;
-        case VALUENAME:
-          _ptree["values"] += *it;
-          break;
-        case SELECTFIELDNAME:
-          _ptree["fields"] += *it;
-          break;
-        case WHERE:
-          _ptree["where"] += string("yes");
-          break;
-        case CONDITIONNAME:
-          _ptree["condition"] += *it;
-          break;
-        case TABLES:
-          _ptree["command"] += string("show ") + *it;
-          break;
-        case BATCH:
-          _ptree["command"] += *it;
-          break;
-        case DROP:
-          _ptree["command"] += *it;
-          break;
-        case DROPTABLENAME:
-          _ptree["table_name"] += *it;
-          break;
-        default:
-          break;
-        }
-        if(current_state == -1)
-          cause_of_failure = *it;
-        else
+        current_state = _table[current_state][new_state];
+        _tokens[i].state = current_state;
+        if(current_state != -1)
           last_state_before_fail = current_state;
     }
     if(current_state == -1)
     {
         fail = true;
-        _ptree.clear();
+        StrView cause_of_failure = _tokens[i - 1].text;
         if(debug)
             cout<<"actual failed state\n";
 
-        if(_keywords_map.contains(cause_of_failure))
+        if(!_tokens[i - 1].quoted && _keywords.find(cause_of_failure.data(), cause_of_failure.size()) != -1)
         {
           if(cause_of_failure == ",")
           {
@@ -218,14 +94,13 @@ mmap_ss Parser::parse_tree() throw(Error_Code)
           
           if(last_state_before_fail == SELECTFIELDNAME || last_state_before_fail == STAR)
           {
-            while(it != input_q.end())
+            for(; i < _tokens.size(); i++)
             {
-              if(*it == "from")
+              if(_tokens[i].text == "from")
               {
                 error_code._code = EXPECTED_COMMA;
                 throw error_code;
               }
-              it++;
             }
             error_code._code = EXPECT_FROM;
             throw error_code;
@@ -234,22 +109,245 @@ mmap_ss Parser::parse_tree() throw(Error_Code)
           throw error_code;
         }
     }
+}
+//To Update Parser Commands must make changes to this function v 
+void Parser::parse_statement(Statement& statement) throw(Error_Code)
+{
+    const bool debug = false;
+    parse();
+    statement.clear();
+    for(int i = 0; i < _tokens.size(); i++)
+    {
+        const StrView& token = _tokens[i].text;
+        if(_tokens[i].param)
+          statement.params++;
+        switch (_tokens[i].state)
+        {
+        case SELECT:
+          statement.command = COMMAND_SELECT;
+          break;
+        case STAR:
+        case SELECTFIELDNAME:
+          statement.fields.push_back(token.str());
+          break;
+        case TABLENAME:
+        case NEWTABLENAME:
+        case OPENTABLENAME:
+        case DROPTABLENAME:
+        case JOINTABLE:
+          statement.table_names.push_back(token.str());
+          break;
+        case MAKE_OR_CREATE:
+          statement.command = COMMAND_MAKE;
+          break;
+        case FIELDNAME:
+          statement.columns.push_back(token.str());
+          break;
+        case INTO:
+          statement.command = COMMAND_INSERT;
+          break;
+        case VALUENAME:
+        case VALUEROWNAME:
+          if(_tokens[i].param)
+            statement.value_params.push_back(statement.values.size());
+          statement.values.push_back(token.str());
+          break;
+        case VALUEROWCLOSE:
+          statement.row_ends.push_back(statement.values.size());
+          break;
+        case WHERE:
+          statement.where = true;
+          break;
+        case CONDITIONNAME:
+          if(_tokens[i].param)
+            statement.condition_params.push_back(statement.condition.size());
+          statement.condition.push_back(token.str());
+          break;
+        case TABLES:
+          statement.command = COMMAND_SHOW_TABLES;
+          break;
+        case BATCH:
+          statement.command = COMMAND_BATCH;
+          break;
+        case TRANSACTION:
+          statement.transaction = true;
+          break;
+        case DROP:
+          statement.command = COMMAND_DROP;
+          break;
+        case ORDER:
+          statement.order = true;
+          break;
+        case ORDERFIELD:
+        case ORDERAGGREGATE:
+          statement.order_by = token.str();
+          break;
+        case ORDERAGGOPEN:
+        case ORDERAGGFIELD:
+        case ORDERAGGCLOSE:
+          //order by count ( * ) names the result column "count(*)"
+          statement.order_by.append(token.data(), token.size());
+          break;
+        case ORDERDIRECTION:
+          statement.direction = token.str();
+          break;
+        case LIMIT:
+          statement.limit = true;
+          break;
+        case LIMITCOUNT:
+          statement.limit_count = token.str();
+          break;
+        case OFFSET:
+          statement.offset = true;
+          break;
+        case OFFSETCOUNT:
+          statement.offset_count = token.str();
+          break;
+        case GROUP:
+          statement.group = true;
+          break;
+        case GROUPFIELD:
+          statement.group_by.push_back(token.str());
+          break;
+        case AGGREGATE:
+          statement.aggregate = true;
+          statement.fields.push_back(token.str());
+          break;
+        case AGGOPEN:
+        case AGGFIELD:
+        case AGGCLOSE:
+          //count ( * ) is kept as the one field "count(*)"
+          statement.fields.back().append(token.data(), token.size());
+          break;
+        case JOIN:
+          statement.join = true;
+          break;
+        case JOINCONDITION:
+          statement.join_condition.push_back(token.str());
+          break;
+        case EXPLAIN:
+          statement.explain = true;
+          break;
+        case LOAD:
+          statement.command = COMMAND_LOAD;
+          break;
+        case LOADDATA:
+          //data is not a keyword, fields and values may still be called data
+          if(token != "data")
+          {
+            Error_Code error_code;
+            error_code._code = MISSING_KEYWORDS;
+            throw error_code;
+          }
+          break;
+        case LOADFILE:
+          statement.file_name = token.str();
+          break;
+        case LOADTABLE:
+          statement.table_names.push_back(token.str());
+          break;
+        case ANALYZE:
+          statement.analyze = true;
+          break;
+        default:
+          break;
+        }
+    }
+    //an insert row has to be closed, and a comma after one has to open the next
+    int last_state = _tokens[_tokens.size() - 1].state;
+    if(last_state == VALUEROWOPEN || last_state == VALUEROWNAME || last_state == VALUEROWNAMECOMMA)
+    {
+        Error_Code error_code;
+        error_code._code = MISSING_RIGHT_PAREN;
+        throw error_code;
+    }
+    if(last_state == VALUEROWCOMMA)
+    {
+        Error_Code error_code;
+        error_code._code = MISSING_LEFT_PAREN;
+        throw error_code;
+    }
     if(debug)
     {
-        cout<<_ptree<<"\n";
-        cout<<"reached the end of parse_tree:\n";
+        cout<<statement<<"\n";
+        cout<<"reached the end of parse_statement:\n";
     }
-    return _ptree;
 }
-void Parser::set_string(char cmd_str[300])
+void Parser::set_string(StrView cmd_str)
 {
     const bool debug = false;
-    strcpy(_input_buffer, cmd_str);
-    _ptree.clear();
+    _input = cmd_str;
+    _tokens.clear();
     if(debug)
-        cout<<"after _ptree is cleared: "<<_ptree<<"\n";
+        cout<<"parser input: "<<_input<<"\n";
 }
 //private
+void Parser::tokenize()
+{
+    STokenizer stk(_input);
+    SToken t;
+    //a quoted value is the text between its quotes, cut out of the command when the closing quote comes
+    //it is quoted with " or ', and only the quote that opened it closes it, "" is an empty value
+    int quotation_begin = -1;
+    char quote = '\0';
+    _tokens.clear();
+    stk>>t;
+    while(stk.more())
+    {
+        StrView token = t.view();
+        switch(t.type())
+        {
+        case STOKEN_PUNC:
+        {
+            //v one punc token can close a quote and open the next one
+            //outside quotes a "?" is a parameter
+            //a value is quoted with " or ', the other one is a character inside it
+            int token_begin = token.data() - _input.data();
+            for(int i = 0; i < token.size(); i++)
+            {
+                if(quotation_begin == -1 && token[i] == '?')
+                {
+                    _tokens.push_back(token.substr(i, 1), true);
+                    continue;
+                }
+                if(quotation_begin == -1 ? token[i] != '\"' && token[i] != '\'' : token[i] != quote)
+                    continue;
+                if(quotation_begin == -1)
+                {
+                    quotation_begin = token_begin + i + 1;
+                    quote = token[i];
+                }
+                else
+                {
+                    _tokens.push_back(_input.substr(quotation_begin, token_begin + i - quotation_begin), false, true);
+                    quotation_begin = -1;
+                }
+            }
+            if(token == "," && quotation_begin == -1)
+               _tokens.push_back(token);
+            break;
+        }
+        case STOKEN_ALPHA:
+        case STOKEN_NUMBER:
+        case STOKEN_OPERATOR:
+        case STOKEN_PAREN:
+            if(quotation_begin == -1)
+                _tokens.push_back(token);
+            break;
+        default:
+            break;
+        }
+        t = SToken();
+        stk>>t;
+    }
+}
+bool Parser::build_tables()
+{
+    init_table(_table);
+    make_table();
+    build_keyword_map();
+    return true;
+}
 //To Update Parser Commands must make changes to this function v 
 void Parser::make_table()
 {
@@ -295,6 +393,11 @@ void Parser::make_table()
     //v last minute addition comma
     mark_fail(_table, VALUENAMECOMMA);
     //^ last minute addition comma
+    mark_fail(_table, VALUEROWOPEN);
+    mark_fail(_table, VALUEROWNAME);
+    mark_fail(_table, VALUEROWNAMECOMMA);
+    mark_success(_table, VALUEROWCLOSE);
+    mark_fail(_table, VALUEROWCOMMA);
 
     //for show
     mark_fail(_table, SHOW);
@@ -302,11 +405,60 @@ void Parser::make_table()
 
     //for batch
     mark_success(_table, BATCH);
+    mark_success(_table, TRANSACTION);
 
     //for drop
     mark_fail(_table, DROP);
     mark_fail(_table, DROPTABLE);
     mark_success(_table, DROPTABLENAME);
+
+    //for order by
+    mark_fail(_table, ORDER);
+    mark_fail(_table, BY);
+    mark_success(_table, ORDERFIELD);
+    mark_success(_table, ORDERDIRECTION);
+    mark_fail(_table, ORDERAGGREGATE);
+    mark_fail(_table, ORDERAGGOPEN);
+    mark_fail(_table, ORDERAGGFIELD);
+    mark_success(_table, ORDERAGGCLOSE);
+
+    //for limit and offset
+    mark_fail(_table, LIMIT);
+    mark_success(_table, LIMITCOUNT);
+    mark_fail(_table, OFFSET);
+    mark_success(_table, OFFSETCOUNT);
+
+    //for group by
+    mark_fail(_table, GROUP);
+    mark_fail(_table, GROUPBY);
+    mark_success(_table, GROUPFIELD);
+    mark_fail(_table, GROUPFIELDCOMMA);
+
+    //for aggregates in the select list
+    mark_fail(_table, AGGREGATE);
+    mark_fail(_table, AGGOPEN);
+    mark_fail(_table, AGGFIELD);
+    mark_fail(_table, AGGCLOSE);
+
+    //for joins
+    mark_fail(_table, TABLENAMECOMMA);
+    mark_fail(_table, INNER);
+    mark_fail(_table, JOIN);
+    mark_fail(_table, JOINTABLE);
+    mark_fail(_table, ON);
+    mark_success(_table, JOINCONDITION);
+
+    //for explain
+    mark_fail(_table, EXPLAIN);
+    mark_fail(_table, ANALYZE);
+
+    //for load data
+    mark_fail(_table, LOAD);
+    mark_fail(_table, LOADDATA);
+    mark_fail(_table, LOADFROM);
+    mark_fail(_table, LOADFILE);
+    mark_fail(_table, LOADINTO);
+    mark_success(_table, LOADTABLE);
     
     //v Marking initial states 
     //mark the expected token previous row's as 
@@ -359,14 +511,144 @@ void Parser::make_table()
     mark_cell(0, _table, SHOW, SHOW);
     mark_cell(SHOW, _table, TABLES, TABLES);
     
-    //for batch
+    //for batch, batch transaction runs the script as one transaction
     mark_cell(0, _table, BATCH, BATCH);
+    mark_cell(BATCH, _table, TRANSACTION, TRANSACTION);
 
     //for drop
     mark_cell(0, _table, DROP, DROP);
     mark_cell(DROP, _table, TABLE, DROPTABLE);
     mark_cell(DROPTABLE, _table, SYM, DROPTABLENAME);
 
+    //for order by, after the table name or the where condition
+    mark_cell(TABLENAME, _table, ORDER, ORDER);
+    mark_cell(CONDITIONNAME, _table, ORDER, ORDER);
+    mark_cell(ORDER, _table, BY, BY);
+    mark_cell(BY, _table, SYM, ORDERFIELD);
+    mark_cell(ORDERFIELD, _table, ORDERDIRECTION, ORDERDIRECTION);
+    //or by an aggregate column of a grouped select
+    mark_cell(BY, _table, AGGREGATE, ORDERAGGREGATE);
+    mark_cell(ORDERAGGREGATE, _table, AGGOPEN, ORDERAGGOPEN);
+    mark_cell(ORDERAGGOPEN, _table, SYM, ORDERAGGFIELD);
+    mark_cell(ORDERAGGOPEN, _table, STAR, ORDERAGGFIELD);
+    mark_cell(ORDERAGGFIELD, _table, AGGCLOSE, ORDERAGGCLOSE);
+    mark_cell(ORDERAGGCLOSE, _table, ORDERDIRECTION, ORDERDIRECTION);
+
+    //for limit and offset, last in a select, offset may also come without a limit
+    mark_cell(TABLENAME, _table, LIMIT, LIMIT);
+    mark_cell(CONDITIONNAME, _table, LIMIT, LIMIT);
+    mark_cell(ORDERFIELD, _table, LIMIT, LIMIT);
+    mark_cell(ORDERDIRECTION, _table, LIMIT, LIMIT);
+    mark_cell(ORDERAGGCLOSE, _table, LIMIT, LIMIT);
+    mark_cell(LIMIT, _table, SYM, LIMITCOUNT);
+    mark_cell(TABLENAME, _table, OFFSET, OFFSET);
+    mark_cell(CONDITIONNAME, _table, OFFSET, OFFSET);
+    mark_cell(ORDERFIELD, _table, OFFSET, OFFSET);
+    mark_cell(ORDERDIRECTION, _table, OFFSET, OFFSET);
+    mark_cell(ORDERAGGCLOSE, _table, OFFSET, OFFSET);
+    mark_cell(LIMITCOUNT, _table, OFFSET, OFFSET);
+    mark_cell(OFFSET, _table, SYM, OFFSETCOUNT);
+
+    //for aggregates, a select field can be count(*) or func(field)
+    mark_cell(SELECT, _table, AGGREGATE, AGGREGATE);
+    mark_cell(SELECTFIELDNAMECOMMA, _table, AGGREGATE, AGGREGATE);
+    mark_cell(AGGREGATE, _table, AGGOPEN, AGGOPEN);
+    mark_cell(AGGOPEN, _table, SYM, AGGFIELD);
+    mark_cell(AGGOPEN, _table, STAR, AGGFIELD);
+    mark_cell(AGGFIELD, _table, AGGCLOSE, AGGCLOSE);
+    mark_cell(AGGCLOSE, _table, COMMA, SELECTFIELDNAMECOMMA);
+    mark_cell(AGGCLOSE, _table, FROM, FROM);
+    //parentheses and function names are still plain words inside a condition
+    mark_cell(WHERE, _table, AGGOPEN, CONDITIONNAME);
+    mark_cell(WHERE, _table, AGGREGATE, CONDITIONNAME);
+    mark_cell(WHERE, _table, AGGCLOSE, CONDITIONNAME);
+    mark_cell(CONDITIONNAME, _table, AGGOPEN, CONDITIONNAME);
+    mark_cell(CONDITIONNAME, _table, AGGCLOSE, CONDITIONNAME);
+    mark_cell(CONDITIONNAME, _table, AGGREGATE, CONDITIONNAME);
+
+    //words that became keywords with order by, limit, group by, aggregates and batch transaction can still be inserted,
+    //unquoted too; in a condition order, limit, offset and group start their clause, so those values are quoted there
+    const int value_keywords[] = {ORDER, BY, ORDERDIRECTION, LIMIT, OFFSET, GROUP, AGGREGATE, AGGOPEN, AGGCLOSE, INNER, JOIN, ON, EXPLAIN, ANALYZE, LOAD,
+                                  TRANSACTION};
+    for(int i = 0; i < sizeof(value_keywords) / sizeof(value_keywords[0]); i++)
+    {
+      mark_cell(VALUES, _table, value_keywords[i], VALUENAME);
+      mark_cell(VALUENAME, _table, value_keywords[i], VALUENAME);
+      mark_cell(VALUENAMECOMMA, _table, value_keywords[i], VALUENAME);
+    }
+
+    //for inserting many rows, a ( right after values opens the first row
+    mark_cell(VALUES, _table, AGGOPEN, VALUEROWOPEN);
+    mark_cell(VALUEROWOPEN, _table, SYM, VALUEROWNAME);
+    mark_cell(VALUEROWNAME, _table, SYM, VALUEROWNAME);
+    mark_cell(VALUEROWNAME, _table, COMMA, VALUEROWNAMECOMMA);
+    mark_cell(VALUEROWNAMECOMMA, _table, SYM, VALUEROWNAME);
+    mark_cell(VALUEROWNAME, _table, AGGCLOSE, VALUEROWCLOSE);
+    mark_cell(VALUEROWCLOSE, _table, COMMA, VALUEROWCOMMA);
+    mark_cell(VALUEROWCOMMA, _table, AGGOPEN, VALUEROWOPEN);
+    //inside a row the parentheses are not values
+    for(int i = 0; i < sizeof(value_keywords) / sizeof(value_keywords[0]); i++)
+    {
+      if(value_keywords[i] == AGGOPEN || value_keywords[i] == AGGCLOSE)
+        continue;
+      mark_cell(VALUEROWOPEN, _table, value_keywords[i], VALUEROWNAME);
+      mark_cell(VALUEROWNAME, _table, value_keywords[i], VALUEROWNAME);
+      mark_cell(VALUEROWNAMECOMMA, _table, value_keywords[i], VALUEROWNAME);
+    }
+
+    //for group by, after the table name or the where condition
+    mark_cell(TABLENAME, _table, GROUP, GROUP);
+    mark_cell(CONDITIONNAME, _table, GROUP, GROUP);
+    mark_cell(GROUP, _table, BY, GROUPBY);
+    mark_cell(GROUPBY, _table, SYM, GROUPFIELD);
+    mark_cell(GROUPFIELD, _table, COMMA, GROUPFIELDCOMMA);
+    mark_cell(GROUPFIELDCOMMA, _table, SYM, GROUPFIELD);
+    mark_cell(GROUPFIELD, _table, ORDER, ORDER);
+    mark_cell(GROUPFIELD, _table, LIMIT, LIMIT);
+    mark_cell(GROUPFIELD, _table, OFFSET, OFFSET);
+
+    //for joins, select ... from a, b where a.x = b.y or from a [inner] join b on a.x = b.y
+    mark_cell(TABLENAME, _table, COMMA, TABLENAMECOMMA);
+    mark_cell(TABLENAMECOMMA, _table, SYM, TABLENAME);
+    mark_cell(TABLENAME, _table, INNER, INNER);
+    mark_cell(TABLENAME, _table, JOIN, JOIN);
+    mark_cell(INNER, _table, JOIN, JOIN);
+    mark_cell(JOIN, _table, SYM, JOINTABLE);
+    mark_cell(JOINTABLE, _table, ON, ON);
+    mark_cell(ON, _table, SYM, JOINCONDITION);
+    mark_cell(JOINCONDITION, _table, SYM, JOINCONDITION);
+    const int join_condition_words[] = {AGGOPEN, AGGREGATE, AGGCLOSE, EXPLAIN, ANALYZE, LOAD, TRANSACTION};
+    for(int i = 0; i < sizeof(join_condition_words) / sizeof(join_condition_words[0]); i++)
+    {
+      mark_cell(ON, _table, join_condition_words[i], JOINCONDITION);
+      mark_cell(JOINCONDITION, _table, join_condition_words[i], JOINCONDITION);
+    }
+    const int after_join_condition[] = {INNER, JOIN, WHERE, ORDER, LIMIT, OFFSET, GROUP};
+    for(int i = 0; i < sizeof(after_join_condition) / sizeof(after_join_condition[0]); i++)
+      mark_cell(JOINCONDITION, _table, after_join_condition[i], after_join_condition[i]);
+    //the join, explain, load and transaction words are still plain words inside a where condition,
+    //and so are asc, desc and by, which only mean something after order or group
+    const int join_words[] = {INNER, JOIN, ON, EXPLAIN, ANALYZE, LOAD, TRANSACTION, ORDERDIRECTION, BY};
+    for(int i = 0; i < sizeof(join_words) / sizeof(join_words[0]); i++)
+    {
+      mark_cell(WHERE, _table, join_words[i], CONDITIONNAME);
+      mark_cell(CONDITIONNAME, _table, join_words[i], CONDITIONNAME);
+    }
+
+    //for explain, in front of a select
+    mark_cell(0, _table, EXPLAIN, EXPLAIN);
+    mark_cell(EXPLAIN, _table, ANALYZE, ANALYZE);
+    mark_cell(EXPLAIN, _table, SELECT, SELECT);
+    mark_cell(ANALYZE, _table, SELECT, SELECT);
+
+    //for load data, the file name quoted so it stays one token
+    mark_cell(0, _table, LOAD, LOAD);
+    mark_cell(LOAD, _table, SYM, LOADDATA);
+    mark_cell(LOADDATA, _table, FROM, LOADFROM);
+    mark_cell(LOADFROM, _table, SYM, LOADFILE);
+    mark_cell(LOADFILE, _table, INTO, LOADINTO);
+    mark_cell(LOADINTO, _table, SYM, LOADTABLE);
+
     if(debug)
     {
         cout << "---After Making Table------\n";
@@ -378,29 +660,60 @@ void Parser::make_table()
 void Parser::build_keyword_map()
 {
     const bool debug = false;
-
-    _keywords_map["select"] = SELECT;
-    _keywords_map["*"] = STAR;
-    _keywords_map["from"] = FROM;
-    _keywords_map["where"] = WHERE;
-    _keywords_map["make"] = MAKE_OR_CREATE;
-    _keywords_map["create"] = MAKE_OR_CREATE;
-    _keywords_map["table"] = TABLE;
-    _keywords_map["fields"] = FIELDS;
-    _keywords_map["insert"] = INSERT;
-    _keywords_map["into"] = INTO;
-    _keywords_map["values"] = VALUES;
-    _keywords_map["show"] = SHOW;
-    _keywords_map["tables"] = TABLES;
-    //last minute addition comma
-    _keywords_map[","] = COMMA;
-    _keywords_map["batch"] = BATCH;
-    _keywords_map["drop"] = DROP;
+    const struct {const char* word; long state;} keywords[] = {
+        {"select", SELECT},
+        {"*", STAR},
+        {"from", FROM},
+        {"where", WHERE},
+        {"make", MAKE_OR_CREATE},
+        {"create", MAKE_OR_CREATE},
+        {"table", TABLE},
+        {"fields", FIELDS},
+        {"insert", INSERT},
+        {"into", INTO},
+        {"values", VALUES},
+        {"show", SHOW},
+        {"tables", TABLES},
+        //last minute addition comma
+        {",", COMMA},
+        {"batch", BATCH},
+        {"drop", DROP},
+        {"order", ORDER},
+        {"by", BY},
+        {"asc", ORDERDIRECTION},
+        {"desc", ORDERDIRECTION},
+        {"limit", LIMIT},
+        {"offset", OFFSET},
+        {"group", GROUP},
+        {"count", AGGREGATE},
+        {"min", AGGREGATE},
+        {"max", AGGREGATE},
+        {"sum", AGGREGATE},
+        {"avg", AGGREGATE},
+        {"(", AGGOPEN},
+        {")", AGGCLOSE},
+        {"inner", INNER},
+        {"join", JOIN},
+        {"on", ON},
+        {"explain", EXPLAIN},
+        {"analyze", ANALYZE},
+        {"load", LOAD},
+        {"transaction", TRANSACTION}
+    };
+    vectorstr words;
+    vector<long> states;
+    for(int i = 0; i < sizeof(keywords) / sizeof(keywords[0]); i++)
+    {
+        words.push_back(keywords[i].word);
+        states.push_back(keywords[i].state);
+    }
+    _keywords.build(words, states);
 
     if(debug)
-        cout<<"_keywords_map:\n"<<_keywords_map;
+        cout<<"_keywords: "<<_keywords.size()<<" words in "<<_keywords.slots()<<" slots\n";
 }
 
 int Parser::_table[MAX_ROWS_PARSER][MAX_COLUMNS_PARSER];
+PerfectHash Parser::_keywords;
 
 #endif // ZAC_PARSER_
\ No newline at end of file
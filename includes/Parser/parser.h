@@ -13,27 +13,40 @@
 #include "parser_constants.h"
 #include "parser_state_machine_functions.h"
 #include "../Tokenizer/stokenize.h"
+#include "../PerfectHash/perfect_hash.h"
+#include "../StrView/str_view.h"
+#include "token_array.h"
+#include "statement.h"
 #include "../error_code/error_code.h"
 
 using namespace std;
 
+//parses a command of any length, which it does not copy: the command has to outlive the parser
 class Parser{
 public:
     Parser();
-    Parser(char cmd_str[300]);
-    mmap_ss parse_tree() throw(Error_Code);
-    void set_string(char cmd_str[300]);
+    Parser(StrView cmd_str);
+    //tokenizes the command and walks the state table over its tokens, throws what parse_statement() throws
+    //allocates nothing for a command of up to TokenArray::INLINE_TOKENS tokens
+    void parse() throw(Error_Code);
+    //parses the command into statement from the states its tokens moved to
+    void parse_statement(Statement& statement) throw(Error_Code);
+    void set_string(StrView cmd_str);
+    //tokens of the command after parse(), each with the state it moved to
+    const TokenArray& tokens() const {return _tokens;}
 
 
 private:
-    mmap_ss _ptree;
-    map_sl _keywords_map;
+    //the state table and the keywords are the same for every parser, the first one made builds them
     static int _table[MAX_ROWS_PARSER][MAX_COLUMNS_PARSER];
+    static PerfectHash _keywords;
     bool fail;
-    Queue<string>input_q;
-    char _input_buffer[300];
-    void make_table();
-    void build_keyword_map();
+    StrView _input;
+    TokenArray _tokens;
+    void tokenize();
+    static bool build_tables();
+    static void make_table();
+    static void build_keyword_map();
 };
 
 #endif //PARSER_
\ No newline at end of file
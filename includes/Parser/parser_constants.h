@@ -10,8 +10,8 @@
 #include <cassert>
 using namespace std;
 
-const int MAX_ROWS_PARSER = 29;
-const int MAX_COLUMNS_PARSER = 29;
+const int MAX_ROWS_PARSER = 72;
+const int MAX_COLUMNS_PARSER = 72;
 //MAX ALWAYS HAVE TWO MORE THAN BIGGEST KEY STATE
 enum key_states
 {
@@ -42,7 +42,47 @@ enum key_states
     BATCH,
     DROP, //DROP
     DROPTABLE,
-    DROPTABLENAME
+    DROPTABLENAME,
+    ORDER, //ORDER BY
+    BY,
+    ORDERFIELD,
+    ORDERDIRECTION, //ASC || DESC
+    LIMIT, //LIMIT N
+    LIMITCOUNT,
+    OFFSET, //OFFSET M
+    OFFSETCOUNT,
+    GROUP, //GROUP BY
+    GROUPBY,
+    GROUPFIELD, //NEEDS COMMA
+    GROUPFIELDCOMMA,
+    AGGREGATE, //COUNT || MIN || MAX || SUM || AVG
+    AGGOPEN, //(
+    AGGFIELD,
+    AGGCLOSE, //)
+    TABLENAMECOMMA, //FROM A, B
+    INNER, //INNER JOIN
+    JOIN,
+    JOINTABLE,
+    ON,
+    JOINCONDITION,
+    EXPLAIN, //EXPLAIN [ANALYZE] SELECT ...
+    ANALYZE,
+    VALUEROWOPEN, //INSERT ... VALUES (A, B), (C, D)
+    VALUEROWNAME, //NEEDS COMMA
+    VALUEROWNAMECOMMA,
+    VALUEROWCLOSE,
+    VALUEROWCOMMA,
+    LOAD, //LOAD DATA FROM "FILE" INTO TABLE
+    LOADDATA,
+    LOADFROM,
+    LOADFILE,
+    LOADINTO,
+    LOADTABLE,
+    TRANSACTION, //BATCH TRANSACTION
+    ORDERAGGREGATE, //ORDER BY COUNT(*)
+    ORDERAGGOPEN,
+    ORDERAGGFIELD,
+    ORDERAGGCLOSE
 };
 
 const int SYM = MAX_COLUMNS_PARSER - 1;
@@ -0,0 +1,84 @@
+#ifndef STATEMENT_CPP
+#define STATEMENT_CPP
+
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <set>
+#include <vector>
+#include <string>
+#include <cassert>
+#include "statement.h"
+
+using namespace std;
+
+Statement::Statement()
+{
+    clear();
+}
+void Statement::clear()
+{
+    command = COMMAND_NONE;
+    table_names.clear();
+    columns.clear();
+    values.clear();
+    row_ends.clear();
+    fields.clear();
+    where = false;
+    condition.clear();
+    join = false;
+    join_condition.clear();
+    aggregate = false;
+    group = false;
+    group_by.clear();
+    order = false;
+    order_by.clear();
+    direction.clear();
+    limit = false;
+    limit_count.clear();
+    offset = false;
+    offset_count.clear();
+    explain = false;
+    analyze = false;
+    file_name.clear();
+    transaction = false;
+    params = 0;
+    value_params.clear();
+    condition_params.clear();
+}
+ostream& operator <<(ostream& outs, const Statement& print_me)
+{
+    const char* names[] = {"none", "make", "insert", "select", "show tables", "batch", "drop", "load"};
+    const vectorstr* parts[] = {&print_me.table_names, &print_me.columns, &print_me.values, &print_me.fields,
+                                &print_me.condition, &print_me.join_condition, &print_me.group_by};
+    const char* part_names[] = {"table_names", "columns", "values", "fields", "condition", "join_condition", "group_by"};
+    outs << "command: " << names[print_me.command] << "\n";
+    for(int i = 0; i < sizeof(parts) / sizeof(parts[0]); i++)
+    {
+        if(parts[i]->empty())
+            continue;
+        outs << part_names[i] << ":";
+        for(int j = 0; j < parts[i]->size(); j++)
+            outs << " |" << (*parts[i])[j] << "|";
+        outs << "\n";
+    }
+    if(!print_me.row_ends.empty())
+        outs << "row_ends: " << print_me.row_ends << "\n";
+    if(print_me.order)
+        outs << "order by: |" << print_me.order_by << "| " << print_me.direction << "\n";
+    if(print_me.limit)
+        outs << "limit: |" << print_me.limit_count << "|\n";
+    if(print_me.offset)
+        outs << "offset: |" << print_me.offset_count << "|\n";
+    if(!print_me.file_name.empty())
+        outs << "file_name: |" << print_me.file_name << "|\n";
+    if(print_me.explain)
+        outs << (print_me.analyze ? "explain analyze\n" : "explain\n");
+    if(print_me.transaction)
+        outs << "transaction\n";
+    if(print_me.params)
+        outs << "params: " << print_me.params << "\n";
+    return outs;
+}
+
+#endif //STATEMENT_CPP
@@ -0,0 +1,67 @@
+#ifndef STATEMENT_H
+#define STATEMENT_H
+
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <set>
+#include <vector>
+#include <string>
+#include <cassert>
+#include "typedefs.h"
+
+using namespace std;
+
+//what a command does
+enum statement_commands
+{
+    COMMAND_NONE,           //explain alone, or a command cut short
+    COMMAND_MAKE,           //make table or create table
+    COMMAND_INSERT,
+    COMMAND_SELECT,
+    COMMAND_SHOW_TABLES,
+    COMMAND_BATCH,
+    COMMAND_DROP,
+    COMMAND_LOAD            //load data from "file" into table
+};
+
+//a parsed command with each of its parts in its own member, filled in by Parser::parse_statement()
+//parts the command does not have are left empty or false
+struct Statement
+{
+    statement_commands command;
+    vectorstr table_names;      //the table, both tables of a join
+    vectorstr columns;          //fields of a new table
+    vectorstr values;           //insert values, every row's one after another
+    vector<int> row_ends;       //end of each parenthesized row in values, empty for a bare value list
+    vectorstr fields;           //select list, "*" for every field, an aggregate as one field "count(*)"
+    bool where;                 //condition is empty when nothing came after where
+    vectorstr condition;
+    bool join;                  //join_condition is empty when nothing came after on
+    vectorstr join_condition;
+    bool aggregate;             //the select list has an aggregate
+    bool group;                 //group_by is empty when no field came after group by
+    vectorstr group_by;
+    bool order;                 //order_by is empty when no field came after order by
+    string order_by;
+    string direction;           //asc, desc or empty
+    bool limit;                 //limit_count is empty when no count came after limit
+    string limit_count;
+    bool offset;
+    string offset_count;
+    bool explain;
+    bool analyze;
+    string file_name;           //file of a load data
+    bool transaction;           //batch transaction
+    int params;                 //"?" placeholders anywhere in the command
+    vector<int> value_params;   //index in values of each "?" that stands for an insert value
+    vector<int> condition_params;   //index in condition of each "?" that stands for a condition value
+
+    Statement();
+    //empties every part, the vectors keep their memory for the next command
+    void clear();
+
+    friend ostream& operator <<(ostream& outs, const Statement& print_me);
+};
+
+#endif //STATEMENT_H
@@ -0,0 +1,66 @@
+#ifndef TOKEN_ARRAY_CPP
+#define TOKEN_ARRAY_CPP
+
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <set>
+#include <vector>
+#include <string>
+#include <cassert>
+#include "token_array.h"
+
+using namespace std;
+
+TokenArray::TokenArray()
+{
+    _data = _inline;
+    _size = 0;
+}
+TokenArray::TokenArray(const TokenArray& copy_me)
+{
+    _data = _inline;
+    _size = 0;
+    *this = copy_me;
+}
+TokenArray& TokenArray::operator =(const TokenArray& rhs)
+{
+    if(this == &rhs)
+        return *this;
+    if(rhs._size > INLINE_TOKENS)
+    {
+        _heap.assign(rhs._data, rhs._data + rhs._size);
+        _data = &_heap[0];
+    }
+    else
+    {
+        copy(rhs._data, rhs._data + rhs._size, _inline);
+        _data = _inline;
+    }
+    _size = rhs._size;
+    return *this;
+}
+void TokenArray::push_back(StrView text, bool param, bool quoted)
+{
+    ParserToken token;
+    token.text = text;
+    token.state = 0;
+    token.param = param;
+    token.quoted = quoted;
+    if(_data == _inline && _size == INLINE_TOKENS)
+    {
+        _heap.assign(_inline, _inline + _size);
+        _data = &_heap[0];
+    }
+    if(_data == _inline)
+        _inline[_size] = token;
+    else
+    {
+        _heap.resize(_size);
+        _heap.push_back(token);
+        _data = &_heap[0];
+    }
+    _size++;
+}
+
+#endif //TOKEN_ARRAY_CPP
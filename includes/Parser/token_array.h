@@ -0,0 +1,50 @@
+#ifndef TOKEN_ARRAY_H
+#define TOKEN_ARRAY_H
+
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <set>
+#include <vector>
+#include <string>
+#include <cassert>
+#include "../StrView/str_view.h"
+
+using namespace std;
+
+//a token of a command and the parser state it moved to
+struct ParserToken
+{
+    StrView text;
+    int state;
+    bool param;         //a "?" outside quotes, a value a prepared statement binds later
+    bool quoted;        //the text between quotes, a value and never a keyword
+};
+
+//the tokens of one command side by side in one array
+//a command of up to INLINE_TOKENS tokens is held inside the array itself, so it allocates nothing,
+//a longer one moves every token to the heap once
+class TokenArray
+{
+public:
+    TokenArray();
+    TokenArray(const TokenArray& copy_me);
+    TokenArray& operator =(const TokenArray& rhs);
+
+    void push_back(StrView text, bool param = false, bool quoted = false);
+    void clear() {_size = 0;}
+    int size() const {return _size;}
+    bool empty() const {return _size == 0;}
+    ParserToken& operator [](int i) {return _data[i];}
+    const ParserToken& operator [](int i) const {return _data[i];}
+
+    static const int INLINE_TOKENS = 128;
+
+private:
+    ParserToken _inline[INLINE_TOKENS];
+    vector<ParserToken> _heap;          //every token once there are more than INLINE_TOKENS
+    ParserToken* _data;                 //_inline or _heap
+    int _size;
+};
+
+#endif //TOKEN_ARRAY_H
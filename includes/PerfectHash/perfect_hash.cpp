@@ -0,0 +1,87 @@
+#ifndef PERFECT_HASH_CPP
+#define PERFECT_HASH_CPP
+
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <set>
+#include <vector>
+#include <string>
+#include <cassert>
+#include <cstring>
+#include "perfect_hash.h"
+
+using namespace std;
+
+PerfectHash::PerfectHash()
+{
+    _words.assign(1, "");
+    _values.assign(1, -1);
+    _seed = 0;
+    _mask = 0;
+    _size = 0;
+}
+void PerfectHash::build(const vector<string>& words, const vector<long>& values)
+{
+    const bool debug = false;
+    const uint32_t SEEDS_PER_SIZE = 4096;
+    assert(words.size() == values.size() && "Every word needs a value");
+    //twice the words keeps the seed search short, a size with no good seed is doubled
+    uint32_t slots = 1;
+    while(slots < 2 * words.size())
+        slots *= 2;
+    while(true)
+    {
+        for(uint32_t seed = 1; seed <= SEEDS_PER_SIZE; seed++)
+        {
+            vector<bool> taken(slots, false);
+            bool collides = false;
+            for(int i = 0; i < words.size() && !collides; i++)
+            {
+                assert(!words[i].empty() && "Cannot hash an empty word");
+                uint32_t slot = hash(words[i].c_str(), words[i].size(), seed) & (slots - 1);
+                collides = taken[slot];
+                taken[slot] = true;
+            }
+            if(collides)
+                continue;
+            _words.assign(slots, "");
+            _values.assign(slots, -1);
+            _seed = seed;
+            _mask = slots - 1;
+            _size = words.size();
+            for(int i = 0; i < words.size(); i++)
+            {
+                uint32_t slot = hash(words[i].c_str(), words[i].size(), seed) & _mask;
+                _words[slot] = words[i];
+                _values[slot] = values[i];
+            }
+            if(debug)
+                cout << "PerfectHash: " << _size << " words in " << slots << " slots, seed " << seed << "\n";
+            return;
+        }
+        slots *= 2;
+    }
+}
+long PerfectHash::find(const char* word, int length) const
+{
+    uint32_t slot = hash(word, length, _seed) & _mask;
+    if(_words[slot].size() != length || memcmp(_words[slot].c_str(), word, length))
+        return -1;
+    return _values[slot];
+}
+
+//private
+uint32_t PerfectHash::hash(const char* word, int length, uint32_t seed)
+{
+    //FNV-1a started from the seed
+    uint32_t h = 2166136261u ^ seed * 16777619u;
+    for(int i = 0; i < length; i++)
+    {
+        h ^= (unsigned char)word[i];
+        h *= 16777619u;
+    }
+    return h ^ h >> 15;
+}
+
+#endif //PERFECT_HASH_CPP
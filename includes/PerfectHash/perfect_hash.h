@@ -0,0 +1,40 @@
+#ifndef PERFECT_HASH_H
+#define PERFECT_HASH_H
+
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <set>
+#include <vector>
+#include <string>
+#include <cassert>
+#include <cstdint>
+
+using namespace std;
+
+//hash table of a fixed set of words whose seed is searched for when it is built, until every word
+//lands in its own slot: a lookup is one hash and at most one string compare, with no probing
+class PerfectHash
+{
+public:
+    PerfectHash();
+    //words[i] is found as values[i], the words have to be distinct and not empty
+    void build(const vector<string>& words, const vector<long>& values);
+    //value of word, -1 if it is not one of the words
+    long find(const char* word, int length) const;
+    long find(const string& word) const {return find(word.c_str(), word.size());}
+    bool contains(const string& word) const {return find(word) != -1;}
+    int size() const {return _size;}
+    int slots() const {return _words.size();}
+
+private:
+    vector<string> _words;      //by slot, empty if no word hashes there
+    vector<long> _values;       //by slot
+    uint32_t _seed;
+    uint32_t _mask;             //slots - 1, slots is a power of two
+    int _size;
+
+    static uint32_t hash(const char* word, int length, uint32_t seed);
+};
+
+#endif //PERFECT_HASH_H
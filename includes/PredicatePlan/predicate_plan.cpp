@@ -0,0 +1,676 @@
+#ifndef PREDICATE_PLAN_CPP
+#define PREDICATE_PLAN_CPP
+
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <set>
+#include <vector>
+#include <string>
+#include <cassert>
+#include <cstring>
+#include <algorithm>
+#include <map>
+#include <chrono>
+#include "predicate_plan.h"
+#include "../SortingAlgorithms/SetAlgorithms.h"
+
+using namespace std;
+
+namespace
+{
+    //what the compile stack holds in place of RPN's TokenStr and ResultSet pointers
+    struct plan_operand
+    {
+        int type;       //TOKEN_STR or RESULT_SET
+        string val;     //field name or literal, empty for results
+        plan_operand(int t = RESULT_SET, const string& v = ""): type(t), val(v) {}
+    };
+    double ms_since(chrono::steady_clock::time_point start)
+    {
+        return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    }
+}
+
+PredicatePlan::PredicatePlan()
+{
+    _max_depth = 0;
+    _profiling = false;
+}
+PredicatePlan::PredicatePlan(const Queue<Token*>& postfix, map_sl& field_indicies) throw(Error_Code)
+{
+    _max_depth = 0;
+    _profiling = false;
+    compile(postfix, field_indicies);
+}
+PredicatePlan::PredicatePlan(int field, const string& field_name, const string& relational, const string& literal) throw(Error_Code)
+{
+    int op = relational_op(relational);
+    if(op == -1)
+    {
+        Error_Code error_code;
+        error_code._error_token = relational;
+        error_code._code = INVALID_USAGE_OF_OP;
+        throw error_code;
+    }
+    _ops.push_back(PlanOp(op, field, field_name, literal));
+    _max_depth = 1;
+    _profiling = false;
+}
+//walks the postfix queue once the way RPN used to evaluate it, but emits
+//plan ops instead of evaluating, so every syntax error is still reported here
+void PredicatePlan::compile(const Queue<Token*>& postfix, map_sl& field_indicies) throw(Error_Code)
+{
+    assert(postfix.begin() && "Cannot evaluate an empty Queue");
+    Error_Code error_code;
+    vector<plan_operand> stack;     //back() is the top
+    int token_str_count = 0;        //tracking consecutive string tokens for syntax validation
+    int depth = 0;
+    _ops.clear();
+    _max_depth = 0;
+
+    for(Queue<Token*>::Iterator it = postfix.begin(); it != postfix.end(); ++it)
+    {
+        //checking for invalid syntax: two string tokens without an operator
+        if(token_str_count == 2 && (*it)->get_type() != OPERATOR)
+        {
+            token_str_count = 0;
+            error_code._error_token = stack.back().val;
+            if(!field_indicies.contains((*it)->get_val()))
+            {
+                error_code._code = SYNTAX_ERR_AT_NEAR;
+                error_code._modify_to_postgre = true;
+            }
+            else
+                error_code._code = EXPECT_A_RELATIONAL;
+            throw error_code;
+        }
+        else if(token_str_count == 2 && (*it)->get_type() == OPERATOR)
+            token_str_count = 0;
+
+        switch((*it)->get_type())
+        {
+        case TOKEN_STR:
+            token_str_count++;
+            stack.push_back(plan_operand(TOKEN_STR, (*it)->get_val()));
+            break;
+
+        case OPERATOR:
+        {
+            Operator* op = static_cast<Operator*>(*it);
+            if(op->is_unary())
+            {
+                //not takes the one condition on top of the stack
+                error_code._error_token = op->get_val();
+                if(stack.empty())
+                {
+                    error_code._code = LOGICAL_MISSING_AN_ARGUMENT;
+                    throw error_code;
+                }
+                if(stack.back().type == TOKEN_STR)
+                {
+                    error_code._code = EXPECT_RELATIONAL;
+                    throw error_code;
+                }
+                _ops.push_back(PlanOp(PLAN_NOT));
+                break;
+            }
+            //checking for sufficient operands
+            if(stack.size() < 2)
+            {
+                error_code._error_token = op->get_val();
+                if(stack.empty())
+                    error_code._code = MISSING_ARGUMENTS;
+                else if(op->get_operator_type() == RELATIONAL)
+                {
+                    if(field_indicies.contains(stack.back().val))
+                        error_code._code = RELATIONAL_MISSING_RIGHT_ARG;
+                    else
+                        error_code._code = RELATIONAL_MISSING_LEFT_ARG;
+                }
+                else
+                    error_code._code = LOGICAL_MISSING_AN_ARGUMENT;
+                throw error_code;
+            }
+
+            plan_operand first_pop = stack.back();
+            stack.pop_back();
+            plan_operand second_pop = stack.back();
+            stack.pop_back();
+
+            //validating operand types match
+            if(first_pop.type != second_pop.type)
+            {
+                string token_str = first_pop.type == TOKEN_STR ? first_pop.val : second_pop.val;
+                error_code._error_token = op->get_val();
+                if(op->get_operator_type() == RELATIONAL)
+                {
+                    if(field_indicies.contains(token_str))
+                        error_code._code = RELATIONAL_MISSING_RIGHT_ARG;
+                    else
+                        error_code._code = RELATIONAL_MISSING_LEFT_ARG;
+                }
+                else
+                    error_code._code = INVALID_USAGE_OF_OP;
+                throw error_code;
+            }
+
+            if(op->get_operator_type() == LOGICAL)
+            {
+                //a logical operator needs two conditions, not a column and a value
+                if(first_pop.type == TOKEN_STR)
+                {
+                    error_code._error_token = op->get_val();
+                    error_code._code = EXPECT_RELATIONAL;
+                    throw error_code;
+                }
+                _ops.push_back(PlanOp(op->get_val() == "and" ? PLAN_AND : PLAN_OR));
+                depth--;
+            }
+            else
+            {
+                int relational = relational_op(op->get_val());
+                //a relational needs a column and a value, not two conditions
+                if(first_pop.type != TOKEN_STR || relational == -1)
+                {
+                    error_code._error_token = op->get_val();
+                    error_code._code = INVALID_USAGE_OF_OP;
+                    throw error_code;
+                }
+                if(!field_indicies.contains(second_pop.val))
+                {
+                    error_code._error_token = second_pop.val;
+                    error_code._code = UNKNOWN_COLUMN;
+                    error_code._modify_to_postgre = true;
+                    throw error_code;
+                }
+                _ops.push_back(PlanOp(relational, field_indicies[second_pop.val], second_pop.val, first_pop.val));
+                depth++;
+                if(depth > _max_depth)
+                    _max_depth = depth;
+            }
+            stack.push_back(plan_operand(RESULT_SET));
+            break;
+        }
+
+        default:
+            break;
+        }
+    }
+
+    //validating final stack state
+    if(stack.size() == 2)
+    {
+        error_code._code = EXPECT_A_RELATIONAL;
+        throw error_code;
+    }
+    assert(stack.size() == 1 && "Result Stack cannot contain more than one element");
+    if(stack.back().type != RESULT_SET)
+    {
+        error_code._code = EXPECT_A_RELATIONAL;
+        throw error_code;
+    }
+}
+vectorlong PredicatePlan::evaluate(vector<mmap_sl>& record_indicies, long record_count, long limit, int max_threads)
+{
+    assert(!_ops.empty() && "Cannot evaluate an empty plan");
+    //a lone comparison, with or without a not, has nothing to run alongside it
+    if(_profiling)
+    {
+        _op_stats.assign(_ops.size(), PlanOpStats());
+        if(record_count < 0)
+            record_count = record_indicies.empty() ? 0 : count_records(record_indicies[0]);
+    }
+    if(max_threads > 1 && _ops.size() > 2)
+    {
+        ResultSet result;
+        evaluate_parallel(record_indicies, result, max_threads, record_count);
+        return finish(result, record_indicies, record_count, limit);
+    }
+    if(_stack.size() < _max_depth)
+        _stack.resize(_max_depth);
+    //a plan that is a single comparison keeps the index key order the caller has always seen,
+    //leaves under an and/or come back sorted so the merges never have to sort
+    bool sorted_leaves = _ops.size() > 1;
+    int top = 0;
+    for(int i = 0; i < _ops.size(); i++)
+    {
+        const PlanOp& op = _ops[i];
+        chrono::steady_clock::time_point start;
+        if(_profiling)
+            start = chrono::steady_clock::now();
+        long keys = 0;
+        if(op.is_leaf())
+        {
+            //only a lone comparison can stop early, and/or/not need every match of their inputs
+            keys = probe(op, record_indicies[op.field], _stack[top], sorted_leaves, sorted_leaves ? -1 : limit, _runs);
+            top++;
+        }
+        else if(op.op == PLAN_NOT)
+        {
+            //the complement stays symbolic until an and/or or the final result needs it
+            _stack[top - 1].set_complemented(!_stack[top - 1].complemented());
+        }
+        else
+        {
+            merge(op.op, _stack[top - 2], _stack[top - 1], _scratch);
+            top--;
+        }
+        if(_profiling)
+            record_stats(i, _stack[top - 1], keys, ms_since(start), record_count);
+    }
+    assert(top == 1 && "Plan must leave exactly one result");
+    return finish(_stack[0], record_indicies, record_count, limit);
+}
+double PredicatePlan::estimate_entries(vector<mmap_sl>& record_indicies, long record_count) const
+{
+    double entries = 0;
+    for(int i = 0; i < _ops.size(); i++)
+    {
+        const PlanOp& op = _ops[i];
+        if(op.op == PLAN_EQ)
+        {
+            mmap_sl& index = record_indicies[op.field];
+            if(index.contains(op.literal))
+                entries += index.get(op.literal).size();
+        }
+        else if(op.op == PLAN_NE)
+            entries += record_count;
+        else if(op.is_leaf())
+            entries += record_count / 3.0;
+    }
+    return entries;
+}
+vector<double> PredicatePlan::estimate_rows(vector<mmap_sl>& record_indicies, long record_count) const
+{
+    vector<double> rows(_ops.size());
+    vector<int> stack;
+    for(int i = 0; i < _ops.size(); i++)
+    {
+        const PlanOp& op = _ops[i];
+        if(op.op == PLAN_EQ || op.op == PLAN_NE)
+        {
+            mmap_sl& index = record_indicies[op.field];
+            double equal = index.contains(op.literal) ? index.get(op.literal).size() : 0;
+            rows[i] = op.op == PLAN_EQ ? equal : record_count - equal;
+        }
+        else if(op.is_leaf())
+            rows[i] = record_count / 3.0;
+        else if(op.op == PLAN_NOT)
+        {
+            rows[i] = record_count - rows[stack.back()];
+            stack.pop_back();
+        }
+        else
+        {
+            double rhs = rows[stack.back()];
+            stack.pop_back();
+            double lhs = rows[stack.back()];
+            stack.pop_back();
+            double both = record_count > 0 ? lhs * rhs / record_count : 0;
+            rows[i] = op.op == PLAN_AND ? both : lhs + rhs - both;
+        }
+        stack.push_back(i);
+    }
+    return rows;
+}
+bool PredicatePlan::matches(const char record[][FIELD_MAX_LEN]) const
+{
+    assert(!_ops.empty() && "Cannot evaluate an empty plan");
+    //plans are shallow, so the stack normally lives on the call stack
+    const int LOCAL_DEPTH = 32;
+    char local_stack[LOCAL_DEPTH];
+    vector<char> heap_stack;
+    char* stack = local_stack;
+    if(_max_depth > LOCAL_DEPTH)
+    {
+        heap_stack.resize(_max_depth);
+        stack = &heap_stack[0];
+    }
+    int top = 0;
+    for(int i = 0; i < _ops.size(); i++)
+    {
+        const PlanOp& op = _ops[i];
+        if(op.is_leaf())
+            stack[top++] = compare(op.op, record[op.field], op.literal);
+        else if(op.op == PLAN_NOT)
+            stack[top - 1] = !stack[top - 1];
+        else
+        {
+            if(op.op == PLAN_AND)
+                stack[top - 2] = stack[top - 2] && stack[top - 1];
+            else
+                stack[top - 2] = stack[top - 2] || stack[top - 1];
+            top--;
+        }
+    }
+    return stack[0];
+}
+void PredicatePlan::set_literal(int op_index, const string& literal)
+{
+    assert(op_index >= 0 && op_index < _ops.size() && _ops[op_index].is_leaf() && "set_literal() expects a leaf");
+    _ops[op_index].literal = literal;
+}
+int PredicatePlan::relational_op(const string& relational)
+{
+    if(relational == "=")
+        return PLAN_EQ;
+    if(relational == "<")
+        return PLAN_LT;
+    if(relational == ">")
+        return PLAN_GT;
+    if(relational == "<=")
+        return PLAN_LE;
+    if(relational == ">=")
+        return PLAN_GE;
+    if(relational == "!=" || relational == "<>")
+        return PLAN_NE;
+    return -1;
+}
+string PredicatePlan::op_string(int op)
+{
+    switch(op)
+    {
+    case PLAN_EQ:
+        return "=";
+    case PLAN_LT:
+        return "<";
+    case PLAN_GT:
+        return ">";
+    case PLAN_LE:
+        return "<=";
+    case PLAN_GE:
+        return ">=";
+    case PLAN_NE:
+        return "!=";
+    case PLAN_AND:
+        return "and";
+    case PLAN_OR:
+        return "or";
+    case PLAN_NOT:
+        return "not";
+    default:
+        return "?";
+    }
+}
+ostream& operator<<(ostream& outs, const PredicatePlan& print_me)
+{
+    for(int i = 0; i < print_me._ops.size(); i++)
+    {
+        const PlanOp& op = print_me._ops[i];
+        if(op.is_leaf())
+            outs<<"["<<op.field_name<<" "<<PredicatePlan::op_string(op.op)<<" "<<op.literal<<"] ";
+        else
+            outs<<PredicatePlan::op_string(op.op)<<" ";
+    }
+    return outs;
+}
+
+//private
+void PredicatePlan::evaluate_parallel(vector<mmap_sl>& record_indicies, ResultSet& result, int max_threads, long record_count)
+{
+    const bool debug = false;
+    //node i is op i, its inputs are the nodes below it in the postfix order
+    //a node's level is one more than its deepest input, so every node of a level can run at once
+    int n = _ops.size();
+    vector<int> lhs(n, -1);
+    vector<int> rhs(n, -1);
+    vector<int> level(n, 0);
+    vector<int> parents(n, 0);
+    vector<vector<int> > levels(1);
+    map<string, int> leaf_node;     //field, op and literal to the one node that probes them
+    vector<int> stack;
+    for(int i = 0; i < n; i++)
+    {
+        const PlanOp& op = _ops[i];
+        if(op.is_leaf())
+        {
+            string key = to_string(op.field) + " " + to_string(op.op) + " " + op.literal;
+            map<string, int>::iterator found = leaf_node.find(key);
+            if(found != leaf_node.end())
+            {
+                if(_profiling)
+                    _op_stats[i].shared_with = found->second;
+                stack.push_back(found->second);
+                continue;
+            }
+            leaf_node[key] = i;
+            levels[0].push_back(i);
+            stack.push_back(i);
+            continue;
+        }
+        if(op.op != PLAN_NOT)
+        {
+            rhs[i] = stack.back();
+            stack.pop_back();
+            parents[rhs[i]]++;
+        }
+        lhs[i] = stack.back();
+        stack.pop_back();
+        parents[lhs[i]]++;
+        level[i] = 1 + max(level[lhs[i]], rhs[i] == -1 ? 0 : level[rhs[i]]);
+        if(level[i] == levels.size())
+            levels.push_back(vector<int>());
+        levels[level[i]].push_back(i);
+        stack.push_back(i);
+    }
+    if(debug)
+        cout<<n<<" ops, "<<levels[0].size()<<" probes, "<<levels.size()<<" levels\n";
+
+    vector<ResultSet> results(n);
+    for(int l = 0; l < levels.size(); l++)
+    {
+        const vector<int>& nodes = levels[l];
+        ThreadPool::shared().parallel_for(nodes.size(), [&](int k)
+        {
+            int i = nodes[k];
+            const PlanOp& op = _ops[i];
+            chrono::steady_clock::time_point start;
+            if(_profiling)
+                start = chrono::steady_clock::now();
+            if(op.is_leaf())
+            {
+                vector<const vectorlong*> runs;
+                long keys = probe(op, record_indicies[op.field], results[i], true, -1, runs);
+                if(_profiling)
+                    record_stats(i, results[i], keys, ms_since(start), record_count);
+                return;
+            }
+            //an input used by one node is taken over, a shared one is copied
+            ResultSet left;
+            if(parents[lhs[i]] == 1)
+                left.swap(results[lhs[i]]);
+            else
+                left = results[lhs[i]];
+            if(op.op == PLAN_NOT)
+                left.set_complemented(!left.complemented());
+            else
+            {
+                ResultSet right;
+                if(parents[rhs[i]] == 1)
+                    right.swap(results[rhs[i]]);
+                else
+                    right = results[rhs[i]];
+                ResultSet scratch;
+                merge(op.op, left, right, scratch);
+            }
+            results[i].swap(left);
+            if(_profiling)
+                record_stats(i, results[i], 0, ms_since(start), record_count);
+        }, max_threads);
+    }
+    if(_profiling)
+    {
+        for(int i = 0; i < n; i++)
+        {
+            if(_op_stats[i].shared_with != -1)
+                _op_stats[i].rows = _op_stats[_op_stats[i].shared_with].rows;
+        }
+    }
+    result.swap(results[stack.back()]);
+}
+vectorlong PredicatePlan::finish(ResultSet& result, vector<mmap_sl>& record_indicies, long record_count, long limit)
+{
+    vectorlong recnos;
+    if(result.complemented())
+    {
+        if(record_count < 0)
+            record_count = record_indicies.empty() ? 0 : count_records(record_indicies[0]);
+        sorted_complement(result.get_val_list(), record_count, recnos, limit);
+        return recnos;
+    }
+    recnos.swap(result.val_list());
+    if(limit >= 0 && recnos.size() > limit)
+        recnos.resize(limit);
+    return recnos;
+}
+void PredicatePlan::record_stats(int i, const ResultSet& result, long keys, double ms, long record_count)
+{
+    PlanOpStats& stats = _op_stats[i];
+    long size = result.get_val_list().size();
+    stats.rows = result.complemented() ? record_count - size : size;
+    stats.keys_visited = keys;
+    stats.entries_visited = _ops[i].is_leaf() ? size : 0;
+    stats.ms = ms;
+}
+long PredicatePlan::probe(const PlanOp& leaf, mmap_sl& index, ResultSet& result, bool sorted, long limit, vector<const vectorlong*>& runs)
+{
+    //bounds are looked up once per probe and "=" uses find() so a miss does not
+    //insert an empty key into the index the way operator[] would
+    //recnos are appended to a key's list in increasing order, so each list is already sorted
+    result.clear();
+    mmap_sl::Iterator from;
+    mmap_sl::Iterator to;
+    switch(leaf.op)
+    {
+    case PLAN_EQ:
+        from = index.find(leaf.literal);
+        if(from != index.end())
+        {
+            const vectorlong& value_list = from->value_list;
+            long count = limit >= 0 && limit < value_list.size() ? limit : value_list.size();
+            result.val_list().assign(value_list.begin(), value_list.begin() + count);
+        }
+        return 1;
+    case PLAN_LT:
+        from = index.begin();
+        to = index.lower_bound(leaf.literal);
+        break;
+    case PLAN_LE:
+        from = index.begin();
+        to = index.upper_bound(leaf.literal);
+        break;
+    case PLAN_GT:
+        from = index.upper_bound(leaf.literal);
+        to = index.end();
+        break;
+    case PLAN_GE:
+        from = index.lower_bound(leaf.literal);
+        to = index.end();
+        break;
+    case PLAN_NE:
+        //the keys below the literal, the keys above it are added after the loop
+        from = index.begin();
+        to = index.lower_bound(leaf.literal);
+        break;
+    default:
+        assert(false && "probe() called with a logical op");
+    }
+    //an unsorted probe under a limit stops collecting keys once they hold enough recnos
+    runs.clear();
+    long found = 0;
+    for(mmap_sl::Iterator it = from; it != to && (limit < 0 || found < limit); ++it)
+    {
+        runs.push_back(&it->value_list);
+        found += it->value_list.size();
+    }
+    if(leaf.op == PLAN_NE)
+    {
+        for(mmap_sl::Iterator it = index.upper_bound(leaf.literal); it != index.end() && (limit < 0 || found < limit); ++it)
+        {
+            runs.push_back(&it->value_list);
+            found += it->value_list.size();
+        }
+    }
+    if(sorted)
+    {
+        k_way_union(runs, result.val_list());
+        return runs.size();
+    }
+    vectorlong& list = result.val_list();
+    for(int i = 0; i < runs.size(); i++)
+        list.insert(list.end(), runs[i]->begin(), runs[i]->end());
+    if(limit >= 0 && list.size() > limit)
+        list.resize(limit);
+    result.set_sorted(runs.size() <= 1);
+    return runs.size();
+}
+void PredicatePlan::merge(int op, ResultSet& lhs, ResultSet& rhs, ResultSet& scratch)
+{
+    //a complemented side stands for every record except its list, so
+    //A and not B = A - B, not A and not B = not (A or B),
+    //A or not B = not (B - A), not A or not B = not (A and B)
+    assert(lhs.sorted() && rhs.sorted() && "and/or inputs must be sorted");
+    const vectorlong& l = lhs.get_val_list();
+    const vectorlong& r = rhs.get_val_list();
+    vectorlong& out = scratch.val_list();
+    bool complemented;
+    if(op == PLAN_AND)
+    {
+        if(!lhs.complemented() && !rhs.complemented())
+            sorted_intersection(l, r, out);
+        else if(!lhs.complemented())
+            sorted_difference(l, r, out);
+        else if(!rhs.complemented())
+            sorted_difference(r, l, out);
+        else
+            sorted_union(l, r, out);
+        complemented = lhs.complemented() && rhs.complemented();
+    }
+    else
+    {
+        if(!lhs.complemented() && !rhs.complemented())
+            sorted_union(l, r, out);
+        else if(!lhs.complemented())
+            sorted_difference(r, l, out);
+        else if(!rhs.complemented())
+            sorted_difference(l, r, out);
+        else
+            sorted_intersection(l, r, out);
+        complemented = lhs.complemented() || rhs.complemented();
+    }
+    scratch.set_sorted(true);
+    scratch.set_complemented(complemented);
+    lhs.swap(scratch);
+}
+long PredicatePlan::count_records(mmap_sl& index)
+{
+    //every record is in every field's index exactly once
+    long count = 0;
+    for(mmap_sl::Iterator it = index.begin(); it != index.end(); ++it)
+        count += it->value_list.size();
+    return count;
+}
+bool PredicatePlan::compare(int op, const char* value, const string& literal)
+{
+    int cmp = strcmp(value, literal.c_str());
+    switch(op)
+    {
+    case PLAN_EQ:
+        return cmp == 0;
+    case PLAN_LT:
+        return cmp < 0;
+    case PLAN_GT:
+        return cmp > 0;
+    case PLAN_LE:
+        return cmp <= 0;
+    case PLAN_GE:
+        return cmp >= 0;
+    case PLAN_NE:
+        return cmp != 0;
+    default:
+        return false;
+    }
+}
+
+#endif //PREDICATE_PLAN_CPP
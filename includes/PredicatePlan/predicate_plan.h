@@ -0,0 +1,130 @@
+#ifndef PREDICATE_PLAN_H
+#define PREDICATE_PLAN_H
+
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <set>
+#include <vector>
+#include <string>
+#include <cassert>
+#include "../Queue/Queue.h"
+#include "../Token/token.h"
+#include "../Token/operator.h"
+#include "../Token/result_set.h"
+#include "../Table/typedefs.h"
+#include "../Table/table_constants.h"
+#include "../Error_code/error_code.h"
+#include "../ThreadPool/thread_pool.h"
+
+using namespace std;
+
+//operation codes of a compiled WHERE clause
+enum plan_op
+{
+    PLAN_EQ,        //leaf: field = literal
+    PLAN_LT,        //leaf: field < literal
+    PLAN_GT,        //leaf: field > literal
+    PLAN_LE,        //leaf: field <= literal
+    PLAN_GE,        //leaf: field >= literal
+    PLAN_NE,        //leaf: field != literal (also written <>)
+    PLAN_AND,       //pops two results, pushes their intersection
+    PLAN_OR,        //pops two results, pushes their union
+    PLAN_NOT        //complements the result on top
+};
+
+//one postfix instruction, leaves carry their resolved field and literal
+struct PlanOp
+{
+    int op;                 //plan_op
+    int field;              //index into the record / record_indicies, -1 for logical ops
+    string field_name;      //kept for printing only
+    string literal;         //right hand side of a leaf
+
+    PlanOp(int op_code = PLAN_AND, int field_index = -1, const string& name = "", const string& value = "")
+        : op(op_code), field(field_index), field_name(name), literal(value) {}
+    bool is_leaf() const {return op <= PLAN_NE;}
+};
+
+//what evaluate() did at one op of a profiled plan, for explain analyze
+struct PlanOpStats
+{
+    long rows;              //recnos the op's result stands for, complements counted as what they select
+    long keys_visited;      //index keys a leaf looked up or walked
+    long entries_visited;   //recnos a leaf copied out of the keys' value lists
+    double ms;              //wall time the op took, including waiting for its thread
+    int shared_with;        //op whose probe this repeated comparison reused, -1 if it probed itself
+
+    PlanOpStats(): rows(0), keys_visited(0), entries_visited(0), ms(0), shared_with(-1) {}
+};
+
+//a WHERE clause compiled once from its postfix token queue into an enum coded op array
+//evaluated either against the per-field MMap indexes or against a single record
+class PredicatePlan
+{
+public:
+    PredicatePlan();
+    //compiles and validates a postfix queue, throwing the same errors RPN reports
+    PredicatePlan(const Queue<Token*>& postfix, map_sl& field_indicies) throw(Error_Code);
+    //single comparison plan: field relational literal
+    PredicatePlan(int field, const string& field_name, const string& relational, const string& literal) throw(Error_Code);
+
+    void compile(const Queue<Token*>& postfix, map_sl& field_indicies) throw(Error_Code);
+    bool empty() const {return _ops.empty();}
+    int size() const {return _ops.size();}
+    const vector<PlanOp>& ops() const {return _ops;}
+    //replaces the literal of the leaf at op_index, used to bind prepared statement parameters
+    void set_literal(int op_index, const string& literal);
+
+    //index probe path: returns the matching recnos from the field indexes
+    //record_count bounds the complement a not produces, -1 counts the records in the indexes
+    //limit keeps only the first limit recnos, a single comparison stops walking its index there
+    //max_threads > 1 probes independent comparisons and merges independent subtrees of an and/or
+    //plan on that many threads of the shared pool, identical comparisons are probed once
+    vectorlong evaluate(vector<mmap_sl>& record_indicies, long record_count = -1, long limit = -1, int max_threads = 1);
+    //scan path: true if the record read from disk satisfies the predicate
+    bool matches(const char record[][FIELD_MAX_LEN]) const;
+    //rough count of the index entries evaluate() visits: exact for =, a third of the
+    //records for a range and all of them for !=
+    double estimate_entries(vector<mmap_sl>& record_indicies, long record_count) const;
+    //rows each op's result is expected to hold, by op: exact for =, a third of the records for
+    //a range, and and/or combine their inputs as if they were independent
+    vector<double> estimate_rows(vector<mmap_sl>& record_indicies, long record_count) const;
+    //with profiling on evaluate() fills op_stats() for every op, it is off for a normal query
+    void set_profiling(bool profiling) {_profiling = profiling;}
+    const vector<PlanOpStats>& op_stats() const {return _op_stats;}
+
+    //maps "=", "<", ">", "<=", ">=", "!=", "<>" to their plan_op, -1 if not a relational
+    static int relational_op(const string& relational);
+    static string op_string(int op);
+
+    friend ostream& operator<<(ostream& outs, const PredicatePlan& print_me);
+
+private:
+    vector<PlanOp> _ops;            //postfix instructions
+    int _max_depth;                 //deepest the evaluation stack gets
+    vector<ResultSet> _stack;       //result stack reused across evaluate() calls
+    ResultSet _scratch;             //merge target reused across evaluate() calls
+    vector<const vectorlong*> _runs;    //value lists of the keys a range leaf covers
+    bool _profiling;
+    vector<PlanOpStats> _op_stats;
+
+    //sorted asks for ascending recnos, otherwise they come back in index key order
+    //and stop once limit of them are found, -1 for all
+    //runs is scratch space, so probes on different threads each pass their own
+    //returns the index keys it looked up or walked
+    static long probe(const PlanOp& leaf, mmap_sl& index, ResultSet& result, bool sorted, long limit, vector<const vectorlong*>& runs);
+    //combines the two results on top of the stack into lhs, following De Morgan for complemented ones
+    //scratch is the merge target, swapped into lhs afterwards
+    static void merge(int op, ResultSet& lhs, ResultSet& rhs, ResultSet& scratch);
+    //evaluates the plan as a dag, one level of independent nodes at a time on the thread pool
+    void evaluate_parallel(vector<mmap_sl>& record_indicies, ResultSet& result, int max_threads, long record_count);
+    //complements and trims the plan's final result into the recnos evaluate() returns
+    static vectorlong finish(ResultSet& result, vector<mmap_sl>& record_indicies, long record_count, long limit);
+    //fills _op_stats[i] from the result op i left, record_count counts what a complement selects
+    void record_stats(int i, const ResultSet& result, long keys, double ms, long record_count);
+    static long count_records(mmap_sl& index);
+    static bool compare(int op, const char* value, const string& literal);
+};
+
+#endif //PREDICATE_PLAN_H
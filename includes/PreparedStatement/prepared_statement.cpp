@@ -0,0 +1,64 @@
+#ifndef PREPARED_STATEMENT_CPP
+#define PREPARED_STATEMENT_CPP
+
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <set>
+#include <vector>
+#include <string>
+#include <cassert>
+#include "prepared_statement.h"
+
+using namespace std;
+
+PreparedStatement::PreparedStatement()
+{
+    _valid = false;
+    _command = COMMAND_NONE;
+    _has_where = false;
+    _plan_ready = false;
+}
+bool PreparedStatement::bind(int param, const string& value)
+{
+    if(param < 1 || param > param_count())
+        return false;
+    _params[param - 1] = value;
+    _bound[param - 1] = true;
+    return true;
+}
+bool PreparedStatement::bind(const vectorstr& values)
+{
+    if(values.size() != _params.size())
+        return false;
+    _params = values;
+    _bound.assign(_params.size(), true);
+    return true;
+}
+bool PreparedStatement::bound(int param) const
+{
+    return param >= 1 && param <= param_count() && _bound[param - 1];
+}
+void PreparedStatement::clear_bindings()
+{
+    for(int i = 0; i < _params.size(); i++)
+    {
+        _params[i].clear();
+        _bound[i] = false;
+    }
+}
+ostream& operator<<(ostream& outs, const PreparedStatement& print_me)
+{
+    outs<<"statement: "<<print_me._text<<"\n";
+    for(int i = 0; i < print_me._params.size(); i++)
+    {
+        outs<<"  ?"<<i + 1<<" = ";
+        if(print_me._bound[i])
+            outs<<print_me._params[i]<<"\n";
+        else
+            outs<<"(unbound)\n";
+    }
+    return outs;
+}
+
+#endif //PREPARED_STATEMENT_CPP
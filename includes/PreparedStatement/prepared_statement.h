@@ -0,0 +1,63 @@
+#ifndef PREPARED_STATEMENT_H
+#define PREPARED_STATEMENT_H
+
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <set>
+#include <vector>
+#include <string>
+#include <cassert>
+#include "../Table/typedefs.h"
+#include "../PredicatePlan/predicate_plan.h"
+#include "../SQL/select_clauses.h"
+
+using namespace std;
+
+//a command parsed once by SQL::prepare with "?" placeholders in place of insert values
+//or where condition values, run any number of times through SQL::execute after binding
+class PreparedStatement
+{
+public:
+    PreparedStatement();
+
+    bool valid() const {return _valid;}
+    const string& text() const {return _text;}
+    statement_commands command() const {return _command;}
+    int param_count() const {return _params.size();}
+
+    //binds value to the param-th "?", counting from 1, false if the statement has no such parameter
+    bool bind(int param, const string& value);
+    //binds every parameter in order, false and nothing bound unless there is one value for each
+    bool bind(const vectorstr& values);
+    //false also for a parameter the statement does not have
+    bool bound(int param) const;
+    void clear_bindings();
+
+    friend ostream& operator<<(ostream& outs, const PreparedStatement& print_me);
+
+private:
+    friend class SQL;
+    string _text;                   //command as given to prepare
+    bool _valid;                    //false if prepare reported an error
+    statement_commands _command;
+    string _table_name;
+    vectorstr _fields;              //select fields
+    vectorstr _values;              //insert values, a parameter's value is replaced when it runs
+    vector<int> _row_ends;          //end of each row in _values when the insert has parenthesized rows
+    vectorstr _condition;           //where condition, a parameter's value is replaced in the plan
+    bool _has_where;
+    SelectClauses _clauses;         //group by, order by, limit and offset of a select
+    vector<int> _positions;         //index of each parameter in _values or _condition
+    vector<int> _comparisons;       //comparison of the condition, counting from 0, each parameter is the value of
+    vectorstr _params;              //bound values
+    vector<bool> _bound;
+
+    //compiled where clause, kept until the table's fields change
+    PredicatePlan _plan;
+    bool _plan_ready;
+    vectorstr _plan_fields;         //table fields the plan was compiled against
+    vector<int> _plan_leaves;       //plan op holding each parameter's literal
+};
+
+#endif //PREPARED_STATEMENT_H
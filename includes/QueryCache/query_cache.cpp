@@ -0,0 +1,218 @@
+#ifndef QUERY_CACHE_CPP
+#define QUERY_CACHE_CPP
+
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <set>
+#include <vector>
+#include <string>
+#include <cassert>
+#include <cstring>
+#include "query_cache.h"
+#include "../Tokenizer/stoken_constants.h"
+
+using namespace std;
+
+namespace
+{
+    //character classes mirroring the STokenizer's token classes
+    enum norm_class {NORM_WORD, NORM_OPERATOR, NORM_PUNC, NORM_PAREN};
+
+    int norm_class_of(char c)
+    {
+        if(strchr(PAREN, c))
+            return NORM_PAREN;
+        if(strchr(OPERATORS, c))
+            return NORM_OPERATOR;
+        if(strchr(PUNC, c))
+            return NORM_PUNC;
+        return NORM_WORD;
+    }
+
+    //true if dropping the whitespace between a and b could merge two tokens into one
+    bool space_matters(char a, char b)
+    {
+        //'!' starts a punctuation token but continues an operator one and
+        //'.' continues a number, so spaces next to them are always kept
+        if(a == '!' || b == '!' || a == '.' || b == '.')
+            return true;
+        int a_class = norm_class_of(a);
+        int b_class = norm_class_of(b);
+        if(a_class == NORM_PAREN || b_class == NORM_PAREN)
+            return false;
+        return a_class == b_class;
+    }
+}
+
+QueryCache::QueryCache()
+{
+    _capacity = 0;
+    _cache_rows = true;
+    reset_stats();
+}
+QueryCache::QueryCache(int capacity, bool cache_rows)
+{
+    _capacity = capacity < 0 ? 0 : capacity;
+    _cache_rows = cache_rows;
+    reset_stats();
+}
+void QueryCache::set_capacity(int capacity)
+{
+    _capacity = capacity < 0 ? 0 : capacity;
+    while(size() > _capacity)
+        evict_lru();
+}
+string QueryCache::normalize(const string& command)
+{
+    //whitespace is kept only where the tokenizer needs it to split two tokens
+    //of the same class ("a = < b" is not "a=<b"), everything else collapses
+    string normalized;
+    char quote = '\0';
+    bool pending_space = false;
+    for(size_t i = 0; i < command.size(); i++)
+    {
+        char c = command[i];
+        if(quote)
+        {
+            normalized += c;
+            if(c == quote)
+                quote = '\0';
+            continue;
+        }
+        if(c == ' ' || c == '\t' || c == '\n' || c == '\r')
+        {
+            pending_space = !normalized.empty();
+            continue;
+        }
+        if(pending_space)
+        {
+            if(space_matters(normalized[normalized.size() - 1], c))
+                normalized += ' ';
+            pending_space = false;
+        }
+        if(c == '\"' || c == '\'')
+            quote = c;
+        normalized += c;
+    }
+    return normalized;
+}
+bool QueryCache::cacheable(const string& normalized_command)
+{
+    return normalized_command.compare(0, 7, "select ") == 0;
+}
+const QueryCacheEntry* QueryCache::lookup(const string& key)
+{
+    if(!enabled())
+        return nullptr;
+    unordered_map<string, entry_list::iterator>::iterator found = _lookup.find(key);
+    if(found == _lookup.end())
+    {
+        _misses++;
+        return nullptr;
+    }
+    _hits++;
+    //move to the front without invalidating the stored iterator
+    _entries.splice(_entries.begin(), _entries, found->second);
+    return &(*found->second);
+}
+void QueryCache::insert(const string& key, const string& table_name, const vectorstr& fields,
+                        const vectorlong& recnos, const Table& result)
+{
+    if(!enabled())
+        return;
+    unordered_map<string, entry_list::iterator>::iterator found = _lookup.find(key);
+    if(found != _lookup.end())
+        drop_entry(found->second);
+    while(size() >= _capacity)
+        evict_lru();
+    _entries.push_front(QueryCacheEntry());
+    QueryCacheEntry& entry = _entries.front();
+    entry.key = key;
+    entry.table_name = table_name;
+    entry.fields = fields;
+    entry.recnos = recnos;
+    entry.has_result = _cache_rows;
+    if(_cache_rows)
+        entry.result = result;
+    _lookup[key] = _entries.begin();
+}
+void QueryCache::invalidate(const string& table_name)
+{
+    entry_list::iterator it = _entries.begin();
+    while(it != _entries.end())
+    {
+        if(it->table_name == table_name)
+        {
+            drop_entry(it++);
+            _invalidations++;
+        }
+        else
+            ++it;
+    }
+}
+bool QueryCache::holds_result(const string& result_name) const
+{
+    for(entry_list::const_iterator it = _entries.begin(); it != _entries.end(); ++it)
+    {
+        if(it->has_result && it->result.get_table_name() == result_name)
+            return true;
+    }
+    return false;
+}
+void QueryCache::clear()
+{
+    while(!_entries.empty())
+        drop_entry(_entries.begin());
+}
+vectorstr QueryCache::take_dropped_results()
+{
+    vectorstr dropped;
+    dropped.swap(_dropped_results);
+    return dropped;
+}
+double QueryCache::hit_rate() const
+{
+    long lookups = _hits + _misses;
+    if(lookups == 0)
+        return 0.0;
+    return static_cast<double>(_hits) / lookups;
+}
+void QueryCache::reset_stats()
+{
+    _hits = 0;
+    _misses = 0;
+    _evictions = 0;
+    _invalidations = 0;
+}
+ostream& operator<<(ostream& outs, const QueryCache& print_me)
+{
+    outs<<"--Query cache--\n";
+    outs<<"entries: "<<print_me.size()<<"/"<<print_me._capacity<<"\n";
+    streamsize old_precision = outs.precision();
+    outs<<"hits: "<<print_me._hits<<", misses: "<<print_me._misses
+        <<", hit rate: "<<fixed<<setprecision(2)<<print_me.hit_rate() * 100<<"%\n";
+    outs.unsetf(ios_base::floatfield);
+    outs.precision(old_precision);
+    outs<<"evictions: "<<print_me._evictions<<", invalidations: "<<print_me._invalidations<<"\n";
+    outs<<"---------------\n";
+    return outs;
+}
+
+//private
+void QueryCache::evict_lru()
+{
+    if(_entries.empty())
+        return;
+    drop_entry(--_entries.end());
+    _evictions++;
+}
+void QueryCache::drop_entry(entry_list::iterator entry)
+{
+    if(entry->has_result && !entry->result.get_table_name().empty())
+        _dropped_results.push_back(entry->result.get_table_name());
+    _lookup.erase(entry->key);
+    _entries.erase(entry);
+}
+
+#endif //QUERY_CACHE_CPP
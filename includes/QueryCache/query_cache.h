@@ -0,0 +1,87 @@
+#ifndef QUERY_CACHE_H
+#define QUERY_CACHE_H
+
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <set>
+#include <vector>
+#include <string>
+#include <cassert>
+#include <list>
+#include <unordered_map>
+#include "../Table/table.h"
+
+using namespace std;
+
+//one cached select: the recnos it produced and (optionally) the rendered result table
+struct QueryCacheEntry
+{
+    string key;                 //normalized query text
+    string table_name;          //table the select read from, used for invalidation
+    vectorstr fields;           //projected field names, needed to re-render from recnos
+    vectorlong recnos;          //record numbers the select produced
+    bool has_result;            //true if result holds the rendered rows
+    Table result;               //rendered result table
+};
+
+//size bounded LRU cache of select results keyed on normalized query text
+//entries are dropped per table whenever that table is written to or dropped
+class QueryCache
+{
+public:
+    QueryCache();
+    QueryCache(int capacity, bool cache_rows = true);
+
+    //capacity is the max number of cached selects, 0 disables the cache
+    void set_capacity(int capacity);
+    int get_capacity() const {return _capacity;}
+    void set_cache_rows(bool cache_rows) {_cache_rows = cache_rows;}
+    bool get_cache_rows() const {return _cache_rows;}
+    bool enabled() const {return _capacity > 0;}
+    int size() const {return _entries.size();}
+
+    //collapses insignificant whitespace outside of quotes so equivalent commands share a key
+    static string normalize(const string& command);
+    //only selects are cached, so only they should be looked up
+    static bool cacheable(const string& normalized_command);
+
+    //returns the cached entry for key (and marks it most recently used), nullptr on a miss
+    const QueryCacheEntry* lookup(const string& key);
+    //caches a select result, evicting the least recently used entry when full
+    void insert(const string& key, const string& table_name, const vectorstr& fields,
+                const vectorlong& recnos, const Table& result);
+    //drops every entry that read from table_name
+    void invalidate(const string& table_name);
+    //an entry answers from the result table named result_name, so its files are still needed
+    bool holds_result(const string& result_name) const;
+    void clear();
+    //the result tables of the entries dropped since the last call, whose files nothing reads anymore
+    vectorstr take_dropped_results();
+
+    //metrics
+    long hits() const {return _hits;}
+    long misses() const {return _misses;}
+    long evictions() const {return _evictions;}
+    long invalidations() const {return _invalidations;}
+    double hit_rate() const;
+    void reset_stats();
+
+    friend ostream& operator<<(ostream& outs, const QueryCache& print_me);
+
+private:
+    typedef list<QueryCacheEntry> entry_list;
+    entry_list _entries;                                        //most recently used at the front
+    unordered_map<string, entry_list::iterator> _lookup;        //key -> position in _entries
+    int _capacity;
+    bool _cache_rows;
+    long _hits;
+    long _misses;
+    long _evictions;
+    long _invalidations;
+    vectorstr _dropped_results;
+    void evict_lru();
+    void drop_entry(entry_list::iterator entry);
+};
+
+#endif //QUERY_CACHE_H
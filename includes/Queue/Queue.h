@@ -1,134 +1,160 @@
 #ifndef QUEUE_H
 #define QUEUE_H
 
-#include "../DoublyLinkedList/DoublyLinkedList.h"
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <cassert>
+#include <new>
+#include <utility>
 #include "../Token/token.h"
 
-//implementing a queue data structure using a doubly linked list
+using namespace std;
+
+//implementing a queue data structure as a ring buffer: the items sit in one array that
+//doubles when it is full, so a push allocates nothing until the queue outgrows its array
 template <typename T>
 class Queue {
 public:
-    //implementing iterator class for traversing queue elements
+    //implementing iterator class for traversing queue elements, front to rear
     class Iterator {
     public:
         friend class Queue;
         //constructing empty iterator
-        Iterator() { _ptr = NULL; }
-        //constructing iterator pointing to specified node
-        Iterator(node<T>* p) { _ptr = p; }
+        Iterator() { _queue = NULL; _index = 0; }
+        //constructing iterator pointing to the index-th item from the front
+        Iterator(const Queue<T>* queue, int index) { _queue = queue; _index = index; }
 
-        operator bool() { return _ptr; }
+        operator bool() { return !is_null(); }
 
         //accessing the value at current position
-        T& operator *() { return _ptr->_item; }
+        T& operator *() { return _queue->slot(_index); }
 
         //accessing members of current item
-        T* operator ->() {
-            T* item_ptr = &_ptr->_item;
-            return item_ptr;
-        }
+        T* operator ->() { return &_queue->slot(_index); }
 
-        //checking if iterator is null
-        bool is_null() { return !_ptr; }
+        //checking if iterator is past the rear
+        bool is_null() const { return !_queue || _index >= _queue->_size; }
 
         //comparing iterators for inequality
         friend bool operator !=(const Iterator& left, const Iterator& right) {
             return !(left == right);
         }
 
-        //comparing iterators for equality
+        //comparing iterators for equality, every iterator past the rear is end()
         friend bool operator ==(const Iterator& left, const Iterator& right) {
-            return left._ptr == right._ptr;
+            if(left.is_null() || right.is_null())
+                return left.is_null() == right.is_null();
+            return left._queue == right._queue && left._index == right._index;
         }
 
         //moving iterator to next position (prefix)
         Iterator& operator++() {
-            _ptr = _ptr->_next;
+            _index++;
             return *this;
         }
 
         //moving iterator to next position (postfix)
         friend Iterator operator++(Iterator& it, int unused) {
-            it._ptr = it._ptr->_next;
-            return Iterator(it._ptr);
+            it._index++;
+            return it;
         }
     private:
-        node<T>* _ptr;                          //pointer to current node
+        const Queue<T>* _queue;                 //queue being walked
+        int _index;                             //position from the front
     };
 
     //constructing empty queue
     Queue();
     //copying existing queue
     Queue(const Queue<T>& copyMe);
+    //taking over another queue's array, which is left empty
+    Queue(Queue<T>&& moveMe);
     //cleaning up queue resources
     ~Queue();
     //assigning from another queue
     Queue& operator=(const Queue<T>& RHS);
+    Queue& operator=(Queue<T>&& RHS);
 
     //checking if queue is empty
-    bool empty();
+    bool empty() const;
     //accessing first element
     T front();
     //accessing last element
     T back();
 
     //adding element to end of queue
-    void push(T item);
+    void push(const T& item);
     //removing and returning first element
     T pop();
-    //removing all elements
+    //removing all elements, the array is kept for reuse
     void clear();
 
     //getting iterator to first element
     Iterator begin() const;
     //getting iterator to end (null)
     Iterator end() const;
-    //debugging pointer structure
+    //debugging the array
     void print_pointers();
     //getting number of elements
     int size() const { return _size; }
+    //getting number of elements the array holds before it grows
+    int capacity() const { return _capacity; }
 
     //outputting queue contents
     template<typename TT>
     friend ostream& operator << (ostream& outs, const Queue<TT>& printMe);
 private:
-    node<T>* _front;    //pointer to first element
-    node<T>* _rear;     //pointer to last element
+    static const int MIN_CAPACITY = 8;
+
+    T* _data;           //ring of _capacity slots, _capacity is 0 or a power of two
+    int _capacity;
+    int _head;          //slot of the first element
     int _size;          //number of elements
+
+    //the index-th item from the front
+    T& slot(int index) const { return _data[(_head + index) & (_capacity - 1)]; }
+    //moves the items to the front of an array of capacity slots
+    void reallocate(int capacity);
+    void release();
 };
 
 //constructing empty queue
 template <typename T>
 Queue<T>::Queue() {
-    _front = nullptr;
-    _rear = nullptr;
+    _data = nullptr;
+    _capacity = 0;
+    _head = 0;
     _size = 0;
 }
 
 //copying existing queue
 template <typename T>
 Queue<T>::Queue(const Queue<T>& copyMe) {
-    if(copyMe._front == nullptr) {
-        assert(copyMe._rear == nullptr && "Rear should be nullptr when front is nullptr.");
-        _front = nullptr;
-        _rear = nullptr;
-        _size = 0;
-    }
-    else {
-        _front = nullptr;
-        _rear = _copy_list(_front, copyMe._front);
-        _size = copyMe._size;
-    }
+    _data = nullptr;
+    _capacity = 0;
+    _head = 0;
+    _size = 0;
+    *this = copyMe;
+}
+
+//taking over another queue's array
+template <typename T>
+Queue<T>::Queue(Queue<T>&& moveMe) {
+    _data = moveMe._data;
+    _capacity = moveMe._capacity;
+    _head = moveMe._head;
+    _size = moveMe._size;
+    moveMe._data = nullptr;
+    moveMe._capacity = 0;
+    moveMe._head = 0;
+    moveMe._size = 0;
 }
 
 //cleaning up queue resources
 template <typename T>
 Queue<T>::~Queue() {
-    const bool debug = false;
-    _clear_list(_front);
-    _front = nullptr;
-    _rear = nullptr;
-    _size = 0;
+    release();
 }
 
 //assigning from another queue
@@ -136,103 +162,149 @@ template <typename T>
 Queue<T>& Queue<T>::operator=(const Queue<T>& RHS) {
     if(this == &RHS)
         return *this;
-    else {
-        _clear_list(_front);
-        _front = nullptr;
-        _rear = nullptr;
-        _rear = _copy_list(_front, RHS._front);
-        _size = RHS._size;
-        return *this;
+    clear();
+    if(_capacity < RHS._size)
+    {
+        release();
+        int capacity = MIN_CAPACITY;
+        while(capacity < RHS._size)
+            capacity *= 2;
+        _data = static_cast<T*>(::operator new(sizeof(T) * capacity));
+        _capacity = capacity;
     }
+    for(int i = 0; i < RHS._size; i++)
+        new (&_data[i]) T(RHS.slot(i));
+    _size = RHS._size;
+    return *this;
+}
+
+//taking over another queue's array
+template <typename T>
+Queue<T>& Queue<T>::operator=(Queue<T>&& RHS) {
+    if(this == &RHS)
+        return *this;
+    release();
+    _data = RHS._data;
+    _capacity = RHS._capacity;
+    _head = RHS._head;
+    _size = RHS._size;
+    RHS._data = nullptr;
+    RHS._capacity = 0;
+    RHS._head = 0;
+    RHS._size = 0;
+    return *this;
 }
 
 //checking if queue is empty
 template <typename T>
-bool Queue<T>::empty() {
-    if(_front == nullptr) {
-        assert(_rear == nullptr && "Rear should be nullptr when front is nullptr.");
-        return true;
-    }
-    else
-        return false;
+bool Queue<T>::empty() const {
+    return _size == 0;
 }
 
 //accessing first element
 template <typename T>
 T Queue<T>::front() {
-    return _front->_item;
+    assert(_size > 0 && "Cannot get the front of an Empty Queue.");
+    return slot(0);
 }
 
 //accessing last element
 template <typename T>
 T Queue<T>::back() {
-    return _rear->_item;
+    assert(_size > 0 && "Cannot get the back of an Empty Queue.");
+    return slot(_size - 1);
 }
 
 //adding element to end of queue
 template <typename T>
-void Queue<T>::push(T item) {
-    if(_front == nullptr) {
-        assert(_rear == nullptr && "Rear should be nullptr when front is nullptr.");
-        _size++;
-        _front = _insert_head(_rear, item);
-    }
-    else {
-        _size++;
-        _rear = _insert_after(_rear, _rear, item);
+void Queue<T>::push(const T& item) {
+    if(_size == _capacity)
+    {
+        //item may be in the array being replaced
+        T copy(item);
+        reallocate(_capacity ? _capacity * 2 : MIN_CAPACITY);
+        new (&slot(_size)) T(std::move(copy));
     }
+    else
+        new (&slot(_size)) T(item);
+    _size++;
 }
 
 //removing and returning first element
 template <typename T>
 T Queue<T>::pop() {
-    assert(_front != nullptr && "Cannot pop an Empty Stack.");
+    assert(_size > 0 && "Cannot pop an Empty Queue.");
+    T& first = slot(0);
+    T item(std::move(first));
+    first.~T();
+    _head = (_head + 1) & (_capacity - 1);
     _size--;
-    if(_front == _rear) {
-        _rear = nullptr;
-        return _remove_head(_front);
-    }
-    else {
-        return _remove_head(_front);
-    }
+    return item;
 }
 
 //removing all elements
 template <typename T>
 void Queue<T>::clear() {
-    _clear_list(_front);
-    _front = nullptr;
-    _rear = nullptr;
+    for(int i = 0; i < _size; i++)
+        slot(i).~T();
+    _head = 0;
     _size = 0;
 }
 
 //getting iterator to first element
 template <typename T>
 typename Queue<T>::Iterator Queue<T>::begin() const {
-    return Iterator(_front);
+    return Iterator(this, 0);
 }
 
 //getting iterator to end (null)
 template <typename T>
 typename Queue<T>::Iterator Queue<T>::end() const {
-    return nullptr;
+    return Iterator();
 }
 
-//debugging pointer structure
+//debugging the array
 template <typename T>
 void Queue<T>::print_pointers() {
-    _print_list(_front);
+    cout << "Head->";
+    for(int i = 0; i < _size; i++)
+        cout << "<-[" << slot(i) << "]->";
+    cout << "|||  " << _size << " of " << _capacity << " slots, head at " << _head << "\n";
+}
+
+//moving the items into a new array
+template <typename T>
+void Queue<T>::reallocate(int capacity) {
+    T* data = static_cast<T*>(::operator new(sizeof(T) * capacity));
+    for(int i = 0; i < _size; i++)
+    {
+        new (&data[i]) T(std::move(slot(i)));
+        slot(i).~T();
+    }
+    ::operator delete(_data);
+    _data = data;
+    _capacity = capacity;
+    _head = 0;
+}
+
+//destroying the items and giving back the array
+template <typename T>
+void Queue<T>::release() {
+    clear();
+    ::operator delete(_data);
+    _data = nullptr;
+    _capacity = 0;
 }
 
 //outputting queue contents
 template<typename TT>
 ostream& operator << (ostream& outs, const Queue<TT>& printMe) {
     outs << "Queue:Head->";
-    for(node<TT>* walker = printMe._front; walker != nullptr; walker = walker->_next) {
-        outs << *walker;
+    for(int i = 0; i < printMe._size; i++) {
+        outs << "<-[" << printMe.slot(i) << "]->";
     }
     outs << "|||\n";
     return outs;
 }
 
-#endif //QUEUE_H
\ No newline at end of file
+#endif //QUEUE_H
@@ -0,0 +1,90 @@
+#ifndef BATCH_PIPELINE_CPP
+#define BATCH_PIPELINE_CPP
+
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <set>
+#include <vector>
+#include <string>
+#include <cassert>
+#include <utility>
+#include "batch_pipeline.h"
+using namespace std;
+
+BatchPipeline::BatchPipeline(StatementSplitter& statements, int capacity): _statements(statements)
+{
+    _capacity = capacity > 0 ? capacity : 1;
+    _done = false;
+    _stopping = false;
+    _parser = thread(&BatchPipeline::parse, this);
+}
+BatchPipeline::~BatchPipeline()
+{
+    stop();
+}
+bool BatchPipeline::next(ParsedCommand& command)
+{
+    if(_taken.empty())
+    {
+        //everything parsed so far changes hands under one lock
+        unique_lock<mutex> lock(_mutex);
+        _ready.wait(lock, [this]{return !_parsed.empty() || _done;});
+        if(_parsed.empty())
+            return false;
+        _taken.swap(_parsed);
+        lock.unlock();
+        _room.notify_one();
+    }
+    std::swap(command, _taken.front());
+    _taken.pop_front();
+    return true;
+}
+void BatchPipeline::stop()
+{
+    {
+        lock_guard<mutex> lock(_mutex);
+        _stopping = true;
+    }
+    _room.notify_one();
+    if(_parser.joinable())
+        _parser.join();
+    _parsed.clear();
+    _taken.clear();
+}
+
+//private
+void BatchPipeline::parse()
+{
+    ParsedCommand command;
+    while(_statements.next(command.text))
+    {
+        command.failed = false;
+        try
+        {
+            Parser parser(command.text);
+            parser.parse_statement(command.statement);
+        }
+        catch(Error_Code error_)
+        {
+            command.failed = true;
+            command.error = error_;
+        }
+        unique_lock<mutex> lock(_mutex);
+        _room.wait(lock, [this]{return _parsed.size() < _capacity || _stopping;});
+        if(_stopping)
+            return;
+        bool was_empty = _parsed.empty();
+        _parsed.push_back(ParsedCommand());
+        std::swap(_parsed.back(), command);
+        lock.unlock();
+        //the caller only waits on an empty queue
+        if(was_empty)
+            _ready.notify_one();
+    }
+    lock_guard<mutex> lock(_mutex);
+    _done = true;
+    _ready.notify_one();
+}
+
+#endif //BATCH_PIPELINE_CPP
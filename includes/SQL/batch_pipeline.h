@@ -0,0 +1,66 @@
+#ifndef BATCH_PIPELINE_H
+#define BATCH_PIPELINE_H
+
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <set>
+#include <vector>
+#include <string>
+#include <cassert>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include "../Parser/parser.h"
+#include "../Tokenizer/statement_splitter.h"
+#include "../error_code/error_code.h"
+
+using namespace std;
+
+//parsed statements waiting for the caller before the parse thread stops to let it catch up
+const int BATCH_PIPELINE_CAPACITY = 1024;
+
+//a statement of a script and what parsing it gave
+struct ParsedCommand
+{
+    string text;
+    Statement statement;
+    bool failed;            //parsing threw error, statement is unusable
+    Error_Code error;
+
+    ParsedCommand(): failed(false) {}
+};
+
+//splits and parses the statements of a script on a thread of its own, so the statements
+//after the one the caller is running are parsed while it runs
+class BatchPipeline
+{
+public:
+    explicit BatchPipeline(StatementSplitter& statements, int capacity = BATCH_PIPELINE_CAPACITY);
+    //stops the parse thread
+    ~BatchPipeline();
+    //the next statement in script order, false once there are no more
+    bool next(ParsedCommand& command);
+    //stops parsing, statements next() has not handed over are dropped
+    void stop();
+
+private:
+    StatementSplitter& _statements;
+    int _capacity;
+    deque<ParsedCommand> _parsed;       //parsed and not taken yet, guarded by _mutex
+    deque<ParsedCommand> _taken;        //taken from _parsed in one go, only the caller uses it
+    bool _done;                         //the parse thread reached the end of the script
+    bool _stopping;
+    mutex _mutex;
+    condition_variable _ready;          //_parsed got a statement or _done was set
+    condition_variable _room;           //_parsed has room again or _stopping was set
+    thread _parser;
+
+    void parse();
+
+    BatchPipeline(const BatchPipeline&);
+    BatchPipeline& operator =(const BatchPipeline&);
+};
+
+#endif //BATCH_PIPELINE_H
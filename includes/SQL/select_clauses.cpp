@@ -0,0 +1,76 @@
+#ifndef SELECT_CLAUSES_CPP
+#define SELECT_CLAUSES_CPP
+
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <set>
+#include <vector>
+#include <string>
+#include <cassert>
+#include <cstdlib>
+#include "select_clauses.h"
+
+using namespace std;
+
+SelectClauses::SelectClauses()
+{
+    aggregated = false;
+    descending = false;
+    limit = -1;
+    offset = 0;
+}
+void SelectClauses::read(const Statement& statement) throw(Error_Code)
+{
+    Error_Code error_code;
+    *this = SelectClauses();
+    if(statement.group)
+    {
+        if(statement.group_by.empty())
+        {
+            error_code._code = EXPECT_GROUP_FIELD;
+            throw error_code;
+        }
+        group_by = statement.group_by;
+    }
+    aggregated = statement.aggregate || statement.group;
+    if(statement.order)
+    {
+        if(statement.order_by.empty())
+        {
+            error_code._code = EXPECT_ORDER_FIELD;
+            throw error_code;
+        }
+        order_by = statement.order_by;
+        descending = statement.direction == "desc";
+    }
+    //limit N offset M
+    const bool given[2] = {statement.limit, statement.offset};
+    const string* count_given[2] = {&statement.limit_count, &statement.offset_count};
+    long* counts[2] = {&limit, &offset};
+    for(int i = 0; i < 2; i++)
+    {
+        if(!given[i])
+            continue;
+        error_code._code = INVALID_LIMIT;
+        const string& count = *count_given[i];
+        if(count.empty() || count.size() > 9 || count.find_first_not_of("0123456789") != string::npos)
+        {
+            error_code._error_token = count;
+            throw error_code;
+        }
+        *counts[i] = atol(count.c_str());
+    }
+}
+long SelectClauses::rows_kept() const
+{
+    return limit < 0 ? -1 : offset + limit;
+}
+long SelectClauses::records_kept() const
+{
+    if(aggregated || !order_by.empty())
+        return -1;
+    return rows_kept();
+}
+
+#endif //SELECT_CLAUSES_CPP
@@ -0,0 +1,45 @@
+#ifndef SELECT_CLAUSES_H
+#define SELECT_CLAUSES_H
+
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <set>
+#include <vector>
+#include <string>
+#include <cassert>
+#include "../Table/typedefs.h"
+#include "../Parser/statement.h"
+#include "../error_code/error_code.h"
+
+using namespace std;
+
+//what a select asks for after its where condition: group by, aggregates, order by, limit and offset
+struct SelectClauses
+{
+    vectorstr group_by;     //group by fields, empty without a group by
+    bool aggregated;        //the select list has an aggregate or there is a group by
+    string order_by;        //empty when unordered
+    bool descending;
+    long limit;             //-1 without a limit
+    long offset;
+
+    SelectClauses();
+    //reads the clauses of a parsed select, reporting a clause missing its field or count
+    void read(const Statement& statement) throw(Error_Code);
+    //leading rows the result needs, offset + limit, -1 for all of them
+    long rows_kept() const;
+    //records the selection can stop at, rows_kept() unless rows are ordered or grouped first
+    long records_kept() const;
+    //drops the first offset rows and keeps limit of the rest
+    template <class T>
+    void page(vector<T>& rows) const
+    {
+        if(offset > 0)
+            rows.erase(rows.begin(), rows.begin() + (offset < rows.size() ? offset : rows.size()));
+        if(limit >= 0 && rows.size() > limit)
+            rows.resize(limit);
+    }
+};
+
+#endif //SELECT_CLAUSES_H
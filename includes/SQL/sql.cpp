@@ -8,6 +8,9 @@
 #include <vector>
 #include <string>
 #include <cassert>
+#include <algorithm>
+#include <map>
+#include <cstdlib>
 #include "sql.h"
 using namespace std;
 
@@ -27,161 +30,195 @@ SQL::SQL(){
 }
 
 //method that will handle different user commands
-Table SQL::command(string command){
+Table SQL::command(string command, bool resultWanted){
+    return run(command, NULL, resultWanted);
+}
+
+//a batch transaction hands over commands its pipeline parsed and does not want an insert's table back
+Table SQL::run(string command, ParsedCommand* preparsed, bool resultWanted){
     const bool debug = false;
     try {
         error = false;
+        errorText.clear();
         Error_Code error_code;
-        char cmd_s[300];
-        strcpy(cmd_s, command.c_str());
-        Parser parser(cmd_s);
-        parseTree.clear();
-        parseTree = parser.parse_tree();
-
+        //a repeated select is answered straight from the cache, skipping parsing and RPN
+        string cacheKey;
+        if(resultCache.enabled())
+        {
+            cacheKey = QueryCache::normalize(command);
+            if(QueryCache::cacheable(cacheKey))
+            {
+                const QueryCacheEntry* cached = resultCache.lookup(cacheKey);
+                if(cached)
+                {
+                    selectRecNos = cached->recnos;
+                    if(cached->has_result)
+                        return cached->result;
+                    return tables[cached->table_name].vector_to_table(cached->recnos, cached->fields);
+                }
+            }
+            else
+                cacheKey.clear();
+        }
+        if(preparsed)
+        {
+            if(preparsed->failed)
+                throw preparsed->error;
+            std::swap(parsed, preparsed->statement);
+        }
+        else
+        {
+            Parser parser(command);
+            parser.parse_statement(parsed);
+        }
+        //a "?" only stands for a value in a prepared statement
+        if(parsed.params)
+        {
+            error_code._code = PARAMETER_NOT_PREPARED;
+            throw error_code;
+        }
+        switch(parsed.command)
+        {
         //to create/make a table
-        if(parseTree["command"][0] == "make" || parseTree["command"][0] == "create")
+        case COMMAND_MAKE:
         {
+            //make table and insert into cut short before the table name
+            if(parsed.table_names.empty())
+            {
+                error_code._code = MISSING_KEYWORDS;
+                throw error_code;
+            }
+            const string& tableName = parsed.table_names[0];
             //two argument CTOR to create new table
-            if(tables.contains(parseTree["table_name"][0]))
+            if(tables.contains(tableName))
             {
                 //error handling should go here
                 //user trying to create an existing table
                 error_code._code = CANNOT_CREATE_PRE_EXISTING_TABLE;
                 throw error_code;
-                return tables[parseTree["table_name"][0]];
-
-            }
-            else
-            {
-                Table table(parseTree["table_name"][0], parseTree["col"]);
-                tables[parseTree["table_name"][0]] = table;
-                write_to_file_txt_app(sqlTableNamesTxt, {parseTree["table_name"][0]});
-                if(debug)
-                    cout<<"Brand New Table created.\n";
-                return table;
             }
+            Table table(tableName, parsed.columns);
+            tables[tableName] = table;
+            invalidateCache(tableName);
+            write_to_file_txt_app(sqlTableNamesTxt, {tableName});
+            if(debug)
+                cout<<"Brand New Table created.\n";
+            return table;
             //^ delete all txt and bin files than test
         }
-        else if(parseTree["command"][0] == "insert")
+        case COMMAND_INSERT:
         {
+            if(parsed.table_names.empty())
+            {
+                error_code._code = MISSING_KEYWORDS;
+                throw error_code;
+            }
             //one argument CTOR to open an existing table to insert into
-            // Table table(parseTree["table_name"][0]);
-            if(!tables.contains(parseTree["table_name"][0]))
+            const string& tableName = parsed.table_names[0];
+            if(!tables.contains(tableName))
             {
                 error_code._code = INSERT_NON_EXISTENT;
                 throw error_code;
             }
-            tables[parseTree["table_name"][0]].insert_into(parseTree["values"]);
-            return tables[parseTree["table_name"][0]];
+            Table& table = tables[tableName];
+            insertRows(table, parsed.values, parsed.row_ends);
+            invalidateCache(tableName);
+            if(!resultWanted)
+                return Table();
+            return table;
         }
-        else if(parseTree["command"][0] == "select")
+        case COMMAND_LOAD:
         {
-            //where means there is a condition
-            if(!parseTree.contains("table_name"))
+            //load data from "employees.csv" into employee
+            //answers with how many records it added, a loaded table is too big to print back
+            if(parsed.table_names.empty())
             {
-                error_code._code = SELECT_EXPECT_TABLE_NAME;
+                error_code._code = MISSING_KEYWORDS;
                 throw error_code;
             }
-            if(!tables.contains(parseTree["table_name"][0]))
+            const string& tableName = parsed.table_names[0];
+            if(!tables.contains(tableName))
             {
-                error_code._code = SELECT_NON_EXISTENT;
+                error_code._code = INSERT_NON_EXISTENT;
                 throw error_code;
             }
-            if(parseTree["fields"][0] == "*" && parseTree.contains("where"))
-            {
-                //select * from student where lname = Yao
-                //select fname, lname from student
-                //v show all fields but select with condition
-                if(!parseTree.contains("condition"))
-                {
-                    error_code._code = EXPECT_CONDITION;
-                    throw error_code;
-                }
-                Table result_table = tables[parseTree["table_name"][0]].select(parseTree["condition"]);
-                selectRecNos = tables[parseTree["table_name"][0]].select_recnos();
-                return result_table;
-            }
-            else if(parseTree["fields"][0] == "*")
+            Table& table = tables[tableName];
+            long loaded = table.load_file(parsed.file_name);
+            invalidateCache(tableName);
+            return table.rows_to_table({{to_string(loaded)}}, {"rows_loaded"});
+        }
+        case COMMAND_SELECT:
+        {
+            //where means there is a condition
+            if(parsed.table_names.empty())
             {
-                //show all fields and select all with no condition
-                Table result_table = tables[parseTree["table_name"][0]].select_all();
-                selectRecNos = tables[parseTree["table_name"][0]].select_recnos();
-                return result_table;
+                error_code._code = SELECT_EXPECT_TABLE_NAME;
+                throw error_code;
             }
-            else if(parseTree.contains("where"))
+            for(int i = 0; i < parsed.table_names.size(); i++)
             {
-                //want to select fields with condition
-                if(!parseTree.contains("condition"))
+                if(!tables.contains(parsed.table_names[i]))
                 {
-                    error_code._code = EXPECT_CONDITION;
+                    error_code._code = SELECT_NON_EXISTENT;
                     throw error_code;
                 }
-                Table result_table = tables[parseTree["table_name"][0]].select(parseTree["fields"], parseTree["condition"]);
-                selectRecNos = tables[parseTree["table_name"][0]].select_recnos();
-                return result_table;
             }
+            SelectClauses clauses;
+            clauses.read(parsed);
+            //explain select ... describes the plan, explain analyze select ... also runs it
+            if(parsed.explain)
+                return explainSelect(clauses);
+            //select * from student, enrollment where student.id = enrollment.sid
+            if(parsed.table_names.size() > 1)
+                return selectJoin(clauses);
+            const string& tableName = parsed.table_names[0];
+            Table& table = tables[tableName];
+            vectorstr resultFields;
+            if(parsed.fields[0] == "*")
+                resultFields = table.get_field_names();
             else
+                resultFields = parsed.fields;
+            Table result_table = selectTable(table, resultFields, clauses);
+            //aggregate rows cannot be rebuilt from record numbers, so they are only cached as rows
+            if(!clauses.aggregated || resultCache.get_cache_rows())
             {
-                //want to show specific fields and select all with no condition
-                Table result_table = tables[parseTree["table_name"][0]].select_all(parseTree["fields"]);
-                selectRecNos = tables[parseTree["table_name"][0]].select_recnos();
-                return result_table;
+                resultCache.insert(cacheKey, tableName, resultFields, selectRecNos, result_table);
+                dropCachedResults();
             }
+            return result_table;
         }
-        else if(parseTree["command"][0] == "show tables")
-        {
+        case COMMAND_SHOW_TABLES:
             // cout<<"SQL CTOR tables:\n"<<tables<<"\n";
             return getTableNamesInATable();
-        }
-        else if(parseTree["command"][0] == "batch")
-        {
-            batch();
+        case COMMAND_BATCH:
+            batch(parsed.transaction);
             error = true;
             return Table();
-        }
-        else if(parseTree["command"][0] == "drop")
+        case COMMAND_DROP:
         {
             //throw if trying to drop a non existing table
             //throw if trying to drop without giving the name of a table
             //delete from the map
             //actually delete the txt file and bin associated with the table_name
-            if(!parseTree.contains("table_name"))
+            if(parsed.table_names.empty())
             {
                 error_code._code = DROP_EXPECT_TABLENAME;
                 throw error_code;
             }
-            if(!tables.contains(parseTree["table_name"][0]))
+            string removed_table_name = parsed.table_names[0];
+            if(!tables.contains(removed_table_name))
             {
                 error_code._code = DROP_NON_EXISTENT;
                 throw error_code;
             }
-            string removed_table_name = parseTree["table_name"][0];
-            // cout<<"Before removing "<<removed_table_name<<" from tables map\n";
-            // cout<<tables;
-            if(remove((removed_table_name + "_fields.txt").c_str()) != 0)
-                cout<<"Could not remove the file: "<<parseTree["table_name"][0] + "_fields.txt\n";
-            if(remove((removed_table_name + "_fields.bin").c_str()) != 0)
-                cout<<"Could not remove the file: "<<parseTree["table_name"][0] + "_fields.bin\n";
-            tables.erase(removed_table_name);
-            // cout<<"After removing "<<removed_table_name<<" from tables map\n";
-            // cout<<tables;
-            vectorstr before_remove_sql_table_names = read_from_file_txt(sqlTableNamesTxt);
-            vectorstr sql_table_names;
-            for(int i = 0; i < before_remove_sql_table_names.size(); i++)
-            {
-                if(tables.contains(before_remove_sql_table_names[i]))
-                {
-                    sql_table_names.push_back(before_remove_sql_table_names[i]);
-                    tables[before_remove_sql_table_names[i]] = Table(before_remove_sql_table_names[i]);
-                }
-            }
-            write_to_file_txt(sqlTableNamesTxt, sql_table_names);
+            dropTable(removed_table_name);
             error = true;
             return Table();
         }
-        else
-        {
-            assert(false && "Invalid Command");
+        default:
+            //explain with no select after it, or a command that stopped at its first word like "show"
+            error_code._code = MISSING_KEYWORDS;
+            throw error_code;
         }
     }
     catch(Error_Code error_)
@@ -189,7 +226,8 @@ Table SQL::command(string command){
         //this function will add the command to the Error_code obj so that it can use it to
         //display errors according to postgre sql standards
         modifyErrorStringPostgre(error_, command);
-        cout<<error_.get_error_string()<<"\n";
+        errorText = error_.get_error_string();
+        cout<<errorText<<"\n";
         error = true;
         return Table();
     }
@@ -211,17 +249,23 @@ void SQL::printTablesNames()
     cout<<"--------------------------\n\n";
 }
 //delete this print function later
-void SQL::batch()
+void SQL::batch(bool transaction)
 {
     // vectorstr command_vec = read_from_file_txt("batch.txt");
     const bool debug = false;
-    ifstream fin;
-    fin.open("batch.txt");
+    //the file streams through a block at a time, statements end with ; or, if it has none, with their lines
+    FTokenizer ftk("batch.txt");
+    StatementSplitter statements(ftk);
     if(debug)
         cout<<"Loading from batch file\n";
+    if(transaction)
+    {
+        batchTransaction(statements);
+        return;
+    }
     string command_str;
     int i = 1;
-    while(getline(fin, command_str))
+    while(statements.next(command_str))
     {
         cout<<i<<": "<<command_str<<"\n";
         Table temp = command(command_str);
@@ -231,10 +275,526 @@ void SQL::batch()
         }
         i++;
     }
-    fin.close();
+}
+//a statement that fails rolls back everything the script did before it and ends the script
+//inserts and loads only collect index keys until a statement reads the tables or the script commits
+void SQL::batchTransaction(StatementSplitter& statements)
+{
+    ExplainTimer timer;
+    BatchPipeline pipeline(statements);
+    map<string, long> startCounts;      //record counts of the tables written to, from before the script
+    vectorstr created;                  //tables the script made
+    ParsedCommand next;
+    long ran = 0;
+    bool failed = false;
+    while(!failed && pipeline.next(next))
+    {
+        ran++;
+        statement_commands kind = next.failed ? COMMAND_NONE : next.statement.command;
+        string tableName = kind == COMMAND_NONE || next.statement.table_names.empty() ? "" : next.statement.table_names[0];
+        //a dropped table's files are gone, there would be nothing to roll back to
+        if(kind == COMMAND_DROP || kind == COMMAND_BATCH)
+        {
+            next.failed = true;
+            next.error._code = NOT_IN_TRANSACTION;
+            next.error._error_token = kind == COMMAND_DROP ? "drop" : "batch";
+        }
+        else if(kind == COMMAND_INSERT || kind == COMMAND_LOAD)
+        {
+            if(tables.contains(tableName) && !startCounts.count(tableName)
+               && find(created.begin(), created.end(), tableName) == created.end())
+            {
+                startCounts[tableName] = tables[tableName].record_count();
+                tables[tableName].defer_index(true);
+            }
+        }
+        else if(kind != COMMAND_MAKE)
+        {
+            for(map<string, long>::iterator it = startCounts.begin(); it != startCounts.end(); it++)
+                tables[it->first].flush_index();
+            for(int i = 0; i < created.size(); i++)
+                tables[created[i]].flush_index();
+        }
+        if(kind == COMMAND_SELECT)
+            cout<<ran<<": "<<next.text<<"\n";
+        Table result = run(next.text, &next, kind == COMMAND_SELECT);
+        if(errorState())
+            failed = true;
+        else if(kind == COMMAND_SELECT)
+            cout<<result;
+        else if(kind == COMMAND_MAKE)
+        {
+            created.push_back(tableName);
+            tables[tableName].defer_index(true);
+        }
+    }
+    pipeline.stop();
+    double ms = timer.ms();
+    if(failed)
+    {
+        for(map<string, long>::iterator it = startCounts.begin(); it != startCounts.end(); it++)
+        {
+            tables[it->first].truncate(it->second);
+            invalidateCache(it->first);
+        }
+        for(int i = 0; i < created.size(); i++)
+            dropTable(created[i]);
+        cout<<"batch transaction rolled back, statement "<<ran<<" failed: "<<next.text<<"\n";
+        return;
+    }
+    for(map<string, long>::iterator it = startCounts.begin(); it != startCounts.end(); it++)
+        tables[it->first].defer_index(false);
+    for(int i = 0; i < created.size(); i++)
+        tables[created[i]].defer_index(false);
+    cout<<"batch transaction committed: "<<ran<<" statements in "<<ExplainOutput::ms_text(ms)<<", "
+        <<ExplainOutput::rows_text(ms > 0 ? ran * 1000 / ms : 0)<<" statements/s\n";
+}
+void SQL::dropTable(const string& tableName)
+{
+    // cout<<"Before removing "<<tableName<<" from tables map\n";
+    // cout<<tables;
+    if(remove((tableName + "_fields.txt").c_str()) != 0)
+        cout<<"Could not remove the file: "<<tableName + "_fields.txt\n";
+    if(remove((tableName + "_fields.bin").c_str()) != 0)
+        cout<<"Could not remove the file: "<<tableName + "_fields.bin\n";
+    tables.erase(tableName);
+    invalidateCache(tableName);
+    // cout<<"After removing "<<tableName<<" from tables map\n";
+    // cout<<tables;
+    vectorstr before_remove_sql_table_names = read_from_file_txt(sqlTableNamesTxt);
+    vectorstr sql_table_names;
+    for(int i = 0; i < before_remove_sql_table_names.size(); i++)
+    {
+        if(tables.contains(before_remove_sql_table_names[i]))
+        {
+            sql_table_names.push_back(before_remove_sql_table_names[i]);
+            tables[before_remove_sql_table_names[i]] = Table(before_remove_sql_table_names[i]);
+        }
+    }
+    write_to_file_txt(sqlTableNamesTxt, sql_table_names);
+}
+void SQL::dropResult(const Table& result)
+{
+    //every command's result is a table of its own, <table>_<serial>, nothing reads it after its rows are sent
+    string resultName = result.get_table_name();
+    if(resultName.empty() || tables.contains(resultName) || resultCache.holds_result(resultName))
+        return;
+    remove((resultName + "_fields.txt").c_str());
+    remove((resultName + "_fields.bin").c_str());
+}
+void SQL::invalidateCache(const string& tableName)
+{
+    resultCache.invalidate(tableName);
+    dropCachedResults();
+}
+void SQL::dropCachedResults()
+{
+    //a result the cache let go of was kept by dropResult, so nothing else removes its files; a client
+    //still streaming it has the records open already
+    vectorstr dropped = resultCache.take_dropped_results();
+    for(int i = 0; i < dropped.size(); i++)
+    {
+        if(tables.contains(dropped[i]) || resultCache.holds_result(dropped[i]))
+            continue;
+        remove((dropped[i] + "_fields.txt").c_str());
+        remove((dropped[i] + "_fields.bin").c_str());
+    }
+}
+
+void SQL::enableQueryCache(int capacity, bool cacheRows)
+{
+    resultCache.set_capacity(capacity);
+    resultCache.set_cache_rows(cacheRows);
+    resultCache.clear();
+    dropCachedResults();
+}
+
+PreparedStatement SQL::prepare(string command)
+{
+    PreparedStatement statement;
+    statement._text = command;
+    try {
+        error = false;
+        errorText.clear();
+        Error_Code error_code;
+        Parser parser(command);
+        Statement parsedPrepared;
+        parser.parse_statement(parsedPrepared);
+
+        statement._command = parsedPrepared.command;
+        if(parsedPrepared.table_names.size() > 1)
+        {
+            error_code._code = UNSUPPORTED_JOIN;
+            throw error_code;
+        }
+        if(!parsedPrepared.table_names.empty())
+            statement._table_name = parsedPrepared.table_names[0];
+        if(statement._command == COMMAND_INSERT)
+        {
+            statement._values = parsedPrepared.values;
+            statement._row_ends = parsedPrepared.row_ends;
+        }
+        else if(statement._command == COMMAND_SELECT)
+        {
+            statement._fields = parsedPrepared.fields;
+            statement._has_where = parsedPrepared.where;
+            statement._condition = parsedPrepared.condition;
+        }
+
+        //every "?" has to have landed in the values or the condition
+        if(statement._command == COMMAND_INSERT)
+            statement._positions = parsedPrepared.value_params;
+        else if(statement._command == COMMAND_SELECT)
+            statement._positions = parsedPrepared.condition_params;
+        if(statement._positions.size() != parsedPrepared.params)
+        {
+            error_code._code = INVALID_PARAMETER;
+            throw error_code;
+        }
+        //in a condition only the value right of a relational is a parameter, the comparisons
+        //compile to plan leaves in the order they are written
+        for(int i = 0, comparisons = 0, next = 0; i < statement._condition.size() && next < statement._positions.size(); i++)
+        {
+            if(PredicatePlan::relational_op(statement._condition[i]) != -1)
+                comparisons++;
+            if(i != statement._positions[next])
+                continue;
+            if(i == 0 || PredicatePlan::relational_op(statement._condition[i - 1]) == -1)
+            {
+                error_code._code = INVALID_PARAMETER;
+                throw error_code;
+            }
+            statement._comparisons.push_back(comparisons - 1);
+            next++;
+        }
+        statement._params.resize(parsedPrepared.params);
+        statement._bound.assign(parsedPrepared.params, false);
+        if(statement._command == COMMAND_SELECT)
+            statement._clauses.read(parsedPrepared);
+        statement._valid = true;
+    }
+    catch(Error_Code error_)
+    {
+        modifyErrorStringPostgre(error_, command);
+        errorText = error_.get_error_string();
+        cout<<errorText<<"\n";
+        error = true;
+    }
+    return statement;
+}
+
+Table SQL::execute(PreparedStatement& statement)
+{
+    try {
+        error = false;
+        errorText.clear();
+        Error_Code error_code;
+        if(!statement.valid())
+        {
+            error_code._code = STATEMENT_NOT_PREPARED;
+            throw error_code;
+        }
+        for(int i = 0; i < statement._bound.size(); i++)
+        {
+            if(!statement._bound[i])
+            {
+                error_code._code = PARAMETER_NOT_BOUND;
+                error_code._error_token = "?" + to_string(i + 1);
+                throw error_code;
+            }
+        }
+
+        if(statement._command == COMMAND_INSERT)
+        {
+            if(!tables.contains(statement._table_name))
+            {
+                error_code._code = INSERT_NON_EXISTENT;
+                throw error_code;
+            }
+            vectorstr values = statement._values;
+            for(int i = 0; i < statement._positions.size(); i++)
+                values[statement._positions[i]] = statement._params[i];
+            insertRows(tables[statement._table_name], values, statement._row_ends);
+            invalidateCache(statement._table_name);
+            return tables[statement._table_name];
+        }
+        else if(statement._command == COMMAND_SELECT)
+        {
+            if(statement._table_name.empty())
+            {
+                error_code._code = SELECT_EXPECT_TABLE_NAME;
+                throw error_code;
+            }
+            if(!tables.contains(statement._table_name))
+            {
+                error_code._code = SELECT_NON_EXISTENT;
+                throw error_code;
+            }
+            Table& table = tables[statement._table_name];
+            vectorstr resultFields = statement._fields[0] == "*" ? table.get_field_names() : statement._fields;
+            if(statement._has_where)
+            {
+                if(statement._condition.empty())
+                {
+                    error_code._code = EXPECT_CONDITION;
+                    throw error_code;
+                }
+                //the condition is compiled on first use and again only if the table was recreated
+                if(!statement._plan_ready || statement._plan_fields != table.get_field_names())
+                {
+                    statement._plan_ready = false;
+                    statement._plan = table.compile_condition(statement._condition);
+                    statement._plan_fields = table.get_field_names();
+                    statement._plan_leaves.clear();
+                    vector<int> leaves;
+                    const vector<PlanOp>& ops = statement._plan.ops();
+                    for(int i = 0; i < ops.size(); i++)
+                    {
+                        if(ops[i].is_leaf())
+                            leaves.push_back(i);
+                    }
+                    for(int i = 0; i < statement._comparisons.size(); i++)
+                    {
+                        if(statement._comparisons[i] >= leaves.size())
+                        {
+                            error_code._code = INVALID_PARAMETER;
+                            throw error_code;
+                        }
+                        statement._plan_leaves.push_back(leaves[statement._comparisons[i]]);
+                    }
+                    statement._plan_ready = true;
+                }
+                for(int i = 0; i < statement._plan_leaves.size(); i++)
+                    statement._plan.set_literal(statement._plan_leaves[i], statement._params[i]);
+                selectRecNos = table.where_recnos(statement._plan, statement._clauses.records_kept());
+            }
+            else
+                selectRecNos = table.all_recnos(statement._clauses.records_kept());
+            return selectResult(table, resultFields, statement._clauses);
+        }
+        //nothing to bind in any other command, so it runs as typed
+        return command(statement._text);
+    }
+    catch(Error_Code error_)
+    {
+        modifyErrorStringPostgre(error_, statement._text);
+        errorText = error_.get_error_string();
+        cout<<errorText<<"\n";
+        error = true;
+        return Table();
+    }
 }
 
 //privates
+void SQL::insertRows(Table& table, const vectorstr& values, const vector<int>& rowEnds)
+{
+    //insert into student values (Joe, CS), (Ann, Math)
+    if(rowEnds.size() <= 1)
+    {
+        table.insert_into(values);
+        return;
+    }
+    vector<vectorstr> rows(rowEnds.size());
+    for(int i = 0, begin = 0; i < rowEnds.size(); begin = rowEnds[i], i++)
+        rows[i].assign(values.begin() + begin, values.begin() + rowEnds[i]);
+    table.insert_many(rows);
+}
+Table SQL::selectTable(Table& table, const vectorstr& resultFields, const SelectClauses& clauses, ExplainOutput* out)
+{
+    Error_Code error_code;
+    //under explain each step adds how it runs and the rows it is expected to give, the steps
+    //only run under explain analyze, which adds what each one did
+    bool run = !out || out->analyze();
+    ExplainTimer timer;
+    //select * from student limit 10 offset 20
+    //only the first offset + limit records are ever needed, an unordered select stops there
+    long kept = clauses.records_kept();
+    double rows = table.record_count();
+    if(parsed.where)
+    {
+        //select * from student where lname = Yao
+        //select fname, lname from student where age > 20
+        if(parsed.condition.empty())
+        {
+            error_code._code = EXPECT_CONDITION;
+            throw error_code;
+        }
+        PredicatePlan plan = table.compile_condition(parsed.condition);
+        int method = -1;
+        int line = -1;
+        vector<double> estimates;
+        if(out)
+        {
+            method = table.where_method(plan);
+            estimates = table.estimate_where_rows(plan);
+            rows = kept >= 0 && kept < estimates.back() ? kept : estimates.back();
+            string how = Table::where_method_name(method);
+            if(method == WHERE_PARALLEL_SCAN)
+                how += " on " + to_string(Table::scan_threads) + " threads, " + to_string(SCAN_MORSEL_RECORDS) + " record batches";
+            else if(method == WHERE_PARALLEL_PROBES)
+                how += " on " + to_string(Table::probe_threads) + " threads";
+            if(kept >= 0)
+                how += ", stops at " + to_string(kept);
+            line = out->step(1, "where: " + how + ", est " + ExplainOutput::rows_text(rows) + " rows");
+            if(out->analyze())
+                plan.set_profiling(true);
+        }
+        long read = table.records_read();
+        timer.restart();
+        if(run)
+            selectRecNos = table.where_recnos(plan, kept);
+        if(out && out->analyze())
+        {
+            string figures = to_string(selectRecNos.size()) + " rows";
+            if(method == WHERE_PARALLEL_SCAN)
+                figures += ", " + to_string(table.records_read() - read) + " records read";
+            out->actual(line, figures + ", " + ExplainOutput::ms_text(timer.ms()));
+        }
+        if(out)
+            out->where_tree(plan, estimates, method != WHERE_PARALLEL_SCAN, 2);
+    }
+    else
+    {
+        //no condition selects every record
+        int line = -1;
+        if(out)
+        {
+            rows = kept >= 0 && kept < rows ? kept : rows;
+            line = out->step(1, string("all records") + (kept >= 0 ? ", stops at " + to_string(kept) : "") + ", est "
+                             + ExplainOutput::rows_text(rows) + " rows");
+        }
+        timer.restart();
+        if(run)
+            selectRecNos = table.all_recnos(kept);
+        if(out && out->analyze())
+            out->actual(line, to_string(selectRecNos.size()) + " rows, " + ExplainOutput::ms_text(timer.ms()));
+    }
+    if(out)
+        out->expect(rows);
+    return selectResult(table, resultFields, clauses, out);
+}
+Table SQL::selectResult(Table& table, const vectorstr& resultFields, const SelectClauses& clauses, ExplainOutput* out)
+{
+    bool run = !out || out->analyze();
+    bool analyze = out && out->analyze();
+    ExplainTimer timer;
+    long read = table.records_read();
+    long keys = table.index_keys_read();
+    int line = -1;
+    if(!clauses.aggregated)
+    {
+        if(!clauses.order_by.empty())
+        {
+            if(out)
+            {
+                table.check_field(clauses.order_by);
+                int method = table.order_method(run ? selectRecNos.size() : (long)out->expected(), clauses.descending, clauses.rows_kept());
+                line = explainOrder(*out, clauses, Table::order_method_name(method));
+            }
+            timer.restart();
+            if(run)
+                table.order_recnos(selectRecNos, clauses.order_by, clauses.descending, clauses.rows_kept());
+            if(analyze)
+                out->actual(line, to_string(selectRecNos.size()) + " rows, " + to_string(table.index_keys_read() - keys) + " index keys, "
+                            + to_string(table.records_read() - read) + " records read, " + ExplainOutput::ms_text(timer.ms()));
+        }
+        line = out ? explainPage(*out, clauses) : -1;
+        if(run)
+            clauses.page(selectRecNos);
+        if(analyze && line != -1)
+            out->actual(line, to_string(selectRecNos.size()) + " rows");
+        if(out)
+        {
+            for(int i = 0; i < resultFields.size(); i++)
+                table.check_field(resultFields[i]);
+            line = out->step(1, "fetch " + to_string(resultFields.size()) + " fields: record reads on " + to_string(Table::scan_threads)
+                             + " threads, est " + ExplainOutput::rows_text(out->expected()) + " records");
+        }
+        if(!run)
+            return Table();
+        read = table.records_read();
+        timer.restart();
+        Table result = table.vector_to_table(selectRecNos, resultFields);
+        if(analyze)
+            out->actual(line, to_string(result.record_count()) + " rows, " + to_string(table.records_read() - read) + " records read, "
+                        + ExplainOutput::ms_text(timer.ms()));
+        return result;
+    }
+    //select major, count(*) from student group by major order by major desc limit 3
+    if(out)
+    {
+        for(int i = 0; i < clauses.group_by.size(); i++)
+            table.check_field(clauses.group_by[i]);
+        int method = table.aggregate_method(resultFields, clauses.group_by);
+        double rows = 1;
+        if(!clauses.group_by.empty())
+        {
+            //at most one group per key of the first group field
+            double keys = table.field_index(table.field_position(clauses.group_by[0])).size();
+            rows = keys < out->expected() ? keys : out->expected();
+        }
+        out->expect(rows);
+        string text = "aggregate";
+        for(int i = 0; i < clauses.group_by.size(); i++)
+            text += (i ? ", " : " by ") + clauses.group_by[i];
+        line = out->step(1, text + ": " + Table::aggregate_method_name(method) + ", est " + ExplainOutput::rows_text(rows) + " rows");
+    }
+    timer.restart();
+    vector<vectorstr> rows;
+    if(run)
+        rows = table.aggregate(selectRecNos, resultFields, clauses.group_by);
+    if(analyze)
+        out->actual(line, to_string(rows.size()) + " rows, " + to_string(table.index_keys_read() - keys) + " index keys, "
+                    + to_string(table.records_read() - read) + " records read, " + ExplainOutput::ms_text(timer.ms()));
+    if(!clauses.order_by.empty())
+    {
+        line = out ? explainOrder(*out, clauses, "sort of the aggregate rows") : -1;
+        timer.restart();
+        if(run)
+            orderAggregateRows(rows, resultFields, clauses);
+        if(analyze)
+            out->actual(line, to_string(rows.size()) + " rows, " + ExplainOutput::ms_text(timer.ms()));
+    }
+    line = out ? explainPage(*out, clauses) : -1;
+    if(run)
+        clauses.page(rows);
+    if(analyze && line != -1)
+        out->actual(line, to_string(rows.size()) + " rows");
+    return run ? table.rows_to_table(rows, resultFields) : Table();
+}
+void SQL::orderAggregateRows(vector<vectorstr>& rows, const vectorstr& resultFields, const SelectClauses& clauses)
+{
+    Error_Code error_code;
+    if(clauses.order_by.empty())
+        return;
+    //an aggregate result is ordered on one of its own columns
+    int column = find(resultFields.begin(), resultFields.end(), clauses.order_by) - resultFields.begin();
+    if(column == resultFields.size())
+    {
+        error_code._code = UNKNOWN_COLUMN;
+        error_code._error_token = clauses.order_by;
+        error_code._modify_to_postgre = true;
+        throw error_code;
+    }
+    //count, sum and avg are numbers the aggregate made, a group key or a min/max is a field value
+    //and orders as text the way the field's index does
+    bool descending = clauses.descending;
+    int func = AggregateColumn(resultFields[column]).func;
+    if(func == AGG_COUNT || func == AGG_SUM || func == AGG_AVG)
+    {
+        stable_sort(rows.begin(), rows.end(), [column, descending](const vectorstr& lhs, const vectorstr& rhs)
+        {
+            double l = atof(lhs[column].c_str());
+            double r = atof(rhs[column].c_str());
+            return descending ? r < l : l < r;
+        });
+        return;
+    }
+    stable_sort(rows.begin(), rows.end(), [column, descending](const vectorstr& lhs, const vectorstr& rhs)
+    {
+        return descending ? rhs[column] < lhs[column] : lhs[column] < rhs[column];
+    });
+}
 void SQL::sqlWriteToFileTxt(string filename)
 {
     if(!file_exists(filename.c_str()))
@@ -253,23 +813,190 @@ Table SQL::getTableNamesInATable()
     }
     return sql_tables;
 }
+Table SQL::selectJoin(const SelectClauses& clauses, ExplainOutput* out)
+{
+    Error_Code error_code;
+    const vectorstr& names = parsed.table_names;
+    if(names.size() != 2 || clauses.aggregated)
+    {
+        error_code._code = UNSUPPORTED_JOIN;
+        throw error_code;
+    }
+    vectorstr columns;
+    if(parsed.fields[0] != "*")
+        columns = parsed.fields;
+    //a plain explain only plans the join, on the rows each side's own conditions are expected to select
+    bool run = !out || out->analyze();
+    ExplainTimer timer;
+    JoinCursor cursor(tables[names[0]], names[0], tables[names[1]], names[1], joinCondition(), columns, !run);
+    vectorstr resultFields = cursor.column_names();
+    int line = out ? explainJoin(*out, cursor, clauses) : -1;
+    if(!run)
+        return Table();
+    selectRecNos.clear();
+    //a joined row is not a record of either table, so unlike a one table select there are no
+    //recnos to hand back: the result table is what the shell prints and the server sends, and
+    //rows are written to it JOIN_RESULT_BATCH at a time with one insert each. A join is never
+    //cached, since a cache entry is dropped on writes to the one table it read from
+    Table result_table = tables[names[0]].rows_to_table(vector<vectorstr>(), resultFields);
+    vector<vectorstr> rows;
+    vectorstr row;
+    if(clauses.order_by.empty())
+    {
+        //rows go from the cursor into the result as they come, a limit stops the join there
+        long skipped = 0;
+        long kept = 0;
+        while((clauses.limit < 0 || kept < clauses.limit) && cursor.next(row))
+        {
+            if(skipped < clauses.offset)
+            {
+                skipped++;
+                continue;
+            }
+            rows.push_back(row);
+            kept++;
+            if(rows.size() == JOIN_RESULT_BATCH)
+            {
+                result_table.insert_many(rows);
+                rows.clear();
+            }
+        }
+    }
+    else
+    {
+        //the order by column rides along at the end of each row if it was not selected
+        int order_column = cursor.add_column(clauses.order_by);
+        bool descending = clauses.descending;
+        auto before = [order_column, descending](const vectorstr& lhs, const vectorstr& rhs)
+        {
+            return descending ? rhs[order_column] < lhs[order_column] : lhs[order_column] < rhs[order_column];
+        };
+        //under a limit only the leading rows_kept() rows are held, cut back whenever twice that
+        //many have come; the sort is stable, so ties keep the order the join gave them
+        long kept = clauses.rows_kept();
+        while(cursor.next(row))
+        {
+            rows.push_back(row);
+            if(kept >= 0 && rows.size() >= 2 * kept + JOIN_RESULT_BATCH)
+            {
+                stable_sort(rows.begin(), rows.end(), before);
+                rows.resize(kept);
+            }
+        }
+        stable_sort(rows.begin(), rows.end(), before);
+        clauses.page(rows);
+        for(int i = 0; i < rows.size(); i++)
+            rows[i].resize(resultFields.size());
+    }
+    result_table.insert_many(rows);
+    if(out)
+        out->actual(line, to_string(result_table.record_count()) + " rows, " + ExplainOutput::ms_text(timer.ms()));
+    return result_table;
+}
+vectorstr SQL::joinCondition()
+{
+    Error_Code error_code;
+    //an inner join's on condition and where condition are one condition
+    vectorstr condition;
+    const bool given[2] = {parsed.join, parsed.where};
+    const vectorstr* parts[2] = {&parsed.join_condition, &parsed.condition};
+    for(int i = 0; i < 2; i++)
+    {
+        if(!given[i])
+            continue;
+        if(parts[i]->empty())
+        {
+            error_code._code = EXPECT_CONDITION;
+            throw error_code;
+        }
+        if(!condition.empty())
+            condition.push_back("and");
+        condition.push_back("(");
+        const vectorstr& part = *parts[i];
+        condition.insert(condition.end(), part.begin(), part.end());
+        condition.push_back(")");
+    }
+    return condition;
+}
+Table SQL::explainSelect(const SelectClauses& clauses)
+{
+    //explain select * from student where age > 20 order by lname limit 5
+    //explain analyze select ... runs every step too, as the select would, and adds what each one did
+    //the select itself adds its steps as it comes to them, so the plan shown is the one that runs
+    ExplainOutput out(parsed.analyze);
+    const vectorstr& names = parsed.table_names;
+    string from = names[0];
+    for(int i = 1; i < names.size(); i++)
+        from += " join " + names[i];
+    int root = out.step(0, "select from " + from);
+    ExplainTimer total;
+    Table result;
+    if(names.size() > 1)
+        result = selectJoin(clauses, &out);
+    else
+    {
+        Table& table = tables[names[0]];
+        result = selectTable(table, parsed.fields[0] == "*" ? table.get_field_names() : parsed.fields, clauses, &out);
+    }
+    if(out.analyze())
+        out.actual(root, to_string(result.record_count()) + " rows, " + ExplainOutput::ms_text(total.ms()));
+    return tables[names[0]].rows_to_table(out.rows(), {"query_plan"});
+}
+int SQL::explainJoin(ExplainOutput& out, JoinCursor& cursor, const SelectClauses& clauses)
+{
+    const vectorstr& names = parsed.table_names;
+    string text = "join: " + JoinCursor::method_name(cursor.method());
+    if(!cursor.join_key().empty())
+        text += " on " + cursor.join_key();
+    out.expect(cursor.estimate_rows());
+    int line = out.step(1, text + ", est " + ExplainOutput::rows_text(out.expected()) + " rows");
+    //under explain analyze each side's records were selected, a plain explain only estimates them
+    for(int i = 0; i < 2; i++)
+        out.step(2, string(i ? "inner " : "outer ") + names[i] + ": " + (out.analyze() ? "" : "est ")
+                 + ExplainOutput::rows_text(cursor.side_rows(i)) + " of " + to_string(tables[names[i]].record_count())
+                 + " records pass its own conditions");
+    if(!clauses.order_by.empty())
+    {
+        cursor.add_column(clauses.order_by);
+        explainOrder(out, clauses, "sort of the joined rows");
+    }
+    explainPage(out, clauses, clauses.order_by.empty() ? ", stops the join early" : "");
+    return line;
+}
+int SQL::explainOrder(ExplainOutput& out, const SelectClauses& clauses, const string& how)
+{
+    return out.step(1, "order by " + clauses.order_by + (clauses.descending ? " desc" : "") + ": " + how);
+}
+int SQL::explainPage(ExplainOutput& out, const SelectClauses& clauses, const string& how)
+{
+    if(clauses.limit < 0 && clauses.offset <= 0)
+        return -1;
+    double rows = out.expected() > clauses.offset ? out.expected() - clauses.offset : 0;
+    if(clauses.limit >= 0 && clauses.limit < rows)
+        rows = clauses.limit;
+    out.expect(rows);
+    string text = "page:";
+    if(clauses.limit >= 0)
+        text += " limit " + to_string(clauses.limit);
+    if(clauses.offset > 0)
+        text += " offset " + to_string(clauses.offset);
+    return out.step(1, text + how + ", est " + ExplainOutput::rows_text(rows) + " rows");
+}
 void SQL::modifyErrorStringPostgre(Error_Code& error, string& command)
 {
     const bool debug = false;
     if(error._modify_to_postgre)
     {
         error._error_input = command;
-        char input_buffer[300];
-        strcpy(input_buffer, command.c_str());
-        STokenizer stk(input_buffer);
+        STokenizer stk(command);
         SToken t;
         stk>>t;
         while(stk.more())
         {
-            if(t.token_str() == error._error_token)
+            if(t.view() == error._error_token)
                 break;
 
-            error._character_count += t.token_str().size();
+            error._character_count += t.view().size();
             t = SToken();
             stk>>t;
         }
@@ -10,27 +10,58 @@
 #include <cassert>
 #include "../Table/table.h"
 #include "../Parser/parser.h"
+#include "../QueryCache/query_cache.h"
+#include "../PreparedStatement/prepared_statement.h"
+#include "select_clauses.h"
+#include "../Join/join.h"
+#include "../Explain/explain.h"
+#include "../Tokenizer/statement_splitter.h"
+#include "batch_pipeline.h"
 #include "../error_code/error_code.h"
 using namespace std;
 
 class SQL{
 public:
     SQL();                                      //Initializes the SQL instance.
-    Table command(string command);              //Processes SQL-like commands (create, insert, select, drop, etc.) and returns a Table object.
+    Table command(string command, bool resultWanted = true);  //Processes SQL-like commands (create, insert, select, drop, etc.) and returns a Table object, an insert returns an empty one unless resultWanted.
     vectorlong selectRecordNos();               //Retrieves record numbers resulting from the last select operation.
     bool errorState(){return error;}            //Checks if an error occurred during the last operation.
+    string errorMessage(){return errorText;}    //The error the last operation printed, empty if it had none (drop and batch set errorState() without one).
     void printTablesNames();                    //Prints the names of all tables managed by the SQL instance.
-    void batch();                               //Processes commands in batch mode from a file (batch.txt).
+    void batch(bool transaction = false);       //Processes the statements of a script file (batch.txt), as one transaction if transaction is set.
+    void enableQueryCache(int capacity, bool cacheRows = true);  //Caches up to capacity select results, 0 disables the cache.
+    const QueryCache& queryCache() const {return resultCache;}  //Read access to the select result cache and its hit-rate metrics.
+    void dropResult(const Table& result);       //Removes the files of a result table once it has been read, a managed table or one the query cache answers from is kept.
+    PreparedStatement prepare(string command);  //Parses an insert or select once, "?" marks a value bound later with bind().
+    Table execute(PreparedStatement& statement);  //Runs a prepared statement with its bound values, skipping tokenizing and parsing.
 
 private:
-    mmap_ss parseTree;                                  //Parse tree storing the structure of the command.
+    Statement parsed;                                   //The command being run as the parser left it, reused from command to command.
     vectorlong selectRecNos;                            //A vector storing record numbers selected in the last query.
     Map<string, Table> tables;                          //A map linking table names to Table objects.
     string sqlTableNamesTxt;                            //File name storing the list of table names.
     bool error;                                         //A flag indicating the error state of the last command.
+    string errorText;                                   //The error message of the last command.
+    QueryCache resultCache;                             //Select results keyed on normalized command text, disabled by default.
+    Table run(string command, ParsedCommand* preparsed, bool resultWanted = true);  //Runs command, parsed here unless a batch pipeline parsed it already.
+    void batchTransaction(StatementSplitter& statements);  //Runs a script as one transaction, printing only selects and a summary.
+    void dropTable(const string& tableName);            //Removes the table's files and forgets it.
+    void invalidateCache(const string& tableName);      //Drops the cached selects of a table that was written to, and their result files.
+    void dropCachedResults();                           //Removes the files of the result tables the cache dropped, evicted or invalidated.
     void sqlWriteToFileTxt(string filename);            //Ensures that the table names file exists and initializes it if necessary.
     Table getTableNamesInATable();                      //Generates a Table object listing all managed table names.
     void modifyErrorStringPostgre(Error_Code& error_, string& command);      //Modifies error messages to align with PostgreSQL standards.
+    void insertRows(Table& table, const vectorstr& values, const vector<int>& rowEnds);  //Inserts values as one row, or as the rows rowEnds splits them into.
+    //the select pipeline, out adds each step to an explain as it comes to it, and the steps only run under explain analyze
+    Table selectTable(Table& table, const vectorstr& resultFields, const SelectClauses& clauses, ExplainOutput* out = nullptr);  //Selects the records of the one table select in parsed and makes its result.
+    Table selectResult(Table& table, const vectorstr& resultFields, const SelectClauses& clauses, ExplainOutput* out = nullptr);  //Orders, aggregates and pages selectRecNos into the result table.
+    Table selectJoin(const SelectClauses& clauses, ExplainOutput* out = nullptr);  //Streams the rows of a two table join in parsed into the result table.
+    vectorstr joinCondition();                          //The on and where conditions of the join in parsed as one condition.
+    void orderAggregateRows(vector<vectorstr>& rows, const vectorstr& resultFields, const SelectClauses& clauses);  //Orders aggregate rows on one of their columns.
+    Table explainSelect(const SelectClauses& clauses);  //Describes how the select in parsed runs, and runs it under explain analyze.
+    int explainJoin(ExplainOutput& out, JoinCursor& cursor, const SelectClauses& clauses);  //Adds the steps of the join cursor plans, returns the join step.
+    int explainOrder(ExplainOutput& out, const SelectClauses& clauses, const string& how);  //Adds the order by step, how it sorts.
+    int explainPage(ExplainOutput& out, const SelectClauses& clauses, const string& how = "");  //Adds the limit and offset step, -1 without either.
 };
 
 
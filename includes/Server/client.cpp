@@ -0,0 +1,198 @@
+#ifndef CLIENT_CPP
+#define CLIENT_CPP
+
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <set>
+#include <vector>
+#include <string>
+#include <cassert>
+#include <cstring>
+#include "client.h"
+#ifndef _WIN32
+#include <cerrno>
+#include <unistd.h>
+#include <netdb.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#endif
+using namespace std;
+
+StealthClient::StealthClient()
+{
+    _fd = -1;
+}
+StealthClient::~StealthClient()
+{
+    disconnect();
+}
+bool StealthClient::query(const string& command, ClientResult& result)
+{
+    return query(command, result, function<void(const vectorstr&)>());
+}
+
+//private
+bool StealthClient::fail(const string& why)
+{
+    _error = why;
+    disconnect();
+    return false;
+}
+
+#ifndef _WIN32
+bool StealthClient::connect_unix(const string& path)
+{
+    disconnect();
+    sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if(path.empty() || path.size() >= sizeof(address.sun_path))
+        return fail("socket path too long: " + path);
+    strcpy(address.sun_path, path.c_str());
+    _fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if(_fd < 0 || connect(_fd, (sockaddr*)&address, sizeof(address)) != 0)
+        return fail(path + ": " + strerror(errno));
+    return true;
+}
+bool StealthClient::connect_tcp(const string& host, int port)
+{
+    disconnect();
+    addrinfo hints;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo* found = NULL;
+    int failed = getaddrinfo(host.c_str(), to_string(port).c_str(), &hints, &found);
+    if(failed != 0)
+        return fail(host + ": " + gai_strerror(failed));
+    string why;
+    for(addrinfo* a = found; a && _fd < 0; a = a->ai_next)
+    {
+        _fd = socket(a->ai_family, a->ai_socktype | SOCK_CLOEXEC, a->ai_protocol);
+        if(_fd >= 0 && connect(_fd, a->ai_addr, a->ai_addrlen) != 0)
+        {
+            why = strerror(errno);
+            close(_fd);
+            _fd = -1;
+        }
+    }
+    freeaddrinfo(found);
+    if(_fd < 0)
+        return fail(host + ":" + to_string(port) + ": " + why);
+    //a command is one small frame, send it now
+    int on = 1;
+    setsockopt(_fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+    return true;
+}
+void StealthClient::disconnect()
+{
+    if(_fd >= 0)
+        close(_fd);
+    _fd = -1;
+    _in = WireReader();
+}
+bool StealthClient::query(const string& command, ClientResult& result, const function<void(const vectorstr&)>& on_row)
+{
+    result = ClientResult();
+    if(_fd < 0)
+    {
+        _error = "not connected";
+        return false;
+    }
+    string frame;
+    wire_put_text(frame, WIRE_QUERY, command);
+    if(!send_all(frame))
+        return false;
+    WireMessage message;
+    vectorstr row;
+    while(receive(message))
+    {
+        const char* body = message.body.data();
+        const char* end = body + message.body.size();
+        switch(message.type)
+        {
+        case WIRE_FIELDS:
+            if(!wire_get_strings(body, end, result.fields))
+                return fail("bad fields frame");
+            break;
+        case WIRE_ROW:
+            if(!wire_get_strings(body, end, row))
+                return fail("bad row frame");
+            result.row_count++;
+            if(on_row)
+                on_row(row);
+            else
+                result.rows.push_back(row);
+            break;
+        case WIRE_DONE:
+            return true;
+        case WIRE_ERROR:
+            result.failed = true;
+            result.error = message.body;
+            return true;
+        default:
+            return fail("unknown frame type");
+        }
+    }
+    return false;
+}
+
+//private
+bool StealthClient::send_all(const string& bytes)
+{
+    long sent = 0;
+    while(sent < bytes.size())
+    {
+        ssize_t put = send(_fd, bytes.data() + sent, bytes.size() - sent, MSG_NOSIGNAL);
+        if(put < 0 && errno == EINTR)
+            continue;
+        if(put <= 0)
+            return fail(string("send: ") + strerror(errno));
+        sent += put;
+    }
+    return true;
+}
+bool StealthClient::receive(WireMessage& message)
+{
+    char buffer[64 * 1024];
+    while(!_in.next(message))
+    {
+        if(_in.failed())
+            return fail("bad frame");
+        ssize_t got = read(_fd, buffer, sizeof(buffer));
+        if(got < 0 && errno == EINTR)
+            continue;
+        if(got == 0)
+            return fail("server closed the connection");
+        if(got < 0)
+            return fail(string("read: ") + strerror(errno));
+        _in.append(buffer, got);
+    }
+    return true;
+}
+#else
+bool StealthClient::connect_unix(const string& path)
+{
+    return fail("stealthd clients are not supported on windows");
+}
+bool StealthClient::connect_tcp(const string& host, int port)
+{
+    return fail("stealthd clients are not supported on windows");
+}
+void StealthClient::disconnect()
+{
+    _fd = -1;
+}
+bool StealthClient::query(const string& command, ClientResult& result, const function<void(const vectorstr&)>& on_row)
+{
+    result = ClientResult();
+    return fail("not connected");
+}
+bool StealthClient::send_all(const string& bytes) {return false;}
+bool StealthClient::receive(WireMessage& message) {return false;}
+#endif
+
+#endif //CLIENT_CPP
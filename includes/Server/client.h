@@ -0,0 +1,59 @@
+#ifndef CLIENT_H
+#define CLIENT_H
+
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <set>
+#include <vector>
+#include <string>
+#include <cassert>
+#include <functional>
+#include "wire_protocol.h"
+
+using namespace std;
+
+//what stealthd answered a command with
+struct ClientResult
+{
+    vectorstr fields;
+    vector<vectorstr> rows;     //left empty when the rows went to a row callback
+    long row_count;             //rows the server sent
+    bool failed;                //the command failed, error says why
+    string error;
+    ClientResult(): row_count(0), failed(false) {}
+};
+
+//a connection to stealthd, one command at a time
+//not on windows, where query() fails with error() set
+class StealthClient
+{
+public:
+    StealthClient();
+    ~StealthClient();
+    bool connect_unix(const string& path);
+    bool connect_tcp(const string& host, int port);
+    void disconnect();
+    bool connected() const {return _fd >= 0;}
+    //false if the connection failed, a command that failed is still answered (result.failed)
+    bool query(const string& command, ClientResult& result);
+    //hands each row to on_row as it arrives instead of keeping it in result.rows
+    bool query(const string& command, ClientResult& result, const function<void(const vectorstr&)>& on_row);
+    //why the last connect or query returned false
+    string error() const {return _error;}
+
+private:
+    int _fd;
+    WireReader _in;
+    string _error;
+
+    bool send_all(const string& bytes);
+    //the next frame, reading more off the socket until one has arrived
+    bool receive(WireMessage& message);
+    bool fail(const string& why);
+
+    StealthClient(const StealthClient&);
+    StealthClient& operator =(const StealthClient&);
+};
+
+#endif //CLIENT_H
@@ -0,0 +1,505 @@
+#ifndef SERVER_CPP
+#define SERVER_CPP
+
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <set>
+#include <vector>
+#include <string>
+#include <cassert>
+#include <cstring>
+#include <fstream>
+#include "server.h"
+#ifdef __linux__
+#include <cerrno>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <arpa/inet.h>
+#endif
+using namespace std;
+
+//epoll ids that are not connections, listeners count down from LISTENER_ID
+const long WAKE_ID = -1;
+const long LISTENER_ID = -2;
+
+//error strings are colored for the terminal, a client gets the text alone
+static string plain_text(const string& colored)
+{
+    string plain;
+    for(int i = 0; i < colored.size(); i++)
+    {
+        if(colored[i] == '\033' && i + 1 < colored.size() && colored[i + 1] == '[')
+        {
+            for(i += 2; i < colored.size() && !isalpha((unsigned char)colored[i]); i++);
+            continue;
+        }
+        plain += colored[i];
+    }
+    return plain;
+}
+
+StealthServer::StealthServer(SQL& sql, int workers): _sql(sql)
+{
+    _worker_count = workers > 0 ? workers : 1;
+    _next_connection = 0;
+    _epoll = -1;
+    _wake = -1;
+    _stopping = false;
+    _workers_done = false;
+    _commands = 0;
+#ifdef __linux__
+    _epoll = epoll_create1(EPOLL_CLOEXEC);
+    _wake = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if(_epoll < 0 || _wake < 0)
+    {
+        _error = string("epoll: ") + strerror(errno);
+        return;
+    }
+    epoll_event event;
+    event.events = EPOLLIN;
+    event.data.u64 = WAKE_ID;
+    epoll_ctl(_epoll, EPOLL_CTL_ADD, _wake, &event);
+#else
+    _error = "stealthd runs on linux only";
+#endif
+}
+StealthServer::~StealthServer()
+{
+#ifdef __linux__
+    for(int i = 0; i < _listeners.size(); i++)
+        close(_listeners[i]);
+    for(int i = 0; i < _socket_paths.size(); i++)
+        unlink(_socket_paths[i].c_str());
+    if(_wake >= 0)
+        close(_wake);
+    if(_epoll >= 0)
+        close(_epoll);
+#endif
+}
+
+#ifdef __linux__
+bool StealthServer::listen_unix(const string& path)
+{
+    if(_epoll < 0)
+        return false;
+    sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if(path.empty() || path.size() >= sizeof(address.sun_path))
+    {
+        _error = "socket path too long: " + path;
+        return false;
+    }
+    strcpy(address.sun_path, path.c_str());
+    //a socket left behind by a server that did not shut down is reused, any other file is not
+    struct stat info;
+    if(stat(path.c_str(), &info) == 0 && S_ISSOCK(info.st_mode))
+        unlink(path.c_str());
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if(fd < 0 || bind(fd, (sockaddr*)&address, sizeof(address)) != 0)
+    {
+        _error = path + ": " + strerror(errno);
+        if(fd >= 0)
+            close(fd);
+        return false;
+    }
+    _socket_paths.push_back(path);
+    return listen_on(fd, path);
+}
+bool StealthServer::listen_tcp(int port)
+{
+    if(_epoll < 0)
+        return false;
+    //loopback only, there is no authentication
+    sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    int fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    int on = 1;
+    if(fd >= 0)
+        setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+    if(fd < 0 || bind(fd, (sockaddr*)&address, sizeof(address)) != 0)
+    {
+        _error = "127.0.0.1:" + to_string(port) + ": " + strerror(errno);
+        if(fd >= 0)
+            close(fd);
+        return false;
+    }
+    return listen_on(fd, "127.0.0.1:" + to_string(port));
+}
+void StealthServer::run()
+{
+    if(_epoll < 0)
+        return;
+    for(int i = 0; i < _worker_count; i++)
+        _workers.push_back(thread(&StealthServer::work, this));
+    const int MAX_EVENTS = 64;
+    epoll_event events[MAX_EVENTS];
+    while(!_stopping)
+    {
+        int ready = epoll_wait(_epoll, events, MAX_EVENTS, -1);
+        if(ready < 0 && errno != EINTR)
+            break;
+        for(int i = 0; i < ready; i++)
+        {
+            long id = (long)events[i].data.u64;
+            if(id == WAKE_ID)
+            {
+                uint64_t count;
+                while(read(_wake, &count, sizeof(count)) > 0);
+                take_replies();
+            }
+            else if(id <= LISTENER_ID)
+                accept_clients(_listeners[LISTENER_ID - id]);
+            else
+            {
+                //a connection closed by an earlier event can still have events in this batch
+                if(events[i].events & (EPOLLHUP | EPOLLERR) && _connections.count(id))
+                {
+                    //the client is gone, but the commands it sent before it went are read and run
+                    _connections[id].hung_up = true;
+                    read_client(id);
+                }
+                else if(events[i].events & EPOLLIN && _connections.count(id))
+                    read_client(id);
+                if(events[i].events & EPOLLOUT && _connections.count(id))
+                    write_client(id);
+            }
+        }
+    }
+    {
+        lock_guard<mutex> lock(_task_mutex);
+        _workers_done = true;
+        _tasks.clear();
+    }
+    _task_ready.notify_all();
+    for(int i = 0; i < _workers.size(); i++)
+        _workers[i].join();
+    _workers.clear();
+    _replies.clear();
+    while(!_connections.empty())
+        close_client(_connections.begin()->first);
+}
+void StealthServer::stop()
+{
+    //only an atomic store and a write, so a signal handler can call it
+    _stopping = true;
+    if(_wake >= 0)
+    {
+        uint64_t one = 1;
+        ssize_t written = write(_wake, &one, sizeof(one));
+        (void)written;
+    }
+}
+
+//private
+bool StealthServer::listen_on(int fd, const string& what)
+{
+    epoll_event event;
+    event.events = EPOLLIN;
+    event.data.u64 = LISTENER_ID - (long)_listeners.size();
+    if(listen(fd, SOMAXCONN) != 0 || epoll_ctl(_epoll, EPOLL_CTL_ADD, fd, &event) != 0)
+    {
+        _error = what + ": " + strerror(errno);
+        close(fd);
+        return false;
+    }
+    _listeners.push_back(fd);
+    return true;
+}
+void StealthServer::accept_clients(int listener)
+{
+    while(true)
+    {
+        int fd = accept4(listener, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if(fd < 0)
+        {
+            if(errno == EINTR || errno == ECONNABORTED)
+                continue;
+            //EAGAIN once the backlog is empty, anything else (out of fds) waits for the next event
+            return;
+        }
+        //replies are written whole frames at a time already, do not hold them back on tcp
+        int on = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &on, sizeof(on));
+        long id = _next_connection++;
+        Connection& connection = _connections[id];
+        connection.fd = fd;
+        connection.events = EPOLLIN;
+        epoll_event event;
+        event.events = EPOLLIN;
+        event.data.u64 = id;
+        epoll_ctl(_epoll, EPOLL_CTL_ADD, fd, &event);
+    }
+}
+void StealthServer::read_client(long id)
+{
+    Connection& connection = _connections[id];
+    char buffer[SERVER_READ_BYTES];
+    while(true)
+    {
+        ssize_t got = read(connection.fd, buffer, sizeof(buffer));
+        if(got > 0)
+        {
+            connection.in.append(buffer, got);
+            continue;
+        }
+        if(got == 0)
+            connection.closing = true;
+        else if(errno == EINTR)
+            continue;
+        else if(errno != EAGAIN && errno != EWOULDBLOCK)
+            connection.broken = true;
+        break;
+    }
+    WireMessage message;
+    while(connection.in.next(message))
+    {
+        if(message.type != WIRE_QUERY)
+        {
+            connection.broken = true;
+            break;
+        }
+        connection.queries.push_back(message.body);
+    }
+    if(connection.in.failed())
+        connection.broken = true;
+    dispatch(id);
+    update(id);
+}
+void StealthServer::write_client(long id)
+{
+    Connection& connection = _connections[id];
+    while(connection.sent < connection.out.size() && !connection.broken)
+    {
+        ssize_t put = send(connection.fd, connection.out.data() + connection.sent,
+                           connection.out.size() - connection.sent, MSG_NOSIGNAL);
+        if(put > 0)
+            connection.sent += put;
+        else if(put < 0 && errno == EINTR)
+            continue;
+        else if(put < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+            break;
+        else
+            connection.broken = true;
+    }
+    //what was written is only cut off the front once it is most of the buffer
+    if(connection.sent == connection.out.size() || connection.broken)
+    {
+        connection.out.clear();
+        connection.sent = 0;
+    }
+    else if(connection.sent * 2 >= connection.out.size())
+    {
+        connection.out.erase(0, connection.sent);
+        connection.sent = 0;
+    }
+    update(id);
+}
+void StealthServer::dispatch(long id)
+{
+    Connection& connection = _connections[id];
+    if(connection.broken)
+        connection.queries.clear();
+    if(connection.running || connection.queries.empty())
+        return;
+    connection.running = true;
+    Task task;
+    task.connection = id;
+    std::swap(task.query, connection.queries.front());
+    connection.queries.pop_front();
+    {
+        lock_guard<mutex> lock(_task_mutex);
+        _tasks.push_back(Task());
+        std::swap(_tasks.back(), task);
+    }
+    _task_ready.notify_one();
+}
+void StealthServer::take_replies()
+{
+    deque<Reply> replies;
+    {
+        lock_guard<mutex> lock(_reply_mutex);
+        replies.swap(_replies);
+    }
+    set<long> written;
+    for(int i = 0; i < replies.size(); i++)
+    {
+        //a connection is only closed once its running command has posted its last reply
+        Connection& connection = _connections[replies[i].connection];
+        if(!connection.broken && !connection.hung_up)
+            connection.out += replies[i].bytes;
+        if(replies[i].last)
+        {
+            connection.running = false;
+            _commands++;
+            dispatch(replies[i].connection);
+        }
+        written.insert(replies[i].connection);
+    }
+    for(set<long>::iterator it = written.begin(); it != written.end(); it++)
+        write_client(*it);
+}
+void StealthServer::close_client(long id)
+{
+    close(_connections[id].fd);
+    _connections.erase(id);
+}
+void StealthServer::update(long id)
+{
+    Connection& connection = _connections[id];
+    bool unsent = connection.sent < connection.out.size();
+    bool gone = connection.broken || connection.hung_up;
+    if(!connection.running && connection.queries.empty() && (gone || (connection.closing && !unsent)))
+    {
+        close_client(id);
+        return;
+    }
+    //a broken or hung up connection stays out of epoll while its commands finish, a hung up
+    //socket would report itself every wait
+    if(gone)
+    {
+        if(connection.events != 0)
+            epoll_ctl(_epoll, EPOLL_CTL_DEL, connection.fd, NULL);
+        connection.events = 0;
+        return;
+    }
+    unsigned events = 0;
+    if(!connection.closing)
+        events |= EPOLLIN;
+    if(unsent)
+        events |= EPOLLOUT;
+    if(events == connection.events)
+        return;
+    connection.events = events;
+    epoll_event event;
+    event.events = events;
+    event.data.u64 = id;
+    epoll_ctl(_epoll, EPOLL_CTL_MOD, connection.fd, &event);
+}
+void StealthServer::post(long connection, string& bytes, bool last)
+{
+    bool was_empty;
+    {
+        lock_guard<mutex> lock(_reply_mutex);
+        was_empty = _replies.empty();
+        _replies.push_back(Reply());
+        _replies.back().connection = connection;
+        _replies.back().bytes.swap(bytes);
+        _replies.back().last = last;
+    }
+    bytes.clear();
+    //the loop takes every reply when it wakes, only the first of a run has to wake it
+    if(was_empty)
+    {
+        uint64_t one = 1;
+        ssize_t written = write(_wake, &one, sizeof(one));
+        (void)written;
+    }
+}
+#else
+bool StealthServer::listen_unix(const string& path)
+{
+    return false;
+}
+bool StealthServer::listen_tcp(int port)
+{
+    return false;
+}
+void StealthServer::run()
+{
+}
+void StealthServer::stop()
+{
+    _stopping = true;
+}
+bool StealthServer::listen_on(int fd, const string& what) {return false;}
+void StealthServer::accept_clients(int listener) {}
+void StealthServer::read_client(long id) {}
+void StealthServer::write_client(long id) {}
+void StealthServer::dispatch(long id) {}
+void StealthServer::take_replies() {}
+void StealthServer::close_client(long id) {}
+void StealthServer::update(long id) {}
+void StealthServer::post(long connection, string& bytes, bool last) {}
+#endif
+
+void StealthServer::work()
+{
+    while(true)
+    {
+        Task task;
+        {
+            unique_lock<mutex> lock(_task_mutex);
+            _task_ready.wait(lock, [this]{return !_tasks.empty() || _workers_done;});
+            if(_workers_done)
+                return;
+            std::swap(task, _tasks.front());
+            _tasks.pop_front();
+        }
+        answer(task);
+    }
+}
+void StealthServer::answer(const Task& task)
+{
+    Table result;
+    vectorstr fields;
+    long rows = 0;
+    fstream f;
+    //a command's result is a table of its own, <table>_<serial>, that the commands after it do not
+    //write to, so its rows are read without the lock; show tables lists into the same sql_tables
+    //files every time, so those are read before the next one can rewrite them
+    unique_lock<mutex> lock(_sql_mutex);
+    result = _sql.command(task.query, false);
+    bool failed = _sql.errorState();
+    string error = plain_text(_sql.errorMessage());
+    if(!failed)
+        fields = result.get_field_names();
+    //a default table (an insert's) has no fields and no record count set
+    if(!fields.empty() && result.record_count() > 0)
+    {
+        rows = result.record_count();
+        result.open_records(f);
+    }
+    if(!result.get_tablenames_table())
+        lock.unlock();
+    string out;
+    if(failed && !error.empty())
+    {
+        wire_put_text(out, WIRE_ERROR, error);
+        post(task.connection, out, true);
+        return;
+    }
+    //drop and batch report errorState() without an error, they have no result
+    wire_put_strings(out, WIRE_FIELDS, fields);
+    for(long i = 0; i < rows; i++)
+    {
+        wire_put_strings(out, WIRE_ROW, result.read_record(f, i));
+        if(out.size() >= SERVER_REPLY_CHUNK)
+            post(task.connection, out, false);
+    }
+    if(rows)
+        f.close();
+    if(!fields.empty())
+    {
+        if(!lock.owns_lock())
+            lock.lock();
+        _sql.dropResult(result);
+    }
+    if(lock.owns_lock())
+        lock.unlock();
+    wire_put_done(out, rows);
+    post(task.connection, out, true);
+}
+
+#endif //SERVER_CPP
@@ -0,0 +1,115 @@
+#ifndef SERVER_H
+#define SERVER_H
+
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <set>
+#include <vector>
+#include <string>
+#include <cassert>
+#include <deque>
+#include <map>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include "../SQL/sql.h"
+#include "wire_protocol.h"
+
+using namespace std;
+
+//bytes a worker encodes before it hands them to the event loop, so a big result goes out while
+//the rest of it is still being encoded
+const long SERVER_REPLY_CHUNK = 64 * 1024;
+//bytes read off a socket at a time
+const long SERVER_READ_BYTES = 64 * 1024;
+
+//stealthd: one SQL instance shared by every client of a unix domain socket and, optionally, a
+//loopback tcp port
+//an epoll loop owns the sockets, workers run the commands; SQL is not thread safe, so commands
+//run one at a time and the workers overlap only in reading and encoding results
+//a client's commands are answered in the order they came, one at a time
+//only built on linux, elsewhere listen_*() fail and run() returns at once
+class StealthServer
+{
+public:
+    explicit StealthServer(SQL& sql, int workers = 2);
+    ~StealthServer();
+    //false with the reason in error() if the socket cannot be listened on
+    bool listen_unix(const string& path);
+    bool listen_tcp(int port);
+    //serves clients until stop()
+    void run();
+    //safe from another thread and from a signal handler
+    void stop();
+    string error() const {return _error;}
+    //commands answered so far
+    long commands() const {return _commands;}
+
+private:
+    struct Connection
+    {
+        int fd;
+        WireReader in;
+        string out;                 //reply bytes not written yet
+        long sent;                  //bytes of out already written
+        deque<string> queries;      //commands waiting for the one running to finish
+        unsigned events;            //what epoll watches it for
+        bool running;               //a worker has one of its commands
+        bool closing;               //the client sent all it will, closed once it is answered
+        bool broken;                //a read, write or frame failed, closed once its command is done
+        bool hung_up;               //the client is gone, what it sent still runs and is not answered
+        Connection(): fd(-1), sent(0), events(0), running(false), closing(false), broken(false), hung_up(false) {}
+    };
+    struct Task
+    {
+        long connection;
+        string query;
+    };
+    struct Reply
+    {
+        long connection;
+        string bytes;
+        bool last;                  //the command is done
+    };
+
+    SQL& _sql;
+    mutex _sql_mutex;
+    int _worker_count;
+    vector<thread> _workers;
+    deque<Task> _tasks;             //guarded by _task_mutex
+    mutex _task_mutex;
+    condition_variable _task_ready;
+    deque<Reply> _replies;          //guarded by _reply_mutex
+    mutex _reply_mutex;
+    map<long, Connection> _connections;     //by id, only the loop touches them
+    long _next_connection;
+    int _epoll;
+    int _wake;                      //eventfd workers and stop() write to
+    vector<int> _listeners;
+    vector<string> _socket_paths;   //unix sockets to unlink when done
+    atomic<bool> _stopping;
+    bool _workers_done;             //guarded by _task_mutex
+    atomic<long> _commands;
+    string _error;
+
+    bool listen_on(int fd, const string& what);
+    void accept_clients(int listener);
+    void read_client(long id);
+    void write_client(long id);
+    void dispatch(long id);
+    void take_replies();
+    void close_client(long id);
+    //closes the connection if it is finished with, or watches it for what it is waiting on
+    void update(long id);
+    void work();
+    //runs the command and hands its reply to the loop
+    void answer(const Task& task);
+    void post(long connection, string& bytes, bool last);
+
+    StealthServer(const StealthServer&);
+    StealthServer& operator =(const StealthServer&);
+};
+
+#endif //SERVER_H
@@ -0,0 +1,125 @@
+#ifndef WIRE_PROTOCOL_CPP
+#define WIRE_PROTOCOL_CPP
+
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <set>
+#include <vector>
+#include <string>
+#include <cassert>
+#include "wire_protocol.h"
+using namespace std;
+
+void wire_put_varint(string& out, unsigned long value)
+{
+    while(value >= 0x80)
+    {
+        out += char((value & 0x7f) | 0x80);
+        value >>= 7;
+    }
+    out += char(value);
+}
+int wire_varint_size(unsigned long value)
+{
+    int size = 1;
+    for(; value >= 0x80; value >>= 7)
+        size++;
+    return size;
+}
+bool wire_get_varint(const char*& p, const char* end, unsigned long& value)
+{
+    value = 0;
+    for(int shift = 0; p < end && shift < 64; shift += 7)
+    {
+        unsigned char byte = *p++;
+        value |= (unsigned long)(byte & 0x7f) << shift;
+        if(!(byte & 0x80))
+            return true;
+    }
+    return false;
+}
+
+void wire_put_text(string& out, char type, const string& text)
+{
+    wire_put_varint(out, 1 + text.size());
+    out += type;
+    out += text;
+}
+void wire_put_strings(string& out, char type, const vectorstr& values)
+{
+    //the length goes first, so it is added up before anything is written
+    unsigned long body = 1 + wire_varint_size(values.size());
+    for(int i = 0; i < values.size(); i++)
+        body += wire_varint_size(values[i].size()) + values[i].size();
+    out.reserve(out.size() + wire_varint_size(body) + body);
+    wire_put_varint(out, body);
+    out += type;
+    wire_put_varint(out, values.size());
+    for(int i = 0; i < values.size(); i++)
+    {
+        wire_put_varint(out, values[i].size());
+        out += values[i];
+    }
+}
+void wire_put_done(string& out, unsigned long rows)
+{
+    wire_put_varint(out, 1 + wire_varint_size(rows));
+    out += char(WIRE_DONE);
+    wire_put_varint(out, rows);
+}
+bool wire_get_strings(const char* p, const char* end, vectorstr& values)
+{
+    values.clear();
+    unsigned long count;
+    if(!wire_get_varint(p, end, count))
+        return false;
+    for(unsigned long i = 0; i < count; i++)
+    {
+        unsigned long size;
+        if(!wire_get_varint(p, end, size) || size > end - p)
+            return false;
+        values.push_back(string(p, size));
+        p += size;
+    }
+    return p == end;
+}
+
+void WireReader::append(const char* data, long size)
+{
+    //taken frames are only cut off the front once they are most of the buffer
+    if(_used > 0 && _used * 2 >= _buffer.size())
+    {
+        _buffer.erase(0, _used);
+        _used = 0;
+    }
+    _buffer.append(data, size);
+}
+bool WireReader::next(WireMessage& message)
+{
+    if(_failed)
+        return false;
+    const char* begin = _buffer.data() + _used;
+    const char* end = _buffer.data() + _buffer.size();
+    const char* p = begin;
+    unsigned long size;
+    if(!wire_get_varint(p, end, size))
+    {
+        //ten bytes hold any varint, more without an end is garbage
+        _failed = end - begin >= 10;
+        return false;
+    }
+    if(size == 0 || size > WIRE_MAX_FRAME)
+    {
+        _failed = true;
+        return false;
+    }
+    if(size > end - p)
+        return false;
+    message.type = *p;
+    message.body.assign(p + 1, size - 1);
+    _used += (p - begin) + size;
+    return true;
+}
+
+#endif //WIRE_PROTOCOL_CPP
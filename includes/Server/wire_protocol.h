@@ -0,0 +1,71 @@
+#ifndef WIRE_PROTOCOL_H
+#define WIRE_PROTOCOL_H
+
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <set>
+#include <vector>
+#include <string>
+#include <cassert>
+#include "../Table/typedefs.h"
+
+using namespace std;
+
+//stealthd's wire format: every message is a frame, the length of its body as a varint and then
+//the body, whose first byte is the message type
+//a command is answered by its fields, a row frame per row, and done, or by one error frame
+enum wire_messages
+{
+    WIRE_QUERY = 'Q',           //client: the command text
+    WIRE_FIELDS = 'F',          //server: the result's field names, before any of its rows
+    WIRE_ROW = 'R',             //server: one row's values
+    WIRE_DONE = 'D',            //server: the command finished, rows sent as a varint
+    WIRE_ERROR = 'E'            //server: the command failed, the error text
+};
+
+//frames longer than this end the connection, a row is at most a few kilobytes
+const unsigned long WIRE_MAX_FRAME = 16 * 1024 * 1024;
+
+//7 bits a byte, low bits first, the high bit set on every byte but the last
+void wire_put_varint(string& out, unsigned long value);
+int wire_varint_size(unsigned long value);
+//false if the varint runs past end or past 64 bits, p is left after it otherwise
+bool wire_get_varint(const char*& p, const char* end, unsigned long& value);
+
+//a frame of type with text as the rest of its body: query and error
+void wire_put_text(string& out, char type, const string& text);
+//a frame of type with a count and every value length prefixed: fields and row
+void wire_put_strings(string& out, char type, const vectorstr& values);
+//a done frame
+void wire_put_done(string& out, unsigned long rows);
+//the values of a fields or row body (after its type byte), false if it is cut short
+bool wire_get_strings(const char* p, const char* end, vectorstr& values);
+
+//one frame taken off a connection
+struct WireMessage
+{
+    char type;
+    string body;                //the body after the type byte
+};
+
+//collects the bytes read off a connection and cuts them into frames
+class WireReader
+{
+public:
+    WireReader(): _used(0), _failed(false) {}
+    void append(const char* data, long size);
+    //the next whole frame, false if it has not all arrived yet or the input is broken
+    bool next(WireMessage& message);
+    //a frame was too long or empty, nothing more can be read
+    bool failed() const {return _failed;}
+    //bytes appended and not taken as frames yet
+    long pending() const {return _buffer.size() - _used;}
+
+private:
+    string _buffer;
+    long _used;                 //bytes of _buffer already taken as frames
+    bool _failed;
+};
+
+#endif //WIRE_PROTOCOL_H
@@ -36,6 +36,13 @@ public:
         _infix = infix;
     }
 
+    //taking over the infix queue instead of copying it
+    ShuntingYard(Queue<Token*> &&infix): _infix(std::move(infix))
+    {
+        _stub = 0;
+        _sql_shunting_yard = false;
+    }
+
     //overloading the insertion operator for printing
     friend ostream& operator << (ostream& outs, const ShuntingYard& print_me)
     {
@@ -47,12 +54,18 @@ public:
     void set_input(const Queue<Token*> &infix)
     {
         _stub = 0;
-        _postfix = Queue<Token*>();
+        _postfix.clear();
         _infix = infix;
     }
+    void set_input(Queue<Token*> &&infix)
+    {
+        _stub = 0;
+        _postfix.clear();
+        _infix = std::move(infix);
+    }
 
-    //converting infix expressions to postfix
-    Queue<Token*> postfix(const Queue<Token*> &infix = Queue<Token*>()) throw(Error_Code)
+    //converting infix expressions to postfix, the queue stays the shunting yard's until its next conversion
+    const Queue<Token*>& postfix(const Queue<Token*> &infix = Queue<Token*>()) throw(Error_Code)
     {
         Error_Code error_code;
         const bool debug = false;
@@ -102,7 +115,8 @@ public:
                 break;
 
             case OPERATOR:
-                if(operator_stack.empty())
+                //a prefix unary operator (not) has no left operand, so nothing on the stack is finished yet
+                if(operator_stack.empty() || static_cast<Operator*>(*it)->is_unary())
                     operator_stack.push(*it);
                 else
                 {
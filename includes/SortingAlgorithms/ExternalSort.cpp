@@ -0,0 +1,204 @@
+#ifndef EXTERNAL_SORT_CPP
+#define EXTERNAL_SORT_CPP
+
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <set>
+#include <vector>
+#include <string>
+#include <cassert>
+#include <cstdio>
+#include <queue>
+#include <functional>
+#include <algorithm>
+#include "ExternalSort.h"
+#include "SortAlgorithms.h"
+#include "RecnoSort.h"
+#ifdef _WIN32
+#include <process.h>
+#define getpid _getpid
+#else
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+namespace
+{
+    //head of one sorted source in the final merge, the smallest entry on top of the heap
+    struct MergeHead
+    {
+        SortEntry entry;
+        int source;
+        bool operator >(const MergeHead& other) const {return other.entry < entry;}
+    };
+}
+
+atomic<long> ExternalSort::_sorts(0);
+
+ExternalSort::ExternalSort(long memory_budget, const string& run_prefix)
+{
+    _buffer_bytes = 0;
+    _entries = 0;
+    _memory_budget = memory_budget;
+    _run_prefix = run_prefix + "_" + to_string(getpid()) + "_" + to_string(_sorts++);
+}
+ExternalSort::~ExternalSort()
+{
+    remove_runs();
+}
+void ExternalSort::add(const string& key, long recno) throw(Error_Code)
+{
+    _entries++;
+    _buffer.push_back(SortEntry(key, recno));
+    _buffer_bytes += sizeof(SortEntry) + key.size();
+    if(_buffer_bytes > _memory_budget)
+        spill();
+}
+void ExternalSort::finish(vector<long>& recnos, bool descending) throw(Error_Code)
+{
+    const bool debug = false;
+    recnos.clear();
+    sort_buffer();
+    vector<long> group_starts;      //where each run of equal keys begins, for descending
+    if(_runs.empty())
+    {
+        //everything fit in memory
+        recnos.reserve(_buffer.size());
+        for(int i = 0; i < _buffer.size(); i++)
+        {
+            if(descending && (i == 0 || _buffer[i].key != _buffer[i - 1].key))
+                group_starts.push_back(i);
+            recnos.push_back(_buffer[i].recno);
+        }
+    }
+    else
+    {
+        if(debug)
+            cout<<"merging "<<_runs.size()<<" runs and "<<_buffer.size()<<" buffered entries\n";
+        //sources 0..runs-1 are the run files, the last source is what is still in memory
+        vector<ifstream> files(_runs.size());
+        for(int i = 0; i < _runs.size(); i++)
+            files[i].open(_runs[i].c_str(), ios::binary);
+        int memory_source = _runs.size();
+        int memory_next = 0;
+
+        priority_queue<MergeHead, vector<MergeHead>, greater<MergeHead> > heads;
+        MergeHead head;
+        for(int i = 0; i < files.size(); i++)
+        {
+            head.source = i;
+            if(read_entry(files[i], head.entry))
+                heads.push(head);
+        }
+        if(memory_next < _buffer.size())
+        {
+            head.source = memory_source;
+            head.entry = _buffer[memory_next++];
+            heads.push(head);
+        }
+        string last_key;
+        while(!heads.empty())
+        {
+            head = heads.top();
+            heads.pop();
+            if(descending && (recnos.empty() || head.entry.key != last_key))
+            {
+                group_starts.push_back(recnos.size());
+                last_key = head.entry.key;
+            }
+            recnos.push_back(head.entry.recno);
+            if(head.source == memory_source)
+            {
+                if(memory_next < _buffer.size())
+                {
+                    head.entry = _buffer[memory_next++];
+                    heads.push(head);
+                }
+            }
+            else if(read_entry(files[head.source], head.entry))
+                heads.push(head);
+        }
+    }
+    long entries = _entries;
+    _buffer.clear();
+    _buffer_bytes = 0;
+    _entries = 0;
+    remove_runs();
+    //a run cut short would silently lose its records
+    if(recnos.size() != entries)
+    {
+        Error_Code error_code;
+        error_code._code = SORT_RUN_FAILED;
+        throw error_code;
+    }
+    if(descending)
+        reverse_key_groups(recnos, group_starts);
+}
+
+void reverse_key_groups(vector<long>& recnos, const vector<long>& group_starts)
+{
+    vector<long> reversed;
+    reversed.reserve(recnos.size());
+    long group_end = recnos.size();
+    for(int i = group_starts.size() - 1; i >= 0; i--)
+    {
+        reversed.insert(reversed.end(), recnos.begin() + group_starts[i], recnos.begin() + group_end);
+        group_end = group_starts[i];
+    }
+    recnos.swap(reversed);
+}
+
+//private
+void ExternalSort::sort_buffer()
+{
+    if(_buffer.size() > 1)
+        parallel_merge_sort(&_buffer[0], _buffer.size());
+}
+void ExternalSort::spill() throw(Error_Code)
+{
+    sort_buffer();
+    string run_name = _run_prefix + "_run_" + to_string(_runs.size()) + ".bin";
+    //listed before it is written, so a run that fails half way is removed too
+    _runs.push_back(run_name);
+    ofstream outs(run_name.c_str(), ios::binary | ios::trunc);
+    for(int i = 0; i < _buffer.size(); i++)
+        write_entry(outs, _buffer[i]);
+    outs.close();
+    if(outs.fail())
+    {
+        Error_Code error_code;
+        error_code._code = SORT_RUN_FAILED;
+        error_code._error_token = run_name;
+        throw error_code;
+    }
+    _buffer.clear();
+    _buffer_bytes = 0;
+}
+void ExternalSort::remove_runs()
+{
+    for(int i = 0; i < _runs.size(); i++)
+        remove(_runs[i].c_str());
+    _runs.clear();
+}
+bool ExternalSort::read_entry(ifstream& ins, SortEntry& entry)
+{
+    unsigned int key_size;
+    if(!ins.read(reinterpret_cast<char*>(&key_size), sizeof(key_size)))
+        return false;
+    entry.key.resize(key_size);
+    if(key_size > 0)
+        ins.read(&entry.key[0], key_size);
+    ins.read(reinterpret_cast<char*>(&entry.recno), sizeof(entry.recno));
+    return static_cast<bool>(ins);
+}
+void ExternalSort::write_entry(ofstream& outs, const SortEntry& entry)
+{
+    unsigned int key_size = entry.key.size();
+    outs.write(reinterpret_cast<const char*>(&key_size), sizeof(key_size));
+    outs.write(entry.key.data(), key_size);
+    outs.write(reinterpret_cast<const char*>(&entry.recno), sizeof(entry.recno));
+}
+
+#endif //EXTERNAL_SORT_CPP
@@ -0,0 +1,85 @@
+#ifndef EXTERNAL_SORT_H
+#define EXTERNAL_SORT_H
+
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <set>
+#include <vector>
+#include <string>
+#include <cassert>
+#include <fstream>
+#include <atomic>
+#include "../Error_code/error_code.h"
+
+using namespace std;
+
+//one row being ordered: the value of the sort field and the record it came from
+struct SortEntry
+{
+    string key;
+    long recno;
+
+    SortEntry(const string& k = "", long r = 0): key(k), recno(r) {}
+    //ties are broken on recno so equal keys keep their record order
+    bool operator <(const SortEntry& other) const
+    {
+        return key < other.key || (key == other.key && recno < other.recno);
+    }
+};
+
+//the same row ordered for a descending sort: larger keys first, ties still in record order
+struct DescendingSortEntry: public SortEntry
+{
+    DescendingSortEntry(const string& k = "", long r = 0): SortEntry(k, r) {}
+    bool operator <(const DescendingSortEntry& other) const
+    {
+        return key > other.key || (key == other.key && recno < other.recno);
+    }
+};
+
+//reverses the order of the groups of equal keys that start at group_starts, keeping the record
+//order inside each group, so a descending order lists ties the same way an ascending one does
+void reverse_key_groups(vector<long>& recnos, const vector<long>& group_starts);
+
+//sorts (key, recno) entries under a memory budget: entries are buffered and, whenever the
+//buffer outgrows the budget, merge sorted and spilled to a run file; finish() merges the runs
+//run files are named <run_prefix>_<process id>_<sort number>_run_<n>.bin, so sorts running at
+//once in one process or in several never share one, and they are removed however the sort ends
+class ExternalSort
+{
+public:
+    ExternalSort(long memory_budget, const string& run_prefix);
+    ~ExternalSort();
+
+    //throws SORT_RUN_FAILED if a run cannot be written
+    void add(const string& key, long recno) throw(Error_Code);
+    //writes the recnos in key order (or reverse key order) and removes the run files
+    //throws SORT_RUN_FAILED if a run cannot be read back whole
+    void finish(vector<long>& recnos, bool descending) throw(Error_Code);
+    int run_count() const {return _runs.size();}
+    //run files this sorter has written and not yet removed
+    const vector<string>& run_files() const {return _runs;}
+
+private:
+    vector<SortEntry> _buffer;
+    long _buffer_bytes;             //estimated memory held by _buffer
+    long _memory_budget;
+    string _run_prefix;             //includes the process id and this sort's number
+    vector<string> _runs;           //file names of the spilled runs
+    long _entries;                  //entries added since the last finish()
+
+    static atomic<long> _sorts;     //sorters made so far in this process
+
+    void sort_buffer();
+    void spill() throw(Error_Code);
+    void remove_runs();
+    static bool read_entry(ifstream& ins, SortEntry& entry);
+    static void write_entry(ofstream& outs, const SortEntry& entry);
+
+    //not copyable, the run files belong to one sorter
+    ExternalSort(const ExternalSort&);
+    ExternalSort& operator =(const ExternalSort&);
+};
+
+#endif //EXTERNAL_SORT_H
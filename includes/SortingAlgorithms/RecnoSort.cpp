@@ -0,0 +1,106 @@
+#ifndef RECNO_SORT_CPP
+#define RECNO_SORT_CPP
+
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <set>
+#include <vector>
+#include <string>
+#include <cassert>
+#include <cstring>
+#include <algorithm>
+#include <functional>
+#include "RecnoSort.h"
+using namespace std;
+
+void radix_sort(long a[], unsigned int size)
+{
+    if(size < 2)
+        return;
+    const int digits = (sizeof(long) * 8 + RADIX_BITS - 1) / RADIX_BITS;
+    //every pass's bucket sizes come from one read of the input
+    vector<unsigned int> counts(digits * RADIX_BUCKETS, 0);
+    unsigned long bits = 0;
+    for(unsigned int i = 0; i < size; i++)
+    {
+        if(a[i] < 0)
+        {
+            sort(a, a + size);
+            return;
+        }
+        unsigned long value = a[i];
+        bits |= value;
+        for(int d = 0; d < digits && value; d++, value >>= RADIX_BITS)
+            counts[d * RADIX_BUCKETS + (value & (RADIX_BUCKETS - 1))]++;
+    }
+    //bytes past the highest one set in any value were never counted, their bucket 0 holds everything
+    for(int d = 0; d < digits; d++)
+    {
+        unsigned int counted = 0;
+        for(int b = 0; b < RADIX_BUCKETS; b++)
+            counted += counts[d * RADIX_BUCKETS + b];
+        counts[d * RADIX_BUCKETS] += size - counted;
+    }
+
+    vector<long> buffer(size);
+    long* from = a;
+    long* to = &buffer[0];
+    for(int d = 0; d < digits && bits >> (d * RADIX_BITS); d++)
+    {
+        unsigned int* count = &counts[d * RADIX_BUCKETS];
+        int shift = d * RADIX_BITS;
+        //one bucket holding every value would move nothing
+        if(count[(from[0] >> shift) & (RADIX_BUCKETS - 1)] == size)
+            continue;
+        unsigned int offsets[RADIX_BUCKETS];
+        unsigned int offset = 0;
+        for(int b = 0; b < RADIX_BUCKETS; b++)
+        {
+            offsets[b] = offset;
+            offset += count[b];
+        }
+        for(unsigned int i = 0; i < size; i++)
+            to[offsets[(from[i] >> shift) & (RADIX_BUCKETS - 1)]++] = from[i];
+        swap(from, to);
+    }
+    if(from != a)
+        memcpy(a, from, size * sizeof(long));
+}
+
+void sort_recnos(long a[], unsigned int size, int max_threads)
+{
+    if(size < 2)
+        return;
+    //where each ascending run starts, only counted as far as a run merge would take them
+    vector<unsigned int> starts(1, 0);
+    for(unsigned int i = 1; i < size && starts.size() <= RECNO_SORT_MAX_RUNS; i++)
+    {
+        if(a[i] < a[i - 1])
+            starts.push_back(i);
+    }
+    if(starts.size() == 1)
+        return;
+    int threads = max_threads > 0 ? max_threads : ThreadPool::shared().size() + 1;
+
+    if(size < RECNO_SORT_SMALL)
+        inseration_sort(a, size);
+    else if(starts.size() <= RECNO_SORT_MAX_RUNS)
+    {
+        //the scan stopped early only once there were too many runs, so starts has them all
+        merge_runs(a, size, starts, threads);
+    }
+    else if(is_sorted(a, a + size, greater<long>()))
+        reverse(a, a + size);
+    else if(size >= PARALLEL_SORT_MIN && threads > 1)
+        parallel_merge_sort(a, size, threads, radix_sort);
+    else
+        radix_sort(a, size);
+}
+void sort_recnos(vector<long>& recnos, int max_threads)
+{
+    if(!recnos.empty())
+        sort_recnos(&recnos[0], recnos.size(), max_threads);
+}
+
+#endif //RECNO_SORT_CPP
@@ -0,0 +1,99 @@
+#ifndef RECNO_SORT_H
+#define RECNO_SORT_H
+
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <set>
+#include <vector>
+#include <string>
+#include <cassert>
+#include <iterator>
+#include <algorithm>
+#include "SortAlgorithms.h"
+#include "../ThreadPool/thread_pool.h"
+
+using namespace std;
+
+//recno arrays shorter than this are insertion sorted, a radix pass costs more than it saves
+const unsigned int RECNO_SORT_SMALL = 64;
+//input of at most this many ascending runs is merged run by run instead of radix sorted,
+//an index probe over several keys hands back one sorted run per key
+//8 runs take 3 merge passes, what a radix sort of recnos under 16 million takes
+const unsigned int RECNO_SORT_MAX_RUNS = 8;
+//arrays at least this long are sorted in slices on the shared thread pool
+const unsigned int PARALLEL_SORT_MIN = 1 << 17;
+//bits of a value one radix pass sorts on
+const int RADIX_BITS = 8;
+const int RADIX_BUCKETS = 1 << RADIX_BITS;
+
+//lsd radix sort of non-negative integers, one pass per byte up to the largest value's
+//highest byte, a pass whose byte is the same in every value is skipped
+//input with a negative value is handed to std::sort
+void radix_sort(long a[], unsigned int size);
+
+//sorting recnos by whichever sort suits the input: nothing if they are already sorted,
+//insertion sort for a few, a run merge for a few sorted runs, a reverse for descending ones,
+//parallel merge sort of radix sorted slices for a lot of them with threads to spare,
+//radix sort otherwise
+//max_threads caps the threads a parallel sort takes, -1 for the whole pool
+void sort_recnos(long a[], unsigned int size, int max_threads = -1);
+void sort_recnos(vector<long>& recnos, int max_threads = -1);
+
+//merging the ascending runs of a[] in pairs until one is left, a run starts at each of starts
+//(the first at 0) and ends where the next one starts, the merges of a round run side by side
+//ties keep their order, so this is stable
+template <class T>
+void merge_runs(T a[], unsigned int size, vector<unsigned int> starts, int max_threads = -1)
+{
+    if(starts.size() <= 1)
+        return;
+    vector<T> buffer(size);
+    T* from = a;
+    T* to = &buffer[0];
+    while(starts.size() > 1)
+    {
+        ThreadPool::shared().parallel_for((starts.size() + 1) / 2, [&](int pair)
+        {
+            unsigned int begin = starts[2 * pair];
+            unsigned int middle = 2 * pair + 1 < starts.size() ? starts[2 * pair + 1] : size;
+            unsigned int end = 2 * pair + 2 < starts.size() ? starts[2 * pair + 2] : size;
+            std::merge(make_move_iterator(from + begin), make_move_iterator(from + middle),
+                       make_move_iterator(from + middle), make_move_iterator(from + end), to + begin);
+        }, max_threads);
+        vector<unsigned int> merged;
+        for(int i = 0; i < starts.size(); i += 2)
+            merged.push_back(starts[i]);
+        starts.swap(merged);
+        swap(from, to);
+    }
+    if(from != a)
+        std::move(from, from + size, a);
+}
+
+//stable merge sort on the shared thread pool: each thread sorts a slice of a[] with
+//slice_sort, then the slices are merged by merge_runs
+//there is a slice per thread asked for even if the pool is smaller, -1 asks for the whole pool
+//below PARALLEL_SORT_MIN items, or with one thread, slice_sort sorts the whole array
+template <class T>
+void parallel_merge_sort(T a[], unsigned int size, int max_threads = -1,
+                         void (*slice_sort)(T[], unsigned int) = merge_sort<T>)
+{
+    int threads = max_threads > 0 ? max_threads : ThreadPool::shared().size() + 1;
+    if(size < PARALLEL_SORT_MIN || threads <= 1)
+    {
+        slice_sort(a, size);
+        return;
+    }
+    vector<unsigned int> starts;
+    for(int i = 0; i < threads; i++)
+        starts.push_back((unsigned long long)size * i / threads);
+    ThreadPool::shared().parallel_for(threads, [&](int slice)
+    {
+        unsigned int end = slice + 1 < threads ? starts[slice + 1] : size;
+        slice_sort(a + starts[slice], end - starts[slice]);
+    }, threads);
+    merge_runs(a, size, starts, threads);
+}
+
+#endif //RECNO_SORT_H
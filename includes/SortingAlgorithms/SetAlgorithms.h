@@ -0,0 +1,164 @@
+#ifndef SET_ALGORITHMS_H
+#define SET_ALGORITHMS_H
+
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <set>
+#include <vector>
+#include <string>
+#include <cassert>
+#include <algorithm>
+#include <queue>
+#include <utility>
+#include <functional>
+
+using namespace std;
+
+//operations on sorted lists with no duplicates, like the record numbers in a result set
+
+//size ratio above which intersection gallops through the larger list instead of walking both
+const unsigned int GALLOP_RATIO = 8;
+
+//first position in a[lo, size) holding a value >= key
+//the step doubles from lo until it passes key, then a binary search narrows it down,
+//so a match k positions ahead costs O(log k) compares
+template <class T>
+unsigned int gallop_lower_bound(const T a[], unsigned int lo, unsigned int size, const T& key)
+{
+    unsigned int step = 1;
+    unsigned int hi = lo;
+    while(hi < size && a[hi] < key)
+    {
+        lo = hi + 1;
+        hi += step;
+        step *= 2;
+    }
+    if(hi > size)
+        hi = size;
+    return lower_bound(a + lo, a + hi, key) - a;
+}
+
+//intersection of two sorted lists, galloping through the larger one when the sizes are skewed
+template <class T>
+void sorted_intersection(const vector<T>& a, const vector<T>& b, vector<T>& result)
+{
+    result.clear();
+    const vector<T>& small = a.size() <= b.size() ? a : b;
+    const vector<T>& large = a.size() <= b.size() ? b : a;
+    if(small.empty())
+        return;
+    if(large.size() / small.size() < GALLOP_RATIO)
+    {
+        set_intersection(a.begin(), a.end(), b.begin(), b.end(), back_inserter(result));
+        return;
+    }
+    unsigned int pos = 0;
+    for(unsigned int i = 0; i < small.size() && pos < large.size(); i++)
+    {
+        pos = gallop_lower_bound(&large[0], pos, large.size(), small[i]);
+        if(pos < large.size() && large[pos] == small[i])
+            result.push_back(small[i]);
+    }
+}
+
+//union of two sorted lists
+template <class T>
+void sorted_union(const vector<T>& a, const vector<T>& b, vector<T>& result)
+{
+    result.clear();
+    result.reserve(a.size() + b.size());
+    set_union(a.begin(), a.end(), b.begin(), b.end(), back_inserter(result));
+}
+
+//values of a that are not in b, galloping through b when it is much larger than a
+template <class T>
+void sorted_difference(const vector<T>& a, const vector<T>& b, vector<T>& result)
+{
+    result.clear();
+    if(a.empty() || b.empty() || b.size() / a.size() < GALLOP_RATIO)
+    {
+        set_difference(a.begin(), a.end(), b.begin(), b.end(), back_inserter(result));
+        return;
+    }
+    unsigned int pos = 0;
+    for(unsigned int i = 0; i < a.size(); i++)
+    {
+        if(pos < b.size())
+            pos = gallop_lower_bound(&b[0], pos, b.size(), a[i]);
+        if(pos == b.size() || b[pos] != a[i])
+            result.push_back(a[i]);
+    }
+}
+
+//every value in [0, universe) that is not in the sorted list, found by walking the gaps between its values
+//limit stops after the first limit values, -1 for all of them
+template <class T>
+void sorted_complement(const vector<T>& list, T universe, vector<T>& result, long limit = -1)
+{
+    result.clear();
+    //values at or past universe are not part of it and take nothing out of it
+    unsigned long inside = lower_bound(list.begin(), list.end(), universe) - list.begin();
+    unsigned long wanted = universe > static_cast<T>(inside) ? universe - inside : 0;
+    if(limit >= 0 && wanted > static_cast<unsigned long>(limit))
+        wanted = limit;
+    result.reserve(wanted);
+    T next = 0;
+    for(unsigned int i = 0; i < list.size() && next < universe && result.size() < wanted; i++)
+    {
+        for(; next < list[i] && next < universe && result.size() < wanted; next++)
+            result.push_back(next);
+        next = list[i] + 1;
+    }
+    for(; next < universe && result.size() < wanted; next++)
+        result.push_back(next);
+}
+
+//union of k sorted lists in one pass, keeping the head of every list in a min heap
+template <class T>
+void k_way_union(const vector<const vector<T>*>& runs, vector<T>& result)
+{
+    result.clear();
+    if(runs.empty())
+        return;
+    if(runs.size() == 1)
+    {
+        result.assign(runs[0]->begin(), runs[0]->end());
+        return;
+    }
+    if(runs.size() == 2)
+    {
+        sorted_union(*runs[0], *runs[1], result);
+        return;
+    }
+    //heap entries are (value, run index), paired with each run's read position
+    typedef pair<T, unsigned int> head;
+    priority_queue<head, vector<head>, greater<head> > heads;
+    vector<unsigned int> next(runs.size(), 0);
+    unsigned int total = 0;
+    for(unsigned int i = 0; i < runs.size(); i++)
+    {
+        total += runs[i]->size();
+        if(!runs[i]->empty())
+        {
+            heads.push(head((*runs[i])[0], i));
+            next[i] = 1;
+        }
+    }
+    result.reserve(total);
+    while(!heads.empty())
+    {
+        head smallest = heads.top();
+        heads.pop();
+        if(result.empty() || result.back() != smallest.first)
+            result.push_back(smallest.first);
+        unsigned int run = smallest.second;
+        if(next[run] < runs[run]->size())
+        {
+            heads.push(head((*runs[run])[next[run]], run));
+            next[run]++;
+        }
+    }
+}
+
+#endif //SET_ALGORITHMS_H
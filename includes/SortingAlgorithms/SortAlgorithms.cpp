@@ -97,23 +97,4 @@ int partition_r(int arr[], int low, int high)
     return partition(arr, low, high);
 }
 
-//heapifying the array for heap sort
-void heapify(int arr[], int N, int i)
-{
-    int largest = i;
-    int l = 2 * i + 1;
-    int r = 2 * i + 2;
-
-    if (l < N && arr[l] > arr[largest])
-        largest = l;
-
-    if (r < N && arr[r] > arr[largest])
-        largest = r;
-
-    if (largest != i) {
-        swap(arr[i], arr[largest]);
-        heapify(arr, N, largest);
-    }
-}
-
 #endif //SORT_AlGORITHMS_CPP
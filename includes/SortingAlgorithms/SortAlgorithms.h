@@ -55,7 +55,9 @@ void bubble_sort(T a[], unsigned int size)
 template <class T>
 void inseration_sort(T a[], unsigned int size)
 {
-    int i, key, j;
+    int i, j;
+    //the key has the element type, an int key cut longs short
+    T key;
     for (i = 1; i < size; i++) {
         key = a[i];
         j = i - 1;
@@ -73,18 +75,18 @@ void inseration_sort(T a[], unsigned int size)
 template <class T>
 void merge(T a[], unsigned int s1, unsigned int s2){
 
-    int *temp;
+    T *temp;
     int copied = 0;
     int copied_1 = 0;
     int copied_2 = 0;
     int i;
 
-    //allocating memory for temporary array
-    temp = new int[s1 + s2];
+    //allocating memory for temporary array of the element type, not int, so longs and records survive
+    temp = new T[s1 + s2];
 
-    //merging elements from both subarrays
+    //merging elements from both subarrays, taking from the first on ties to keep the sort stable
     while(copied_1 < s1 && copied_2 < s2){
-        if(a[copied_1] < (a + s1)[copied_2]){
+        if(!((a + s1)[copied_2] < a[copied_1])){
             temp[copied] = a[copied_1];
             copied++;
             copied_1++;
@@ -151,7 +153,25 @@ void quickSort(T arr[],int low,int high)
   }
 }
 
-void heapify(int arr[], int N, int i);
+//heapifying the subtree rooted at i of a max heap of N items
+template <class T>
+void heapify(T arr[], int N, int i)
+{
+    int largest = i;
+    int l = 2 * i + 1;
+    int r = 2 * i + 2;
+
+    if (l < N && arr[largest] < arr[l])
+        largest = l;
+
+    if (r < N && arr[largest] < arr[r])
+        largest = r;
+
+    if (largest != i) {
+        Swap(arr[i], arr[largest]);
+        heapify(arr, N, largest);
+    }
+}
 
 //implementing iterative merge sort
 template <class T>
@@ -190,6 +210,30 @@ void heap_sort(T a[], unsigned int size)
         heapify(a, i, 0);
     }
 }
+//offering items one at a time, keeping only the k smallest seen so far in a max heap,
+//so the largest of them is at heap[0] and is the one replaced by a smaller item
+//heap_sort(&heap[0], heap.size()) afterwards puts them in ascending order
+template <class T>
+void top_k_push(vector<T>& heap, unsigned int k, const T& item)
+{
+    if (heap.size() < k)
+    {
+        heap.push_back(item);
+        //the heap is only built once it is full, until then nothing is ever dropped
+        if (heap.size() == k)
+        {
+            for (int i = k / 2 - 1; i >= 0; i--)
+                heapify(&heap[0], k, i);
+        }
+        return;
+    }
+    if (k > 0 && item < heap[0])
+    {
+        heap[0] = item;
+        heapify(&heap[0], k, 0);
+    }
+}
+
 sort_f_ptr get_sort_func_ptr(int func_name);
 string print_func_name(int f_name);
 int get_sort_func_name(sort_f_ptr f);
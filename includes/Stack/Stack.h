@@ -1,41 +1,49 @@
 #ifndef STACK_H
 #define STACK_H
 
-#include "../DoublyLinkedList/DoublyLinkedList.h"
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <cassert>
+#include <new>
+#include <utility>
+
 using namespace std;
 
-//implementing a stack data structure using a doubly linked list
+//implementing a stack data structure as an array: the first STACK_INLINE items are kept in
+//the stack itself, so the operator stack of a where clause never touches the heap
+const int STACK_INLINE = 16;
+
 template <typename T>
 class Stack {
 public:
-    //implementing iterator class for traversing stack elements
+    //implementing iterator class for traversing stack elements, top to bottom
     class Iterator {
     public:
         friend class Stack;
         //constructing empty iterator
-        Iterator() { _ptr = NULL; }
-        //constructing iterator pointing to specified node
-        Iterator(node<T>* p) { _ptr = p; }
+        Iterator() { _stack = NULL; _depth = 0; }
+        //constructing iterator pointing to the item depth below the top
+        Iterator(const Stack<T>* stack, int depth) { _stack = stack; _depth = depth; }
 
         //enabling boolean context usage (if(iterator))
         operator bool() {
-            return _ptr;
+            return !is_null();
         }
 
         //accessing the value at current position
         T& operator *() {
-            return _ptr->_item;
+            return _stack->_data[_stack->_size - 1 - _depth];
         }
 
         //accessing members of current item
         T* operator ->() {
-            T* item_ptr = &_ptr->_item;
-            return item_ptr;
+            return &_stack->_data[_stack->_size - 1 - _depth];
         }
 
-        //checking if iterator is null
-        bool is_null() {
-            return !_ptr;
+        //checking if iterator is past the bottom
+        bool is_null() const {
+            return !_stack || _depth >= _stack->_size;
         }
 
         //comparing iterators for inequality
@@ -43,69 +51,80 @@ public:
             return !(left == right);
         }
 
-        //comparing iterators for equality
+        //comparing iterators for equality, every iterator past the bottom is end()
         friend bool operator ==(const Iterator& left, const Iterator& right) {
-            return left._ptr == right._ptr;
+            if(left.is_null() || right.is_null())
+                return left.is_null() == right.is_null();
+            return left._stack == right._stack && left._depth == right._depth;
         }
 
         //moving iterator to next position (prefix)
         Iterator& operator++() {
-            _ptr = _ptr->_next;
+            _depth++;
             return *this;
         }
 
         //moving iterator to next position (postfix)
         friend Iterator operator++(Iterator& it, int unused) {
-            it._ptr = it._ptr->_next;
-            return Iterator(it._ptr);
+            it._depth++;
+            return it;
         }
-
     private:
-        node<T>* _ptr;                          //pointer to current node
+        const Stack<T>* _stack;                 //stack being walked
+        int _depth;                             //items above the current one
     };
 
     //constructing empty stack
     Stack();
     //copying existing stack
     Stack(const Stack<T>& copyMe);
+    //taking over another stack's items, which is left empty
+    Stack(Stack<T>&& moveMe);
     //cleaning up stack resources
     ~Stack();
     //assigning from another stack
     Stack<T>& operator=(const Stack<T>& RHS);
-
+    Stack<T>& operator=(Stack<T>&& RHS);
     //accessing top element of stack
     T top();
     //checking if stack is empty
-    bool empty();
+    bool empty() const;
     //adding element to top of stack
-    void push(T item);
+    void push(const T& item);
     //removing and returning top element
     T pop();
-
     //outputting stack contents
     template<typename TT>
     friend ostream& operator<<(ostream& outs, const Stack<TT>& printMe);
-
     //getting iterator to first element
     Iterator begin() const;
     //getting iterator to end (null)
     Iterator end() const;
     //getting number of elements
     int size() const { return _size; }
+    //true while the items are in the stack itself
+    bool is_inline() const { return _data == inline_data(); }
 
 private:
-    node<T>* _top;     //pointer to top element
-    int _size;         //number of elements
+    alignas(T) unsigned char _inline[STACK_INLINE * sizeof(T)];
+    T* _data;          //_inline, or a heap array once the stack outgrows it
+    int _capacity;
+    int _size;         //number of elements, the top is _data[_size - 1]
+
+    T* inline_data() const { return reinterpret_cast<T*>(const_cast<unsigned char*>(_inline)); }
+    void grow();
+    void release();
 };
 
 //constructing empty stack
 template <typename T>
 Stack<T>::Stack() {
-   const bool debug = false;
+    const bool debug = false;
     if(debug) {
         cout << "Stack CTOR() Fired.\n";
     }
-    _top = nullptr;
+    _data = inline_data();
+    _capacity = STACK_INLINE;
     _size = 0;
 }
 
@@ -116,15 +135,19 @@ Stack<T>::Stack(const Stack<T>& copyMe) {
     if(debug) {
         cout << "Stack Copy CTOR() Fired.\n";
     }
-    if(copyMe._top == nullptr) {
-        _top = nullptr;
-        _size = 0;
-    }
-    else {
-        _top = nullptr;
-        _copy_list(_top, copyMe._top);
-        _size = copyMe._size;
-    }
+    _data = inline_data();
+    _capacity = STACK_INLINE;
+    _size = 0;
+    *this = copyMe;
+}
+
+//taking over another stack's items
+template <typename T>
+Stack<T>::Stack(Stack<T>&& moveMe) {
+    _data = inline_data();
+    _capacity = STACK_INLINE;
+    _size = 0;
+    *this = std::move(moveMe);
 }
 
 //cleaning up stack resources
@@ -134,9 +157,7 @@ Stack<T>::~Stack() {
     if(debug) {
         cout << "Stack DTOR() Fired.\n";
     }
-    _clear_list(_top);
-    _top = nullptr;
-    _size = 0;
+    release();
 }
 
 //assigning from another stack
@@ -148,63 +169,124 @@ Stack<T>& Stack<T>::operator=(const Stack<T>& RHS) {
     }
     if(this == &RHS)
         return *this;
-    else {
-        _clear_list(_top);
-        _top = nullptr;
-        _copy_list(_top, RHS._top);
+    release();
+    while(_capacity < RHS._size)
+        grow();
+    for(int i = 0; i < RHS._size; i++)
+        new (&_data[i]) T(RHS._data[i]);
+    _size = RHS._size;
+    return *this;
+}
+
+//taking over another stack's items: a heap array changes hands, inline items are moved one by one
+template <typename T>
+Stack<T>& Stack<T>::operator=(Stack<T>&& RHS) {
+    if(this == &RHS)
+        return *this;
+    release();
+    if(!RHS.is_inline())
+    {
+        _data = RHS._data;
+        _capacity = RHS._capacity;
         _size = RHS._size;
+        RHS._data = RHS.inline_data();
+        RHS._capacity = STACK_INLINE;
+        RHS._size = 0;
         return *this;
     }
+    for(int i = 0; i < RHS._size; i++)
+        new (&_data[i]) T(std::move(RHS._data[i]));
+    _size = RHS._size;
+    RHS.release();
+    return *this;
 }
 
 //accessing top element
 template <typename T>
 T Stack<T>::top() {
-    return _top->_item;
+    assert(_size > 0 && "Cannot get the top of an Empty Stack.");
+    return _data[_size - 1];
 }
 
 //checking if stack is empty
 template <typename T>
-bool Stack<T>::empty() {
-    return _top == nullptr;
+bool Stack<T>::empty() const {
+    return _size == 0;
 }
 
 //adding element to top of stack
 template <typename T>
-void Stack<T>::push(T item) {
+void Stack<T>::push(const T& item) {
+    if(_size == _capacity)
+    {
+        //item may be in the array being replaced
+        T copy(item);
+        grow();
+        new (&_data[_size]) T(std::move(copy));
+    }
+    else
+        new (&_data[_size]) T(item);
     _size++;
-    _insert_head(_top, item);
 }
 
 //removing and returning top element
 template <typename T>
 T Stack<T>::pop() {
-    assert(_top != nullptr && "Cannot pop an Empty Stack.");
+    assert(_size > 0 && "Cannot pop an Empty Stack.");
     _size--;
-    return _remove_head(_top);
+    T item(std::move(_data[_size]));
+    _data[_size].~T();
+    return item;
 }
 
 //getting iterator to first element
 template<typename T>
 typename Stack<T>::Iterator Stack<T>::begin() const {
-    return Iterator(_top);
+    return Iterator(this, 0);
 }
 
 //getting iterator to end (null)
 template<typename T>
 typename Stack<T>::Iterator Stack<T>::end() const {
-    return nullptr;
+    return Iterator();
+}
+
+//moving the items to a heap array twice the size
+template <typename T>
+void Stack<T>::grow() {
+    T* data = static_cast<T*>(::operator new(sizeof(T) * _capacity * 2));
+    for(int i = 0; i < _size; i++)
+    {
+        new (&data[i]) T(std::move(_data[i]));
+        _data[i].~T();
+    }
+    if(!is_inline())
+        ::operator delete(_data);
+    _data = data;
+    _capacity *= 2;
+}
+
+//destroying the items and going back to the inline array
+template <typename T>
+void Stack<T>::release() {
+    for(int i = 0; i < _size; i++)
+        _data[i].~T();
+    if(!is_inline())
+        ::operator delete(_data);
+    _data = inline_data();
+    _capacity = STACK_INLINE;
+    _size = 0;
 }
 
 //outputting stack contents
 template<typename TT>
 ostream& operator<<(ostream& outs, const Stack<TT>& printMe) {
     outs << "Stack:Head->";
-    for(node<TT>* walker = printMe._top; walker != nullptr; walker = walker->_next) {
-        outs << *walker;
+    for(int i = printMe._size - 1; i >= 0; i--) {
+        outs << "<-[" << printMe._data[i] << "]->";
     }
     outs << "|||\n";
     return outs;
 }
 
-#endif //STACK_H
\ No newline at end of file
+#endif //STACK_H
@@ -0,0 +1,42 @@
+#ifndef STR_VIEW_CPP
+#define STR_VIEW_CPP
+
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <set>
+#include <vector>
+#include <string>
+#include <cassert>
+#include <cstring>
+#include "str_view.h"
+
+using namespace std;
+
+StrView StrView::substr(int pos, int length) const
+{
+    assert(pos >= 0 && pos <= _size && "Substring starts outside of the view");
+    if(length < 0 || length > _size - pos)
+        length = _size - pos;
+    return StrView(_data + pos, length);
+}
+int StrView::find(char c, int pos) const
+{
+    for(int i = pos; i < _size; i++)
+    {
+        if(_data[i] == c)
+            return i;
+    }
+    return -1;
+}
+bool operator ==(const StrView& lhs, const StrView& rhs)
+{
+    return lhs._size == rhs._size && !memcmp(lhs._data, rhs._data, lhs._size);
+}
+ostream& operator <<(ostream& outs, const StrView& view)
+{
+    outs.write(view._data, view._size);
+    return outs;
+}
+
+#endif //STR_VIEW_CPP
@@ -0,0 +1,45 @@
+#ifndef STR_VIEW_H
+#define STR_VIEW_H
+
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <set>
+#include <vector>
+#include <string>
+#include <cassert>
+#include <cstring>
+
+using namespace std;
+
+//a slice of text someone else owns: a pointer and a length, never a copy
+//the text has to outlive every view of it
+class StrView
+{
+public:
+    StrView(): _data(""), _size(0) {}
+    StrView(const char* data, int size): _data(data), _size(size) {}
+    StrView(const char* text): _data(text), _size(strlen(text)) {}
+    StrView(const string& text): _data(text.c_str()), _size(text.size()) {}
+
+    const char* data() const {return _data;}
+    int size() const {return _size;}
+    bool empty() const {return _size == 0;}
+    char operator [](int i) const {return _data[i];}
+    //the view from pos, at most length chars of it
+    StrView substr(int pos, int length = -1) const;
+    //position of the first c at or after pos, -1 if there is none
+    int find(char c, int pos = 0) const;
+    //a copy of the text, for whoever has to keep it
+    string str() const {return string(_data, _size);}
+
+    friend bool operator ==(const StrView& lhs, const StrView& rhs);
+    friend bool operator !=(const StrView& lhs, const StrView& rhs) {return !(lhs == rhs);}
+    friend ostream& operator <<(ostream& outs, const StrView& view);
+
+private:
+    const char* _data;
+    int _size;
+};
+
+#endif //STR_VIEW_H
@@ -8,6 +8,9 @@
 #include <vector>
 #include <string>
 #include <cassert>
+#include <cstring>
+#include <algorithm>
+#include <unordered_map>
 #include "table.h"
 
 using namespace std;
@@ -20,11 +23,17 @@ Table::Table()
         cout << "Table CTOR Fired.\n";
     }
     _tablenames_table = false;
+    _records_read = 0;
+    _index_keys_read = 0;
+    _defer_index = false;
 }
 Table::Table(const string &str, const vectorstr &string_vec)
 {
     // str is name of the table //string_vec is the attributes in there
     _tablenames_table = false;
+    _records_read = 0;
+    _index_keys_read = 0;
+    _defer_index = false;
     const bool light_hearted_debug = false;
     if(light_hearted_debug)
         cout << "Two argument table CTOR\n";
@@ -75,6 +84,9 @@ Table::Table(const string &str, const vectorstr &string_vec)
 Table::Table(const string &str)
 {
     _tablenames_table = false;
+    _records_read = 0;
+    _index_keys_read = 0;
+    _defer_index = false;
     const bool light_hearted_debug = false;
     if(light_hearted_debug)
         cout << "One argument table CTOR\n";
@@ -129,10 +141,16 @@ void Table::insert_into(const vectorstr &insert_vec)
     //^
     _record_count++;
     _last_record_number++;
-    push_into_attribute_mmaps(insert_vec, recno);
+    if (_defer_index)
+    {
+        for (int i = 0; i < insert_vec.size() && i < _pending_keys.size(); i++)
+            _pending_keys[i].push_back(make_pair(insert_vec[i], recno));
+    }
+    else
+        push_into_attribute_mmaps(insert_vec, recno);
     if (debug)
     {
-        for (int i = 0; i < insert_vec.size(); i++)
+        for (int i = 0; i < _record_indicies.size(); i++)
         {
             // this works?!?
             cout << "mmap of attributes field[" << i << "]:\n"
@@ -140,6 +158,150 @@ void Table::insert_into(const vectorstr &insert_vec)
         }
     }
 }
+void Table::insert_many(const vector<vectorstr> &rows)
+{
+    const bool debug = false;
+    if (rows.empty())
+        return;
+    // every record laid out one after another the way FileRecord::write() puts them in the file
+    const int record_bytes = FileRecord::ROW * (FileRecord::MAX + 1);
+    vector<char> records(rows.size() * record_bytes);
+    for (int i = 0; i < rows.size(); i++)
+    {
+        FileRecord r(rows[i]);
+        memcpy(&records[i * record_bytes], r._record, record_bytes);
+    }
+    fstream f;
+    open_fileRW(f, _bin_filename.c_str());
+    f.seekp(0, f.end);
+    long first_recno = f.tellp() / record_bytes;
+    f.write(&records[0], records.size());
+    f.close();
+    _record_count += rows.size();
+    _last_record_number += rows.size();
+    if (debug)
+        cout << "recnos: " << first_recno << " to " << first_recno + rows.size() - 1 << "\n";
+    vector<pair<string, long> > keys;
+    for (int field = 0; field < _record_indicies.size(); field++)
+    {
+        keys.clear();
+        for (int i = 0; i < rows.size(); i++)
+        {
+            if (field < rows[i].size())
+                keys.push_back(make_pair(rows[i][field], first_recno + i));
+        }
+        add_index_keys(field, keys);
+    }
+}
+long Table::load_file(const string &path) throw(Error_Code)
+{
+    // load data from "employees.csv" into employee
+    const bool debug = false;
+    Error_Code error_code;
+    MappedFile file;
+    if (!file.open(path))
+    {
+        error_code._code = LOAD_FILE_NOT_FOUND;
+        error_code._error_token = path;
+        throw error_code;
+    }
+    const char *begin = file.data();
+    const char *end = begin + file.size();
+    // byte order mark some editors put in front of utf-8 files
+    if (end - begin >= 3 && !memcmp(begin, "\xEF\xBB\xBF", 3))
+        begin += 3;
+    char delimiter = load_delimiter(path, begin, end - begin);
+    // a first line of the table's field names is a header, not a record
+    vectorstr header;
+    const char *after_header = parse_load_line(begin, end, delimiter, header);
+    if (header == _field_name_vec)
+        begin = after_header;
+    vector<LoadChunk> chunks = split_load_chunks(begin, end);
+    const int record_bytes = FileRecord::ROW * (FileRecord::MAX + 1);
+    const int fields = _record_indicies.size();
+    const long threads = load_threads > 0 ? load_threads : 1;
+    // index keys of the rows appended since they last went to the indexes, by field
+    vector<vector<pair<string, long> > > keys(fields);
+    fstream f;
+    open_fileRW(f, _bin_filename.c_str());
+    f.seekp(0, f.end);
+    long first_recno = f.tellp() / record_bytes;
+    long recno = first_recno;
+    // a wave of chunks is parsed side by side, then appended in file order with a write per chunk,
+    // so only one wave of records is ever held in memory
+    for (long wave = 0; wave < chunks.size(); wave += threads)
+    {
+        long count = wave + threads < chunks.size() ? threads : chunks.size() - wave;
+        ThreadPool::shared().parallel_for(count, [&](int c)
+        {
+            parse_load_chunk(chunks[wave + c], delimiter, fields);
+        }, threads);
+        for (long c = wave; c < wave + count; c++)
+        {
+            LoadChunk &chunk = chunks[c];
+            if (chunk.rows)
+                f.write(&chunk.records[0], chunk.records.size());
+            for (int field = 0; field < fields; field++)
+            {
+                for (long row = 0; row < chunk.rows; row++)
+                    keys[field].push_back(make_pair(move(chunk.keys[field][row]), recno + row));
+            }
+            recno += chunk.rows;
+            vector<char>().swap(chunk.records);
+            vector<vectorstr>().swap(chunk.keys);
+        }
+        // the keys go to the indexes every LOAD_INDEX_ROWS rows and once more at the end, each
+        // field's in one sorted pass with the fields side by side, their recnos come after the
+        // ones already there so every key's list stays in recno order
+        if (fields && (keys[0].size() >= LOAD_INDEX_ROWS || wave + count == chunks.size()))
+        {
+            ThreadPool::shared().parallel_for(fields, [&](int field)
+            {
+                add_index_keys(field, keys[field]);
+                keys[field].clear();
+            }, threads);
+        }
+    }
+    f.close();
+    long loaded = recno - first_recno;
+    _record_count += loaded;
+    _last_record_number += loaded;
+    if (debug)
+        cout << "loaded " << loaded << " records from " << path << " in " << chunks.size() << " chunks\n";
+    return loaded;
+}
+void Table::defer_index(bool defer)
+{
+    if (!defer)
+        flush_index();
+    _defer_index = defer;
+    _pending_keys.resize(_record_indicies.size());
+}
+void Table::flush_index()
+{
+    const long threads = load_threads > 0 ? load_threads : 1;
+    ThreadPool::shared().parallel_for(_pending_keys.size(), [&](int field)
+    {
+        if (!_pending_keys[field].empty())
+            push_into_attribute_mmap_sorted(field, _pending_keys[field]);
+        vector<pair<string, long> >().swap(_pending_keys[field]);
+    }, threads);
+}
+void Table::truncate(long record_count)
+{
+    const bool debug = false;
+    const int record_bytes = FileRecord::ROW * (FileRecord::MAX + 1);
+    truncate_file(_bin_filename, record_count * record_bytes);
+    if (debug)
+        cout << "truncated " << _table_name << " from " << _record_count << " to " << record_count << " records\n";
+    _record_count = record_count;
+    _last_record_number = record_count - 1;
+    _defer_index = false;
+    _pending_keys.clear();
+    _record_indicies.clear();
+    init_record_indicies_vector(_record_indicies);
+    create_record_indicies(_record_indicies, _bin_filename);
+}
 
 ostream &operator<<(ostream &outs,
                     const Table &print_me)
@@ -220,50 +382,17 @@ Table Table::select(vectorstr string_vec, const string &field, const string &rel
 {
     const bool debug = false;
     // the string vec has field names
-    //_record_indicies[_field_indicies[field]] <- this gives the right multimap
-    //  _record_indicies[_field_indicies[field]][condition] <- this is getting the condition from the multimap
-    _build_vector.clear();
-    if (relational == "=")
+    // a single comparison compiles to a one leaf plan that probes _record_indicies[_field_indicies[field]]
+    if (!_field_indicies.contains(field))
     {
-        _build_vector = _record_indicies[_field_indicies[field]][condition];
-    }
-    else if (relational == "<")
-    {
-        for (mmap_sl::Iterator it = _record_indicies[_field_indicies[field]].begin();
-             it != _record_indicies[_field_indicies[field]].lower_bound(condition); ++it)
-        {
-            for (int i = 0; i < (*it).value_list.size(); i++)
-                _build_vector.push_back((*it).value_list[i]);
-        }
-    }
-    else if (relational == ">")
-    {
-        for (mmap_sl::Iterator it = _record_indicies[_field_indicies[field]].upper_bound(condition);
-             it != _record_indicies[_field_indicies[field]].end(); ++it)
-        {
-            for (int i = 0; i < (*it).value_list.size(); i++)
-                _build_vector.push_back((*it).value_list[i]);
-        }
-    }
-    else if (relational == ">=")
-    {
-        for (mmap_sl::Iterator it = _record_indicies[_field_indicies[field]].lower_bound(condition);
-             it != _record_indicies[_field_indicies[field]].end(); ++it)
-        {
-            for (int i = 0; i < (*it).value_list.size(); i++)
-                _build_vector.push_back((*it).value_list[i]);
-        }
-    }
-    else
-    {
-        // less than equal
-        for (mmap_sl::Iterator it = _record_indicies[_field_indicies[field]].begin();
-             it != _record_indicies[_field_indicies[field]].upper_bound(condition); ++it)
-        {
-            for (int i = 0; i < (*it).value_list.size(); i++)
-                _build_vector.push_back((*it).value_list[i]);
-        }
+        Error_Code error_code;
+        error_code._error_token = field;
+        error_code._code = UNKNOWN_COLUMN;
+        error_code._modify_to_postgre = true;
+        throw error_code;
     }
+    PredicatePlan plan(_field_indicies[field], field, relational, condition);
+    _build_vector = plan.evaluate(_record_indicies, _record_count);
     if (debug)
         cout << "_build_vector: " << _build_vector << "\n";
     // string vec is the field name vec
@@ -275,82 +404,287 @@ vector<long> Table::select_recnos()
 }
 Table Table::select(vectorstr string_vec, Queue<Token *> token_q)
 {
-    RPN rpn_1(token_q);
+    RPN rpn_1(std::move(token_q));
     _build_vector = rpn_1(_record_indicies, _field_indicies);
     return vector_to_table(_build_vector, string_vec);
 }
 Table Table::select(vectorstr string_vec, vectorstr condition) throw(Error_Code)
 {
     const bool debug = false;
+    PredicatePlan plan = compile_condition(condition);
+    _build_vector = plan.evaluate(_record_indicies, _record_count);
+    if (debug)
+        cout << "_build_vector: " << _build_vector << "\n";
+    // string vec is field_name vec
+    return vector_to_table(_build_vector, string_vec);
+}
+Table Table::select(vectorstr condition) throw(Error_Code)
+{
+    return select(_field_name_vec, condition);
+}
+PredicatePlan Table::compile_condition(const vectorstr& condition) throw(Error_Code)
+{
+    const bool debug = false;
+    // the tokens only live until the plan is compiled, the arena frees them all when it goes,
+    // also when the condition throws
+    Arena tokens;
     Queue<Token *> infix;
     for (int i = 0; i < condition.size(); i++)
     {
         if (condition[i] == "(")
         {
-            infix.push(new LParen);
+            infix.push(tokens.make<LParen>());
         }
         else if (condition[i] == ")")
         {
-            infix.push(new RParen);
+            infix.push(tokens.make<RParen>());
         }
-        else if (condition[i] == "<" || condition[i] == "<=" || condition[i] == ">" || condition[i] == ">=" || condition[i] == "=")
+        else if (PredicatePlan::relational_op(condition[i]) != -1)
         {
-            infix.push(new Relational(condition[i]));
+            infix.push(tokens.make<Relational>(condition[i]));
         }
-        else if (condition[i] == "and" || condition[i] == "or")
+        else if (condition[i] == "and" || condition[i] == "or" || condition[i] == "not")
         {
-            infix.push(new Logical(condition[i]));
+            infix.push(tokens.make<Logical>(condition[i]));
         }
         else
         {
-            infix.push(new TokenStr(condition[i]));
+            infix.push(tokens.make<TokenStr>(condition[i]));
         }
     }
-    ShuntingYard sy(infix);
+    ShuntingYard sy(std::move(infix));
+    // set_sql_shuting_yard lets shuting yard know to do sql specific shunting yard instructions
     sy.set_sql_shuting_yard(true, &_field_indicies);
-    RPN rpn_1(sy.postfix());
-    _build_vector = rpn_1(_record_indicies, _field_indicies);
+    // the postfix queue is validated and compiled once, evaluation no longer touches the tokens
+    PredicatePlan plan(sy.postfix(), _field_indicies);
     if (debug)
-        cout << "_build_vector: " << _build_vector << "\n";
-    // string vec is field_name vec
-    return vector_to_table(_build_vector, string_vec);
+        cout << "plan: " << plan << "\n";
+    return plan;
 }
-Table Table::select(vectorstr condition) throw(Error_Code)
+vectorlong Table::all_recnos(long keep)
+{
+    long count = keep >= 0 && keep < _record_count ? keep : _record_count;
+    _build_vector.clear();
+    for (long i = 0; i < count; i++)
+    {
+        _build_vector.push_back(i);
+    }
+    return _build_vector;
+}
+vectorlong Table::where_recnos(const vectorstr &condition, long keep) throw(Error_Code)
+{
+    PredicatePlan plan = compile_condition(condition);
+    return where_recnos(plan, keep);
+}
+vectorlong Table::where_recnos(PredicatePlan &plan, long keep)
+{
+    // plan may have been compiled earlier, only the index probes run here
+    int method = where_method(plan);
+    if (method == WHERE_PARALLEL_SCAN)
+    {
+        ParallelScan scan(_bin_filename, scan_threads);
+        _build_vector = scan.filter(plan, _record_count, keep);
+        _records_read += scan.records_read();
+        return _build_vector;
+    }
+    _build_vector = plan.evaluate(_record_indicies, _record_count, keep, method == WHERE_PARALLEL_PROBES ? probe_threads : 1);
+    return _build_vector;
+}
+int Table::where_method(PredicatePlan &plan)
+{
+    // probes unless reading every record on scan_threads threads is cheaper than the probes and merges,
+    // a lone comparison always probes to keep its index key order
+    // independent comparisons and subtrees only go to other threads when there is a morsel's worth of recnos
+    if (plan.size() <= 1 || _record_count <= SCAN_MORSEL_RECORDS)
+        return WHERE_INDEX_PROBES;
+    double entries = plan.estimate_entries(_record_indicies, _record_count);
+    double scan_cost = double(_record_count) * RECORD_READ_COST / scan_threads;
+    if (scan_cost < entries)
+        return WHERE_PARALLEL_SCAN;
+    if (entries > SCAN_MORSEL_RECORDS && probe_threads > 1)
+        return WHERE_PARALLEL_PROBES;
+    return WHERE_INDEX_PROBES;
+}
+int Table::order_method(long selected, bool descending, long keep) const
+{
+    // walking the field's index visits every record once, sorting reads only the selected
+    // records from disk, so a small selection out of a big table is cheaper to sort
+    // under a limit the sort keeps a keep sized heap, and an ascending walk stops once it has keep records
+    bool bounded = keep >= 0 && keep < selected;
+    double kept = bounded ? keep : selected;
+    double sort_cost = selected * (log2(kept + 1) + RECORD_READ_COST);
+    double stream_cost = bounded && !descending ? double(_record_count) * kept / selected : _record_count;
+    if (sort_cost >= stream_cost)
+        return ORDER_INDEX_WALK;
+    return bounded ? ORDER_TOP_K : ORDER_EXTERNAL_SORT;
+}
+int Table::aggregate_method(const vectorstr &columns, const vectorstr &group_by) const
+{
+    // every field but a group one is read through its own index when there is no group by,
+    // with one group field the walk over its keys answers count(*) and aggregates of that field,
+    // anything else is hashed on the group values of the records read from disk
+    if (group_by.size() > 1)
+        return AGGREGATE_HASH;
+    for (int i = 0; i < columns.size(); i++)
+    {
+        AggregateColumn column(columns[i]);
+        if (!group_by.empty() && column.field != "*" && column.field != group_by[0])
+            return AGGREGATE_HASH;
+    }
+    return AGGREGATE_INDEX_WALK;
+}
+string Table::where_method_name(int method)
+{
+    switch (method)
+    {
+    case WHERE_PARALLEL_SCAN:
+        return "parallel scan";
+    case WHERE_PARALLEL_PROBES:
+        return "parallel index probes";
+    default:
+        return "index probes";
+    }
+}
+string Table::order_method_name(int method)
+{
+    switch (method)
+    {
+    case ORDER_INDEX_WALK:
+        return "index walk";
+    case ORDER_TOP_K:
+        return "top-k heap";
+    default:
+        return "external merge sort";
+    }
+}
+string Table::aggregate_method_name(int method)
+{
+    return method == AGGREGATE_INDEX_WALK ? "index walk" : "hash aggregate";
+}
+void Table::order_recnos(vectorlong &recnos, const string &field, bool descending, long keep) throw(Error_Code)
 {
     const bool debug = false;
-    Queue<Token *> infix;
-    for (int i = 0; i < condition.size(); i++)
+    check_field(field);
+    if (keep == 0)
+        recnos.clear();
+    if (recnos.size() > 1)
     {
-        if (condition[i] == "(")
-        {
-            infix.push(new LParen);
-        }
-        else if (condition[i] == ")")
+        int field_index = _field_indicies[field];
+        bool bounded = keep >= 0 && keep < recnos.size();
+        int method = order_method(recnos.size(), descending, keep);
+        if (method == ORDER_INDEX_WALK)
         {
-            infix.push(new RParen);
+            if (debug)
+                cout << "order by " << field << ": streaming the index\n";
+            vector<bool> is_selected(_record_count, recnos.size() == _record_count);
+            if (recnos.size() != _record_count)
+            {
+                for (int i = 0; i < recnos.size(); i++)
+                    is_selected[recnos[i]] = true;
+            }
+            recnos.clear();
+            vectorlong group_starts;
+            mmap_sl &index = _record_indicies[field_index];
+            for (mmap_sl::Iterator it = index.begin(); it != index.end(); ++it)
+            {
+                _index_keys_read++;
+                const vectorlong &value_list = it->value_list;
+                long group_start = recnos.size();
+                for (int i = 0; i < value_list.size(); i++)
+                {
+                    if (is_selected[value_list[i]])
+                        recnos.push_back(value_list[i]);
+                }
+                if (recnos.size() > group_start)
+                    group_starts.push_back(group_start);
+                if (bounded && !descending && recnos.size() >= keep)
+                    break;
+            }
+            if (descending)
+                reverse_key_groups(recnos, group_starts);
         }
-        else if (condition[i] == "<" || condition[i] == "<=" || condition[i] == ">" || condition[i] == ">=" || condition[i] == "=")
+        else if (method == ORDER_TOP_K)
         {
-            infix.push(new Relational(condition[i]));
+            _records_read += recnos.size();
+            if (debug)
+                cout << "order by " << field << ": keeping the top " << keep << " of " << recnos.size() << " records\n";
+            if (descending)
+                top_k_recnos<DescendingSortEntry>(recnos, field_index, keep);
+            else
+                top_k_recnos<SortEntry>(recnos, field_index, keep);
         }
-        else if (condition[i] == "and" || condition[i] == "or")
+        else
         {
-            infix.push(new Logical(condition[i]));
+            _records_read += recnos.size();
+            if (debug)
+                cout << "order by " << field << ": sorting " << recnos.size() << " records\n";
+            ExternalSort sorter(sort_memory_budget, _table_name + "_order_by");
+            fstream f;
+            FileRecord r;
+            open_fileRW(f, _bin_filename.c_str());
+            for (int i = 0; i < recnos.size(); i++)
+            {
+                r.read(f, recnos[i]);
+                sorter.add(r._record[field_index], recnos[i]);
+            }
+            f.close();
+            sorter.finish(recnos, descending);
         }
-        else
+        if (keep >= 0 && recnos.size() > keep)
+            recnos.resize(keep);
+    }
+    _build_vector = recnos;
+}
+vector<vectorstr> Table::aggregate(const vectorlong &recnos, const vectorstr &columns, const vectorstr &group_by) throw(Error_Code)
+{
+    const bool debug = false;
+    for (int i = 0; i < group_by.size(); i++)
+        check_field(group_by[i]);
+    vector<AggregateColumn> parsed;
+    for (int i = 0; i < columns.size(); i++)
+    {
+        AggregateColumn column(columns[i]);
+        if (column.field != "*" || column.func != AGG_COUNT)
+            check_field(column.field);
+        if (!column.is_aggregate() && find(group_by.begin(), group_by.end(), column.field) == group_by.end())
         {
-            infix.push(new TokenStr(condition[i]));
+            Error_Code error_code;
+            error_code._code = FIELD_NOT_GROUPED;
+            error_code._error_token = column.field;
+            throw error_code;
         }
+        parsed.push_back(column);
     }
-    ShuntingYard sy(infix);
-    // set_sql_shuting_yard lets shuting yard know to do sql specific shunting yard instructions
-    sy.set_sql_shuting_yard(true, &_field_indicies);
-    RPN rpn_1(sy.postfix());
-    _build_vector = rpn_1(_record_indicies, _field_indicies);
+    bool from_index = aggregate_method(columns, group_by) == AGGREGATE_INDEX_WALK;
     if (debug)
-        cout << "_build_vector: " << _build_vector << "\n";
-    // pass in field_name_vec
-    return vector_to_table(_build_vector, _field_name_vec);
+        cout << "aggregate: " << (from_index ? "index walk" : "hashing records") << "\n";
+    _build_vector = recnos;
+    if (from_index)
+        return aggregate_from_index(recnos, parsed, group_by);
+    return aggregate_from_records(recnos, parsed, group_by);
+}
+Table Table::rows_to_table(const vector<vectorstr> &rows, const vectorstr &field_name_vec)
+{
+    serial++;
+    Table temp(_table_name + "_" + to_string(serial), field_name_vec);
+    for (int i = 0; i < rows.size(); i++)
+    {
+        temp.insert_into(rows[i]);
+    }
+    return temp;
+}
+void Table::open_records(fstream &f) const
+{
+    open_fileRW(f, _bin_filename.c_str());
+}
+vectorstr Table::read_record(fstream &f, long recno) const
+{
+    FileRecord r;
+    r.read(f, recno);
+    vectorstr record;
+    for (int i = 0; i < _field_count; i++)
+        record.push_back(r._record[i]);
+    return record;
 }
 void Table::print_field_names(ostream &outs) const
 {
@@ -366,19 +700,16 @@ Table Table::vector_to_table(const vector<long> &build_vector, const vectorstr &
     // Table new_Table(_table_name + to_string(serial+1),  );
     serial++;
     Table temp(_table_name + "_" + to_string(serial), field_name_vec);
-    fstream f;
-    FileRecord r;
-    open_fileRW(f, _bin_filename.c_str());
-    for (int i = 0; i < build_vector.size(); i++)
+    // records are read and projected in parallel, then inserted in build_vector order
+    vector<int> fields;
+    for (int i = 0; i < field_name_vec.size(); i++)
+        fields.push_back(_field_indicies.at(field_name_vec[i]));
+    ParallelScan scan(_bin_filename, scan_threads);
+    scan.for_each_row(build_vector, fields, [&temp](const vectorstr &row)
     {
-        r.read(f, build_vector[i]);
-        // after reading will have array;
-        // get the rows(fields) from the array;
-        // create a insert_into vector with the two d array
-        vectorstr insert_into_vec = vec_from_record(r._record, field_name_vec);
-        temp.insert_into(insert_into_vec);
-    }
-    f.close();
+        temp.insert_into(row);
+    });
+    _records_read += scan.records_read();
     return temp;
 }
 
@@ -433,7 +764,8 @@ void Table::create_record_indicies(vector<mmap_sl> &record_i_s, const string &bi
 void Table::push_into_attribute_mmaps(vectorstr insert_vec, const long &recno)
 {
     const bool debug = false;
-    for (int i = 0; i < insert_vec.size(); i++)
+    // values past the last field have no index
+    for (int i = 0; i < insert_vec.size() && i < _record_indicies.size(); i++)
     {
         // this works?!?
         _record_indicies[i][insert_vec[i]] += recno;
@@ -453,6 +785,32 @@ void Table::push_into_attribute_mmaps(char insert_record_arr[][FIELD_MAX_LEN], c
         //     cout<<"mmap of attributes field["<<i<<"]:\n"<<_record_indicies[i]<<"\n";
     }
 }
+void Table::push_into_attribute_mmap_sorted(int field, vector<pair<string, long> > &keys)
+{
+    // one pair per distinct key holding all of its recnos, the tree takes them in key order
+    sort(keys.begin(), keys.end());
+    vector<MPair<string, long> > runs;
+    for (int i = 0; i < keys.size(); i++)
+    {
+        if (runs.empty() || runs.back().key != keys[i].first)
+            runs.push_back(MPair<string, long>(keys[i].first));
+        runs.back().value_list.push_back(keys[i].second);
+    }
+    _record_indicies[field].insert_sorted(runs);
+}
+void Table::add_index_keys(int field, vector<pair<string, long> > &keys)
+{
+    if (!_defer_index)
+    {
+        push_into_attribute_mmap_sorted(field, keys);
+        return;
+    }
+    vector<pair<string, long> > &pending = _pending_keys[field];
+    if (pending.empty())
+        pending.swap(keys);
+    else
+        pending.insert(pending.end(), make_move_iterator(keys.begin()), make_move_iterator(keys.end()));
+}
 int Table::get_init_record_count()
 {
     // vectorstr rec_count = read_from_file_txt(_rec_count_filename);
@@ -488,11 +846,218 @@ vectorstr Table::vec_from_record(char insert_record_arr[][FIELD_MAX_LEN], const
     // the returned record_vector should be ready for insert_into to just grab and insert
     return record_vector;
 }
+template <class Entry>
+void Table::top_k_recnos(vectorlong &recnos, int field_index, long keep)
+{
+    // only keep records are held at once, so this never needs to spill
+    vector<Entry> heap;
+    heap.reserve(keep);
+    fstream f;
+    FileRecord r;
+    open_fileRW(f, _bin_filename.c_str());
+    for (int i = 0; i < recnos.size(); i++)
+    {
+        r.read(f, recnos[i]);
+        top_k_push(heap, keep, Entry(r._record[field_index], recnos[i]));
+    }
+    f.close();
+    if (!heap.empty())
+        heap_sort(&heap[0], heap.size());
+    recnos.clear();
+    for (int i = 0; i < heap.size(); i++)
+        recnos.push_back(heap[i].recno);
+}
+void Table::check_field(const string &field) throw(Error_Code)
+{
+    if (!_field_indicies.contains(field))
+    {
+        Error_Code error_code;
+        error_code._error_token = field;
+        error_code._code = UNKNOWN_COLUMN;
+        error_code._modify_to_postgre = true;
+        throw error_code;
+    }
+}
+long Table::selected_count(const vectorlong &value_list, const vector<bool> &is_selected, bool all_selected)
+{
+    if (all_selected)
+        return value_list.size();
+    long count = 0;
+    for (int i = 0; i < value_list.size(); i++)
+    {
+        if (is_selected[value_list[i]])
+            count++;
+    }
+    return count;
+}
+vector<vectorstr> Table::aggregate_from_index(const vectorlong &recnos, const vector<AggregateColumn> &columns, const vectorstr &group_by)
+{
+    // a key's value_list holds the records with that value, so each key adds its value once
+    // with the count of its selected records and no record is read from disk
+    bool all_selected = recnos.size() == _record_count;
+    vector<bool> is_selected;
+    if (!all_selected)
+    {
+        is_selected.assign(_record_count, false);
+        for (int i = 0; i < recnos.size(); i++)
+            is_selected[recnos[i]] = true;
+    }
+    vector<vectorstr> rows;
+    if (group_by.empty())
+    {
+        vectorstr row;
+        for (int c = 0; c < columns.size(); c++)
+        {
+            Accumulator total(columns[c].func);
+            if (columns[c].func == AGG_COUNT)
+                total.add_count(recnos.size());
+            else if (!recnos.empty())
+            {
+                mmap_sl &index = _record_indicies[_field_indicies[columns[c].field]];
+                if (all_selected && columns[c].func == AGG_MIN)
+                {
+                    total.add(index.begin()->key);
+                    _index_keys_read++;
+                }
+                else if (all_selected && columns[c].func == AGG_MAX)
+                {
+                    total.add(index.last()->key);
+                    _index_keys_read++;
+                }
+                else
+                {
+                    for (mmap_sl::Iterator it = index.begin(); it != index.end(); ++it)
+                    {
+                        _index_keys_read++;
+                        long count = selected_count(it->value_list, is_selected, all_selected);
+                        total.add(it->key, count);
+                        // keys come in order, the first one with a selected record is the min
+                        if (count && columns[c].func == AGG_MIN)
+                            break;
+                    }
+                }
+            }
+            row.push_back(total.result());
+        }
+        rows.push_back(row);
+        return rows;
+    }
+    if (recnos.empty())
+        return rows;
+    mmap_sl &index = _record_indicies[_field_indicies[group_by[0]]];
+    for (mmap_sl::Iterator it = index.begin(); it != index.end(); ++it)
+    {
+        _index_keys_read++;
+        long count = selected_count(it->value_list, is_selected, all_selected);
+        if (!count)
+            continue;
+        vectorstr row;
+        for (int c = 0; c < columns.size(); c++)
+        {
+            if (!columns[c].is_aggregate())
+            {
+                row.push_back(it->key);
+                continue;
+            }
+            Accumulator group(columns[c].func);
+            if (columns[c].func == AGG_COUNT)
+                group.add_count(count);
+            else
+                group.add(it->key, count);
+            row.push_back(group.result());
+        }
+        rows.push_back(row);
+    }
+    return rows;
+}
+vector<vectorstr> Table::aggregate_from_records(const vectorlong &recnos, const vector<AggregateColumn> &columns, const vectorstr &group_by)
+{
+    // hash aggregation: group values joined into one key find the group's accumulators
+    vector<int> group_fields;
+    for (int i = 0; i < group_by.size(); i++)
+        group_fields.push_back(_field_indicies[group_by[i]]);
+    vector<int> column_fields;
+    for (int c = 0; c < columns.size(); c++)
+        column_fields.push_back(columns[c].field == "*" ? -1 : _field_indicies[columns[c].field]);
+
+    unordered_map<string, int> group_of;
+    vector<vectorstr> group_values;
+    vector<vector<Accumulator> > totals;
+    // rows are read in parallel as the group fields followed by the column fields
+    vector<int> read_fields = group_fields;
+    read_fields.insert(read_fields.end(), column_fields.begin(), column_fields.end());
+    for (int i = 0; i < read_fields.size(); i++)
+    {
+        if (read_fields[i] == -1)
+            read_fields[i] = 0;
+    }
+    int group_count = group_fields.size();
+    ParallelScan scan(_bin_filename, scan_threads);
+    scan.for_each_row(recnos, read_fields, [&](const vectorstr &record)
+    {
+        string key;
+        for (int g = 0; g < group_count; g++)
+        {
+            // field values are C strings, so '\0' cannot appear inside one
+            key += record[g];
+            key += '\0';
+        }
+        unordered_map<string, int>::iterator found = group_of.find(key);
+        int group;
+        if (found == group_of.end())
+        {
+            group = group_values.size();
+            group_of[key] = group;
+            group_values.push_back(vectorstr(record.begin(), record.begin() + group_count));
+            vector<Accumulator> accumulators;
+            for (int c = 0; c < columns.size(); c++)
+                accumulators.push_back(Accumulator(columns[c].func));
+            totals.push_back(accumulators);
+        }
+        else
+            group = found->second;
+        for (int c = 0; c < columns.size(); c++)
+        {
+            if (!columns[c].is_aggregate())
+                continue;
+            if (column_fields[c] == -1)
+                totals[group][c].add_count(1);
+            else
+                totals[group][c].add(record[group_count + c]);
+        }
+    });
+    _records_read += scan.records_read();
+
+    // groups come out in group by value order, the way the index walk returns them
+    vector<pair<vectorstr, int> > order;
+    for (int g = 0; g < group_values.size(); g++)
+        order.push_back(make_pair(group_values[g], g));
+    sort(order.begin(), order.end());
+    vector<vectorstr> rows;
+    for (int i = 0; i < order.size(); i++)
+    {
+        int group = order[i].second;
+        vectorstr row;
+        for (int c = 0; c < columns.size(); c++)
+        {
+            if (columns[c].is_aggregate())
+                row.push_back(totals[group][c].result());
+            else
+                row.push_back(group_values[group][find(group_by.begin(), group_by.end(), columns[c].field) - group_by.begin()]);
+        }
+        rows.push_back(row);
+    }
+    return rows;
+}
 void Table::set_tablenames_table(bool tablenames_table)
 {
     _tablenames_table = tablenames_table;
 }
 
 int Table::serial = 0;
+long Table::sort_memory_budget = SORT_MEMORY_BUDGET;
+int Table::scan_threads = ThreadPool::hardware_threads();
+int Table::probe_threads = ThreadPool::hardware_threads();
+int Table::load_threads = ThreadPool::hardware_threads();
 
 #endif // ZAC_TABLE_
\ No newline at end of file
@@ -22,16 +22,44 @@
 #include "../ReversePolishNotation/ReversePolishNotation.h"
 #include "../ShuntingYardAlgorithm/ShuntingYardAlgo.h"
 #include "../Files/FileRecord.h"
+#include "../PredicatePlan/predicate_plan.h"
+#include "../SortingAlgorithms/ExternalSort.h"
+#include "../SortingAlgorithms/SortAlgorithms.h"
+#include "../Aggregate/aggregate.h"
+#include "../ParallelScan/parallel_scan.h"
+#include "../BulkLoad/bulk_load.h"
+#include "../Arena/arena.h"
 
 using namespace std;
 
+//how a where clause, an order by and an aggregate are answered, chosen per query by cost
+enum where_methods {WHERE_INDEX_PROBES, WHERE_PARALLEL_PROBES, WHERE_PARALLEL_SCAN};
+enum order_methods {ORDER_INDEX_WALK, ORDER_TOP_K, ORDER_EXTERNAL_SORT};
+enum aggregate_methods {AGGREGATE_INDEX_WALK, AGGREGATE_HASH};
+
 class Table{
 public:
     static int serial;
+    static long sort_memory_budget;     //bytes an order by sorts in memory before spilling runs to disk
+    static int scan_threads;            //threads reading records in parallel, 1 reads them on the caller only
+    static int probe_threads;           //most threads one where clause probes and merges its index lookups on
+    static int load_threads;            //threads parsing the file of a load data
     Table();
     Table(const string& str, const vectorstr& string_vec);
     Table(const string& str);
     void insert_into(const vectorstr& insert_vec);
+    //appends the rows with one write, then adds them to each field's index sorted by key
+    void insert_many(const vector<vectorstr>& rows);
+    //appends every line of a csv or tsv file as a record, returns how many
+    //throws LOAD_FILE_NOT_FOUND if the file cannot be opened
+    long load_file(const string& path) throw(Error_Code);
+    //while the index is deferred, inserts and loads append their records and only collect their
+    //index keys, flush_index() adds what was collected to each field's index in one sorted pass
+    //anything reading the indexes has to flush them first
+    void defer_index(bool defer);
+    void flush_index();
+    //drops the records from record_count on and rebuilds the indexes, for a rolled back batch
+    void truncate(long record_count);
     friend ostream& operator<<(ostream& outs,
                                const Table& print_me);
     Table select_all();
@@ -41,8 +69,42 @@ public:
     Table select(vectorstr condition) throw(Error_Code);
     vector<long> select_recnos();
     Table select(vectorstr string_vec, Queue<Token*> token_q);
+    PredicatePlan compile_condition(const vectorstr& condition) throw(Error_Code);
+    //keep > -1 stops after the first keep recnos, for a limit
+    vectorlong all_recnos(long keep = -1);
+    vectorlong where_recnos(const vectorstr& condition, long keep = -1) throw(Error_Code);
+    vectorlong where_recnos(PredicatePlan& plan, long keep = -1);
+    void order_recnos(vectorlong& recnos, const string& field, bool descending, long keep = -1) throw(Error_Code);
+    //the method where_recnos(), order_recnos() and aggregate() pick, an explain shows them without running them
+    int where_method(PredicatePlan& plan);
+    int order_method(long selected, bool descending, long keep) const;
+    int aggregate_method(const vectorstr& columns, const vectorstr& group_by) const;
+    static string where_method_name(int method);
+    static string order_method_name(int method);
+    static string aggregate_method_name(int method);
+    vector<double> estimate_where_rows(PredicatePlan& plan) {return plan.estimate_rows(_record_indicies, _record_count);}
+    //running totals of the work selects on this table did, an explain analyze reads them before and after a step
+    long records_read() const {return _records_read;}
+    long index_keys_read() const {return _index_keys_read;}
+    //one row per group of the selected records (a single row without group_by), columns are
+    //group by fields or aggregates like "count(*)", rows come in group by value order
+    vector<vectorstr> aggregate(const vectorlong& recnos, const vectorstr& columns, const vectorstr& group_by) throw(Error_Code);
+    Table rows_to_table(const vector<vectorstr>& rows, const vectorstr& field_name_vec);
     void print_field_names(ostream& outs=cout) const;
     Table vector_to_table(const vector<long>& build_vector, const vectorstr& field_name_vec);
+    vectorstr get_field_names() const {return _field_name_vec;}
+    //names its files too, <name>_fields.txt and <name>_fields.bin
+    string get_table_name() const {return _table_name;}
+    //record and index access for readers outside the table, like a join
+    bool has_field(const string& field) const {return _field_indicies.contains(field);}
+    //throws UNKNOWN_COLUMN for a field the table does not have
+    void check_field(const string& field) throw(Error_Code);
+    int field_position(const string& field) {return _field_indicies.at(field);}
+    mmap_sl& field_index(int position) {return _record_indicies[position];}
+    long record_count() const {return _record_count;}
+    void open_records(fstream& f) const;
+    //every field of the record, in field order
+    vectorstr read_record(fstream& f, long recno) const;
     void set_tablenames_table(bool tablenames_table);
     bool get_tablenames_table(){return _tablenames_table;}
     friend Table operator + (const Table& lhs, const Table& rhs)
@@ -65,10 +127,23 @@ private:
     int _field_count;
     vector<long> _build_vector;
     bool _tablenames_table;
+    long _records_read;
+    long _index_keys_read;
+    bool _defer_index;
+    vector<vector<pair<string, long> > > _pending_keys;    //by field, keys not in the index yet
     void create_field_indicies(map_sl& field_i_s);
     void init_record_indicies_vector(vector<mmap_sl>& list);
     void create_record_indicies(vector<mmap_sl>& record_i_s, const string& bin_fi_name);
     void push_into_attribute_mmaps(vectorstr insert_vec, const long& recno);
+    //adds (value, recno) keys to the field's index in one sorted pass, keys is left sorted
+    void push_into_attribute_mmap_sorted(int field, vector<pair<string, long> >& keys);
+    //the keys go to the field's index, or to its pending keys while the index is deferred
+    void add_index_keys(int field, vector<pair<string, long> >& keys);
+    template <class Entry>
+    void top_k_recnos(vectorlong& recnos, int field_index, long keep);
+    static long selected_count(const vectorlong& value_list, const vector<bool>& is_selected, bool all_selected);
+    vector<vectorstr> aggregate_from_index(const vectorlong& recnos, const vector<AggregateColumn>& columns, const vectorstr& group_by);
+    vector<vectorstr> aggregate_from_records(const vectorlong& recnos, const vector<AggregateColumn>& columns, const vectorstr& group_by);
     void push_into_attribute_mmaps(char insert_record_arr[][FIELD_MAX_LEN], const long& recno);
     int get_init_record_count();
     vectorstr vec_from_record(char insert_record_arr[][FIELD_MAX_LEN], const vectorstr& field_vector);
@@ -11,5 +11,13 @@
 using namespace std;
 
 const int FIELD_MAX_LEN = 101;
+//bytes an order by may buffer before spilling sorted runs to disk
+const long SORT_MEMORY_BUDGET = 4 * 1024 * 1024;
+//cost of reading one record from disk, in index entry visits, when choosing how to order rows
+const int RECORD_READ_COST = 4;
+//records one task of a parallel scan reads
+const long SCAN_MORSEL_RECORDS = 1024;
+//joined rows buffered before they are written to the join's result table in one insert
+const long JOIN_RESULT_BATCH = 1024;
 
 #endif //TABLE_CONSTANTS_H
\ No newline at end of file
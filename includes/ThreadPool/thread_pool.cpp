@@ -0,0 +1,124 @@
+#ifndef THREAD_POOL_CPP
+#define THREAD_POOL_CPP
+
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <set>
+#include <vector>
+#include <string>
+#include <cassert>
+#include "thread_pool.h"
+
+using namespace std;
+
+ThreadPool::ThreadPool(int threads)
+{
+    _stopping = false;
+    for(int i = 0; i < threads; i++)
+        _workers.push_back(thread(&ThreadPool::work, this));
+}
+ThreadPool::~ThreadPool()
+{
+    {
+        lock_guard<mutex> lock(_mutex);
+        _stopping = true;
+    }
+    _work_ready.notify_all();
+    for(int i = 0; i < _workers.size(); i++)
+        _workers[i].join();
+}
+void ThreadPool::parallel_for(int count, const function<void(int)>& task, int max_threads)
+{
+    if(count <= 0)
+        return;
+    int helpers = max_threads < 0 ? size() : max_threads - 1;
+    if(helpers > count - 1)
+        helpers = count - 1;
+    if(helpers > size())
+        helpers = size();
+    if(helpers <= 0)
+    {
+        for(int i = 0; i < count; i++)
+            task(i);
+        return;
+    }
+    shared_ptr<Job> job(new Job);
+    job->task = &task;
+    job->count = count;
+    job->next = 0;
+    job->done = 0;
+    job->helpers = helpers;
+    {
+        lock_guard<mutex> lock(_mutex);
+        _jobs.push_back(job);
+    }
+    if(helpers == 1)
+        _work_ready.notify_one();
+    else
+        _work_ready.notify_all();
+    run_tasks(*job);
+    {
+        //nothing is left to claim, so no worker should pick this job up anymore
+        lock_guard<mutex> lock(_mutex);
+        for(deque<shared_ptr<Job> >::iterator it = _jobs.begin(); it != _jobs.end(); it++)
+        {
+            if(*it == job)
+            {
+                _jobs.erase(it);
+                break;
+            }
+        }
+    }
+    unique_lock<mutex> lock(job->finished_mutex);
+    while(job->done < job->count)
+        job->finished.wait(lock);
+}
+ThreadPool& ThreadPool::shared()
+{
+    static ThreadPool pool(hardware_threads() - 1);
+    return pool;
+}
+int ThreadPool::hardware_threads()
+{
+    int threads = thread::hardware_concurrency();
+    return threads > 0 ? threads : 1;
+}
+
+//private
+void ThreadPool::work()
+{
+    while(true)
+    {
+        shared_ptr<Job> job;
+        {
+            unique_lock<mutex> lock(_mutex);
+            while(!_stopping && _jobs.empty())
+                _work_ready.wait(lock);
+            if(_stopping)
+                return;
+            job = _jobs.front();
+            //a job leaves the queue once it has all the helpers it asked for
+            if(--job->helpers == 0)
+                _jobs.pop_front();
+        }
+        run_tasks(*job);
+    }
+}
+void ThreadPool::run_tasks(Job& job)
+{
+    int ran = 0;
+    for(int i = job.next++; i < job.count; i = job.next++)
+    {
+        (*job.task)(i);
+        ran++;
+    }
+    if(ran == 0)
+        return;
+    lock_guard<mutex> lock(job.finished_mutex);
+    job.done += ran;
+    if(job.done == job.count)
+        job.finished.notify_all();
+}
+
+#endif //THREAD_POOL_CPP
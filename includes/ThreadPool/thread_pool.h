@@ -0,0 +1,60 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <cmath>
+#include <iostream>
+#include <iomanip>
+#include <set>
+#include <vector>
+#include <string>
+#include <cassert>
+#include <deque>
+#include <memory>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <condition_variable>
+
+using namespace std;
+
+//fixed set of worker threads that run parallel_for jobs
+//the calling thread works on its own job too, so a task may start a parallel_for of its own
+//without waiting on workers that are all busy
+class ThreadPool
+{
+public:
+    explicit ThreadPool(int threads);
+    ~ThreadPool();
+    int size() const {return _workers.size();}
+    //runs task(0) .. task(count - 1) and returns once every one of them is done
+    //at most max_threads threads (the caller included) work on it, -1 for the whole pool
+    void parallel_for(int count, const function<void(int)>& task, int max_threads = -1);
+    //pool with one worker per hardware thread besides the caller's, started on first use
+    static ThreadPool& shared();
+    //hardware threads, at least 1
+    static int hardware_threads();
+
+private:
+    struct Job
+    {
+        const function<void(int)>* task;
+        int count;
+        atomic<int> next;       //next task index nobody has claimed
+        int done;               //guarded by finished_mutex
+        int helpers;            //workers that still may join, guarded by the pool mutex
+        mutex finished_mutex;
+        condition_variable finished;
+    };
+    vector<thread> _workers;
+    deque<shared_ptr<Job> > _jobs;      //jobs with unclaimed tasks
+    mutex _mutex;
+    condition_variable _work_ready;
+    bool _stopping;
+
+    void work();
+    //claims and runs tasks of job until none are left unclaimed
+    static void run_tasks(Job& job);
+};
+
+#endif //THREAD_POOL_H
@@ -16,7 +16,13 @@ Logical::Logical(const string& val) : Operator()
 {
     set_token_type(OPERATOR);
     set_operator_type(LOGICAL);
-    if(val == "and")
+    if(val == "not")
+    {
+        //binds tighter than and/or but looser than the relational it negates
+        set_precedence(3);
+        set_unary(true);
+    }
+    else if(val == "and")
         set_precedence(2);
     else if(val == "or")
         set_precedence(1);
@@ -36,8 +42,8 @@ vectorlong Logical::evaluate(Token* field_token, Token* condition_token, vector<
     const bool debug = false;
     if(debug)
         cout<<"Virtual evaluate() of logical class fired.\n";
-    vectorlong field_token_vec = static_cast<ResultSet*>(field_token)->get_val_list();
-    vectorlong condition_token_vec = static_cast<ResultSet*>(condition_token)->get_val_list();
+    const vectorlong& field_token_vec = static_cast<ResultSet*>(field_token)->get_val_list();
+    const vectorlong& condition_token_vec = static_cast<ResultSet*>(condition_token)->get_val_list();
     if(_val == "and")
     {
         return intersect(field_token_vec, condition_token_vec);
@@ -48,34 +54,38 @@ vectorlong Logical::evaluate(Token* field_token, Token* condition_token, vector<
     }
     else
     {
-        //if not "and" or "or" then, throw that there's a syntax error at or near the operator relational token is holding
+        //"not" needs the table's full recno set to complement against, so only PredicatePlan evaluates it
         assert(_val == "or" && "Unrecognized token\n");
     }
 
 }
-vectorlong Logical::intersect(vectorlong vector_1, vectorlong vector_2)
+vectorlong Logical::intersect(const vectorlong& vector_1, const vectorlong& vector_2)
 {
-    vectorlong result_vec;
-    long* vector_1_arr = &vector_1[0];
-    long* vector_2_arr = &vector_2[0];
     //for intersect // want to pick only the elements that both vectors have in common
-    merge_sort(vector_1_arr, vector_1.size());
-    merge_sort(vector_2_arr, vector_2.size());
-    set_intersection(vector_1.begin(), vector_1.end(), vector_2.begin(), vector_2.end(), back_inserter(result_vec));
+    vectorlong result_vec;
+    vectorlong scratch_1;
+    vectorlong scratch_2;
+    sorted_intersection(sorted_view(vector_1, scratch_1), sorted_view(vector_2, scratch_2), result_vec);
     return result_vec;
 }
-//Better performing union_vecs
-vectorlong Logical::union_vecs(vectorlong& vector_1, vectorlong& vector_2)
+vectorlong Logical::union_vecs(const vectorlong& vector_1, const vectorlong& vector_2)
 {
-    //ofc set_union didn't work! both vectors need to be sorted for se_union to work
+    //both vectors need to be sorted for the union to work
     vectorlong result_vec;
-    long* vector_1_arr = &vector_1[0];
-    long* vector_2_arr = &vector_2[0];
-    merge_sort(vector_1_arr, vector_1.size());
-    merge_sort(vector_2_arr, vector_2.size());
-    set_union(vector_1.begin(), vector_1.end(), vector_2.begin(), vector_2.end(), back_inserter(result_vec));
+    vectorlong scratch_1;
+    vectorlong scratch_2;
+    sorted_union(sorted_view(vector_1, scratch_1), sorted_view(vector_2, scratch_2), result_vec);
     return result_vec;
 }
+const vectorlong& Logical::sorted_view(const vectorlong& vec, vectorlong& scratch)
+{
+    //results of an earlier and/or are already sorted, so only unsorted input is copied
+    if(is_sorted(vec.begin(), vec.end()))
+        return vec;
+    scratch = vec;
+    sort_recnos(scratch);
+    return scratch;
+}
 void Logical::print_value()
 {
     cout<<_val;
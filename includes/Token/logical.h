@@ -12,6 +12,8 @@
 #include "result_set.h"
 #include "operator.h"
 #include "../SortingAlgorithms/SortAlgorithms.h"
+#include "../SortingAlgorithms/RecnoSort.h"
+#include "../SortingAlgorithms/SetAlgorithms.h"
 #include <algorithm>
 
 using namespace std;
@@ -23,12 +25,13 @@ public:
     Logical(const string &val);
     string get_val();
     vectorlong evaluate(Token *field_token, Token *condition_token, vector<mmap_sl> &record_indicies, map_sl &field_indicies) throw(Error_Code);
-    vectorlong intersect(vectorlong vector_1, vectorlong vector_2);
-    // Better performing union_vecs
-    vectorlong union_vecs(vectorlong &vector_1, vectorlong &vector_2);
+    vectorlong intersect(const vectorlong& vector_1, const vectorlong& vector_2);
+    vectorlong union_vecs(const vectorlong& vector_1, const vectorlong& vector_2);
     void print_value();
 private:
     string _val;
+    //vec if it is already sorted, otherwise a sorted copy of it in scratch
+    static const vectorlong& sorted_view(const vectorlong& vec, vectorlong& scratch);
 };
 
 #endif // ZAC_LOGICAL_
\ No newline at end of file
@@ -14,12 +14,14 @@ using namespace std;
 
 Operator::Operator() {
     _val = "";
+    _unary = false;
     set_token_type(OPERATOR);
     set_operator_type(TOKEN_END+1);
 }
 
 Operator::Operator(string val) : Token() {
     _val = val;
+    _unary = false;
     set_token_type(OPERATOR);
     set_operator_type(TOKEN_END+1);
 }
@@ -52,6 +54,16 @@ void Operator::set_precedence(const int& precedence)
     _precedence = precedence;
 }
 
+bool Operator::is_unary()
+{
+    return _unary;
+}
+
+void Operator::set_unary(bool unary)
+{
+    _unary = unary;
+}
+
 void Operator::print_value()
 {
     cout<<_val;
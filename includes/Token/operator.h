@@ -21,11 +21,15 @@ public:
     int get_operator_type();
     int get_precedence();
     void set_precedence(const int& precedence);
+    //unary operators (not) take a single operand that follows them
+    bool is_unary();
+    void set_unary(bool unary);
     void print_value();
 private:
     string _val;
     int _op_type;
     int _precedence;
+    bool _unary;
 };
 
 #endif //OPERATOR_H
\ No newline at end of file
@@ -9,6 +9,7 @@
 #include <string>
 #include <cassert>
 #include "relational.h"
+#include "../PredicatePlan/predicate_plan.h"
 
 using namespace std;
 
@@ -17,14 +18,14 @@ Relational::Relational()
     _val = "";
     set_token_type(OPERATOR);
     set_operator_type(RELATIONAL);
-    set_precedence(3);
+    set_precedence(4);
 }
 Relational::Relational(const string& val) : Operator()
 {
     _val = val;
     set_token_type(OPERATOR);
     set_operator_type(RELATIONAL);
-    set_precedence(3);
+    set_precedence(4);
 }
 string Relational::get_val()
 {
@@ -48,53 +49,10 @@ vectorlong Relational::evaluate(Token* field_token, Token* condition_token, vect
     const bool debug = false;
     if(debug)
         cout<<"Virtual evaluate() of relational class fired.\n";
-    //the string vec has field names
-    //_record_indicies[field_indicies[field]] <- this gives the right multimap
-    // _record_indicies[_field_indicies[field]][condition] <- this is getting the condition from the multimap
-    vectorlong build_vector;
-    string relational = _val;
-    if(relational == "=")
-    {
-        build_vector = record_indicies[field_indicies[field]][condition];
-    }
-    else if(relational == "<")
-    {
-        for(mmap_sl::Iterator it = record_indicies[field_indicies[field]].begin(); 
-        it !=  record_indicies[field_indicies[field]].lower_bound(condition); ++it)
-        {
-            for(int i = 0; i < (*it).value_list.size(); i++)
-                build_vector.push_back((*it).value_list[i]);
-        }
-    }
-    else if(relational == ">")
-    {
-        for(mmap_sl::Iterator it = record_indicies[field_indicies[field]].upper_bound(condition); 
-        it !=  record_indicies[field_indicies[field]].end(); ++it)
-        {
-            for(int i = 0; i < (*it).value_list.size(); i++)
-                build_vector.push_back((*it).value_list[i]);
-        }
-    }
-    else if(relational == ">=")
-    {
-        for(mmap_sl::Iterator it = record_indicies[field_indicies[field]].lower_bound(condition); 
-        it !=  record_indicies[field_indicies[field]].end(); ++it)
-        {
-            for(int i = 0; i < (*it).value_list.size(); i++)
-                build_vector.push_back((*it).value_list[i]);
-        }
-    }
-    else
-    {
-        //less than equal
-        for(mmap_sl::Iterator it = record_indicies[field_indicies[field]].begin(); 
-        it !=  record_indicies[field_indicies[field]].upper_bound(condition); ++it)
-        {
-            for(int i = 0; i < (*it).value_list.size(); i++)
-                build_vector.push_back((*it).value_list[i]);
-        }
-    }
-    //if not less than equal then, throw that there's a syntax error at or near the operator relational token is holding
+    //a single comparison is a one leaf plan, which also rejects operators it does not know
+    //instead of treating them as "<="
+    PredicatePlan plan(field_indicies[field], field, _val, condition);
+    vectorlong build_vector = plan.evaluate(record_indicies);
     if(debug)
         cout<<"build_vector: "<<build_vector<<"\n";
     return build_vector;
@@ -8,27 +8,47 @@
 #include <vector>
 #include <string>
 #include <cassert>
+#include <algorithm>
 #include "result_set.h"
 using namespace std;
 
 ResultSet::ResultSet()
 {
     _val_list = {};
+    _sorted = true;
+    _complemented = false;
     set_token_type(RESULT_SET);
 }
-ResultSet::ResultSet(vectorlong val_list) : Token()
+ResultSet::ResultSet(const vectorlong& val_list, bool sorted) : Token()
 {
     _val_list = val_list;
+    _sorted = sorted;
+    _complemented = false;
     set_token_type(RESULT_SET);
 }
-ResultSet ResultSet::operator =(const vectorlong& val_list)
+ResultSet& ResultSet::operator =(const vectorlong& val_list)
 {
     set_token_type(RESULT_SET);
     _val_list = val_list;
+    _sorted = false;
+    _complemented = false;
+    return *this;
 }
-vectorlong ResultSet::get_val_list()
+const vectorlong& ResultSet::get_val_list() const
 {
     return _val_list;
 }
+void ResultSet::swap(ResultSet& other)
+{
+    _val_list.swap(other._val_list);
+    std::swap(_sorted, other._sorted);
+    std::swap(_complemented, other._complemented);
+}
+void ResultSet::clear()
+{
+    _val_list.clear();
+    _sorted = true;
+    _complemented = false;
+}
 
 #endif //RESULT_SET_H
\ No newline at end of file
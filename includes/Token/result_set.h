@@ -17,12 +17,24 @@ class ResultSet : public Token
 {
 public:
     ResultSet();
-    ResultSet(vectorlong val_list);
-    ResultSet operator =(const vectorlong& val_list);
-    vectorlong get_val_list();
-    
+    ResultSet(const vectorlong& val_list, bool sorted = false);
+    ResultSet& operator =(const vectorlong& val_list);
+    const vectorlong& get_val_list() const;
+    //direct access so results can be filled and swapped in place
+    vectorlong& val_list() {return _val_list;}
+    //true if the records are in ascending order with no duplicates
+    bool sorted() const {return _sorted;}
+    void set_sorted(bool sorted) {_sorted = sorted;}
+    //true if the set is every record except the ones listed, so a not costs nothing
+    bool complemented() const {return _complemented;}
+    void set_complemented(bool complemented) {_complemented = complemented;}
+    void swap(ResultSet& other);
+    void clear();
+
 private:
     vectorlong _val_list;
+    bool _sorted;
+    bool _complemented;
 };
 
 #endif //RESULT_SET_H
\ No newline at end of file
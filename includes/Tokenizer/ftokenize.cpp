@@ -0,0 +1,72 @@
+#ifndef FTOKENIZER_CPP
+#define FTOKENIZER_CPP
+
+#include "ftokenize.h"
+
+using namespace std;
+
+FTokenizer::FTokenizer(const string& fname, int block_size)
+{
+    _f.open(fname.c_str(), ios::binary);
+    _open = !_f.fail();
+    _block_size = block_size > 0 ? block_size : MAX_BLOCK;
+    _cut = 0;
+    _block_start = 0;
+    _pos = 0;
+    _blockPos = 0;
+    _more = _open && get_new_block();
+}
+FTokenizer& operator >> (FTokenizer& f, SToken& t)
+{
+    while(f._more)
+    {
+        if(f._stk.more())
+        {
+            f._stk >> t;
+            //the token that leaves the STokenizer done only marks the end of the block
+            if(f._stk.more())
+            {
+                //an empty token is past the end of the text
+                f._blockPos = t.view().empty() ? f._cut : t.view().data() - f._block.data();
+                f._pos = f._block_start + f._blockPos;
+                return f;
+            }
+        }
+        f._more = f.get_new_block();
+    }
+    t = SToken();
+    return f;
+}
+
+//private
+bool FTokenizer::get_new_block()
+{
+    const bool debug = false;
+    //v the text after the last cut moves to the front of the block
+    _block_start += _cut;
+    _block.erase(0, _cut);
+    bool end_of_file = false;
+    size_t cut = string::npos;
+    while(cut == string::npos && !end_of_file)
+    {
+        int kept = _block.size();
+        _block.resize(kept + _block_size);
+        _f.read(&_block[kept], _block_size);
+        _block.resize(kept + _f.gcount());
+        end_of_file = _f.gcount() < _block_size;
+        //a block with no space in it is one word, it grows until the word ends
+        cut = _block.find_last_of(" \t\n");
+    }
+    _cut = end_of_file ? _block.size() : cut + 1;
+    if(debug)
+        cout << "----- New Block ---------------------" << _cut << " of " << _block.size() << "\n";
+    if(_cut == 0)
+    {
+        _f.close();
+        return false;
+    }
+    _stk.set_string(StrView(_block.data(), _cut));
+    return true;
+}
+
+#endif
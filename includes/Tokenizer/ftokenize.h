@@ -10,122 +10,38 @@
 
 using namespace std;
 
+//tokenizes a file a block at a time, the way the STokenizer tokenizes a string
+//a block is only tokenized up to its last space, the word it ends in is carried into the next block,
+//so no token is ever cut in two. tokens are slices of the current block: use them before the next >>
 class FTokenizer
 {
 public:
-    const int MAX_BLOCK = MAX_BUFFER;
-    FTokenizer(char* fname)
-    {
-        _f.open(fname);
-        if(_f.fail())
-        {
-            cout <<"_f ifstream error opening "<<fname<<"\n";
-            exit(1);
-        }
-        _pos = 0;
-        _blockPos = 0;
-        _done_count = 0;
-        if(get_new_block())
-            _more_blocks = true;
-        else
-            _more_blocks = false;
-    }
-    SToken next_token()
-    {
-        return SToken();
-    }
-    bool more()        //returns the current value of _more
-    {
-        return _more;
-    }
-    int pos()          //returns the value of _pos
-    {
-        return _pos;
-    }
-    int block_pos()     //returns the value of _blockPos
-    {
-        return _blockPos;
-    }
-    friend FTokenizer& operator >> (FTokenizer& f, SToken& t)
-    {
-        if(f._more_blocks)
-        {
-            if(f._stk.done())
-            {
-                // cout <<"done f._blockPos" <<f._blockPos << "\n";
-                if(f.get_new_block())
-                {
-                    f._done_count = 0;
-                    f._blockPos = 0;
-                    f._more_blocks = true;
-                    f._stk >> t;
-                    f._blockPos++;
-                    f._pos++;
-                }
-                else
-                {
-                    f._more_blocks = false;
-                }
-            }
-            else
-            {
-                // cout <<"f._blockPos" <<f._blockPos << "\n";
-                f._stk >> t;
-                f._blockPos++;
-                f._pos++;
-            }
-        }
-        else
-        {
-            if(f._stk.more())
-            {
-                f._stk >> t;
-                f._blockPos++;
-                f._pos++;
-            }
-            else
-            {
-                f._more = false;
-                f._f.close();
-            }
-        }
-        return f;
-    }
+    static const int MAX_BLOCK = MAX_BUFFER;
+    //block_size is for testing the carry over with small blocks
+    explicit FTokenizer(const string& fname, int block_size = MAX_BLOCK);
+    //false if the file could not be opened, it then has no tokens
+    bool is_open() const {return _open;}
+    bool more() const {return _more;}   //false once >> has run past the last token
+    long pos() const {return _pos;}     //where in the file the last token starts
+    int block_pos() const {return _blockPos;}   //where in its block the last token starts
+    //extract one token, the same way as from an STokenizer: f >> t; while(f.more()) {...; f >> t;}
+    friend FTokenizer& operator >> (FTokenizer& f, SToken& t);
+
 private:
-    bool get_new_block() //gets the new block from the file
-    {
-        const bool debug = true;
-        char tempblock[MAX_BLOCK];
-        // tempblock[0] = '\0';
-        _f.read(tempblock, MAX_BLOCK);
-        tempblock[_f.gcount()] = '\0';
-        if(debug)
-        {
-            cout << "-------tempblock-----" << "\n";
-            cout << tempblock << "\n";
-        }
-        if(strlen(tempblock) > 0)
-        {
-            cout << "----- New Block ---------------------"<<_f.gcount()<<"\n";
-            _stk.set_string(tempblock);
-            return true;
-        }
-        else
-        {
-            return false;
-        }
+    bool get_new_block();  //gets the new block from the file, false at the end of the file
 
-    }
     std::ifstream _f;   //file being tokenized
-    STokenizer _stk;     //The STokenizer object to tokenize current block
-    int _pos;           //Current position in the file
+    int _block_size;    //bytes read at a time
+    string _block;      //current block, after the text carried from the last block
+    int _cut;           //the block is tokenized up to here, the rest is carried
+    long _block_start;  //where in the file the current block starts
+    STokenizer _stk;    //The STokenizer object to tokenize current block
+    long _pos;          //Current position in the file
     int _blockPos;      //Current position in the current block
+    bool _open;
     bool _more;         //false if last token of the last block
-    bool _more_blocks;
                         //  has been processed and now we are at
                         //  the end of the last block.
-    int _done_count;
 };
 
-
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,156 @@
+#ifndef STATEMENT_SPLITTER_CPP
+#define STATEMENT_SPLITTER_CPP
+
+#include "statement_splitter.h"
+#include "../Parser/parser.h"
+
+using namespace std;
+
+StatementSplitter::StatementSplitter(FTokenizer& ftk): _ftk(ftk)
+{
+    _kind = SCRIPT_UNKNOWN;
+    _quote = '\0';
+    _last_complete = false;
+    _next_ready = 0;
+    _finished = false;
+}
+bool StatementSplitter::next(string& statement)
+{
+    while(_next_ready == _ready.size())
+    {
+        if(_finished)
+            return false;
+        _ready.clear();
+        _next_ready = 0;
+        read_statement();
+    }
+    statement = _ready[_next_ready++];
+    return true;
+}
+
+//private
+void StatementSplitter::read_statement()
+{
+    SToken t;
+    while(_ready.empty() && !_finished)
+    {
+        _ftk >> t;
+        if(!_ftk.more())
+        {
+            end_script();
+            return;
+        }
+        StrView text = t.view();
+        switch(t.type())
+        {
+        case STOKEN_PUNC:
+        case STOKEN_SPACE:
+        case STOKEN_UNKNOWN:
+            //quotes, ; and newlines only come in these
+            for(int i = 0; i < text.size(); i++)
+                add_char(text[i]);
+            break;
+        default:
+            _statement.append(text.data(), text.size());
+            break;
+        }
+    }
+}
+void StatementSplitter::add_char(char c)
+{
+    if(c == '\n')
+    {
+        end_line();
+        return;
+    }
+    if(_quote != '\0')
+    {
+        if(c == _quote)
+            _quote = '\0';
+    }
+    else if(c == '\"' || c == '\'')
+        _quote = c;
+    else if(c == ';')
+    {
+        if(_kind == SCRIPT_UNKNOWN)
+        {
+            //the first ; shows statements end with ;, so the lines held so far are all one statement
+            _kind = SCRIPT_SEMICOLONS;
+            string first;
+            for(int i = 0; i < _lines.size(); i++)
+                first += _lines[i] + "\n";
+            _statement = first + _statement;
+            _lines.clear();
+        }
+        end_statement(_statement);
+        _statement.clear();
+        return;
+    }
+    _statement += c;
+}
+void StatementSplitter::end_line()
+{
+    //a quote left open ends with its line, so one stray quote cannot swallow the rest of the script
+    _quote = '\0';
+    if(_kind == SCRIPT_SEMICOLONS)
+    {
+        _statement += '\n';
+        return;
+    }
+    if(_kind == SCRIPT_UNKNOWN && _statement.find_first_not_of(" \t\r") != string::npos)
+    {
+        //one whole command on a line may still go on over the next ones to a ;, like a select
+        //before its where, two cannot
+        bool line_complete = complete(_statement);
+        if(line_complete && _last_complete)
+            end_lines();
+        _last_complete = line_complete;
+    }
+    if(_kind == SCRIPT_LINES)
+        end_statement(_statement);
+    else
+        _lines.push_back(_statement);
+    _statement.clear();
+}
+void StatementSplitter::end_script()
+{
+    _finished = true;
+    //no ; in the whole script, every line is a statement
+    if(_kind == SCRIPT_UNKNOWN)
+        end_lines();
+    end_statement(_statement);
+    _statement.clear();
+}
+void StatementSplitter::end_statement(const string& text)
+{
+    const char* spaces = " \t\n\r";
+    size_t begin = text.find_first_not_of(spaces);
+    if(begin == string::npos)
+        return;
+    size_t end = text.find_last_not_of(spaces);
+    _ready.push_back(text.substr(begin, end - begin + 1));
+}
+void StatementSplitter::end_lines()
+{
+    _kind = SCRIPT_LINES;
+    for(int i = 0; i < _lines.size(); i++)
+        end_statement(_lines[i]);
+    _lines.clear();
+}
+bool StatementSplitter::complete(const string& line)
+{
+    Parser parser(line);
+    Statement statement;
+    try
+    {
+        parser.parse();
+        parser.parse_statement(statement);
+    }
+    catch(Error_Code&)
+    {
+        return false;
+    }
+    return true;
+}
+
+#endif //STATEMENT_SPLITTER_CPP
@@ -0,0 +1,49 @@
+#ifndef STATEMENT_SPLITTER_H
+#define STATEMENT_SPLITTER_H
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include "ftokenize.h"
+
+using namespace std;
+
+//cuts a script into its statements as its tokens stream in from an FTokenizer
+//statements end with a ; that is not in quotes and can span lines. a script with no ; runs a
+//statement per line, the way batch files always have: until its first ; the splitter cannot
+//tell which kind of script it has, so it holds the lines before it. two lines in a row that each
+//parse as a whole command cannot be one statement, so they settle it as a script of lines and
+//the held lines go out, after that only a line is held
+class StatementSplitter
+{
+public:
+    explicit StatementSplitter(FTokenizer& ftk);
+    //the next statement without its ; and outer spaces, false once the script has none left
+    //empty statements are skipped
+    bool next(string& statement);
+
+private:
+    enum script_kind {SCRIPT_UNKNOWN, SCRIPT_LINES, SCRIPT_SEMICOLONS};
+
+    FTokenizer& _ftk;
+    script_kind _kind;
+    string _statement;      //text of the statement being read
+    char _quote;            //the quote the statement is in, '\0' outside quotes
+    vector<string> _lines;  //lines read before the kind of script is known
+    bool _last_complete;    //the last line held that is not blank parses as a whole command
+    vector<string> _ready;  //statements to hand out, in order
+    int _next_ready;
+    bool _finished;         //the whole script has been read
+
+    //reads tokens until a statement is ready or the script ends
+    void read_statement();
+    void add_char(char c);
+    void end_line();
+    void end_script();
+    void end_statement(const string& text);
+    void end_lines();
+    //the line parses as a whole command by itself
+    static bool complete(const string& line);
+};
+
+#endif //STATEMENT_SPLITTER_H
@@ -5,9 +5,11 @@
 #include "iomanip"
 #include "string.h"
 #include "stoken_constants.h"
+#include "../StrView/str_view.h"
 
 using namespace std;
 
+//a token is a slice of the text being tokenized, that text has to outlive it
 class SToken
 {
 public:
@@ -19,17 +21,16 @@ public:
         {
             cout << "Token CTOR Fired.\n";
         }
-        _token = "";
         _type = 0;
     }
-    SToken(string str, int type)
+    SToken(StrView token, int type)
     {
          const bool debug = false;
         if(debug)
         {
-            cout << "Token(string str, int type) CTOR Fired.\n";
+            cout << "Token(StrView token, int type) CTOR Fired.\n";
         }
-        _token = str;
+        _token = token;
         _type = type;
     }
     friend ostream& operator <<(ostream& outs, const SToken& t)
@@ -37,9 +38,9 @@ public:
         outs<< "|"<<t._token<<"|";
         return outs;
     }
-    int type() const
+    stoken_types type() const
     {
-        return _type;
+        return static_cast<stoken_types>(_type);
     }
     string type_string() const
     {
@@ -67,12 +68,17 @@ public:
             return "ERROR";
         }
     }
+    //a copy of the token
     string token_str() const
+    {
+        return _token.str();
+    }
+    StrView view() const
     {
         return _token;
     }
 private:
-    string _token;
+    StrView _token;
     int _type;
 };
 
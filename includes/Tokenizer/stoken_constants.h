@@ -4,12 +4,13 @@
 //v Prof's code
 // const int MAX_COLUMNS = 256;
 // const int MAX_ROWS = 100;
-const int MAX_BUFFER = 200;
+//size of the blocks the FTokenizer reads, the STokenizer takes text of any length
+const int MAX_BUFFER = 64 * 1024;
 //For now
 //v Constants for table 1
 // const int MAX_ROWS = 5;
 //v Constants for table 2
-const int MAX_ROWS = 9;
+const int MAX_ROWS = 10;
 const int MAX_COLUMNS = 128;
 
 const char ALFA[] = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ*";
@@ -24,16 +25,20 @@ const int START_ALPHA = 6;
 const int START_OPERATOR = 20;
 const int START_PUNC = 10;
 
-//token types:
-const int STOKEN_NUMBER = 1;
-const int STOKEN_ALPHA = 2;
-const int STOKEN_SPACE = 3;
-const int STOKEN_OPERATOR = 4;
-const int STOKEN_PUNC = 5;
-//TOKEN PAREN is 8 because 6 and 7 are being used to handle decimals
-const int STOKEN_PAREN = 8;
-
-const int STOKEN_UNKNOWN = -1;
-const int STOKEN_END = -2;
+//token types, each is also the table state that accepts it:
+enum stoken_types
+{
+    STOKEN_END = -2,
+    STOKEN_UNKNOWN = -1,
+    STOKEN_NUMBER = 1,
+    STOKEN_ALPHA = 2,
+    STOKEN_SPACE = 3,
+    STOKEN_OPERATOR = 4,
+    STOKEN_PUNC = 5,
+    //TOKEN PAREN is 8 because 6 and 7 are being used to handle decimals
+    STOKEN_PAREN = 8
+};
+//state 9 is a word followed by a dot, a qualified name like student.lname if a letter comes next
+const int STOKEN_QUALIFIER_DOT = 9;
 
 #endif
\ No newline at end of file
@@ -3,42 +3,38 @@
 
 #include "stoken_constants.h"
 #include "string.h"
+#include "cassert"
 #include "stoken.h"
 #include "state_machine_functions.h"
 
 using namespace std;
 
+//tokens are slices of the text being tokenized, which is never copied and can be any length
+//the text has to outlive the tokenizer and its tokens
 class STokenizer
 {
 public:
     STokenizer()
     {
-        //make buffer empty
         const bool debug = false;
         if(debug)
         {
             cout << "Stokenizer CTOR Fired.\n";
         }
-        _buffer[0] = '\0';
         _pos = 0;
-        init_table(_table);
+        build_table_once();
         _buffer_null_hit_count = 0;
-        make_table(_table);
         _subscript_token = false;
     }
-    STokenizer(char str[])
+    STokenizer(StrView str)
     {
         const bool debug = false;
         if(debug)
         {
-            cout << "Stokenizer(char str[]) CTOR Fired.\n";
+            cout << "Stokenizer(StrView str) CTOR Fired.\n";
         }
-        //v Making sure buffer does not contain garbage
-        memset(_buffer, 0, strlen(_buffer));
-        strcpy(_buffer, str);
-        init_table(_table);
-        //v Not sure just testing
-        make_table(_table);
+        _buffer = str;
+        build_table_once();
         //v a CTOR bug was fixed here
         _pos = 0;
         _buffer_null_hit_count = 0;
@@ -62,7 +58,7 @@ public:
         //v Test for without memset
         // return _buffer_null_hit_count == 2;
         // return !(_buffer[_pos]);
-        return _buffer_null_hit_count == 2 || strlen(_buffer) == 0;
+        return _buffer_null_hit_count == 2 || at(0) == '\0';
     }
     bool more()            //true: there are more tokens
     {
@@ -110,7 +106,7 @@ public:
     friend STokenizer& operator >> (STokenizer& s, SToken& t)
     {
         const bool debug = false;
-        string token_str = "";
+        StrView token_str;
         int token_type;
         int start_state = 0;
         if(!(s.get_token(start_state, token_str)))
@@ -120,16 +116,18 @@ public:
             if(s._subscript_token)
             {
                 //v To make sure done works properly
+                //the token holds the bytes it skips, so the tokens of a text add up to all of it
+                token_str = s.skipped(s._pos, 2);
                 s._pos += 2;
-                if(s._buffer[s._pos] == '\0')
+                if(s.at(s._pos) == '\0')
                     s._buffer_null_hit_count++;
                 token_type = STOKEN_UNKNOWN;
-                token_str = "";
                 t = SToken(token_str, token_type);
                 s._subscript_token = false;
             }
             else
             {
+                token_str = s.skipped(s._pos, 1);
                 s._pos++;
                 token_type = STOKEN_UNKNOWN;
                 t = SToken(token_str, token_type);
@@ -137,7 +135,7 @@ public:
         }
         else
         {
-            char last_char_before_failing = s._buffer[s._pos - 1];
+            char last_char_before_failing = s.at(s._pos - 1);
             // cout <<"s._pos: "<<s._pos<<"\n";
             // cout <<"strlen(s._buffer): "<< strlen(s._buffer) <<"\n";
             // cout <<"s._buffer[s._pos - 1]: "<<s._buffer[s._pos - 1]<<"\n";
@@ -158,14 +156,9 @@ public:
     }
 
     //set a new string as the input string
-    void set_string(char str[])
+    void set_string(StrView str)
     {
-        // cout <<"_buffer before strcpy without memset: "<<_buffer<<"\n";
-        memset(_buffer, 0, strlen(_buffer));
-        //^ emptying the _buffer
-        strcpy(_buffer, str);
-        // cout <<"_buffer after strcpy without memset: "<<_buffer<<"\n";
-        // cout << "----- New Block ---------------------"<<sizeof(_buffer)<<"\n";
+        _buffer = str;
         _pos = 0;
         _buffer_null_hit_count = 0;
     }
@@ -176,13 +169,13 @@ public:
     void print_buffer()
     {
         cout<< "String in buffer: ";
-        for(int i = 0; _buffer[i] != '\0'; i++)
-            cout << _buffer[i];
+        for(int i = 0; at(i) != '\0'; i++)
+            cout << at(i);
         cout<< "NULL";
     }
     //for testing stage private functions
     //to delete later
-    bool get_token_test(int& start_state, string& token)
+    bool get_token_test(int& start_state, StrView& token)
     {
         return get_token(start_state, token);
     }
@@ -218,7 +211,19 @@ private:
     //     }
     // }
     //^ stage zero stokenizer table
-    void make_table(int _table[][MAX_COLUMNS])
+    //the table is the same for every tokenizer, the first one made builds it
+    static void build_table_once()
+    {
+        static const bool table_built = build_table();
+        assert(table_built);
+    }
+    static bool build_table()
+    {
+        init_table(_table);
+        make_table(_table);
+        return true;
+    }
+    static void make_table(int _table[][MAX_COLUMNS])
     {
         const bool debug = false;
         if(debug)
@@ -236,6 +241,7 @@ private:
         mark_fail(_table, 6);
         mark_success(_table, 7);
         mark_success(_table, 8);
+        mark_fail(_table, STOKEN_QUALIFIER_DOT);
 
         //v Marking initial states 
 
@@ -263,6 +269,11 @@ private:
 
         //if get a period in state 3 put to state 6
         mark_cell(STOKEN_NUMBER, _table, '.', 6);
+        //'!' starts a punctuation token, but "!=" is the not equal operator
+        mark_cell(STOKEN_PUNC, _table, '=', STOKEN_OPERATOR);
+        //table.field stays one word, a dot not followed by a letter is still punctuation
+        mark_cell(STOKEN_ALPHA, _table, '.', STOKEN_QUALIFIER_DOT);
+        mark_cells(STOKEN_QUALIFIER_DOT, _table, ALFA, STOKEN_ALPHA);
         //if get another dot in state 6 then punc state '3'
 
         if(debug)
@@ -276,17 +287,17 @@ private:
     //     one of the acceptable token types
     //To implement tonight
     //Precond: start_state < MAX_ROWS
-    bool get_token(int& start_state, string& token)
+    bool get_token(int& start_state, StrView& token)
     {
         const bool debug = false;
-        if(_buffer[_pos] < 0)
+        if(at(_pos) < 0)
         {
             _subscript_token = true;
             return false;
         }
-        if(_table[start_state][_buffer[_pos]] == -1)
+        if(_table[start_state][at(_pos)] == -1)
             return false;
-        if(_buffer[_pos] > MAX_COLUMNS-1)
+        if(at(_pos) > MAX_COLUMNS-1)
             return false;
         
         bool _fail_state = false;
@@ -294,15 +305,15 @@ private:
         bool unsucess_state = false;
         int token_start_pos = _pos;
 
-        for(int i = token_start_pos; _buffer[i] != '\0' && !_fail_state; i++)
+        for(int i = token_start_pos; at(i) != '\0' && !_fail_state; i++)
         {
-            if(_buffer[i] < 0)
+            if(at(i) < 0)
                 _subscript_token = true;
             //v mistake
             // _current_state = _table[_current_state][_buffer[i]];
             if(!_subscript_token)
             {
-                int _current_state = _table[start_state][_buffer[i]];
+                int _current_state = _table[start_state][at(i)];
                 if(debug)
                     cout <<"current_state: "<<_current_state<<"\n";
                 //If I'm at this # state that's not -1, am I a sucessful state?
@@ -346,17 +357,15 @@ private:
                 }
             }
         }
-        if(_buffer[_pos] == '\0')
+        if(at(_pos) == '\0')
             _buffer_null_hit_count++;
         if(_buffer_null_hit_count == 2 && !_fail_state)
         {
             token_found = true;
         }
         //_pos is a direct 0 based index 
-        for(int j = token_start_pos; j < _pos; j++)
-        {
-                token += _buffer[j];
-        }
+        if(_pos > token_start_pos)
+            token = _buffer.substr(token_start_pos, _pos - token_start_pos);
 
         return token_found;
     }
@@ -403,8 +412,19 @@ private:
     //     return token_found;
     // }
 
+    //char i of the input, '\0' past its end the way a c string ends
+    char at(int i) const
+    {
+        return i < _buffer.size() ? _buffer[i] : '\0';
+    }
+    //up to length chars from pos, none past the end of the input
+    StrView skipped(int pos, int length) const
+    {
+        return pos < _buffer.size() ? _buffer.substr(pos, length) : StrView();
+    }
+
     //---------------------------------
-    char _buffer[MAX_BUFFER];       //input string
+    StrView _buffer;                //input string
     int _pos;                       //current position in the string
     static int _table[MAX_ROWS][MAX_COLUMNS];
     unsigned int _buffer_null_hit_count;
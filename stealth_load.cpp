@@ -0,0 +1,146 @@
+#include <iostream>
+#include <iomanip>
+#include <cstring>
+#include <vector>
+#include <thread>
+#include <chrono>
+#include <algorithm>
+#include "includes/Server/client.h"
+
+using namespace std;
+
+//stealth_load: many clients sending commands to a running stealthd at once
+//usage: stealth_load [socket path] [--tcp port] [--clients n] [--queries n] [--rows n]
+//every client runs its queries back to back, one in ten an insert and the rest selects
+
+struct ClientRun {
+    vector<double> latencies;   //milliseconds of every query
+    long failed = 0;
+    long rows = 0;
+    string error;
+};
+
+bool connectClient(StealthClient& client, const string& socketPath, int tcpPort) {
+    return tcpPort > 0 ? client.connect_tcp("127.0.0.1", tcpPort) : client.connect_unix(socketPath);
+}
+
+void runClient(int id, int queries, int rows, const string& socketPath, int tcpPort, ClientRun& run) {
+    StealthClient client;
+    if(!connectClient(client, socketPath, tcpPort)) {
+        run.error = client.error();
+        return;
+    }
+    ClientResult result;
+    for(int i = 0; i < queries; i++) {
+        string command;
+        int key = (id * 7919 + i * 104729) % rows;
+        if(i % 10 == 9) {
+            command = "insert into loadtest values " + to_string(rows + id * queries + i) + ", " + string(1, 'a' + key % 10) + ", " + to_string(key % 1000);
+        }
+        else if(i % 2) {
+            command = "select dept, score from loadtest where id = " + to_string(key);
+        }
+        else {
+            command = "select * from loadtest where dept = " + string(1, 'a' + key % 10) + " and score < " + to_string(key % 100);
+        }
+        chrono::steady_clock::time_point start = chrono::steady_clock::now();
+        if(!client.query(command, result)) {
+            run.error = client.error();
+            return;
+        }
+        run.latencies.push_back(chrono::duration<double, milli>(chrono::steady_clock::now() - start).count());
+        run.failed += result.failed;
+        run.rows += result.row_count;
+    }
+}
+
+double percentile(const vector<double>& sorted, double p) {
+    if(sorted.empty()) {
+        return 0;
+    }
+    return sorted[min(sorted.size() - 1, (size_t)(p * sorted.size()))];
+}
+
+int main(int argc, char** argv) {
+    string socketPath = "stealth.sock";
+    int tcpPort = 0;
+    int clients = 8;
+    int queries = 1000;
+    int rows = 10000;
+
+    for(int i = 1; i < argc; i++) {
+        if(!strcmp(argv[i], "--tcp") && i + 1 < argc) {
+            tcpPort = atoi(argv[++i]);
+        }
+        else if(!strcmp(argv[i], "--clients") && i + 1 < argc) {
+            clients = max(1, atoi(argv[++i]));
+        }
+        else if(!strcmp(argv[i], "--queries") && i + 1 < argc) {
+            queries = max(1, atoi(argv[++i]));
+        }
+        else if(!strcmp(argv[i], "--rows") && i + 1 < argc) {
+            rows = max(1, atoi(argv[++i]));
+        }
+        else if(argv[i][0] != '-') {
+            socketPath = argv[i];
+        }
+        else {
+            cout << "usage: stealth_load [socket path] [--tcp port] [--clients n] [--queries n] [--rows n]\n";
+            return 1;
+        }
+    }
+
+    //a fresh table to query, loaded through the server in one batched insert per thousand rows
+    StealthClient setup;
+    ClientResult result;
+    if(!connectClient(setup, socketPath, tcpPort)) {
+        cout << "stealth_load: " << setup.error() << "\n";
+        return 1;
+    }
+    setup.query("drop table loadtest", result);
+    setup.query("make table loadtest fields id, dept, score", result);
+    for(int first = 0; first < rows; first += 1000) {
+        string insert = "insert into loadtest values ";
+        for(int i = first; i < rows && i < first + 1000; i++) {
+            insert += (i > first ? ", (" : "(") + to_string(i) + ", " + string(1, 'a' + i % 10) + ", " + to_string(i * 37 % 1000) + ")";
+        }
+        if(!setup.query(insert, result) || result.failed) {
+            cout << "stealth_load: loading failed: " << (result.failed ? result.error : setup.error()) << "\n";
+            return 1;
+        }
+    }
+    setup.disconnect();
+
+    vector<ClientRun> runs(clients);
+    vector<thread> threads;
+    chrono::steady_clock::time_point start = chrono::steady_clock::now();
+    for(int i = 0; i < clients; i++) {
+        threads.push_back(thread(runClient, i, queries, rows, socketPath, tcpPort, ref(runs[i])));
+    }
+    for(int i = 0; i < clients; i++) {
+        threads[i].join();
+    }
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+    vector<double> latencies;
+    long failed = 0;
+    long rowsSent = 0;
+    for(int i = 0; i < clients; i++) {
+        if(!runs[i].error.empty()) {
+            cout << "client " << i << ": " << runs[i].error << "\n";
+        }
+        latencies.insert(latencies.end(), runs[i].latencies.begin(), runs[i].latencies.end());
+        failed += runs[i].failed;
+        rowsSent += runs[i].rows;
+    }
+    sort(latencies.begin(), latencies.end());
+
+    cout << clients << " clients, " << latencies.size() << " queries in " << fixed << setprecision(2) << seconds << " s: "
+         << setprecision(0) << latencies.size() / seconds << " queries/s, " << rowsSent << " rows\n";
+    cout << setprecision(3) << "latency p50 " << percentile(latencies, 0.50) << " ms, p99 " << percentile(latencies, 0.99)
+         << " ms, max " << (latencies.empty() ? 0 : latencies.back()) << " ms\n";
+    if(failed) {
+        cout << failed << " queries failed\n";
+    }
+    return failed || latencies.size() != (size_t)clients * queries;
+}
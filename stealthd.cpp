@@ -0,0 +1,66 @@
+#include <iostream>
+#include <iomanip>
+#include <cstring>
+#include <csignal>
+#include "includes/SQL/sql.h"
+#include "includes/Server/server.h"
+#include "includes/ThreadPool/thread_pool.h"
+
+using namespace std;
+
+//stealthd: serves the tables of the directory it runs in to many clients at once
+//usage: stealthd [socket path] [--tcp port] [--workers n]
+
+StealthServer* runningServer = NULL;
+
+void stopServer(int signal) {
+    if(runningServer) {
+        runningServer->stop();
+    }
+}
+
+int main(int argc, char** argv) {
+    string socketPath = "stealth.sock";
+    int tcpPort = 0;
+    int workers = ThreadPool::hardware_threads();
+
+    for(int i = 1; i < argc; i++) {
+        if(!strcmp(argv[i], "--tcp") && i + 1 < argc) {
+            tcpPort = atoi(argv[++i]);
+        }
+        else if(!strcmp(argv[i], "--workers") && i + 1 < argc) {
+            workers = atoi(argv[++i]);
+        }
+        else if(argv[i][0] != '-') {
+            socketPath = argv[i];
+        }
+        else {
+            cout << "usage: stealthd [socket path] [--tcp port] [--workers n]\n";
+            return 1;
+        }
+    }
+
+    //one SQL instance owns the tables, every client goes through it
+    SQL stealthDBSystem;
+    StealthServer server(stealthDBSystem, workers);
+    if(!server.listen_unix(socketPath) || (tcpPort > 0 && !server.listen_tcp(tcpPort))) {
+        cout << "stealthd: " << server.error() << "\n";
+        return 1;
+    }
+
+    runningServer = &server;
+    signal(SIGINT, stopServer);
+    signal(SIGTERM, stopServer);
+
+    cout << "stealthd listening on " << socketPath;
+    if(tcpPort > 0) {
+        cout << " and 127.0.0.1:" << tcpPort;
+    }
+    cout << " with " << workers << " workers\n" << endl;
+
+    server.run();
+    runningServer = NULL;
+
+    cout << "\nstealthd stopped after " << server.commands() << " commands\n";
+    return 0;
+}